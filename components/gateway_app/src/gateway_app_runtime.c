@@ -10,6 +10,8 @@
 #include "wifi_service.h"
 #include "wifi_init.h"
 
+#include "esp_timer.h"
+
 #include <string.h>
 
 static gateway_status_t gateway_app_runtime_repo_load(void *ctx,
@@ -40,7 +42,7 @@ static const device_service_repo_port_t s_gateway_app_runtime_repo_port = {
 static void gateway_app_runtime_on_device_list_changed(void *ctx)
 {
     (void)ctx;
-    (void)esp_event_post(GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_LIST_CHANGED, NULL, 0, 0);
+    (void)gateway_event_post_changed(GATEWAY_EVENT_DEVICE_LIST_CHANGED, esp_timer_get_time());
 }
 
 static void gateway_app_runtime_on_device_delete_request(void *ctx,
@@ -10,6 +10,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "gateway_events.h"
+#include "gateway_persistence_adapter.h"
 #include "gateway_zigbee_runtime.h"
 #include "gateway_zigbee_runtime_internal.h"
 #include "rcp_tool.h"
@@ -24,6 +25,45 @@ static const char *TAG = "ZIGBEE_RUNTIME";
 
 static gateway_zigbee_runtime_handle_t s_active_runtime = NULL;
 
+static gateway_status_t zigbee_group_repo_load(void *ctx, zigbee_group_t *groups, size_t max_groups, int *group_count)
+{
+    (void)ctx;
+    return gateway_persistence_groups_load(groups, max_groups, group_count);
+}
+
+static gateway_status_t zigbee_group_repo_save(void *ctx, const zigbee_group_t *groups, size_t max_groups,
+                                               int group_count)
+{
+    (void)ctx;
+    return gateway_persistence_groups_save(groups, max_groups, group_count);
+}
+
+static const zigbee_group_repo_port_t s_zigbee_group_repo_port = {
+    .load = zigbee_group_repo_load,
+    .save = zigbee_group_repo_save,
+    .ctx = NULL,
+};
+
+static gateway_status_t zigbee_interview_repo_load(void *ctx, gateway_device_interview_t *records, size_t max_records,
+                                                   int *record_count)
+{
+    (void)ctx;
+    return gateway_persistence_interviews_load(records, max_records, record_count);
+}
+
+static gateway_status_t zigbee_interview_repo_save(void *ctx, const gateway_device_interview_t *records,
+                                                   size_t max_records, int record_count)
+{
+    (void)ctx;
+    return gateway_persistence_interviews_save(records, max_records, record_count);
+}
+
+static const zigbee_interview_repo_port_t s_zigbee_interview_repo_port = {
+    .load = zigbee_interview_repo_load,
+    .save = zigbee_interview_repo_save,
+    .ctx = NULL,
+};
+
 gateway_zigbee_runtime_handle_t gateway_zigbee_runtime_get_active(void)
 {
     return s_active_runtime;
@@ -77,6 +117,7 @@ static void esp_zb_task(void *pvParameters)
     esp_zb_cluster_list_add_basic_cluster(cluster_list, basic_cluster, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
     esp_zb_cluster_list_add_identify_cluster(cluster_list, esp_zb_identify_cluster_create(NULL), ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
     esp_zb_cluster_list_add_on_off_cluster(cluster_list, esp_zb_on_off_cluster_create(NULL), ESP_ZB_ZCL_CLUSTER_CLIENT_ROLE);
+    esp_zb_cluster_list_add_groups_cluster(cluster_list, esp_zb_groups_cluster_create(NULL), ESP_ZB_ZCL_CLUSTER_CLIENT_ROLE);
 
     esp_zb_ep_list_add_gateway_ep(ep_list, cluster_list, endpoint_config);
     esp_zb_device_register(ep_list);
@@ -104,12 +145,15 @@ esp_err_t gateway_zigbee_runtime_create(const gateway_runtime_context_t *ctx, ga
 
     handle->device_service = ctx->device_service;
     handle->gateway_state = ctx->gateway_state;
+    zigbee_event_ring_init(&handle->events);
     gateway_zigbee_runtime_set_active(handle);
 
     zigbee_service_init_params_t params = {
         .device_service = handle->device_service,
         .gateway_state = handle->gateway_state,
         .runtime_ops = gateway_zigbee_runtime_get_ops(),
+        .group_repo = &s_zigbee_group_repo_port,
+        .interview_repo = &s_zigbee_interview_repo_port,
     };
 
     esp_err_t ret = zigbee_service_create(&params, &handle->zigbee_service);
@@ -150,6 +194,8 @@ void gateway_zigbee_runtime_destroy(gateway_zigbee_runtime_handle_t handle)
         return;
     }
 
+    gateway_zigbee_runtime_events_stop(handle);
+
     if (handle->delete_req_handler) {
         (void)esp_event_handler_instance_unregister(
             GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_DELETE_REQUEST, handle->delete_req_handler);
@@ -163,6 +209,7 @@ void gateway_zigbee_runtime_destroy(gateway_zigbee_runtime_handle_t handle)
 
     handle->device_service = NULL;
     handle->gateway_state = NULL;
+    handle->last_live_lqi_request_us = 0;
     handle->last_live_lqi_refresh_us = 0;
 
     if (gateway_zigbee_runtime_get_active() == handle) {
@@ -195,6 +242,13 @@ esp_err_t gateway_zigbee_runtime_start(gateway_zigbee_runtime_handle_t handle)
     rcp_init_auto_update();
 #endif
 
+    /* The consumer exists before the stack, so nothing the Zigbee task posts waits for a late start. */
+    err = gateway_zigbee_runtime_events_start(handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start Zigbee event task: %s", esp_err_to_name(err));
+        return err;
+    }
+
     BaseType_t task_ok = xTaskCreate(esp_zb_task, "Zigbee_main", 8192, NULL, 5, NULL);
     if (task_ok != pdPASS) {
         ESP_LOGE(TAG, "Failed to create Zigbee task");
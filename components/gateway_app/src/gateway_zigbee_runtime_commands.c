@@ -1,18 +1,173 @@
 #include <string.h>
 
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
 #include "esp_zigbee_gateway.h"
 #include "gateway_status_esp.h"
 #include "gateway_zigbee_runtime_internal.h"
 
 static const char *TAG = "ZIGBEE_RUNTIME";
 
+#define ZIGBEE_RUNTIME_LOCK_TIMEOUT_MS 2000
+
 static esp_err_t zigbee_runtime_send_on_off(uint16_t short_addr, uint8_t endpoint, uint8_t on_off)
 {
     send_on_off_command(short_addr, endpoint, on_off);
     return ESP_OK;
 }
 
+/* The whole batch is queued under one stack lock instead of one hand-off per command. */
+static esp_err_t zigbee_runtime_send_on_off_batch(const zigbee_on_off_cmd_t *cmds, size_t count, esp_err_t *out_results)
+{
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_RUNTIME_LOCK_TIMEOUT_MS))) {
+        for (size_t i = 0; i < count; i++) {
+            out_results[i] = ESP_ERR_TIMEOUT;
+        }
+        return ESP_OK;
+    }
+    for (size_t i = 0; i < count; i++) {
+        send_on_off_command(cmds[i].short_addr, cmds[i].endpoint, cmds[i].on_off);
+        out_results[i] = ESP_OK;
+    }
+    esp_zb_lock_release();
+    return ESP_OK;
+}
+
+/* Runs from zigbee_service_cmd_pump, which the event task calls with the stack lock held. */
+static esp_err_t zigbee_runtime_transmit_on_off(const zigbee_on_off_cmd_t *cmd, uint8_t *out_tsn)
+{
+    *out_tsn = send_on_off_command(cmd->short_addr, cmd->endpoint, cmd->on_off);
+    return ESP_OK;
+}
+
+/* The alarm fires in the Zigbee task, which only hands the pump to the event task. */
+static void zigbee_runtime_cmd_pump_alarm(uint8_t param)
+{
+    (void)param;
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_CMD_PUMP,
+        .origin_us = esp_timer_get_time(),
+    };
+    gateway_zigbee_runtime_post_event(gateway_zigbee_runtime_get_active(), &event);
+}
+
+/* Callers include the Zigbee task itself; the stack lock is recursive, so that is safe. */
+static esp_err_t zigbee_runtime_schedule_cmd_pump(uint32_t delay_ms)
+{
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_RUNTIME_LOCK_TIMEOUT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    /* Only the earliest wake-up matters; an older alarm would just pump an idle queue. */
+    esp_zb_scheduler_alarm_cancel(zigbee_runtime_cmd_pump_alarm, 0);
+    esp_zb_scheduler_alarm(zigbee_runtime_cmd_pump_alarm, 0, delay_ms);
+    esp_zb_lock_release();
+    return ESP_OK;
+}
+
+/* Runs from zigbee_service_interview_pump under the stack lock; both strings come back in one response. */
+static esp_err_t zigbee_runtime_read_basic_identity(uint16_t short_addr, uint8_t endpoint)
+{
+    uint16_t attrs[] = {ESP_ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID, ESP_ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID};
+    esp_zb_zcl_read_attr_cmd_t cmd_req = {
+        .zcl_basic_cmd = {
+            .dst_addr_u.addr_short = short_addr,
+            .dst_endpoint = endpoint,
+            .src_endpoint = ESP_ZB_GATEWAY_ENDPOINT,
+        },
+        .address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+        .clusterID = ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+        .attr_number = sizeof(attrs) / sizeof(attrs[0]),
+        .attr_field = attrs,
+    };
+    esp_zb_zcl_read_attr_cmd_req(&cmd_req);
+    return ESP_OK;
+}
+
+static void zigbee_runtime_interview_pump_alarm(uint8_t param)
+{
+    (void)param;
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_INTERVIEW_PUMP,
+        .origin_us = esp_timer_get_time(),
+    };
+    gateway_zigbee_runtime_post_event(gateway_zigbee_runtime_get_active(), &event);
+}
+
+static esp_err_t zigbee_runtime_schedule_interview_pump(uint32_t delay_ms)
+{
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_RUNTIME_LOCK_TIMEOUT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_zb_scheduler_alarm_cancel(zigbee_runtime_interview_pump_alarm, 0);
+    esp_zb_scheduler_alarm(zigbee_runtime_interview_pump_alarm, 0, delay_ms);
+    esp_zb_lock_release();
+    return ESP_OK;
+}
+
+typedef enum {
+    ZIGBEE_RUNTIME_GROUP_ADD,
+    ZIGBEE_RUNTIME_GROUP_REMOVE,
+} zigbee_runtime_group_op_t;
+
+static esp_err_t zigbee_runtime_group_membership(zigbee_runtime_group_op_t op, uint16_t group_id, uint16_t short_addr,
+                                                 uint8_t endpoint)
+{
+    esp_zb_zcl_groups_add_group_cmd_t cmd_req = {
+        .zcl_basic_cmd = {
+            .dst_addr_u.addr_short = short_addr,
+            .dst_endpoint = endpoint,
+            .src_endpoint = ESP_ZB_GATEWAY_ENDPOINT,
+        },
+        .address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+        .group_id = group_id,
+    };
+
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_RUNTIME_LOCK_TIMEOUT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    if (op == ZIGBEE_RUNTIME_GROUP_ADD) {
+        esp_zb_zcl_groups_add_group_cmd_req(&cmd_req);
+    } else {
+        esp_zb_zcl_groups_remove_group_cmd_req(&cmd_req);
+    }
+    esp_zb_lock_release();
+
+    ESP_LOGI(TAG, "%s 0x%04x/%u %s group 0x%04x", op == ZIGBEE_RUNTIME_GROUP_ADD ? "Adding" : "Removing", short_addr,
+             endpoint, op == ZIGBEE_RUNTIME_GROUP_ADD ? "to" : "from", group_id);
+    return ESP_OK;
+}
+
+static esp_err_t zigbee_runtime_group_add_member(uint16_t group_id, uint16_t short_addr, uint8_t endpoint)
+{
+    return zigbee_runtime_group_membership(ZIGBEE_RUNTIME_GROUP_ADD, group_id, short_addr, endpoint);
+}
+
+static esp_err_t zigbee_runtime_group_remove_member(uint16_t group_id, uint16_t short_addr, uint8_t endpoint)
+{
+    return zigbee_runtime_group_membership(ZIGBEE_RUNTIME_GROUP_REMOVE, group_id, short_addr, endpoint);
+}
+
+/* One group-addressed frame reaches every member, however many there are. */
+static esp_err_t zigbee_runtime_send_group_on_off(uint16_t group_id, uint8_t on_off)
+{
+    esp_zb_zcl_on_off_cmd_t cmd_req = {
+        .zcl_basic_cmd = {
+            .dst_addr_u.addr_short = group_id,
+            .src_endpoint = ESP_ZB_GATEWAY_ENDPOINT,
+        },
+        .address_mode = ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT,
+        .on_off_cmd_id = on_off ? ESP_ZB_ZCL_CMD_ON_OFF_ON_ID : ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID,
+    };
+
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_RUNTIME_LOCK_TIMEOUT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_zb_zcl_on_off_cmd_req(&cmd_req);
+    esp_zb_lock_release();
+    return ESP_OK;
+}
+
 static esp_err_t zigbee_runtime_delete_device(uint16_t short_addr)
 {
     gateway_zigbee_runtime_handle_t runtime = gateway_zigbee_runtime_get_active();
@@ -34,10 +189,25 @@ static esp_err_t zigbee_runtime_rename_device(uint16_t short_addr, const char *n
     return gateway_status_to_esp_err(device_service_update_name(runtime->device_service, short_addr, new_name));
 }
 
+/* Zigbee task only: ZDO answers the service copied out of its callbacks. */
+static bool zigbee_runtime_post_event(const zigbee_event_t *event)
+{
+    return gateway_zigbee_runtime_post_event(gateway_zigbee_runtime_get_active(), event);
+}
+
 static const zigbee_service_runtime_ops_t s_zigbee_runtime_ops = {
     .send_on_off = zigbee_runtime_send_on_off,
+    .send_on_off_batch = zigbee_runtime_send_on_off_batch,
     .delete_device = zigbee_runtime_delete_device,
     .rename_device = zigbee_runtime_rename_device,
+    .group_add_member = zigbee_runtime_group_add_member,
+    .group_remove_member = zigbee_runtime_group_remove_member,
+    .send_group_on_off = zigbee_runtime_send_group_on_off,
+    .transmit_on_off = zigbee_runtime_transmit_on_off,
+    .schedule_cmd_pump = zigbee_runtime_schedule_cmd_pump,
+    .read_basic_identity = zigbee_runtime_read_basic_identity,
+    .schedule_interview_pump = zigbee_runtime_schedule_interview_pump,
+    .post_event = zigbee_runtime_post_event,
 };
 
 const zigbee_service_runtime_ops_t *gateway_zigbee_runtime_get_ops(void)
@@ -45,7 +215,7 @@ const zigbee_service_runtime_ops_t *gateway_zigbee_runtime_get_ops(void)
     return &s_zigbee_runtime_ops;
 }
 
-void send_on_off_command(uint16_t short_addr, uint8_t endpoint, uint8_t on_off)
+uint8_t send_on_off_command(uint16_t short_addr, uint8_t endpoint, uint8_t on_off)
 {
     esp_zb_zcl_on_off_cmd_t cmd_req = {
         .zcl_basic_cmd = {
@@ -56,7 +226,7 @@ void send_on_off_command(uint16_t short_addr, uint8_t endpoint, uint8_t on_off)
         .address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
         .on_off_cmd_id = on_off ? ESP_ZB_ZCL_CMD_ON_OFF_ON_ID : ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID,
     };
-    esp_zb_zcl_on_off_cmd_req(&cmd_req);
+    return esp_zb_zcl_on_off_cmd_req(&cmd_req);
 }
 
 void send_leave_command(uint16_t short_addr, esp_zb_ieee_addr_t ieee_addr)
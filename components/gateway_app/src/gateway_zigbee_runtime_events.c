@@ -0,0 +1,242 @@
+#include <inttypes.h>
+#include <string.h>
+
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "gateway_events.h"
+#include "gateway_status_esp.h"
+#include "gateway_zigbee_runtime_internal.h"
+#include "zigbee_service.h"
+
+static const char *TAG = "ZIGBEE_EVENTS";
+
+#define ZIGBEE_EVENT_TASK_STACK_SIZE 4096
+#define ZIGBEE_EVENT_TASK_PRIORITY 4
+#define ZIGBEE_EVENT_TASK_STOP_TIMEOUT_MS 1000
+#define ZIGBEE_EVENT_POST_TIMEOUT_MS 100
+#define ZIGBEE_EVENT_STACK_LOCK_TIMEOUT_MS 2000
+#define LIVE_LQI_REFRESH_MIN_INTERVAL_US (3 * 1000 * 1000)
+
+#define ZIGBEE_EVENT_NOTIFY_DATA (1u << 0)
+#define ZIGBEE_EVENT_NOTIFY_STOP (1u << 1)
+
+bool gateway_zigbee_runtime_post_event(gateway_zigbee_runtime_handle_t handle, const zigbee_event_t *event)
+{
+    if (!handle || !event || !zigbee_event_ring_push(&handle->events, event)) {
+        return false;
+    }
+    /* Before the event task exists the ring just holds the events; it drains them on start. */
+    TaskHandle_t task = handle->event_task;
+    if (task) {
+        (void)xTaskNotify(task, ZIGBEE_EVENT_NOTIFY_DATA, eSetBits);
+    }
+    return true;
+}
+
+static void apply_live_lqi_refresh(gateway_zigbee_runtime_handle_t handle, int64_t origin_us)
+{
+    /* Traffic bursts collapse into one neighbor table walk per interval. */
+    int64_t now_us = esp_timer_get_time();
+    if ((now_us - handle->last_live_lqi_refresh_us) < LIVE_LQI_REFRESH_MIN_INTERVAL_US) {
+        return;
+    }
+    handle->last_live_lqi_refresh_us = now_us;
+
+    esp_err_t ret = zigbee_service_refresh_neighbor_lqi_from_table(handle->zigbee_service);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Live LQI refresh failed: %s", esp_err_to_name(ret));
+        return;
+    }
+    (void)gateway_event_post_changed(GATEWAY_EVENT_LQI_STATE_CHANGED, origin_us);
+}
+
+static void apply_interview_done(gateway_zigbee_runtime_handle_t handle, int64_t origin_us)
+{
+    bool changed = false;
+    esp_err_t ret = zigbee_service_interview_collect(handle->zigbee_service, &changed);
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_SUPPORTED) {
+        /* The record is still served from memory; it is only lost on reboot. */
+        ESP_LOGW(TAG, "Failed to store device interview: %s", esp_err_to_name(ret));
+    }
+    if (changed) {
+        (void)gateway_event_post_changed(GATEWAY_EVENT_DEVICE_LIST_CHANGED, origin_us);
+    }
+}
+
+/* The pumps put frames on air, which outside the Zigbee task needs the stack lock. */
+static void run_cmd_pump(gateway_zigbee_runtime_handle_t handle)
+{
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_EVENT_STACK_LOCK_TIMEOUT_MS))) {
+        ESP_LOGW(TAG, "Zigbee stack busy, command queue waits for the next pump");
+        return;
+    }
+    zigbee_service_cmd_pump(handle->zigbee_service);
+    esp_zb_lock_release();
+}
+
+static void run_interview_pump(gateway_zigbee_runtime_handle_t handle, int64_t origin_us)
+{
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_EVENT_STACK_LOCK_TIMEOUT_MS))) {
+        ESP_LOGW(TAG, "Zigbee stack busy, interview waits for the next pump");
+        return;
+    }
+    bool finished = zigbee_service_interview_pump(handle->zigbee_service);
+    esp_zb_lock_release();
+    if (finished) {
+        apply_interview_done(handle, origin_us);
+    }
+}
+
+static void apply_event(gateway_zigbee_runtime_handle_t handle, const zigbee_event_t *event)
+{
+    switch (event->kind) {
+    case ZIGBEE_EVENT_NETWORK: {
+        esp_err_t ret = gateway_status_to_esp_err(gateway_state_set_network(handle->gateway_state, &event->u.network));
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to publish gateway state: %s", esp_err_to_name(ret));
+        }
+        break;
+    }
+    case ZIGBEE_EVENT_DEVICE_ANNOUNCE: {
+        gateway_device_announce_event_t evt = {
+            .short_addr = event->u.announce.short_addr,
+            .origin_us = event->origin_us,
+        };
+        memcpy(evt.ieee_addr, event->u.announce.ieee_addr, sizeof(evt.ieee_addr));
+        esp_err_t ret = esp_event_post(GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_ANNOUNCE, &evt, sizeof(evt),
+                                       pdMS_TO_TICKS(ZIGBEE_EVENT_POST_TIMEOUT_MS));
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to post DEVICE_ANNOUNCE event: %s", esp_err_to_name(ret));
+        }
+        bool changed = false;
+        ret = zigbee_service_on_device_announce(handle->zigbee_service, event->u.announce.short_addr,
+                                                event->u.announce.ieee_addr, &changed);
+        if (ret != ESP_OK && ret != ESP_ERR_NOT_SUPPORTED) {
+            ESP_LOGW(TAG, "Interview of 0x%04x not queued: %s", event->u.announce.short_addr, esp_err_to_name(ret));
+        }
+        if (changed) {
+            (void)gateway_event_post_changed(GATEWAY_EVENT_DEVICE_LIST_CHANGED, event->origin_us);
+        }
+        break;
+    }
+    case ZIGBEE_EVENT_INTERVIEW_DONE:
+        apply_interview_done(handle, event->origin_us);
+        break;
+    case ZIGBEE_EVENT_ATTR_VALUE: {
+        bool changed = false;
+        esp_err_t ret = zigbee_service_on_attr_value(
+            handle->zigbee_service, event->u.attr.short_addr, event->u.attr.endpoint, event->u.attr.cluster_id,
+            event->u.attr.attr_id, event->u.attr.zcl_type, event->u.attr.value, event->u.attr.size,
+            (gateway_attr_source_t)event->u.attr.source, &changed);
+        if (ret == ESP_OK && changed) {
+            (void)gateway_event_post_changed(GATEWAY_EVENT_DEVICE_STATE_CHANGED, event->origin_us);
+        }
+        break;
+    }
+    case ZIGBEE_EVENT_LINK_ACTIVITY:
+        apply_live_lqi_refresh(handle, event->origin_us);
+        break;
+    case ZIGBEE_EVENT_CMD_PUMP:
+        run_cmd_pump(handle);
+        break;
+    case ZIGBEE_EVENT_CMD_RESPONSE:
+        zigbee_service_on_cmd_response(handle->zigbee_service, event->u.cmd_response.short_addr,
+                                       event->u.cmd_response.tsn, event->u.cmd_response.success);
+        break;
+    case ZIGBEE_EVENT_INTERVIEW_PUMP:
+        run_interview_pump(handle, event->origin_us);
+        break;
+    case ZIGBEE_EVENT_BASIC_IDENTITY:
+        zigbee_service_interview_on_basic(handle->zigbee_service, event->u.basic.short_addr,
+                                          event->u.basic.has_manufacturer ? event->u.basic.manufacturer : NULL,
+                                          event->u.basic.has_model ? event->u.basic.model : NULL);
+        break;
+    case ZIGBEE_EVENT_LQI_PAGE:
+    case ZIGBEE_EVENT_TOPOLOGY_PAGE:
+    case ZIGBEE_EVENT_ACTIVE_EP:
+    case ZIGBEE_EVENT_SIMPLE_DESC:
+        zigbee_service_on_zdo_event(handle->zigbee_service, event);
+        break;
+    default:
+        break;
+    }
+}
+
+static void zigbee_event_task(void *arg)
+{
+    gateway_zigbee_runtime_handle_t handle = (gateway_zigbee_runtime_handle_t)arg;
+    uint32_t dropped_seen = 0;
+    for (;;) {
+        uint32_t bits = 0;
+        (void)xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        if (bits & ZIGBEE_EVENT_NOTIFY_STOP) {
+            break;
+        }
+        zigbee_event_t event;
+        while (zigbee_event_ring_pop(&handle->events, &event)) {
+            apply_event(handle, &event);
+        }
+
+        gateway_zigbee_event_stats_t stats = {0};
+        zigbee_event_ring_get_stats(&handle->events, &stats);
+        if (stats.dropped_total != dropped_seen) {
+            ESP_LOGW(TAG, "Event ring full: %" PRIu32 " Zigbee events dropped (peak %" PRIu32 "/%" PRIu32 ")",
+                     stats.dropped_total - dropped_seen, stats.depth_peak, stats.capacity);
+            dropped_seen = stats.dropped_total;
+            /* A dropped pump or INTERVIEW_DONE would leave its queue waiting forever; run both pumps once more.
+             * Dropped answers need nothing: their requests time out and are retried like lost frames. */
+            int64_t now_us = esp_timer_get_time();
+            run_cmd_pump(handle);
+            run_interview_pump(handle, now_us);
+            apply_interview_done(handle, now_us);
+        }
+        (void)gateway_state_set_zigbee_events(handle->gateway_state, &stats);
+    }
+    xSemaphoreGive(handle->event_task_done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t gateway_zigbee_runtime_events_start(gateway_zigbee_runtime_handle_t handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->event_task) {
+        return ESP_OK;
+    }
+    if (!handle->event_task_done) {
+        handle->event_task_done = xSemaphoreCreateBinary();
+        if (!handle->event_task_done) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (xTaskCreate(zigbee_event_task, "zgw_zb_events", ZIGBEE_EVENT_TASK_STACK_SIZE, handle,
+                    ZIGBEE_EVENT_TASK_PRIORITY, &handle->event_task) != pdPASS) {
+        handle->event_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    /* Anything queued before the task existed (initial network state) is applied right away. */
+    (void)xTaskNotify(handle->event_task, ZIGBEE_EVENT_NOTIFY_DATA, eSetBits);
+    return ESP_OK;
+}
+
+void gateway_zigbee_runtime_events_stop(gateway_zigbee_runtime_handle_t handle)
+{
+    if (!handle) {
+        return;
+    }
+    if (handle->event_task) {
+        (void)xTaskNotify(handle->event_task, ZIGBEE_EVENT_NOTIFY_STOP, eSetBits);
+        /* The task still uses the handle and the semaphore until it gives it, so a slow event is waited out. */
+        if (xSemaphoreTake(handle->event_task_done, pdMS_TO_TICKS(ZIGBEE_EVENT_TASK_STOP_TIMEOUT_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "Zigbee event task did not stop in %d ms, still waiting", ZIGBEE_EVENT_TASK_STOP_TIMEOUT_MS);
+            (void)xSemaphoreTake(handle->event_task_done, portMAX_DELAY);
+        }
+        handle->event_task = NULL;
+    }
+    if (handle->event_task_done) {
+        vSemaphoreDelete(handle->event_task_done);
+        handle->event_task_done = NULL;
+    }
+}
@@ -7,22 +7,36 @@
 #include "esp_err.h"
 #include "esp_event.h"
 #include "esp_zigbee_core.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "gateway_zigbee_runtime.h"
 #include "state_store.h"
+#include "zigbee_event_ring.h"
 #include "zigbee_service.h"
 
 struct gateway_zigbee_runtime {
     esp_event_handler_instance_t delete_req_handler;
-    int64_t last_live_lqi_refresh_us;
+    int64_t last_live_lqi_request_us; /* Zigbee task only */
+    int64_t last_live_lqi_refresh_us; /* event task only */
     device_service_handle_t device_service;
     gateway_state_handle_t gateway_state;
     zigbee_service_handle_t zigbee_service;
+    /* Zigbee task -> event task; the Zigbee task only pushes and notifies. */
+    zigbee_event_ring_t events;
+    TaskHandle_t event_task;
+    SemaphoreHandle_t event_task_done;
 };
 
 gateway_zigbee_runtime_handle_t gateway_zigbee_runtime_get_active(void);
 void gateway_zigbee_runtime_set_active(gateway_zigbee_runtime_handle_t handle);
 
-void refresh_lqi_from_live_event(gateway_zigbee_runtime_handle_t handle, const char *reason);
+esp_err_t gateway_zigbee_runtime_events_start(gateway_zigbee_runtime_handle_t handle);
+void gateway_zigbee_runtime_events_stop(gateway_zigbee_runtime_handle_t handle);
+/* Zigbee task only: copies the event into the ring and wakes the event task, never blocks. false — dropped. */
+bool gateway_zigbee_runtime_post_event(gateway_zigbee_runtime_handle_t handle, const zigbee_event_t *event);
+
+void request_live_lqi_refresh(gateway_zigbee_runtime_handle_t handle);
 void gateway_state_publish(gateway_zigbee_runtime_handle_t handle, bool zigbee_started, bool factory_new);
 void device_delete_request_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data);
 esp_err_t gateway_zigbee_runtime_action_handler(esp_zb_core_action_callback_id_t callback_id, const void *message);
@@ -6,63 +6,57 @@
 #include "esp_timer.h"
 #include "esp_zigbee_gateway.h"
 #include "gateway_events.h"
-#include "gateway_status_esp.h"
 #include "gateway_zigbee_runtime_internal.h"
 #include "zigbee_service.h"
 #include <zcl/esp_zigbee_zcl_core.h>
 
 static const char *TAG = "ZIGBEE_RUNTIME";
-#define LIVE_LQI_REFRESH_MIN_INTERVAL_US (3 * 1000 * 1000)
+#define LIVE_LQI_REQUEST_MIN_INTERVAL_US (3 * 1000 * 1000)
 
 static void bdb_start_top_level_commissioning_cb(uint8_t mode_mask)
 {
     esp_zb_bdb_start_top_level_commissioning(mode_mask);
 }
 
-void refresh_lqi_from_live_event(gateway_zigbee_runtime_handle_t handle, const char *reason)
+void request_live_lqi_refresh(gateway_zigbee_runtime_handle_t handle)
 {
-    if (!handle || !handle->zigbee_service) {
+    if (!handle) {
         return;
     }
+    /* Only the request is throttled here; the table walk and the cache update run in the event task. */
     int64_t now_us = esp_timer_get_time();
-    if ((now_us - handle->last_live_lqi_refresh_us) < LIVE_LQI_REFRESH_MIN_INTERVAL_US) {
+    if ((now_us - handle->last_live_lqi_request_us) < LIVE_LQI_REQUEST_MIN_INTERVAL_US) {
         return;
     }
-    handle->last_live_lqi_refresh_us = now_us;
+    handle->last_live_lqi_request_us = now_us;
 
-    esp_err_t ret = zigbee_service_refresh_neighbor_lqi_from_table(handle->zigbee_service);
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Live LQI refresh failed (%s): %s", reason, esp_err_to_name(ret));
-        return;
-    }
-    (void)esp_event_post(GATEWAY_EVENT, GATEWAY_EVENT_LQI_STATE_CHANGED, NULL, 0, 0);
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_LINK_ACTIVITY,
+        .origin_us = now_us,
+    };
+    gateway_zigbee_runtime_post_event(handle, &event);
 }
 
 void gateway_state_publish(gateway_zigbee_runtime_handle_t handle, bool zigbee_started, bool factory_new)
 {
-    if (!handle || !handle->gateway_state) {
-        ESP_LOGW(TAG, "Gateway state handle is not initialized");
+    if (!handle) {
         return;
     }
 
-    gateway_network_state_t state = {
-        .zigbee_started = zigbee_started,
-        .factory_new = factory_new,
-        .pan_id = 0,
-        .channel = 0,
-        .short_addr = 0,
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_NETWORK,
+        .origin_us = esp_timer_get_time(),
+        .u.network = {
+            .zigbee_started = zigbee_started,
+            .factory_new = factory_new,
+        },
     };
-
     if (zigbee_started) {
-        state.pan_id = esp_zb_get_pan_id();
-        state.channel = esp_zb_get_current_channel();
-        state.short_addr = esp_zb_get_short_address();
-    }
-
-    esp_err_t ret = gateway_status_to_esp_err(gateway_state_set_network(handle->gateway_state, &state));
-    if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to publish gateway state: %s", esp_err_to_name(ret));
+        event.u.network.pan_id = esp_zb_get_pan_id();
+        event.u.network.channel = esp_zb_get_current_channel();
+        event.u.network.short_addr = esp_zb_get_short_address();
     }
+    gateway_zigbee_runtime_post_event(handle, &event);
 }
 
 void device_delete_request_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
@@ -138,21 +132,20 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
         esp_zb_zdo_signal_device_annce_params_t *params =
             (esp_zb_zdo_signal_device_annce_params_t *)esp_zb_app_signal_get_params(p_sg_p);
         ESP_LOGI(TAG, "New device joined: 0x%04hx", params->device_short_addr);
-        gateway_device_announce_event_t evt = {
-            .short_addr = params->device_short_addr,
+        zigbee_event_t event = {
+            .kind = ZIGBEE_EVENT_DEVICE_ANNOUNCE,
+            .origin_us = esp_timer_get_time(),
+            .u.announce.short_addr = params->device_short_addr,
         };
-        memcpy(evt.ieee_addr, params->ieee_addr, sizeof(evt.ieee_addr));
-        esp_err_t post_ret = esp_event_post(GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_ANNOUNCE, &evt, sizeof(evt), 0);
-        if (post_ret != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to post DEVICE_ANNOUNCE event: %s", esp_err_to_name(post_ret));
-        }
+        memcpy(event.u.announce.ieee_addr, params->ieee_addr, sizeof(event.u.announce.ieee_addr));
+        gateway_zigbee_runtime_post_event(runtime, &event);
         esp_err_t close_ret = esp_zb_bdb_close_network();
         if (close_ret == ESP_OK) {
             ESP_LOGI(TAG, "Permit join closed after new device join");
         } else {
             ESP_LOGW(TAG, "Failed to close permit join: %s", esp_err_to_name(close_ret));
         }
-        refresh_lqi_from_live_event(runtime, "device_announce");
+        request_live_lqi_refresh(runtime);
         break;
     }
 
@@ -162,6 +155,68 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
     }
 }
 
+/* The value is copied into the event: the stack frees the report once the callback returns. */
+static void post_attr_value(gateway_zigbee_runtime_handle_t runtime, uint16_t short_addr, uint8_t endpoint,
+                            uint16_t cluster_id, const esp_zb_zcl_attribute_t *attr, gateway_attr_source_t source)
+{
+    size_t width = zigbee_service_zcl_scalar_width((uint8_t)attr->data.type);
+    if (!attr->data.value || width == 0 || width > ZIGBEE_EVENT_ATTR_VALUE_MAX ||
+        (attr->data.size != 0 && attr->data.size < width)) {
+        return;
+    }
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_ATTR_VALUE,
+        .origin_us = esp_timer_get_time(),
+        .u.attr = {
+            .short_addr = short_addr,
+            .cluster_id = cluster_id,
+            .attr_id = attr->id,
+            .endpoint = endpoint,
+            .zcl_type = (uint8_t)attr->data.type,
+            .source = (uint8_t)source,
+            .size = (uint8_t)width,
+        },
+    };
+    memcpy(event.u.attr.value, attr->data.value, width);
+    gateway_zigbee_runtime_post_event(runtime, &event);
+}
+
+/* ZCL character strings carry a length byte in front; 0xFF marks an invalid string. */
+static bool copy_zcl_string(const esp_zb_zcl_attribute_t *attr, char *out, size_t out_size)
+{
+    const uint8_t *raw = (const uint8_t *)attr->data.value;
+    if (!raw || attr->data.type != ESP_ZB_ZCL_ATTR_TYPE_CHAR_STRING || raw[0] == 0xFF) {
+        return false;
+    }
+    size_t len = raw[0] < out_size - 1 ? raw[0] : out_size - 1;
+    memcpy(out, raw + 1, len);
+    out[len] = '\0';
+    return true;
+}
+
+/* Basic strings only feed the device interview; they never reach the scalar attribute cache. */
+static void handle_basic_identity(gateway_zigbee_runtime_handle_t runtime,
+                                  const esp_zb_zcl_cmd_read_attr_resp_message_t *resp)
+{
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_BASIC_IDENTITY,
+        .origin_us = esp_timer_get_time(),
+    };
+    event.u.basic.short_addr = resp->info.src_address.u.short_addr;
+    for (const esp_zb_zcl_read_attr_resp_variable_t *var = resp->variables; var; var = var->next) {
+        if (var->status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+            continue;
+        }
+        if (var->attribute.id == ESP_ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID) {
+            event.u.basic.has_manufacturer =
+                copy_zcl_string(&var->attribute, event.u.basic.manufacturer, sizeof(event.u.basic.manufacturer));
+        } else if (var->attribute.id == ESP_ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID) {
+            event.u.basic.has_model = copy_zcl_string(&var->attribute, event.u.basic.model, sizeof(event.u.basic.model));
+        }
+    }
+    gateway_zigbee_runtime_post_event(runtime, &event);
+}
+
 esp_err_t gateway_zigbee_runtime_action_handler(esp_zb_core_action_callback_id_t callback_id, const void *message)
 {
     gateway_zigbee_runtime_handle_t runtime = gateway_zigbee_runtime_get_active();
@@ -172,17 +227,45 @@ esp_err_t gateway_zigbee_runtime_action_handler(esp_zb_core_action_callback_id_t
     esp_err_t ret = ESP_OK;
     switch (callback_id) {
     case ESP_ZB_CORE_REPORT_ATTR_CB_ID: {
-        esp_zb_zcl_report_attr_message_t *report = (esp_zb_zcl_report_attr_message_t *)message;
-        if (report->cluster == ESP_ZB_ZCL_CLUSTER_ID_ON_OFF &&
-            report->attribute.id == ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID) {
-            bool state = *(bool *)report->attribute.data.value;
-            ESP_LOGI(TAG, "Device 0x%04x report: State is %s", report->src_address.u.short_addr, state ? "ON" : "OFF");
+        const esp_zb_zcl_report_attr_message_t *report = (const esp_zb_zcl_report_attr_message_t *)message;
+        if (report->status == ESP_ZB_ZCL_STATUS_SUCCESS) {
+            post_attr_value(runtime, report->src_address.u.short_addr, report->src_endpoint, report->cluster,
+                             &report->attribute, GATEWAY_ATTR_SOURCE_REPORT);
         }
-        refresh_lqi_from_live_event(runtime, "report_attr");
+        request_live_lqi_refresh(runtime);
         break;
     }
-    case ESP_ZB_CORE_CMD_DEFAULT_RESP_CB_ID:
+    case ESP_ZB_CORE_CMD_READ_ATTR_RESP_CB_ID: {
+        const esp_zb_zcl_cmd_read_attr_resp_message_t *resp = (const esp_zb_zcl_cmd_read_attr_resp_message_t *)message;
+        if (resp->info.status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+            break;
+        }
+        if (resp->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_BASIC) {
+            handle_basic_identity(runtime, resp);
+            break;
+        }
+        for (const esp_zb_zcl_read_attr_resp_variable_t *var = resp->variables; var; var = var->next) {
+            if (var->status == ESP_ZB_ZCL_STATUS_SUCCESS) {
+                post_attr_value(runtime, resp->info.src_address.u.short_addr, resp->info.src_endpoint,
+                                 resp->info.cluster, &var->attribute, GATEWAY_ATTR_SOURCE_READ);
+            }
+        }
         break;
+    }
+    case ESP_ZB_CORE_CMD_DEFAULT_RESP_CB_ID: {
+        const esp_zb_zcl_cmd_default_resp_message_t *resp = (const esp_zb_zcl_cmd_default_resp_message_t *)message;
+        if (resp->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_ON_OFF) {
+            zigbee_event_t event = {
+                .kind = ZIGBEE_EVENT_CMD_RESPONSE,
+                .origin_us = esp_timer_get_time(),
+            };
+            event.u.cmd_response.short_addr = resp->info.src_address.u.short_addr;
+            event.u.cmd_response.tsn = resp->info.header.tsn;
+            event.u.cmd_response.success = resp->status_code == ESP_ZB_ZCL_STATUS_SUCCESS;
+            gateway_zigbee_runtime_post_event(runtime, &event);
+        }
+        break;
+    }
     default:
         break;
     }
@@ -36,3 +36,5 @@ gateway_status_t device_service_add_with_ieee(device_service_handle_t handle, ui
 gateway_status_t device_service_update_name(device_service_handle_t handle, uint16_t addr, const char *new_name);
 gateway_status_t device_service_delete(device_service_handle_t handle, uint16_t addr);
 int device_service_get_snapshot(device_service_handle_t handle, zb_device_t *out, size_t max_items);
+/* Bumped on every successful list change: load, add, rename or delete. */
+uint32_t device_service_get_generation(device_service_handle_t handle);
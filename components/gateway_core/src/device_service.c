@@ -120,6 +120,9 @@ gateway_status_t device_service_init(device_service_handle_t handle)
     }
     device_service_lock_acquire(handle);
     gateway_status_t load_ret = device_service_storage_load_locked(handle);
+    if (load_ret == GATEWAY_STATUS_OK) {
+        handle->generation++;
+    }
     device_service_lock_release(handle);
 
     return load_ret;
@@ -198,6 +201,9 @@ gateway_status_t device_service_add_with_ieee(device_service_handle_t handle, ui
         ret = GATEWAY_STATUS_INVALID_ARG;
         break;
     }
+    if (ret == GATEWAY_STATUS_OK && changed) {
+        handle->generation++;
+    }
 
     device_service_lock_release(handle);
 
@@ -242,6 +248,8 @@ gateway_status_t device_service_update_name(device_service_handle_t handle, uint
         ret = device_service_storage_save_locked(handle);
         if (ret != GATEWAY_STATUS_OK) {
             device_service_restore_snapshot(handle, snapshot, snapshot_count);
+        } else {
+            handle->generation++;
         }
     } else {
         ret = GATEWAY_STATUS_FAIL;
@@ -290,6 +298,8 @@ gateway_status_t device_service_delete(device_service_handle_t handle, uint16_t
         if (ret != GATEWAY_STATUS_OK) {
             device_service_restore_snapshot(handle, snapshot, snapshot_count);
             deleted = false;
+        } else {
+            handle->generation++;
         }
     } else {
         ret = GATEWAY_STATUS_FAIL;
@@ -323,3 +333,15 @@ int device_service_get_snapshot(device_service_handle_t handle, zb_device_t *out
     device_service_lock_release(handle);
     return count;
 }
+
+uint32_t device_service_get_generation(device_service_handle_t handle)
+{
+    if (!handle) {
+        return 0;
+    }
+
+    device_service_lock_acquire(handle);
+    uint32_t generation = handle->generation;
+    device_service_lock_release(handle);
+    return generation;
+}
@@ -10,6 +10,7 @@ struct device_service {
     const device_service_repo_port_t *repo_port;
     zb_device_t devices[MAX_DEVICES];
     int device_count;
+    uint32_t generation;
     device_service_on_list_changed_fn on_list_changed;
     device_service_on_delete_request_fn on_delete_request;
     void *notifier_ctx;
@@ -11,14 +11,25 @@ typedef enum {
     GATEWAY_EVENT_DEVICE_DELETE_REQUEST,
     GATEWAY_EVENT_DEVICE_LIST_CHANGED,
     GATEWAY_EVENT_LQI_STATE_CHANGED,
+    GATEWAY_EVENT_JOB_STATE_CHANGED,
+    /* A cached device attribute changed (report or read). */
+    GATEWAY_EVENT_DEVICE_STATE_CHANGED,
 } gateway_event_id_t;
 
 typedef struct {
     uint16_t short_addr;
     gateway_ieee_addr_t ieee_addr;
+    int64_t origin_us;
 } gateway_device_announce_event_t;
 
 typedef struct {
     uint16_t short_addr;
     gateway_ieee_addr_t ieee_addr;
 } gateway_device_delete_request_event_t;
+
+/* Payload of *_CHANGED events: esp_timer time (us) of the change at its source, for end-to-end latency. */
+typedef struct {
+    int64_t origin_us;
+} gateway_event_origin_t;
+
+esp_err_t gateway_event_post_changed(gateway_event_id_t event_id, int64_t origin_us);
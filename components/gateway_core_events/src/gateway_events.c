@@ -1,3 +1,11 @@
 #include "gateway_events.h"
 
 ESP_EVENT_DEFINE_BASE(GATEWAY_EVENT);
+
+esp_err_t gateway_event_post_changed(gateway_event_id_t event_id, int64_t origin_us)
+{
+    gateway_event_origin_t evt = {
+        .origin_us = origin_us,
+    };
+    return esp_event_post(GATEWAY_EVENT, event_id, &evt, sizeof(evt), 0);
+}
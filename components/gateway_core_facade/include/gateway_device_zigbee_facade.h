@@ -11,6 +11,10 @@ typedef struct zigbee_service *zigbee_service_handle_t;
 
 esp_err_t gateway_device_zigbee_send_on_off(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint,
                                             uint8_t on_off);
+esp_err_t gateway_device_zigbee_send_on_off_confirmed(zigbee_service_handle_t handle, uint16_t short_addr,
+                                                      uint8_t endpoint, uint8_t on_off, uint32_t timeout_ms);
+esp_err_t gateway_device_zigbee_send_on_off_batch(zigbee_service_handle_t handle, const zigbee_on_off_cmd_t *cmds,
+                                                  size_t count, esp_err_t *out_results);
 esp_err_t gateway_device_zigbee_get_network_status(zigbee_service_handle_t handle, zigbee_network_status_t *out_status);
 int gateway_device_zigbee_get_devices_snapshot(zigbee_service_handle_t handle, zb_device_t *out_devices, int max_devices);
 int gateway_device_zigbee_get_neighbor_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out_neighbors,
@@ -18,6 +22,26 @@ int gateway_device_zigbee_get_neighbor_lqi_snapshot(zigbee_service_handle_t hand
 esp_err_t gateway_device_zigbee_get_cached_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out_neighbors,
                                                         int max_neighbors, int *out_count, zigbee_lqi_source_t *out_source,
                                                         uint64_t *out_updated_ms);
+int gateway_device_zigbee_get_cmd_stats_snapshot(zigbee_service_handle_t handle, gateway_cmd_stats_t *out_stats,
+                                                  int max_stats);
+int gateway_device_zigbee_get_attr_snapshot(zigbee_service_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                            gateway_attr_entry_t *out_attrs, int max_attrs);
+int gateway_device_zigbee_get_device_profiles(zigbee_service_handle_t handle, gateway_device_profile_t *out_profiles,
+                                              int max_profiles);
+esp_err_t gateway_device_zigbee_get_topology_summary(zigbee_service_handle_t handle, gateway_topology_summary_t *out);
+int gateway_device_zigbee_get_topology_nodes(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                             gateway_topology_node_t *out, size_t max_items);
+int gateway_device_zigbee_get_topology_edges(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                             gateway_topology_edge_t *out, size_t max_items);
+esp_err_t gateway_device_zigbee_get_state_generation(zigbee_service_handle_t handle, zigbee_state_generation_t *out_generation);
 esp_err_t gateway_device_zigbee_permit_join(zigbee_service_handle_t handle, uint8_t duration_seconds);
 esp_err_t gateway_device_zigbee_delete_device(zigbee_service_handle_t handle, uint16_t short_addr);
 esp_err_t gateway_device_zigbee_rename_device(zigbee_service_handle_t handle, uint16_t short_addr, const char *name);
+esp_err_t gateway_device_zigbee_group_create(zigbee_service_handle_t handle, const char *name, uint16_t *out_group_id);
+esp_err_t gateway_device_zigbee_group_delete(zigbee_service_handle_t handle, uint16_t group_id);
+esp_err_t gateway_device_zigbee_group_add_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                                 uint8_t endpoint);
+esp_err_t gateway_device_zigbee_group_remove_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                                    uint8_t endpoint);
+esp_err_t gateway_device_zigbee_group_send_on_off(zigbee_service_handle_t handle, uint16_t group_id, uint8_t on_off);
+int gateway_device_zigbee_get_groups_snapshot(zigbee_service_handle_t handle, zigbee_group_t *out_groups, int max_groups);
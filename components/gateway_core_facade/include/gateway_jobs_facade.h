@@ -26,6 +26,7 @@ typedef enum {
     GATEWAY_CORE_JOB_TYPE_REBOOT,
     GATEWAY_CORE_JOB_TYPE_UPDATE,
     GATEWAY_CORE_JOB_TYPE_LQI_REFRESH,
+    GATEWAY_CORE_JOB_TYPE_TOPOLOGY_CRAWL,
 } gateway_core_job_type_t;
 
 typedef enum {
@@ -62,4 +62,6 @@ esp_err_t gateway_wifi_system_get_factory_reset_report(gateway_wifi_system_handl
 esp_err_t gateway_wifi_system_collect_telemetry(gateway_wifi_system_handle_t handle, gateway_core_telemetry_t *out);
 esp_err_t gateway_wifi_system_get_network_state(gateway_wifi_system_handle_t handle, gateway_network_state_t *out_state);
 esp_err_t gateway_wifi_system_get_wifi_state(gateway_wifi_system_handle_t handle, gateway_wifi_state_t *out_state);
+esp_err_t gateway_wifi_system_get_zigbee_event_stats(gateway_wifi_system_handle_t handle,
+                                                     gateway_zigbee_event_stats_t *out_stats);
 esp_err_t gateway_wifi_system_get_schema_version(gateway_wifi_system_handle_t handle, int32_t *out_version);
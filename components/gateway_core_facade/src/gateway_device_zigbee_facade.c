@@ -11,6 +11,24 @@ esp_err_t gateway_device_zigbee_send_on_off(zigbee_service_handle_t handle, uint
     return zigbee_service_send_on_off(handle, short_addr, endpoint, on_off);
 }
 
+esp_err_t gateway_device_zigbee_send_on_off_confirmed(zigbee_service_handle_t handle, uint16_t short_addr,
+                                                      uint8_t endpoint, uint8_t on_off, uint32_t timeout_ms)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_send_on_off_confirmed(handle, short_addr, endpoint, on_off, timeout_ms);
+}
+
+esp_err_t gateway_device_zigbee_send_on_off_batch(zigbee_service_handle_t handle, const zigbee_on_off_cmd_t *cmds,
+                                                  size_t count, esp_err_t *out_results)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_send_on_off_batch(handle, cmds, count, out_results);
+}
+
 esp_err_t gateway_device_zigbee_get_network_status(zigbee_service_handle_t handle, zigbee_network_status_t *out_status)
 {
     if (!handle) {
@@ -50,6 +68,67 @@ esp_err_t gateway_device_zigbee_get_cached_lqi_snapshot(zigbee_service_handle_t
                                                   out_updated_ms);
 }
 
+int gateway_device_zigbee_get_cmd_stats_snapshot(zigbee_service_handle_t handle, gateway_cmd_stats_t *out_stats,
+                                                  int max_stats)
+{
+    if (!out_stats || max_stats <= 0 || !handle) {
+        return 0;
+    }
+    return zigbee_service_get_cmd_stats_snapshot(handle, out_stats, (size_t)max_stats);
+}
+
+int gateway_device_zigbee_get_attr_snapshot(zigbee_service_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                            gateway_attr_entry_t *out_attrs, int max_attrs)
+{
+    if (!out_attrs || max_attrs <= 0 || !handle) {
+        return 0;
+    }
+    return zigbee_service_get_attr_snapshot(handle, cluster_id, attr_id, out_attrs, (size_t)max_attrs);
+}
+
+int gateway_device_zigbee_get_device_profiles(zigbee_service_handle_t handle, gateway_device_profile_t *out_profiles,
+                                              int max_profiles)
+{
+    if (!out_profiles || max_profiles <= 0 || !handle) {
+        return 0;
+    }
+    return zigbee_service_get_device_profiles(handle, out_profiles, (size_t)max_profiles);
+}
+
+esp_err_t gateway_device_zigbee_get_topology_summary(zigbee_service_handle_t handle, gateway_topology_summary_t *out)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_get_topology_summary(handle, out);
+}
+
+int gateway_device_zigbee_get_topology_nodes(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                             gateway_topology_node_t *out, size_t max_items)
+{
+    if (!handle) {
+        return -1;
+    }
+    return zigbee_service_get_topology_nodes(handle, crawl_id, from, out, max_items);
+}
+
+int gateway_device_zigbee_get_topology_edges(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                             gateway_topology_edge_t *out, size_t max_items)
+{
+    if (!handle) {
+        return -1;
+    }
+    return zigbee_service_get_topology_edges(handle, crawl_id, from, out, max_items);
+}
+
+esp_err_t gateway_device_zigbee_get_state_generation(zigbee_service_handle_t handle, zigbee_state_generation_t *out_generation)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_get_state_generation(handle, out_generation);
+}
+
 esp_err_t gateway_device_zigbee_permit_join(zigbee_service_handle_t handle, uint8_t duration_seconds)
 {
     if (!handle) {
@@ -73,3 +152,53 @@ esp_err_t gateway_device_zigbee_rename_device(zigbee_service_handle_t handle, ui
     }
     return zigbee_service_rename_device(handle, short_addr, name);
 }
+
+esp_err_t gateway_device_zigbee_group_create(zigbee_service_handle_t handle, const char *name, uint16_t *out_group_id)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_group_create(handle, name, out_group_id);
+}
+
+esp_err_t gateway_device_zigbee_group_delete(zigbee_service_handle_t handle, uint16_t group_id)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_group_delete(handle, group_id);
+}
+
+esp_err_t gateway_device_zigbee_group_add_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                                 uint8_t endpoint)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_group_add_member(handle, group_id, short_addr, endpoint);
+}
+
+esp_err_t gateway_device_zigbee_group_remove_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                                    uint8_t endpoint)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_group_remove_member(handle, group_id, short_addr, endpoint);
+}
+
+esp_err_t gateway_device_zigbee_group_send_on_off(zigbee_service_handle_t handle, uint16_t group_id, uint8_t on_off)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return zigbee_service_group_send_on_off(handle, group_id, on_off);
+}
+
+int gateway_device_zigbee_get_groups_snapshot(zigbee_service_handle_t handle, zigbee_group_t *out_groups, int max_groups)
+{
+    if (!out_groups || max_groups <= 0 || !handle) {
+        return 0;
+    }
+    return zigbee_service_get_groups_snapshot(handle, out_groups, (size_t)max_groups);
+}
@@ -96,6 +96,8 @@ static zgw_job_type_t to_job_type(gateway_core_job_type_t type)
         return ZGW_JOB_TYPE_UPDATE;
     case GATEWAY_CORE_JOB_TYPE_LQI_REFRESH:
         return ZGW_JOB_TYPE_LQI_REFRESH;
+    case GATEWAY_CORE_JOB_TYPE_TOPOLOGY_CRAWL:
+        return ZGW_JOB_TYPE_TOPOLOGY_CRAWL;
     case GATEWAY_CORE_JOB_TYPE_WIFI_SCAN:
     default:
         return ZGW_JOB_TYPE_WIFI_SCAN;
@@ -113,6 +115,8 @@ static gateway_core_job_type_t from_job_type(zgw_job_type_t type)
         return GATEWAY_CORE_JOB_TYPE_UPDATE;
     case ZGW_JOB_TYPE_LQI_REFRESH:
         return GATEWAY_CORE_JOB_TYPE_LQI_REFRESH;
+    case ZGW_JOB_TYPE_TOPOLOGY_CRAWL:
+        return GATEWAY_CORE_JOB_TYPE_TOPOLOGY_CRAWL;
     case ZGW_JOB_TYPE_WIFI_SCAN:
     default:
         return GATEWAY_CORE_JOB_TYPE_WIFI_SCAN;
@@ -191,6 +191,16 @@ esp_err_t gateway_wifi_system_get_wifi_state(gateway_wifi_system_handle_t handle
     return gateway_status_to_esp_err(gateway_state_get_wifi(handle->gateway_state, out_state));
 }
 
+esp_err_t gateway_wifi_system_get_zigbee_event_stats(gateway_wifi_system_handle_t handle,
+                                                     gateway_zigbee_event_stats_t *out_stats)
+{
+    esp_err_t ret = require_gateway_state_handle(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return gateway_status_to_esp_err(gateway_state_get_zigbee_events(handle->gateway_state, out_stats));
+}
+
 esp_err_t gateway_wifi_system_get_schema_version(gateway_wifi_system_handle_t handle, int32_t *out_version)
 {
     if (!handle) {
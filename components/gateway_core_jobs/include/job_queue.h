@@ -12,6 +12,7 @@ typedef enum {
     ZGW_JOB_TYPE_REBOOT,
     ZGW_JOB_TYPE_UPDATE,
     ZGW_JOB_TYPE_LQI_REFRESH,
+    ZGW_JOB_TYPE_TOPOLOGY_CRAWL,
 } zgw_job_type_t;
 
 typedef enum {
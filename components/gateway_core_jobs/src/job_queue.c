@@ -10,6 +10,7 @@ const char *job_queue_type_to_string(zgw_job_type_t type)
     case ZGW_JOB_TYPE_REBOOT: return "reboot";
     case ZGW_JOB_TYPE_UPDATE: return "update";
     case ZGW_JOB_TYPE_LQI_REFRESH: return "lqi_refresh";
+    case ZGW_JOB_TYPE_TOPOLOGY_CRAWL: return "topology_crawl";
     default: return "unknown";
     }
 }
@@ -77,7 +78,8 @@ esp_err_t job_queue_init_with_handle(job_queue_handle_t handle)
     }
 
     if (!handle->job_q) {
-        handle->job_q = xQueueCreate(ZGW_JOB_MAX, sizeof(uint32_t));
+        /* One spare entry so an async completion is never dropped by a full queue. */
+        handle->job_q = xQueueCreate(ZGW_JOB_MAX + 1, sizeof(uint32_t));
         if (!handle->job_q) {
             return ESP_ERR_NO_MEM;
         }
@@ -24,6 +24,16 @@ typedef struct zgw_job_queue {
     zigbee_service_handle_t zigbee_service_handle;
     struct wifi_service *wifi_service_handle;
     struct system_service *system_service_handle;
+    /* Job waiting for an asynchronous completion (0 — none) and the error it finished with. */
+    uint32_t async_job_id;
+    zgw_job_type_t async_job_type;
+    esp_err_t async_err;
+    /* Async jobs dequeued while another one runs; they stay QUEUED and start after its completion, in order. */
+    uint32_t async_deferred[ZGW_JOB_MAX];
+    size_t async_deferred_count;
 } zgw_job_queue_t;
 
+/* Job ids start at 1, so 0 on job_q tells the worker that the async job has finished. */
+#define JOB_QUEUE_MSG_ASYNC_DONE 0u
+
 void job_queue_worker_task(void *arg);
@@ -152,7 +152,7 @@ esp_err_t job_queue_json_build_lqi_refresh_result(zigbee_service_handle_t zigbee
 
     zigbee_neighbor_lqi_t neighbors[MAX_DEVICES] = {0};
     int count = 0;
-    esp_err_t err = zigbee_service_refresh_neighbor_lqi_snapshot(zigbee_service_handle, neighbors, MAX_DEVICES, &count);
+    esp_err_t err = zigbee_service_get_lqi_refresh_result(zigbee_service_handle, neighbors, MAX_DEVICES, &count);
     if (err != ESP_OK) {
         return err;
     }
@@ -201,3 +201,28 @@ esp_err_t job_queue_json_build_lqi_refresh_result(zigbee_service_handle_t zigbee
     }
     return ESP_OK;
 }
+
+esp_err_t job_queue_json_build_topology_result(zigbee_service_handle_t zigbee_service_handle, char *out, size_t out_size)
+{
+    if (!zigbee_service_handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    gateway_topology_summary_t summary = {0};
+    esp_err_t err = zigbee_service_get_topology_summary(zigbee_service_handle, &summary);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    /* The graph itself is served by /api/v1/topology; the job result only points at it. */
+    int written = snprintf(out, out_size,
+                           "{\"crawl_id\":%" PRIu32 ",\"nodes\":%u,\"edges\":%u,\"routers_done\":%u,"
+                           "\"routers_failed\":%u,\"truncated\":%s,\"duration_ms\":%" PRIu64 "}",
+                           summary.crawl_id, (unsigned)summary.node_count, (unsigned)summary.edge_count,
+                           (unsigned)summary.routers_done, (unsigned)summary.routers_failed,
+                           summary.truncated ? "true" : "false", summary.finished_ms - summary.started_ms);
+    if (written < 0 || (size_t)written >= out_size) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
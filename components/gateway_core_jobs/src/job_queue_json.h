@@ -14,3 +14,4 @@ esp_err_t job_queue_json_build_reboot_result_with_services(struct system_service
                                                            size_t out_size);
 esp_err_t job_queue_json_build_update_result(char *out, size_t out_size);
 esp_err_t job_queue_json_build_lqi_refresh_result(zigbee_service_handle_t zigbee_service_handle, char *out, size_t out_size);
+esp_err_t job_queue_json_build_topology_result(zigbee_service_handle_t zigbee_service_handle, char *out, size_t out_size);
@@ -21,7 +21,51 @@ esp_err_t job_queue_policy_execute(zgw_job_type_t type,
         return job_queue_json_build_update_result(result, result_size);
     case ZGW_JOB_TYPE_LQI_REFRESH:
         return job_queue_json_build_lqi_refresh_result(zigbee_service_handle, result, result_size);
+    case ZGW_JOB_TYPE_TOPOLOGY_CRAWL:
+        return job_queue_json_build_topology_result(zigbee_service_handle, result, result_size);
     default:
         return ESP_ERR_INVALID_ARG;
     }
 }
+
+bool job_queue_policy_is_async(zgw_job_type_t type)
+{
+    return type == ZGW_JOB_TYPE_LQI_REFRESH || type == ZGW_JOB_TYPE_TOPOLOGY_CRAWL;
+}
+
+esp_err_t job_queue_policy_start_async(zgw_job_type_t type,
+                                       zigbee_service_handle_t zigbee_service_handle,
+                                       zigbee_service_done_fn_t done,
+                                       void *ctx)
+{
+    switch (type) {
+    case ZGW_JOB_TYPE_LQI_REFRESH:
+        if (!zigbee_service_handle) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        return zigbee_service_start_lqi_refresh(zigbee_service_handle, done, ctx);
+    case ZGW_JOB_TYPE_TOPOLOGY_CRAWL:
+        if (!zigbee_service_handle) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        return zigbee_service_start_topology_crawl(zigbee_service_handle, done, ctx);
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+}
+
+uint64_t job_queue_policy_tick_async(zgw_job_type_t type, zigbee_service_handle_t zigbee_service_handle)
+{
+    if (!zigbee_service_handle) {
+        return UINT64_MAX;
+    }
+    switch (type) {
+    case ZGW_JOB_TYPE_LQI_REFRESH:
+        return zigbee_service_lqi_refresh_tick(zigbee_service_handle);
+    case ZGW_JOB_TYPE_TOPOLOGY_CRAWL:
+        return zigbee_service_topology_tick(zigbee_service_handle);
+    default:
+        break;
+    }
+    return UINT64_MAX;
+}
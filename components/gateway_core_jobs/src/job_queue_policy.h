@@ -1,7 +1,9 @@
 #pragma once
 
 #include "job_queue.h"
+#include "zigbee_service.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -12,3 +14,15 @@ esp_err_t job_queue_policy_execute(zgw_job_type_t type,
                                    struct system_service *system_service_handle,
                                    char *result,
                                    size_t result_size);
+
+/*
+ * Jobs that finish outside the worker: start returns at once and done fires later from another task.
+ * The worker then builds the result with job_queue_policy_execute.
+ */
+bool job_queue_policy_is_async(zgw_job_type_t type);
+esp_err_t job_queue_policy_start_async(zgw_job_type_t type,
+                                       zigbee_service_handle_t zigbee_service_handle,
+                                       zigbee_service_done_fn_t done,
+                                       void *ctx);
+/* Earliest moment (esp_timer ms) the async job needs a tick from the worker; UINT64_MAX if none. */
+uint64_t job_queue_policy_tick_async(zgw_job_type_t type, zigbee_service_handle_t zigbee_service_handle);
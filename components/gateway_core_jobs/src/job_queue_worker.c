@@ -5,40 +5,20 @@
 
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include <stdio.h>
+#include <string.h>
 
 static const char *TAG = "JOB_QUEUE";
 
-static void execute_job(job_queue_handle_t handle, uint32_t job_id)
+static void finish_job(job_queue_handle_t handle, uint32_t job_id, zgw_job_type_t type, esp_err_t exec_err,
+                       const char *result)
 {
-    zgw_job_type_t type = ZGW_JOB_TYPE_WIFI_SCAN;
-    uint32_t reboot_delay_ms = 1000;
+    int64_t finished_us = esp_timer_get_time();
 
     xSemaphoreTake(handle->mutex, portMAX_DELAY);
     int idx = job_queue_find_slot_index_by_id(handle->jobs, job_id);
-    if (idx < 0 || !handle->jobs[idx].used) {
-        xSemaphoreGive(handle->mutex);
-        return;
-    }
-    handle->jobs[idx].state = ZGW_JOB_STATE_RUNNING;
-    handle->jobs[idx].updated_ms = job_queue_now_ms();
-    type = handle->jobs[idx].type;
-    reboot_delay_ms = handle->jobs[idx].reboot_delay_ms;
-    xSemaphoreGive(handle->mutex);
-
-    char result[ZGW_JOB_RESULT_MAX_LEN] = {0};
-    esp_err_t exec_err =
-        job_queue_policy_execute(type,
-                                 reboot_delay_ms,
-                                 handle->zigbee_service_handle,
-                                 handle->wifi_service_handle,
-                                 handle->system_service_handle,
-                                 result,
-                                 sizeof(result));
-
-    xSemaphoreTake(handle->mutex, portMAX_DELAY);
-    idx = job_queue_find_slot_index_by_id(handle->jobs, job_id);
     if (idx >= 0 && handle->jobs[idx].used) {
         uint64_t finished_ms = job_queue_now_ms();
         handle->jobs[idx].err = exec_err;
@@ -65,11 +45,159 @@ static void execute_job(job_queue_handle_t handle, uint32_t job_id)
     xSemaphoreGive(handle->mutex);
 
     if (exec_err == ESP_OK && type == ZGW_JOB_TYPE_LQI_REFRESH) {
-        esp_err_t post_ret = esp_event_post(GATEWAY_EVENT, GATEWAY_EVENT_LQI_STATE_CHANGED, NULL, 0, 0);
+        esp_err_t post_ret = gateway_event_post_changed(GATEWAY_EVENT_LQI_STATE_CHANGED, finished_us);
         if (post_ret != ESP_OK) {
             ESP_LOGW(TAG, "Failed to post LQI_STATE_CHANGED: %s", esp_err_to_name(post_ret));
         }
     }
+
+    esp_err_t job_post_ret = gateway_event_post_changed(GATEWAY_EVENT_JOB_STATE_CHANGED, finished_us);
+    if (job_post_ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to post JOB_STATE_CHANGED: %s", esp_err_to_name(job_post_ret));
+    }
+}
+
+static void async_job_done(void *ctx, esp_err_t err, int count)
+{
+    (void)count;
+    job_queue_handle_t handle = (job_queue_handle_t)ctx;
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    handle->async_err = err;
+    xSemaphoreGive(handle->mutex);
+
+    /* May run in the Zigbee task: hand the result over instead of building it here. */
+    uint32_t msg = JOB_QUEUE_MSG_ASYNC_DONE;
+    if (xQueueSend(handle->job_q, &msg, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to queue async job completion");
+    }
+}
+
+static void start_async_job(job_queue_handle_t handle, uint32_t job_id, zgw_job_type_t type)
+{
+    esp_err_t err = job_queue_policy_start_async(type, handle->zigbee_service_handle, async_job_done, handle);
+    if (err == ESP_OK) {
+        return;
+    }
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    handle->async_job_id = 0;
+    xSemaphoreGive(handle->mutex);
+    finish_job(handle, job_id, type, err, "");
+}
+
+static void execute_job(job_queue_handle_t handle, uint32_t job_id);
+
+static void finish_async_job(job_queue_handle_t handle)
+{
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    uint32_t job_id = handle->async_job_id;
+    zgw_job_type_t type = handle->async_job_type;
+    esp_err_t exec_err = handle->async_err;
+    uint32_t reboot_delay_ms = 0;
+    int idx = job_queue_find_slot_index_by_id(handle->jobs, job_id);
+    if (idx >= 0) {
+        reboot_delay_ms = handle->jobs[idx].reboot_delay_ms;
+    }
+    handle->async_job_id = 0;
+    xSemaphoreGive(handle->mutex);
+    if (job_id == 0) {
+        return;
+    }
+
+    char result[ZGW_JOB_RESULT_MAX_LEN] = {0};
+    if (exec_err == ESP_OK) {
+        exec_err = job_queue_policy_execute(type,
+                                            reboot_delay_ms,
+                                            handle->zigbee_service_handle,
+                                            handle->wifi_service_handle,
+                                            handle->system_service_handle,
+                                            result,
+                                            sizeof(result));
+    }
+    finish_job(handle, job_id, type, exec_err, result);
+
+    /* Start the deferred async jobs; one that fails to start right away lets the next one go. */
+    for (;;) {
+        xSemaphoreTake(handle->mutex, portMAX_DELAY);
+        uint32_t next_id = 0;
+        if (handle->async_job_id == 0 && handle->async_deferred_count > 0) {
+            next_id = handle->async_deferred[0];
+            handle->async_deferred_count--;
+            memmove(&handle->async_deferred[0], &handle->async_deferred[1],
+                    handle->async_deferred_count * sizeof(handle->async_deferred[0]));
+        }
+        xSemaphoreGive(handle->mutex);
+        if (next_id == 0) {
+            return;
+        }
+        execute_job(handle, next_id);
+    }
+}
+
+static void execute_job(job_queue_handle_t handle, uint32_t job_id)
+{
+    zgw_job_type_t type = ZGW_JOB_TYPE_WIFI_SCAN;
+    uint32_t reboot_delay_ms = 1000;
+
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    int idx = job_queue_find_slot_index_by_id(handle->jobs, job_id);
+    if (idx < 0 || !handle->jobs[idx].used) {
+        xSemaphoreGive(handle->mutex);
+        return;
+    }
+    type = handle->jobs[idx].type;
+    bool is_async = job_queue_policy_is_async(type);
+    if (is_async && handle->async_job_id != 0) {
+        /* One radio job at a time: this one waits for ASYNC_DONE instead of failing. */
+        if (handle->async_deferred_count < ZGW_JOB_MAX) {
+            handle->async_deferred[handle->async_deferred_count++] = job_id;
+        }
+        xSemaphoreGive(handle->mutex);
+        return;
+    }
+    handle->jobs[idx].state = ZGW_JOB_STATE_RUNNING;
+    handle->jobs[idx].updated_ms = job_queue_now_ms();
+    reboot_delay_ms = handle->jobs[idx].reboot_delay_ms;
+    if (is_async) {
+        handle->async_job_id = job_id;
+        handle->async_job_type = type;
+    }
+    xSemaphoreGive(handle->mutex);
+
+    /* The worker does not wait for the radio; other jobs run until the completion arrives. */
+    if (is_async) {
+        start_async_job(handle, job_id, type);
+        return;
+    }
+
+    char result[ZGW_JOB_RESULT_MAX_LEN] = {0};
+    esp_err_t exec_err =
+        job_queue_policy_execute(type,
+                                 reboot_delay_ms,
+                                 handle->zigbee_service_handle,
+                                 handle->wifi_service_handle,
+                                 handle->system_service_handle,
+                                 result,
+                                 sizeof(result));
+    finish_job(handle, job_id, type, exec_err, result);
+}
+
+static TickType_t async_wait_ticks(job_queue_handle_t handle)
+{
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    bool pending = handle->async_job_id != 0;
+    zgw_job_type_t type = handle->async_job_type;
+    xSemaphoreGive(handle->mutex);
+    if (!pending) {
+        return portMAX_DELAY;
+    }
+
+    /* The tick may finish the job itself; its completion is then already waiting on job_q. */
+    uint64_t deadline = job_queue_policy_tick_async(type, handle->zigbee_service_handle);
+    if (deadline == UINT64_MAX) {
+        return portMAX_DELAY;
+    }
+    uint64_t now = job_queue_now_ms();
+    return deadline > now ? pdMS_TO_TICKS((uint32_t)(deadline - now)) + 1 : 0;
 }
 
 void job_queue_worker_task(void *arg)
@@ -81,7 +209,12 @@ void job_queue_worker_task(void *arg)
     }
     for (;;) {
         uint32_t id = 0;
-        if (xQueueReceive(handle->job_q, &id, portMAX_DELAY) == pdTRUE) {
+        if (xQueueReceive(handle->job_q, &id, async_wait_ticks(handle)) != pdTRUE) {
+            continue;
+        }
+        if (id == JOB_QUEUE_MSG_ASYNC_DONE) {
+            finish_async_job(handle);
+        } else {
             execute_job(handle, id);
         }
     }
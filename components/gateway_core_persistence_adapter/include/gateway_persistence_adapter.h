@@ -23,5 +23,14 @@ gateway_status_t gateway_persistence_devices_save(const gateway_device_record_t
                                                   int device_count);
 gateway_status_t gateway_persistence_devices_clear(void);
 
+gateway_status_t gateway_persistence_groups_load(gateway_group_record_t *groups, size_t max_groups, int *group_count);
+gateway_status_t gateway_persistence_groups_save(const gateway_group_record_t *groups, size_t max_groups,
+                                                 int group_count);
+
+gateway_status_t gateway_persistence_interviews_load(gateway_device_interview_t *records, size_t max_records,
+                                                     int *record_count);
+gateway_status_t gateway_persistence_interviews_save(const gateway_device_interview_t *records, size_t max_records,
+                                                     int record_count);
+
 gateway_status_t gateway_persistence_partitions_erase_zigbee_storage(void);
 gateway_status_t gateway_persistence_partitions_erase_zigbee_factory(void);
@@ -56,6 +56,29 @@ gateway_status_t gateway_persistence_devices_clear(void)
     return gateway_status_from_esp_err(device_repository_clear());
 }
 
+gateway_status_t gateway_persistence_groups_load(gateway_group_record_t *groups, size_t max_groups, int *group_count)
+{
+    return gateway_status_from_esp_err(device_repository_load_groups(groups, max_groups, group_count));
+}
+
+gateway_status_t gateway_persistence_groups_save(const gateway_group_record_t *groups, size_t max_groups,
+                                                 int group_count)
+{
+    return gateway_status_from_esp_err(device_repository_save_groups(groups, max_groups, group_count));
+}
+
+gateway_status_t gateway_persistence_interviews_load(gateway_device_interview_t *records, size_t max_records,
+                                                     int *record_count)
+{
+    return gateway_status_from_esp_err(device_repository_load_interviews(records, max_records, record_count));
+}
+
+gateway_status_t gateway_persistence_interviews_save(const gateway_device_interview_t *records, size_t max_records,
+                                                     int record_count)
+{
+    return gateway_status_from_esp_err(device_repository_save_interviews(records, max_records, record_count));
+}
+
 gateway_status_t gateway_persistence_partitions_erase_zigbee_storage(void)
 {
     return gateway_status_from_esp_err(storage_partitions_erase_zigbee_storage());
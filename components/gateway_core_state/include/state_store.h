@@ -25,6 +25,9 @@ gateway_status_t gateway_state_set_network(gateway_state_handle_t handle, const
 gateway_status_t gateway_state_get_network(gateway_state_handle_t handle, gateway_network_state_t *out_state);
 gateway_status_t gateway_state_set_wifi(gateway_state_handle_t handle, const gateway_wifi_state_t *state);
 gateway_status_t gateway_state_get_wifi(gateway_state_handle_t handle, gateway_wifi_state_t *out_state);
+/* Zigbee event queue counters, written by the consumer; no generation bump. */
+gateway_status_t gateway_state_set_zigbee_events(gateway_state_handle_t handle, const gateway_zigbee_event_stats_t *stats);
+gateway_status_t gateway_state_get_zigbee_events(gateway_state_handle_t handle, gateway_zigbee_event_stats_t *out_stats);
 gateway_status_t gateway_state_update_lqi(gateway_state_handle_t handle,
                                           uint16_t short_addr,
                                           int lqi,
@@ -32,3 +35,25 @@ gateway_status_t gateway_state_update_lqi(gateway_state_handle_t handle,
                                           gateway_lqi_source_t source,
                                           uint64_t updated_ms);
 int gateway_state_get_lqi_snapshot(gateway_state_handle_t handle, gateway_lqi_cache_entry_t *out, size_t max_items);
+/* Command event (see gateway_cmd_stats_t); rtt_ms counts for ACKED and FAILED. Full tables evict the stalest entry. */
+gateway_status_t gateway_state_record_cmd(gateway_state_handle_t handle,
+                                          uint16_t short_addr,
+                                          gateway_cmd_event_t event,
+                                          uint32_t rtt_ms);
+int gateway_state_get_cmd_stats_snapshot(gateway_state_handle_t handle, gateway_cmd_stats_t *out, size_t max_items);
+/* Drops a removed device's command stats. */
+gateway_status_t gateway_state_forget_cmd_stats(gateway_state_handle_t handle, uint16_t short_addr);
+/*
+ * O(1) ZCL attribute cache over a small probe window that evicts its oldest entry. updated_ms == 0 means now;
+ * out_changed is set for a new entry or a changed value.
+ */
+gateway_status_t gateway_state_update_attr(gateway_state_handle_t handle, const gateway_attr_entry_t *entry,
+                                           bool *out_changed);
+/* Drops every attribute of a removed device. */
+gateway_status_t gateway_state_forget_attrs(gateway_state_handle_t handle, uint16_t short_addr);
+/* One attribute (cluster_id, attr_id) across all devices and endpoints. */
+int gateway_state_get_attr_snapshot(gateway_state_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                    gateway_attr_entry_t *out, size_t max_items);
+/* Change counters of network state, LQI, command stats and attributes; 0 until first written. */
+gateway_status_t gateway_state_get_generations(gateway_state_handle_t handle, uint32_t *out_network, uint32_t *out_lqi,
+                                               uint32_t *out_cmd_stats, uint32_t *out_attrs);
@@ -5,13 +5,25 @@
 
 #include "gateway_state_lock.h"
 
+/* Slots checked per key; lookups always scan the whole window, so freeing a slot needs no tombstone. */
+#define GATEWAY_STATE_ATTR_PROBE_WINDOW \
+    (GATEWAY_STATE_ATTR_CACHE_CAPACITY < 8 ? GATEWAY_STATE_ATTR_CACHE_CAPACITY : 8)
+
 struct gateway_state_store {
     gateway_state_lock_t state_lock;
     gateway_state_lock_ctx_t lock_ctx;
     gateway_network_state_t network_state;
     gateway_wifi_state_t wifi_state;
+    gateway_zigbee_event_stats_t zigbee_events;
     gateway_lqi_cache_entry_t lqi_cache[GATEWAY_STATE_LQI_CACHE_CAPACITY];
     int lqi_cache_count;
+    gateway_cmd_stats_t cmd_stats[GATEWAY_STATE_LQI_CACHE_CAPACITY];
+    int cmd_stats_count;
+    gateway_attr_entry_t attrs[GATEWAY_STATE_ATTR_CACHE_CAPACITY];
+    uint32_t network_generation;
+    uint32_t lqi_generation;
+    uint32_t cmd_stats_generation;
+    uint32_t attr_generation;
     gateway_state_now_ms_provider_t now_ms_provider;
     uint64_t fallback_now_ms;
 };
@@ -27,6 +39,60 @@ static uint64_t gateway_state_now_ms(gateway_state_handle_t handle)
     return ++handle->fallback_now_ms;
 }
 
+static const uint32_t s_rtt_bucket_bounds_ms[GATEWAY_CMD_RTT_BUCKET_COUNT - 1] = GATEWAY_CMD_RTT_BUCKET_BOUNDS_MS;
+
+static void cmd_stats_record_rtt(gateway_cmd_stats_t *stats, uint32_t rtt_ms)
+{
+    size_t bucket = 0;
+    while (bucket < GATEWAY_CMD_RTT_BUCKET_COUNT - 1 && rtt_ms > s_rtt_bucket_bounds_ms[bucket]) {
+        bucket++;
+    }
+    stats->rtt_buckets[bucket]++;
+    if (rtt_ms > stats->rtt_max_ms) {
+        stats->rtt_max_ms = rtt_ms;
+    }
+}
+
+/* Same rule as the API latency histogram: bucket edge, capped by the observed maximum. */
+static uint32_t cmd_stats_rtt_percentile_ms(const gateway_cmd_stats_t *stats, uint32_t percentile)
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < GATEWAY_CMD_RTT_BUCKET_COUNT; i++) {
+        count += stats->rtt_buckets[i];
+    }
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = (count * percentile + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < GATEWAY_CMD_RTT_BUCKET_COUNT - 1; i++) {
+        seen += stats->rtt_buckets[i];
+        if (seen >= rank) {
+            return s_rtt_bucket_bounds_ms[i] < stats->rtt_max_ms ? s_rtt_bucket_bounds_ms[i] : stats->rtt_max_ms;
+        }
+    }
+    return stats->rtt_max_ms;
+}
+
+static size_t attr_slot_index(uint16_t short_addr, uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id)
+{
+    uint32_t key = ((uint32_t)short_addr << 16) ^ ((uint32_t)cluster_id << 4) ^ attr_id ^ ((uint32_t)endpoint << 24);
+    key *= 2654435761u;
+    return (size_t)(key >> 8) % GATEWAY_STATE_ATTR_CACHE_CAPACITY;
+}
+
+static bool attr_key_equal(const gateway_attr_entry_t *a, const gateway_attr_entry_t *b)
+{
+    return a->short_addr == b->short_addr && a->endpoint == b->endpoint && a->cluster_id == b->cluster_id &&
+           a->attr_id == b->attr_id;
+}
+
+static bool network_state_equal(const gateway_network_state_t *a, const gateway_network_state_t *b)
+{
+    return a->zigbee_started == b->zigbee_started && a->factory_new == b->factory_new && a->pan_id == b->pan_id &&
+           a->channel == b->channel && a->short_addr == b->short_addr;
+}
+
 void gateway_state_set_now_ms_provider(gateway_state_handle_t handle, gateway_state_now_ms_provider_t provider)
 {
     if (!handle) {
@@ -71,11 +137,19 @@ void gateway_state_destroy(gateway_state_handle_t handle)
     }
     handle->network_state = (gateway_network_state_t){0};
     handle->wifi_state = (gateway_wifi_state_t){0};
+    handle->zigbee_events = (gateway_zigbee_event_stats_t){0};
     handle->lqi_cache_count = 0;
+    handle->cmd_stats_count = 0;
+    handle->network_generation = 0;
+    handle->lqi_generation = 0;
+    handle->cmd_stats_generation = 0;
+    handle->attr_generation = 0;
     handle->now_ms_provider = NULL;
     handle->fallback_now_ms = 0;
     gateway_state_lock_ctx_init(&handle->lock_ctx);
     memset(handle->lqi_cache, 0, sizeof(handle->lqi_cache));
+    memset(handle->cmd_stats, 0, sizeof(handle->cmd_stats));
+    memset(handle->attrs, 0, sizeof(handle->attrs));
     free(handle);
 }
 
@@ -101,6 +175,9 @@ gateway_status_t gateway_state_set_network(gateway_state_handle_t handle, const
     }
 
     gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    if (!network_state_equal(&handle->network_state, state)) {
+        handle->network_generation++;
+    }
     handle->network_state = *state;
     gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
     return GATEWAY_STATUS_OK;
@@ -154,6 +231,38 @@ gateway_status_t gateway_state_get_wifi(gateway_state_handle_t handle, gateway_w
     return GATEWAY_STATUS_OK;
 }
 
+gateway_status_t gateway_state_set_zigbee_events(gateway_state_handle_t handle, const gateway_zigbee_event_stats_t *stats)
+{
+    if (!handle || !stats) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return ret;
+    }
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    handle->zigbee_events = *stats;
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+    return GATEWAY_STATUS_OK;
+}
+
+gateway_status_t gateway_state_get_zigbee_events(gateway_state_handle_t handle, gateway_zigbee_event_stats_t *out_stats)
+{
+    if (!handle || !out_stats) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return ret;
+    }
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    *out_stats = handle->zigbee_events;
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+    return GATEWAY_STATUS_OK;
+}
+
 gateway_status_t gateway_state_update_lqi(gateway_state_handle_t handle,
                                           uint16_t short_addr,
                                           int lqi,
@@ -195,6 +304,7 @@ gateway_status_t gateway_state_update_lqi(gateway_state_handle_t handle,
     handle->lqi_cache[idx].rssi = rssi;
     handle->lqi_cache[idx].source = source;
     handle->lqi_cache[idx].updated_ms = updated_ms;
+    handle->lqi_generation++;
     gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
     return GATEWAY_STATUS_OK;
 }
@@ -220,3 +330,233 @@ int gateway_state_get_lqi_snapshot(gateway_state_handle_t handle, gateway_lqi_ca
     gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
     return count;
 }
+
+gateway_status_t gateway_state_record_cmd(gateway_state_handle_t handle,
+                                          uint16_t short_addr,
+                                          gateway_cmd_event_t event,
+                                          uint32_t rtt_ms)
+{
+    if (!handle) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return ret;
+    }
+    uint64_t now_ms = gateway_state_now_ms(handle);
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    gateway_cmd_stats_t *stats = NULL;
+    for (int i = 0; i < handle->cmd_stats_count; i++) {
+        if (handle->cmd_stats[i].short_addr == short_addr) {
+            stats = &handle->cmd_stats[i];
+            break;
+        }
+    }
+    if (!stats) {
+        if (handle->cmd_stats_count < GATEWAY_STATE_LQI_CACHE_CAPACITY) {
+            stats = &handle->cmd_stats[handle->cmd_stats_count++];
+        } else {
+            /* Rejoins leave stale addresses behind; the one idle the longest makes room. */
+            stats = &handle->cmd_stats[0];
+            for (int i = 1; i < handle->cmd_stats_count; i++) {
+                if (handle->cmd_stats[i].updated_ms < stats->updated_ms) {
+                    stats = &handle->cmd_stats[i];
+                }
+            }
+        }
+        memset(stats, 0, sizeof(*stats));
+        stats->short_addr = short_addr;
+    }
+
+    switch (event) {
+    case GATEWAY_CMD_EVENT_SENT:
+        stats->sent++;
+        break;
+    case GATEWAY_CMD_EVENT_ACKED:
+        stats->acked++;
+        cmd_stats_record_rtt(stats, rtt_ms);
+        break;
+    case GATEWAY_CMD_EVENT_FAILED:
+        stats->failed++;
+        cmd_stats_record_rtt(stats, rtt_ms);
+        break;
+    case GATEWAY_CMD_EVENT_TIMEOUT:
+        stats->timeout++;
+        break;
+    default:
+        break;
+    }
+    stats->updated_ms = now_ms;
+    handle->cmd_stats_generation++;
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+    return GATEWAY_STATUS_OK;
+}
+
+gateway_status_t gateway_state_forget_cmd_stats(gateway_state_handle_t handle, uint16_t short_addr)
+{
+    if (!handle) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return ret;
+    }
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    for (int i = 0; i < handle->cmd_stats_count; i++) {
+        if (handle->cmd_stats[i].short_addr == short_addr) {
+            handle->cmd_stats_count--;
+            memmove(&handle->cmd_stats[i], &handle->cmd_stats[i + 1],
+                    sizeof(handle->cmd_stats[0]) * (size_t)(handle->cmd_stats_count - i));
+            handle->cmd_stats_generation++;
+            break;
+        }
+    }
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+    return GATEWAY_STATUS_OK;
+}
+
+int gateway_state_get_cmd_stats_snapshot(gateway_state_handle_t handle, gateway_cmd_stats_t *out, size_t max_items)
+{
+    if (!handle || !out || max_items == 0) {
+        return 0;
+    }
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return 0;
+    }
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    int count = handle->cmd_stats_count;
+    if ((size_t)count > max_items) {
+        count = (int)max_items;
+    }
+    if (count > 0) {
+        memcpy(out, handle->cmd_stats, sizeof(gateway_cmd_stats_t) * (size_t)count);
+    }
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+
+    for (int i = 0; i < count; i++) {
+        out[i].rtt_p50_ms = cmd_stats_rtt_percentile_ms(&out[i], 50);
+        out[i].rtt_p95_ms = cmd_stats_rtt_percentile_ms(&out[i], 95);
+    }
+    return count;
+}
+
+gateway_status_t gateway_state_update_attr(gateway_state_handle_t handle, const gateway_attr_entry_t *entry,
+                                           bool *out_changed)
+{
+    if (!handle || !entry) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return ret;
+    }
+    uint64_t updated_ms = entry->updated_ms ? entry->updated_ms : gateway_state_now_ms(handle);
+    if (updated_ms == 0) {
+        updated_ms = 1;
+    }
+    size_t base = attr_slot_index(entry->short_addr, entry->endpoint, entry->cluster_id, entry->attr_id);
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    gateway_attr_entry_t *slot = NULL;
+    gateway_attr_entry_t *free_slot = NULL;
+    gateway_attr_entry_t *oldest = NULL;
+    for (size_t i = 0; i < GATEWAY_STATE_ATTR_PROBE_WINDOW; i++) {
+        gateway_attr_entry_t *candidate = &handle->attrs[(base + i) % GATEWAY_STATE_ATTR_CACHE_CAPACITY];
+        if (candidate->updated_ms == 0) {
+            free_slot = free_slot ? free_slot : candidate;
+        } else if (attr_key_equal(candidate, entry)) {
+            slot = candidate;
+            break;
+        } else if (!oldest || candidate->updated_ms < oldest->updated_ms) {
+            oldest = candidate;
+        }
+    }
+    bool changed = !slot || slot->value != entry->value || slot->zcl_type != entry->zcl_type;
+    if (!slot) {
+        /* A full window gives up its stalest entry: memory stays bounded and the update stays O(1). */
+        slot = free_slot ? free_slot : oldest;
+    }
+    *slot = *entry;
+    slot->updated_ms = updated_ms;
+    handle->attr_generation++;
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+
+    if (out_changed) {
+        *out_changed = changed;
+    }
+    return GATEWAY_STATUS_OK;
+}
+
+gateway_status_t gateway_state_forget_attrs(gateway_state_handle_t handle, uint16_t short_addr)
+{
+    if (!handle) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return ret;
+    }
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    bool removed = false;
+    for (size_t i = 0; i < GATEWAY_STATE_ATTR_CACHE_CAPACITY; i++) {
+        if (handle->attrs[i].updated_ms != 0 && handle->attrs[i].short_addr == short_addr) {
+            memset(&handle->attrs[i], 0, sizeof(handle->attrs[i]));
+            removed = true;
+        }
+    }
+    if (removed) {
+        handle->attr_generation++;
+    }
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+    return GATEWAY_STATUS_OK;
+}
+
+int gateway_state_get_attr_snapshot(gateway_state_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                    gateway_attr_entry_t *out, size_t max_items)
+{
+    if (!handle || !out || max_items == 0) {
+        return 0;
+    }
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return 0;
+    }
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    size_t count = 0;
+    for (size_t i = 0; i < GATEWAY_STATE_ATTR_CACHE_CAPACITY && count < max_items; i++) {
+        const gateway_attr_entry_t *entry = &handle->attrs[i];
+        if (entry->updated_ms != 0 && entry->cluster_id == cluster_id && entry->attr_id == attr_id) {
+            out[count++] = *entry;
+        }
+    }
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+    return (int)count;
+}
+
+gateway_status_t gateway_state_get_generations(gateway_state_handle_t handle, uint32_t *out_network, uint32_t *out_lqi,
+                                               uint32_t *out_cmd_stats, uint32_t *out_attrs)
+{
+    if (!handle || !out_network || !out_lqi || !out_cmd_stats || !out_attrs) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    gateway_status_t ret = gateway_state_init(handle);
+    if (ret != GATEWAY_STATUS_OK) {
+        return ret;
+    }
+
+    gateway_state_lock_ctx_enter(&handle->lock_ctx, handle->state_lock);
+    *out_network = handle->network_generation;
+    *out_lqi = handle->lqi_generation;
+    *out_cmd_stats = handle->cmd_stats_generation;
+    *out_attrs = handle->attr_generation;
+    gateway_state_lock_ctx_exit(&handle->lock_ctx, handle->state_lock);
+    return GATEWAY_STATUS_OK;
+}
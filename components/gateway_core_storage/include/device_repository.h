@@ -8,4 +8,11 @@
 
 esp_err_t device_repository_load(gateway_device_record_t *devices, size_t max_devices, int *device_count, bool *loaded);
 esp_err_t device_repository_save(const gateway_device_record_t *devices, size_t max_devices, int device_count);
+/* Groups share the devices namespace, so device_repository_clear() drops them as well. */
+esp_err_t device_repository_load_groups(gateway_group_record_t *groups, size_t max_groups, int *group_count);
+esp_err_t device_repository_save_groups(const gateway_group_record_t *groups, size_t max_groups, int group_count);
+/* Interview records share the namespace too; only the used prefix of the table is stored. */
+esp_err_t device_repository_load_interviews(gateway_device_interview_t *records, size_t max_records, int *record_count);
+esp_err_t device_repository_save_interviews(const gateway_device_interview_t *records, size_t max_records,
+                                            int record_count);
 esp_err_t device_repository_clear(void);
@@ -40,6 +40,18 @@ static esp_err_t erase_devices_locked(void)
     if (err == ESP_OK) {
         err = storage_kv_erase_key(handle, "dev_list", NULL);
     }
+    if (err == ESP_OK) {
+        err = storage_kv_erase_key(handle, "grp_count", NULL);
+    }
+    if (err == ESP_OK) {
+        err = storage_kv_erase_key(handle, "grp_list", NULL);
+    }
+    if (err == ESP_OK) {
+        err = storage_kv_erase_key(handle, "ivw_count", NULL);
+    }
+    if (err == ESP_OK) {
+        err = storage_kv_erase_key(handle, "ivw_list", NULL);
+    }
     if (err == ESP_OK) {
         err = storage_kv_commit(handle);
     }
@@ -121,6 +133,147 @@ esp_err_t device_repository_save(const gateway_device_record_t *devices, size_t
     return err;
 }
 
+esp_err_t device_repository_load_groups(gateway_group_record_t *groups, size_t max_groups, int *group_count)
+{
+    if (!groups || !group_count || max_groups == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *group_count = 0;
+    memset(groups, 0, sizeof(gateway_group_record_t) * max_groups);
+
+    esp_err_t err = devices_lock();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    storage_kv_handle_t handle = NULL;
+    err = storage_kv_open_readonly(NVS_NAMESPACE, &handle);
+    if (err == ESP_OK) {
+        int32_t count = 0;
+        bool count_found = false;
+        size_t out_len = 0;
+        bool blob_found = false;
+        if (storage_kv_get_i32(handle, "grp_count", &count, &count_found) == ESP_OK && count_found && count > 0 &&
+            storage_kv_get_blob(handle, "grp_list", groups, sizeof(gateway_group_record_t) * max_groups, &out_len,
+                                &blob_found) == ESP_OK &&
+            blob_found) {
+            size_t stored = out_len / sizeof(gateway_group_record_t);
+            *group_count = (int)((size_t)count < stored ? (size_t)count : stored);
+        }
+        storage_kv_close(handle);
+        err = ESP_OK;
+    } else if (err == ESP_ERR_NOT_FOUND) {
+        err = ESP_OK;
+    }
+
+    devices_unlock();
+    return err;
+}
+
+esp_err_t device_repository_save_groups(const gateway_group_record_t *groups, size_t max_groups, int group_count)
+{
+    if (!groups || max_groups == 0 || group_count < 0 || (size_t)group_count > max_groups) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = devices_lock();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    storage_kv_handle_t handle = NULL;
+    err = storage_kv_open_readwrite(NVS_NAMESPACE, &handle);
+    if (err == ESP_OK) {
+        err = storage_kv_set_i32(handle, "grp_count", group_count);
+        if (err == ESP_OK) {
+            /* Only the used prefix is written: group records are large and the table is mostly empty. */
+            size_t len = sizeof(gateway_group_record_t) * (size_t)(group_count > 0 ? group_count : 1);
+            err = storage_kv_set_blob(handle, "grp_list", groups, len);
+        }
+        if (err == ESP_OK) {
+            err = storage_kv_commit(handle);
+        }
+        storage_kv_close(handle);
+    }
+
+    devices_unlock();
+    return err;
+}
+
+esp_err_t device_repository_load_interviews(gateway_device_interview_t *records, size_t max_records, int *record_count)
+{
+    if (!records || !record_count || max_records == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *record_count = 0;
+    memset(records, 0, sizeof(gateway_device_interview_t) * max_records);
+
+    esp_err_t err = devices_lock();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    storage_kv_handle_t handle = NULL;
+    err = storage_kv_open_readonly(NVS_NAMESPACE, &handle);
+    if (err == ESP_OK) {
+        int32_t count = 0;
+        bool count_found = false;
+        size_t out_len = 0;
+        bool blob_found = false;
+        if (storage_kv_get_i32(handle, "ivw_count", &count, &count_found) == ESP_OK && count_found && count > 0 &&
+            storage_kv_get_blob(handle, "ivw_list", records, sizeof(gateway_device_interview_t) * max_records,
+                                &out_len, &blob_found) == ESP_OK &&
+            blob_found) {
+            /* A blob that does not split into whole records was written with another layout: start over. */
+            size_t stored = out_len % sizeof(gateway_device_interview_t) == 0 ? out_len / sizeof(gateway_device_interview_t)
+                                                                                : 0;
+            *record_count = (int)((size_t)count < stored ? (size_t)count : stored);
+            if (*record_count == 0) {
+                memset(records, 0, sizeof(gateway_device_interview_t) * max_records);
+            }
+        }
+        storage_kv_close(handle);
+        err = ESP_OK;
+    } else if (err == ESP_ERR_NOT_FOUND) {
+        err = ESP_OK;
+    }
+
+    devices_unlock();
+    return err;
+}
+
+esp_err_t device_repository_save_interviews(const gateway_device_interview_t *records, size_t max_records,
+                                            int record_count)
+{
+    if (!records || max_records == 0 || record_count < 0 || (size_t)record_count > max_records) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = devices_lock();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    storage_kv_handle_t handle = NULL;
+    err = storage_kv_open_readwrite(NVS_NAMESPACE, &handle);
+    if (err == ESP_OK) {
+        err = storage_kv_set_i32(handle, "ivw_count", record_count);
+        if (err == ESP_OK) {
+            size_t len = sizeof(gateway_device_interview_t) * (size_t)(record_count > 0 ? record_count : 1);
+            err = storage_kv_set_blob(handle, "ivw_list", records, len);
+        }
+        if (err == ESP_OK) {
+            err = storage_kv_commit(handle);
+        }
+        storage_kv_close(handle);
+    }
+
+    devices_unlock();
+    return err;
+}
+
 esp_err_t device_repository_clear(void)
 {
     esp_err_t err = devices_lock();
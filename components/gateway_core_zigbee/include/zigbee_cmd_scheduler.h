@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gateway_runtime_types.h"
+#include "gateway_status.h"
+
+/*
+ * On/Off scheduler: bounded per-device queues, one command in flight per device, Default Response matched
+ * by (short_addr, TSN), exponential retries, latest command per endpoint wins. Pure logic; time is now_ms.
+ */
+
+#define ZIGBEE_CMD_SCHED_SLOTS 32
+#define ZIGBEE_CMD_SCHED_DEVICE_DEPTH 4
+#define ZIGBEE_CMD_SCHED_MAX_IN_FLIGHT 8
+#define ZIGBEE_CMD_SCHED_MAX_ATTEMPTS 3
+#define ZIGBEE_CMD_SCHED_ACK_TIMEOUT_MS 3000
+#define ZIGBEE_CMD_SCHED_RETRY_BASE_MS 500
+#define ZIGBEE_CMD_SCHED_DONE_RING 16
+#define ZIGBEE_CMD_SCHED_IDLE UINT64_MAX
+
+typedef enum {
+    ZIGBEE_CMD_SLOT_FREE = 0,
+    ZIGBEE_CMD_SLOT_QUEUED,
+    ZIGBEE_CMD_SLOT_IN_FLIGHT,
+} zigbee_cmd_slot_state_t;
+
+typedef struct {
+    uint32_t ticket;
+    uint32_t seq; /* queue order; a merge keeps the replaced command's place */
+    zigbee_on_off_cmd_t cmd;
+    uint8_t state;
+    uint8_t attempts;
+    uint8_t tsn;
+    uint64_t due_ms; /* QUEUED: not before; IN_FLIGHT: response deadline */
+    uint64_t sent_ms; /* last handoff to the stack */
+    void *waiter;
+} zigbee_cmd_slot_t;
+
+/* Outcome: INVALID_STATE when superseded, TIMEOUT after the last attempt, FAIL on a ZCL error; rtt_ms 0 without a reply. */
+typedef struct {
+    uint32_t ticket;
+    uint16_t short_addr;
+    gateway_status_t status;
+    uint32_t rtt_ms;
+    void *waiter;
+} zigbee_cmd_completion_t;
+
+typedef void (*zigbee_cmd_complete_fn_t)(void *ctx, const zigbee_cmd_completion_t *completion);
+
+typedef struct {
+    zigbee_cmd_slot_t slots[ZIGBEE_CMD_SCHED_SLOTS];
+    zigbee_cmd_completion_t done[ZIGBEE_CMD_SCHED_DONE_RING];
+    size_t done_next;
+    uint32_t next_ticket;
+    uint32_t next_seq;
+    zigbee_cmd_complete_fn_t on_complete;
+    void *on_complete_ctx;
+} zigbee_cmd_scheduler_t;
+
+void zigbee_cmd_scheduler_init(zigbee_cmd_scheduler_t *sched, zigbee_cmd_complete_fn_t on_complete, void *ctx);
+
+/* Queues a command, superseding a queued one for the same endpoint; NO_MEM when full. waiter returns in the completion. */
+gateway_status_t zigbee_cmd_scheduler_submit(zigbee_cmd_scheduler_t *sched, const zigbee_on_off_cmd_t *cmd,
+                                             uint64_t now_ms, void *waiter, uint32_t *out_ticket);
+
+/* Oldest ready command of an idle device, now IN_FLIGHT; the caller must report via zigbee_cmd_scheduler_on_sent. */
+bool zigbee_cmd_scheduler_next(zigbee_cmd_scheduler_t *sched, uint64_t now_ms, uint32_t *out_ticket,
+                               zigbee_on_off_cmd_t *out_cmd);
+
+/* Stack handoff result; sent == false counts as a failed attempt. */
+void zigbee_cmd_scheduler_on_sent(zigbee_cmd_scheduler_t *sched, uint32_t ticket, bool sent, uint8_t tsn,
+                                  uint64_t now_ms);
+
+/* Default Response; false when no such command is in flight (stray or late reply). */
+bool zigbee_cmd_scheduler_on_response(zigbee_cmd_scheduler_t *sched, uint16_t short_addr, uint8_t tsn,
+                                      gateway_status_t status, uint64_t now_ms);
+
+/* Overdue replies retry after RETRY_BASE_MS * 2^(attempt-1), or TIMEOUT after MAX_ATTEMPTS. */
+void zigbee_cmd_scheduler_tick(zigbee_cmd_scheduler_t *sched, uint64_t now_ms);
+
+/* Next time tick or next has work; ZIGBEE_CMD_SCHED_IDLE when empty. */
+uint64_t zigbee_cmd_scheduler_next_due_ms(const zigbee_cmd_scheduler_t *sched);
+
+/* The waiter gave up; the command itself stays queued. */
+void zigbee_cmd_scheduler_detach_waiter(zigbee_cmd_scheduler_t *sched, uint32_t ticket);
+
+/* Outcome from the recent-results ring; false while pending or once overwritten. */
+bool zigbee_cmd_scheduler_result(const zigbee_cmd_scheduler_t *sched, uint32_t ticket, gateway_status_t *out_status);
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gateway_runtime_types.h"
+
+/*
+ * Lock-free SPSC ring from the Zigbee task to the runtime event task. Push only copies a slot and moves head;
+ * a full ring drops the event and counts it in dropped_total.
+ */
+
+#ifndef ZIGBEE_EVENT_RING_CAPACITY
+#define ZIGBEE_EVENT_RING_CAPACITY 32
+#endif
+
+_Static_assert((ZIGBEE_EVENT_RING_CAPACITY & (ZIGBEE_EVENT_RING_CAPACITY - 1)) == 0,
+               "ZIGBEE_EVENT_RING_CAPACITY must be a power of two");
+
+#define ZIGBEE_EVENT_ATTR_VALUE_MAX 4
+/* Records per Mgmt_Lqi_rsp page and endpoints per Active_EP_rsp carried to the event task. */
+#define ZIGBEE_EVENT_LQI_PAGE_MAX 8
+#define ZIGBEE_EVENT_ACTIVE_EP_MAX 8
+
+typedef enum {
+    ZIGBEE_EVENT_NONE = 0,
+    ZIGBEE_EVENT_NETWORK,         /* stack started or formed a network: u.network */
+    ZIGBEE_EVENT_DEVICE_ANNOUNCE, /* u.announce */
+    ZIGBEE_EVENT_ATTR_VALUE,      /* attribute report or read response: u.attr */
+    ZIGBEE_EVENT_LINK_ACTIVITY,   /* device traffic: refresh LQI from the neighbor table */
+    ZIGBEE_EVENT_INTERVIEW_DONE,  /* interview finished: collect and store the result */
+    ZIGBEE_EVENT_CMD_PUMP,        /* command timer fired: zigbee_service_cmd_pump */
+    ZIGBEE_EVENT_CMD_RESPONSE,    /* On/Off Default Response: u.cmd_response */
+    ZIGBEE_EVENT_INTERVIEW_PUMP,  /* interview timer fired: zigbee_service_interview_pump */
+    ZIGBEE_EVENT_BASIC_IDENTITY,  /* Basic manufacturer/model: u.basic */
+    ZIGBEE_EVENT_LQI_PAGE,        /* Mgmt_Lqi page of an LQI refresh: u.lqi_page */
+    ZIGBEE_EVENT_TOPOLOGY_PAGE,   /* Mgmt_Lqi page of a topology crawl: u.lqi_page */
+    ZIGBEE_EVENT_ACTIVE_EP,       /* interview Active_EP_rsp: u.active_ep */
+    ZIGBEE_EVENT_SIMPLE_DESC,     /* interview Simple_Desc_rsp: u.simple_desc */
+} zigbee_event_kind_t;
+
+typedef struct {
+    uint16_t short_addr;
+    uint8_t lqi;
+    uint8_t relationship;
+    uint8_t depth;
+    uint8_t device_type;
+} zigbee_event_neighbor_t;
+
+typedef struct {
+    uint8_t kind;
+    int64_t origin_us; /* when the Zigbee task saw the event */
+    union {
+        gateway_network_state_t network;
+        struct {
+            uint16_t short_addr;
+            gateway_ieee_addr_t ieee_addr;
+        } announce;
+        struct {
+            uint16_t short_addr;
+            uint16_t cluster_id;
+            uint16_t attr_id;
+            uint8_t endpoint;
+            uint8_t zcl_type;
+            uint8_t source; /* gateway_attr_source_t */
+            uint8_t size;
+            uint8_t value[ZIGBEE_EVENT_ATTR_VALUE_MAX];
+        } attr;
+        struct {
+            uint16_t short_addr;
+            uint8_t tsn;
+            bool success;
+        } cmd_response;
+        struct {
+            uint16_t short_addr;
+            bool has_manufacturer;
+            bool has_model;
+            char manufacturer[GATEWAY_INTERVIEW_STRING_MAX_LEN + 1];
+            char model[GATEWAY_INTERVIEW_STRING_MAX_LEN + 1];
+        } basic;
+        struct {
+            uint32_t token; /* crawl request token; unused by LQI refresh */
+            uint8_t status; /* ZDP status; error pages carry no records */
+            uint8_t start_index;
+            uint8_t total;
+            uint8_t count;
+            zigbee_event_neighbor_t records[ZIGBEE_EVENT_LQI_PAGE_MAX];
+        } lqi_page;
+        struct {
+            uint32_t token;
+            uint8_t status;
+            uint8_t count;
+            uint8_t endpoints[ZIGBEE_EVENT_ACTIVE_EP_MAX];
+        } active_ep;
+        struct {
+            uint32_t token;
+            bool ok;
+            gateway_endpoint_desc_t desc;
+        } simple_desc;
+    } u;
+} zigbee_event_t;
+
+typedef struct {
+    atomic_uint head; /* producer only */
+    atomic_uint tail; /* consumer only */
+    atomic_uint pushed_total;
+    atomic_uint dropped_total;
+    atomic_uint depth_peak;
+    zigbee_event_t slots[ZIGBEE_EVENT_RING_CAPACITY];
+} zigbee_event_ring_t;
+
+/* Before the producer and consumer start. */
+void zigbee_event_ring_init(zigbee_event_ring_t *ring);
+
+/* Producer task only; false when full and the event was dropped. */
+bool zigbee_event_ring_push(zigbee_event_ring_t *ring, const zigbee_event_t *event);
+
+/* Consumer task only; false when empty. */
+bool zigbee_event_ring_pop(zigbee_event_ring_t *ring, zigbee_event_t *out);
+
+/* Any task; counters are read one by one and may disagree slightly. */
+void zigbee_event_ring_get_stats(zigbee_event_ring_t *ring, gateway_zigbee_event_stats_t *out);
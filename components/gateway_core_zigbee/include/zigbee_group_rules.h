@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gateway_config_types.h"
+#include "gateway_status.h"
+
+/* Pure group table rules, like device_service_rules; zigbee_service commits a copy only after the command succeeds. */
+
+int zigbee_group_rules_find(const gateway_group_record_t *groups, int group_count, uint16_t group_id);
+
+/* Lowest free id from 1; GATEWAY_STATUS_NO_MEM when the table is full. */
+gateway_status_t zigbee_group_rules_create(gateway_group_record_t *groups, int *group_count, size_t max_groups,
+                                           const char *name, uint16_t *out_group_id);
+
+gateway_status_t zigbee_group_rules_delete(gateway_group_record_t *groups, int *group_count, uint16_t group_id,
+                                           gateway_group_record_t *deleted_record);
+
+/* Adding an existing member is GATEWAY_STATUS_OK with no change. */
+gateway_status_t zigbee_group_rules_add_member(gateway_group_record_t *group, uint16_t short_addr, uint8_t endpoint);
+gateway_status_t zigbee_group_rules_remove_member(gateway_group_record_t *group, uint16_t short_addr, uint8_t endpoint);
+
+/* Drops a removed device from every group; returns the number of memberships removed. */
+int zigbee_group_rules_remove_device(gateway_group_record_t *groups, int group_count, uint16_t short_addr);
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gateway_config_types.h"
+
+/*
+ * Post-announce interview: Active_EP_req, Simple_Desc_req per endpoint, then Basic 0x0004/0x0005, one device
+ * at a time. Pure logic; time is now_ms. ZDP replies match by token, Basic replies by the address on that step.
+ */
+
+#define ZIGBEE_INTERVIEW_QUEUE_DEPTH 4
+#define ZIGBEE_INTERVIEW_MAX_ATTEMPTS 3
+#define ZIGBEE_INTERVIEW_TIMEOUT_MS 5000
+#define ZIGBEE_INTERVIEW_IDLE UINT64_MAX
+
+#define ZIGBEE_INTERVIEW_CLUSTER_BASIC 0x0000u
+#define ZIGBEE_INTERVIEW_ATTR_MANUFACTURER 0x0004u
+#define ZIGBEE_INTERVIEW_ATTR_MODEL 0x0005u
+
+typedef enum {
+    ZIGBEE_INTERVIEW_STEP_IDLE = 0,
+    ZIGBEE_INTERVIEW_STEP_ACTIVE_EP,
+    ZIGBEE_INTERVIEW_STEP_SIMPLE_DESC,
+    ZIGBEE_INTERVIEW_STEP_BASIC,
+    ZIGBEE_INTERVIEW_STEP_FINISHED, /* result waits for zigbee_interview_take_result */
+} zigbee_interview_step_t;
+
+typedef enum {
+    ZIGBEE_INTERVIEW_REQ_ACTIVE_EP = 1,
+    ZIGBEE_INTERVIEW_REQ_SIMPLE_DESC,
+    ZIGBEE_INTERVIEW_REQ_BASIC,
+} zigbee_interview_req_kind_t;
+
+typedef struct {
+    uint32_t token;
+    uint8_t kind; /* zigbee_interview_req_kind_t */
+    uint16_t short_addr;
+    uint8_t endpoint; /* for Simple_Desc and Basic */
+} zigbee_interview_request_t;
+
+typedef struct {
+    uint16_t short_addr;
+    gateway_ieee_addr_t ieee_addr;
+} zigbee_interview_pending_t;
+
+typedef struct {
+    uint8_t step;
+    bool in_flight;
+    bool partial;
+    uint8_t attempts;
+    uint8_t desc_index;
+    uint32_t token;
+    uint32_t next_token;
+    uint64_t due_ms;
+    gateway_device_interview_t record;
+    zigbee_interview_pending_t queue[ZIGBEE_INTERVIEW_QUEUE_DEPTH];
+    uint8_t queue_count;
+} zigbee_interview_t;
+
+void zigbee_interview_init(zigbee_interview_t *iv);
+
+/* Queues a device; a known IEEE only takes the new short_addr. false when full (retried on the next announce). */
+bool zigbee_interview_enqueue(zigbee_interview_t *iv, uint16_t short_addr, const gateway_ieee_addr_t ieee_addr);
+
+/* Drops a deleted device from the queue and aborts its interview. */
+bool zigbee_interview_cancel(zigbee_interview_t *iv, uint16_t short_addr);
+
+/* Next request when nothing is in flight; send it with out->token. */
+bool zigbee_interview_next(zigbee_interview_t *iv, uint64_t now_ms, zigbee_interview_request_t *out);
+
+/* Replies for token; false when unknown (late). Endpoints 0 and 242 (Green Power) are skipped. */
+bool zigbee_interview_on_active_ep(zigbee_interview_t *iv, uint32_t token, const uint8_t *endpoints, uint8_t count);
+bool zigbee_interview_on_simple_desc(zigbee_interview_t *iv, uint32_t token, const gateway_endpoint_desc_t *desc);
+/* Basic reply from short_addr; NULL means the attribute is unsupported, not an error. */
+bool zigbee_interview_on_basic(zigbee_interview_t *iv, uint16_t short_addr, const char *manufacturer,
+                               const char *model);
+
+/* ZDP error for token; after MAX_ATTEMPTS a missing Active_EP drops the interview, others end PARTIAL. */
+bool zigbee_interview_on_error(zigbee_interview_t *iv, uint32_t token);
+
+/* A request unanswered for TIMEOUT_MS counts as an error. */
+void zigbee_interview_tick(zigbee_interview_t *iv, uint64_t now_ms);
+
+/* When tick/next is due: the request deadline, 0 to send now, ZIGBEE_INTERVIEW_IDLE when idle. */
+uint64_t zigbee_interview_next_due_ms(const zigbee_interview_t *iv);
+
+/* Takes a finished interview; the next device waits until it is taken. */
+bool zigbee_interview_take_result(zigbee_interview_t *iv, gateway_device_interview_t *out);
+
+/* Endpoint with a server cluster_id, or 0. */
+uint8_t zigbee_interview_find_endpoint(const gateway_device_interview_t *record, uint16_t cluster_id);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gateway_runtime_types.h"
+#include "gateway_status.h"
+
+/*
+ * Pipelined Mgmt_Lqi_req walk: the first reply sizes the table, then up to MAX_IN_FLIGHT pages are requested
+ * at once and stored by start_index in any order. Pure logic; time is now_ms.
+ */
+
+#define ZIGBEE_LQI_REFRESH_MAX_IN_FLIGHT 4
+#define ZIGBEE_LQI_REFRESH_MAX_REQUESTS 16
+#define ZIGBEE_LQI_REFRESH_PAGE_TIMEOUT_MS 3500
+#define ZIGBEE_LQI_REFRESH_IDLE UINT64_MAX
+
+typedef enum {
+    ZIGBEE_LQI_REFRESH_STATE_IDLE = 0,
+    ZIGBEE_LQI_REFRESH_STATE_RUNNING,
+    ZIGBEE_LQI_REFRESH_STATE_DONE,
+} zigbee_lqi_refresh_state_t;
+
+typedef struct {
+    bool used;
+    uint8_t start_index;
+    uint8_t span;
+} zigbee_lqi_page_t;
+
+typedef struct {
+    uint8_t state;
+    gateway_status_t status;
+    bool total_known;
+    uint8_t total; /* table size capped at MAX_DEVICES */
+    uint8_t page_size;
+    uint8_t requests;
+    uint64_t deadline_ms; /* pushed back by every reply */
+    zigbee_lqi_page_t pages[ZIGBEE_LQI_REFRESH_MAX_IN_FLIGHT];
+    bool have[MAX_DEVICES];
+    zigbee_neighbor_lqi_t entries[MAX_DEVICES];
+} zigbee_lqi_refresh_t;
+
+/* Starts a new walk and clears the previous result. */
+void zigbee_lqi_refresh_begin(zigbee_lqi_refresh_t *r, uint64_t now_ms);
+
+/* Next page to request; call until false. Running out of requests with gaps left ends the walk with FAIL. */
+bool zigbee_lqi_refresh_next(zigbee_lqi_refresh_t *r, uint8_t *out_start_index);
+
+/* Page at start_index; table_entries is the full table size. false for an unexpected or late page. */
+bool zigbee_lqi_refresh_on_page(zigbee_lqi_refresh_t *r, uint8_t start_index, uint8_t table_entries,
+                                const zigbee_neighbor_lqi_t *items, uint8_t count, uint64_t now_ms);
+
+/* A ZDP error on an expected page ends the walk with GATEWAY_STATUS_FAIL. */
+bool zigbee_lqi_refresh_on_error(zigbee_lqi_refresh_t *r, uint8_t start_index);
+
+/* GATEWAY_STATUS_TIMEOUT after PAGE_TIMEOUT_MS without a reply. */
+void zigbee_lqi_refresh_tick(zigbee_lqi_refresh_t *r, uint64_t now_ms);
+
+/* Deadline for tick; ZIGBEE_LQI_REFRESH_IDLE when no walk runs. */
+uint64_t zigbee_lqi_refresh_deadline_ms(const zigbee_lqi_refresh_t *r);
+
+/* true once done; entries[0..count) stay valid until the next begin. */
+bool zigbee_lqi_refresh_result(const zigbee_lqi_refresh_t *r, gateway_status_t *out_status, size_t *out_count);
@@ -1,20 +1,58 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #include "esp_err.h"
 #include "gateway_runtime_types.h"
 #include "device_service.h"
+#include "zigbee_event_ring.h"
 
 struct gateway_state_store;
 
 typedef struct {
     esp_err_t (*send_on_off)(uint16_t short_addr, uint8_t endpoint, uint8_t on_off);
+    /* Optional: the whole batch under one stack lock; falls back to send_on_off. */
+    esp_err_t (*send_on_off_batch)(const zigbee_on_off_cmd_t *cmds, size_t count, esp_err_t *out_results);
     esp_err_t (*delete_device)(uint16_t short_addr);
     esp_err_t (*rename_device)(uint16_t short_addr, const char *name);
+    /* Groups cluster commands and group-cast On/Off; groups are unavailable without them. */
+    esp_err_t (*group_add_member)(uint16_t group_id, uint16_t short_addr, uint8_t endpoint);
+    esp_err_t (*group_remove_member)(uint16_t group_id, uint16_t short_addr, uint8_t endpoint);
+    esp_err_t (*send_group_on_off)(uint16_t group_id, uint8_t on_off);
+    /*
+     * Command scheduler, optional as a pair: transmit_on_off runs under the stack lock and returns the TSN;
+     * schedule_cmd_pump requests zigbee_service_cmd_pump after delay_ms. Without them send_on_off is unconfirmed.
+     */
+    esp_err_t (*transmit_on_off)(const zigbee_on_off_cmd_t *cmd, uint8_t *out_tsn);
+    esp_err_t (*schedule_cmd_pump)(uint32_t delay_ms);
+    /*
+     * Interview, optional as a pair: read_basic_identity reads Basic manufacturer/model under the stack lock;
+     * schedule_interview_pump requests zigbee_service_interview_pump after delay_ms. Without them no interviews run.
+     */
+    esp_err_t (*read_basic_identity)(uint16_t short_addr, uint8_t endpoint);
+    esp_err_t (*schedule_interview_pump)(uint32_t delay_ms);
+    /*
+     * Optional: ZDO callbacks copy replies into events posted here, and the event task hands them to
+     * zigbee_service_on_zdo_event. Without it replies run in the Zigbee task. false means dropped.
+     */
+    bool (*post_event)(const zigbee_event_t *event);
 } zigbee_service_runtime_ops_t;
 
+typedef struct {
+    gateway_status_t (*load)(void *ctx, zigbee_group_t *groups, size_t max_groups, int *group_count);
+    gateway_status_t (*save)(void *ctx, const zigbee_group_t *groups, size_t max_groups, int group_count);
+    void *ctx;
+} zigbee_group_repo_port_t;
+
+typedef struct {
+    gateway_status_t (*load)(void *ctx, gateway_device_interview_t *records, size_t max_records, int *record_count);
+    gateway_status_t (*save)(void *ctx, const gateway_device_interview_t *records, size_t max_records,
+                             int record_count);
+    void *ctx;
+} zigbee_interview_repo_port_t;
+
 typedef struct zigbee_service zigbee_service_t;
 typedef zigbee_service_t *zigbee_service_handle_t;
 
@@ -22,6 +60,10 @@ typedef struct {
     device_service_handle_t device_service;
     struct gateway_state_store *gateway_state;
     const zigbee_service_runtime_ops_t *runtime_ops;
+    /* Optional: without it groups last until reboot. */
+    const zigbee_group_repo_port_t *group_repo;
+    /* Optional: without it interviews repeat after every reboot. */
+    const zigbee_interview_repo_port_t *interview_repo;
 } zigbee_service_init_params_t;
 
 esp_err_t zigbee_service_create(const zigbee_service_init_params_t *params, zigbee_service_handle_t *out_handle);
@@ -30,13 +72,93 @@ void zigbee_service_destroy(zigbee_service_handle_t handle);
 esp_err_t zigbee_service_get_network_status(zigbee_service_handle_t handle, zigbee_network_status_t *out);
 esp_err_t zigbee_service_permit_join(zigbee_service_handle_t handle, uint16_t seconds);
 esp_err_t zigbee_service_send_on_off(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint, uint8_t on_off);
+/* out_results[i] is the result of command i; the call itself fails only on bad arguments or state. */
+esp_err_t zigbee_service_send_on_off_batch(zigbee_service_handle_t handle, const zigbee_on_off_cmd_t *cmds, size_t count,
+                                           esp_err_t *out_results);
+/*
+ * send_on_off that waits up to timeout_ms for the Default Response; ESP_ERR_TIMEOUT leaves the command queued,
+ * ESP_ERR_INVALID_STATE means a newer one superseded it. Needs the scheduler runtime ops.
+ */
+esp_err_t zigbee_service_send_on_off_confirmed(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint,
+                                               uint8_t on_off, uint32_t timeout_ms);
+/* Command queue pump and On/Off Default Responses, from the event task; cmd_pump takes the stack lock. */
+void zigbee_service_cmd_pump(zigbee_service_handle_t handle);
+void zigbee_service_on_cmd_response(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t tsn, bool success);
+/* Width of a cacheable ZCL scalar type (up to 4 bytes), or 0. Lock-free. */
+size_t zigbee_service_zcl_scalar_width(uint8_t zcl_type);
+/*
+ * Caches a reported or read attribute value; event task only. ESP_ERR_NOT_SUPPORTED for non-scalar types,
+ * out_changed when the value is new or different.
+ */
+esp_err_t zigbee_service_on_attr_value(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint,
+                                       uint16_t cluster_id, uint16_t attr_id, uint8_t zcl_type, const void *value,
+                                       size_t size, gateway_attr_source_t source, bool *out_changed);
+int zigbee_service_get_attr_snapshot(zigbee_service_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                     gateway_attr_entry_t *out, size_t max_items);
+/*
+ * Announce from the event task (see zigbee_interview.h): a COMPLETE record for the IEEE only takes the new
+ * short_addr (out_changed), others are queued. ESP_ERR_NO_MEM when the queue is full.
+ */
+esp_err_t zigbee_service_on_device_announce(zigbee_service_handle_t handle, uint16_t short_addr,
+                                            const gateway_ieee_addr_t ieee_addr, bool *out_changed);
+/*
+ * Event task, under the stack lock: timeouts and the next request; true when the interview waits
+ * for zigbee_service_interview_collect. Only one service instance owns ZDP answers; others get false.
+ */
+bool zigbee_service_interview_pump(zigbee_service_handle_t handle);
+/* Event task: Basic manufacturer/model from a Read Attributes Response; NULL when absent. */
+void zigbee_service_interview_on_basic(zigbee_service_handle_t handle, uint16_t short_addr, const char *manufacturer,
+                                       const char *model);
+/* Outside the Zigbee task: caches and stores a finished interview; out_changed for a new record. */
+esp_err_t zigbee_service_interview_collect(zigbee_service_handle_t handle, bool *out_changed);
+/* Interview results, one row per device. */
+int zigbee_service_get_device_profiles(zigbee_service_handle_t handle, gateway_device_profile_t *out, size_t max_items);
 int zigbee_service_get_devices_snapshot(zigbee_service_handle_t handle, zb_device_t *out, size_t max_items);
 int zigbee_service_get_neighbor_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out, size_t max_items);
-esp_err_t zigbee_service_refresh_neighbor_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out,
-                                                       size_t max_items, int *out_count);
+/* Async completion, called exactly once from zigbee_service_on_zdo_event or a *_tick. */
+typedef void (*zigbee_service_done_fn_t)(void *ctx, esp_err_t err, int count);
+/*
+ * Non-blocking pipelined Mgmt_Lqi_req walk of the coordinator table; done fires after the LQI cache update.
+ * ESP_ERR_INVALID_STATE when the stack is down or a walk is running.
+ */
+esp_err_t zigbee_service_start_lqi_refresh(zigbee_service_handle_t handle, zigbee_service_done_fn_t done, void *ctx);
+/* Ends a walk silent past the page timeout; returns the next deadline (esp_timer ms) or UINT64_MAX. */
+uint64_t zigbee_service_lqi_refresh_tick(zigbee_service_handle_t handle);
+/* Records of the last finished walk, without merging into the cache. */
+esp_err_t zigbee_service_get_lqi_refresh_result(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out,
+                                                size_t max_items, int *out_count);
+/*
+ * Mgmt_Lqi crawl of the whole network (see zigbee_topology_crawl.h); done gets ESP_OK when at least the
+ * coordinator answered, plus the node count. ESP_ERR_INVALID_STATE while any instance has a crawl running.
+ */
+esp_err_t zigbee_service_start_topology_crawl(zigbee_service_handle_t handle, zigbee_service_done_fn_t done, void *ctx);
+/* Timeouts and retries; returns the next tick time (esp_timer ms) or UINT64_MAX. */
+uint64_t zigbee_service_topology_tick(zigbee_service_handle_t handle);
+esp_err_t zigbee_service_get_topology_summary(zigbee_service_handle_t handle, gateway_topology_summary_t *out);
+/* Nodes or edges from index `from`; the number copied, or -1 once crawl_id is no longer current. */
+int zigbee_service_get_topology_nodes(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                      gateway_topology_node_t *out, size_t max_items);
+int zigbee_service_get_topology_edges(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                      gateway_topology_edge_t *out, size_t max_items);
+/* Event task: a ZDO reply posted via post_event; follow-up requests take the stack lock. */
+void zigbee_service_on_zdo_event(zigbee_service_handle_t handle, const zigbee_event_t *event);
 esp_err_t zigbee_service_refresh_neighbor_lqi_from_table(zigbee_service_handle_t handle);
 esp_err_t zigbee_service_get_cached_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out,
                                                  size_t max_items, int *out_count,
                                                  zigbee_lqi_source_t *out_source, uint64_t *out_updated_ms);
+/* Per-device unicast command stats with p50/p95 RTT filled in. */
+int zigbee_service_get_cmd_stats_snapshot(zigbee_service_handle_t handle, gateway_cmd_stats_t *out, size_t max_items);
+/* Read before the snapshot so a cache never pairs old content with a new generation. */
+esp_err_t zigbee_service_get_state_generation(zigbee_service_handle_t handle, zigbee_state_generation_t *out);
 esp_err_t zigbee_service_delete_device(zigbee_service_handle_t handle, uint16_t short_addr);
 esp_err_t zigbee_service_rename_device(zigbee_service_handle_t handle, uint16_t short_addr, const char *name);
+
+/* Membership changes only after Add/Remove Group reaches the stack and is stored at once; group control is one group-cast. */
+esp_err_t zigbee_service_group_create(zigbee_service_handle_t handle, const char *name, uint16_t *out_group_id);
+esp_err_t zigbee_service_group_delete(zigbee_service_handle_t handle, uint16_t group_id);
+esp_err_t zigbee_service_group_add_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                          uint8_t endpoint);
+esp_err_t zigbee_service_group_remove_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                             uint8_t endpoint);
+esp_err_t zigbee_service_group_send_on_off(zigbee_service_handle_t handle, uint16_t group_id, uint8_t on_off);
+int zigbee_service_get_groups_snapshot(zigbee_service_handle_t handle, zigbee_group_t *out, size_t max_items);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gateway_runtime_types.h"
+
+/*
+ * Breadth-first Mgmt_Lqi_req crawl from the coordinator, up to MAX_IN_FLIGHT routers at once, into fixed arrays.
+ * Pure logic; time is now_ms. Replies carry no sender address, so each request has a token.
+ */
+
+#define ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT 4
+#define ZIGBEE_TOPOLOGY_MAX_ATTEMPTS 2
+#define ZIGBEE_TOPOLOGY_PAGE_TIMEOUT_MS 3500
+#define ZIGBEE_TOPOLOGY_IDLE UINT64_MAX
+
+/* Neighbor table record from a reply. */
+typedef struct {
+    uint16_t short_addr;
+    uint8_t device_type;
+    uint8_t relationship;
+    uint8_t depth;
+    uint8_t lqi;
+} zigbee_topology_neighbor_t;
+
+typedef struct {
+    uint32_t token; /* 0 marks a free slot */
+    uint16_t node;
+    uint64_t due_ms;
+} zigbee_topology_request_t;
+
+typedef struct {
+    gateway_topology_summary_t summary;
+    uint32_t next_token;
+    zigbee_topology_request_t in_flight[ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT];
+    gateway_topology_node_t nodes[GATEWAY_TOPOLOGY_MAX_NODES];
+    gateway_topology_edge_t edges[GATEWAY_TOPOLOGY_MAX_EDGES];
+} zigbee_topology_crawl_t;
+
+/* Starts a crawl from root_addr; crawl_id grows and the old graph is cleared. */
+void zigbee_topology_crawl_begin(zigbee_topology_crawl_t *c, uint16_t root_addr, uint64_t now_ms);
+
+/* Next request for the earliest waiting router while a slot is free; send it with out_token and repeat while true. */
+bool zigbee_topology_crawl_next(zigbee_topology_crawl_t *c, uint64_t now_ms, uint32_t *out_token, uint16_t *out_addr,
+                                uint8_t *out_start_index);
+
+/* Neighbor page for token; false for an unknown (late) token. */
+bool zigbee_topology_crawl_on_page(zigbee_topology_crawl_t *c, uint32_t token, uint8_t table_entries,
+                                   const zigbee_topology_neighbor_t *items, uint8_t count, uint64_t now_ms);
+
+/* ZDP error for token: the router is retried, then FAILED after MAX_ATTEMPTS. */
+bool zigbee_topology_crawl_on_error(zigbee_topology_crawl_t *c, uint32_t token, uint64_t now_ms);
+
+/* Requests unanswered for PAGE_TIMEOUT_MS count as errors. */
+void zigbee_topology_crawl_tick(zigbee_topology_crawl_t *c, uint64_t now_ms);
+
+/* When tick/next is due: 0 if a request can go now, else the nearest deadline; ZIGBEE_TOPOLOGY_IDLE when idle. */
+uint64_t zigbee_topology_crawl_next_due_ms(const zigbee_topology_crawl_t *c);
@@ -0,0 +1,267 @@
+#include "zigbee_cmd_scheduler.h"
+
+#include <string.h>
+
+static bool seq_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+static uint32_t take_ticket(zigbee_cmd_scheduler_t *sched)
+{
+    /* 0 never names a command, so callers can use it as "no ticket". */
+    if (++sched->next_ticket == 0) {
+        sched->next_ticket = 1;
+    }
+    return sched->next_ticket;
+}
+
+static void complete_slot(zigbee_cmd_scheduler_t *sched, zigbee_cmd_slot_t *slot, gateway_status_t status,
+                          uint32_t rtt_ms)
+{
+    zigbee_cmd_completion_t completion = {
+        .ticket = slot->ticket,
+        .short_addr = slot->cmd.short_addr,
+        .status = status,
+        .rtt_ms = rtt_ms,
+        .waiter = slot->waiter,
+    };
+    sched->done[sched->done_next] = completion;
+    sched->done_next = (sched->done_next + 1) % ZIGBEE_CMD_SCHED_DONE_RING;
+    memset(slot, 0, sizeof(*slot));
+    if (sched->on_complete) {
+        sched->on_complete(sched->on_complete_ctx, &completion);
+    }
+}
+
+static zigbee_cmd_slot_t *find_ticket(zigbee_cmd_scheduler_t *sched, uint32_t ticket)
+{
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        if (sched->slots[i].state != ZIGBEE_CMD_SLOT_FREE && sched->slots[i].ticket == ticket) {
+            return &sched->slots[i];
+        }
+    }
+    return NULL;
+}
+
+static bool device_in_flight(const zigbee_cmd_scheduler_t *sched, uint16_t short_addr)
+{
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        const zigbee_cmd_slot_t *slot = &sched->slots[i];
+        if (slot->state == ZIGBEE_CMD_SLOT_IN_FLIGHT && slot->cmd.short_addr == short_addr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t in_flight_count(const zigbee_cmd_scheduler_t *sched)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        count += sched->slots[i].state == ZIGBEE_CMD_SLOT_IN_FLIGHT ? 1 : 0;
+    }
+    return count;
+}
+
+static void retry_or_fail(zigbee_cmd_scheduler_t *sched, zigbee_cmd_slot_t *slot, uint64_t now_ms)
+{
+    if (slot->attempts >= ZIGBEE_CMD_SCHED_MAX_ATTEMPTS) {
+        complete_slot(sched, slot, GATEWAY_STATUS_TIMEOUT, 0);
+        return;
+    }
+    slot->state = ZIGBEE_CMD_SLOT_QUEUED;
+    slot->due_ms = now_ms + ((uint64_t)ZIGBEE_CMD_SCHED_RETRY_BASE_MS << (slot->attempts - 1));
+}
+
+void zigbee_cmd_scheduler_init(zigbee_cmd_scheduler_t *sched, zigbee_cmd_complete_fn_t on_complete, void *ctx)
+{
+    if (!sched) {
+        return;
+    }
+    memset(sched, 0, sizeof(*sched));
+    sched->on_complete = on_complete;
+    sched->on_complete_ctx = ctx;
+}
+
+gateway_status_t zigbee_cmd_scheduler_submit(zigbee_cmd_scheduler_t *sched, const zigbee_on_off_cmd_t *cmd,
+                                             uint64_t now_ms, void *waiter, uint32_t *out_ticket)
+{
+    if (!sched || !cmd || !out_ticket || cmd->short_addr == 0 || cmd->endpoint == 0) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+
+    zigbee_cmd_slot_t *free_slot = NULL;
+    size_t device_depth = 0;
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        zigbee_cmd_slot_t *slot = &sched->slots[i];
+        if (slot->state == ZIGBEE_CMD_SLOT_FREE) {
+            free_slot = free_slot ? free_slot : slot;
+            continue;
+        }
+        if (slot->cmd.short_addr != cmd->short_addr) {
+            continue;
+        }
+        /* Only the newest state matters for a switch: a queued command is rewritten in place. */
+        if (slot->state == ZIGBEE_CMD_SLOT_QUEUED && slot->cmd.endpoint == cmd->endpoint) {
+            uint32_t seq = slot->seq;
+            complete_slot(sched, slot, GATEWAY_STATUS_INVALID_STATE, 0);
+            slot->state = ZIGBEE_CMD_SLOT_QUEUED;
+            slot->ticket = take_ticket(sched);
+            slot->seq = seq;
+            slot->cmd = *cmd;
+            slot->due_ms = now_ms;
+            slot->waiter = waiter;
+            *out_ticket = slot->ticket;
+            return GATEWAY_STATUS_OK;
+        }
+        device_depth++;
+    }
+
+    if (!free_slot || device_depth >= ZIGBEE_CMD_SCHED_DEVICE_DEPTH) {
+        return GATEWAY_STATUS_NO_MEM;
+    }
+
+    free_slot->state = ZIGBEE_CMD_SLOT_QUEUED;
+    free_slot->ticket = take_ticket(sched);
+    free_slot->seq = sched->next_seq++;
+    free_slot->cmd = *cmd;
+    free_slot->attempts = 0;
+    free_slot->due_ms = now_ms;
+    free_slot->waiter = waiter;
+    *out_ticket = free_slot->ticket;
+    return GATEWAY_STATUS_OK;
+}
+
+/* The oldest queued command of a device decides when that device is next served. */
+static zigbee_cmd_slot_t *device_head(zigbee_cmd_scheduler_t *sched, uint16_t short_addr)
+{
+    zigbee_cmd_slot_t *head = NULL;
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        zigbee_cmd_slot_t *slot = &sched->slots[i];
+        if (slot->state == ZIGBEE_CMD_SLOT_QUEUED && slot->cmd.short_addr == short_addr &&
+            (!head || seq_before(slot->seq, head->seq))) {
+            head = slot;
+        }
+    }
+    return head;
+}
+
+bool zigbee_cmd_scheduler_next(zigbee_cmd_scheduler_t *sched, uint64_t now_ms, uint32_t *out_ticket,
+                               zigbee_on_off_cmd_t *out_cmd)
+{
+    if (!sched || !out_ticket || !out_cmd || in_flight_count(sched) >= ZIGBEE_CMD_SCHED_MAX_IN_FLIGHT) {
+        return false;
+    }
+
+    zigbee_cmd_slot_t *best = NULL;
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        zigbee_cmd_slot_t *slot = &sched->slots[i];
+        if (slot->state != ZIGBEE_CMD_SLOT_QUEUED || (best && !seq_before(slot->seq, best->seq))) {
+            continue;
+        }
+        if (device_head(sched, slot->cmd.short_addr) != slot || slot->due_ms > now_ms ||
+            device_in_flight(sched, slot->cmd.short_addr)) {
+            continue;
+        }
+        best = slot;
+    }
+    if (!best) {
+        return false;
+    }
+
+    best->state = ZIGBEE_CMD_SLOT_IN_FLIGHT;
+    best->attempts++;
+    best->due_ms = now_ms + ZIGBEE_CMD_SCHED_ACK_TIMEOUT_MS;
+    *out_ticket = best->ticket;
+    *out_cmd = best->cmd;
+    return true;
+}
+
+void zigbee_cmd_scheduler_on_sent(zigbee_cmd_scheduler_t *sched, uint32_t ticket, bool sent, uint8_t tsn,
+                                  uint64_t now_ms)
+{
+    zigbee_cmd_slot_t *slot = sched ? find_ticket(sched, ticket) : NULL;
+    if (!slot || slot->state != ZIGBEE_CMD_SLOT_IN_FLIGHT) {
+        return;
+    }
+    if (!sent) {
+        retry_or_fail(sched, slot, now_ms);
+        return;
+    }
+    slot->tsn = tsn;
+    slot->sent_ms = now_ms;
+}
+
+bool zigbee_cmd_scheduler_on_response(zigbee_cmd_scheduler_t *sched, uint16_t short_addr, uint8_t tsn,
+                                      gateway_status_t status, uint64_t now_ms)
+{
+    if (!sched) {
+        return false;
+    }
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        zigbee_cmd_slot_t *slot = &sched->slots[i];
+        if (slot->state == ZIGBEE_CMD_SLOT_IN_FLIGHT && slot->cmd.short_addr == short_addr && slot->tsn == tsn) {
+            uint64_t rtt_ms = now_ms > slot->sent_ms ? now_ms - slot->sent_ms : 0;
+            complete_slot(sched, slot, status, rtt_ms > UINT32_MAX ? UINT32_MAX : (uint32_t)rtt_ms);
+            return true;
+        }
+    }
+    return false;
+}
+
+void zigbee_cmd_scheduler_tick(zigbee_cmd_scheduler_t *sched, uint64_t now_ms)
+{
+    if (!sched) {
+        return;
+    }
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        zigbee_cmd_slot_t *slot = &sched->slots[i];
+        if (slot->state == ZIGBEE_CMD_SLOT_IN_FLIGHT && slot->due_ms <= now_ms) {
+            retry_or_fail(sched, slot, now_ms);
+        }
+    }
+}
+
+uint64_t zigbee_cmd_scheduler_next_due_ms(const zigbee_cmd_scheduler_t *sched)
+{
+    if (!sched) {
+        return ZIGBEE_CMD_SCHED_IDLE;
+    }
+
+    bool can_send = in_flight_count(sched) < ZIGBEE_CMD_SCHED_MAX_IN_FLIGHT;
+    uint64_t due = ZIGBEE_CMD_SCHED_IDLE;
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_SLOTS; i++) {
+        const zigbee_cmd_slot_t *slot = &sched->slots[i];
+        /* A queued command behind an in-flight one waits for its response or deadline, not for a timer. */
+        bool counts = slot->state == ZIGBEE_CMD_SLOT_IN_FLIGHT ||
+                      (slot->state == ZIGBEE_CMD_SLOT_QUEUED && can_send &&
+                       !device_in_flight(sched, slot->cmd.short_addr));
+        if (counts && slot->due_ms < due) {
+            due = slot->due_ms;
+        }
+    }
+    return due;
+}
+
+void zigbee_cmd_scheduler_detach_waiter(zigbee_cmd_scheduler_t *sched, uint32_t ticket)
+{
+    zigbee_cmd_slot_t *slot = sched ? find_ticket(sched, ticket) : NULL;
+    if (slot) {
+        slot->waiter = NULL;
+    }
+}
+
+bool zigbee_cmd_scheduler_result(const zigbee_cmd_scheduler_t *sched, uint32_t ticket, gateway_status_t *out_status)
+{
+    if (!sched || ticket == 0 || !out_status) {
+        return false;
+    }
+    for (size_t i = 0; i < ZIGBEE_CMD_SCHED_DONE_RING; i++) {
+        if (sched->done[i].ticket == ticket) {
+            *out_status = sched->done[i].status;
+            return true;
+        }
+    }
+    return false;
+}
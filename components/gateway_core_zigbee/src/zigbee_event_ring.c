@@ -0,0 +1,68 @@
+#include "zigbee_event_ring.h"
+
+#include <string.h>
+
+#define RING_MASK (ZIGBEE_EVENT_RING_CAPACITY - 1u)
+
+void zigbee_event_ring_init(zigbee_event_ring_t *ring)
+{
+    if (!ring) {
+        return;
+    }
+    memset(ring->slots, 0, sizeof(ring->slots));
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->pushed_total, 0);
+    atomic_init(&ring->dropped_total, 0);
+    atomic_init(&ring->depth_peak, 0);
+}
+
+bool zigbee_event_ring_push(zigbee_event_ring_t *ring, const zigbee_event_t *event)
+{
+    if (!ring || !event) {
+        return false;
+    }
+    /* head is ours; tail is acquired so the consumer has finished reading the slot we are about to reuse. */
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    unsigned depth = head - tail;
+    if (depth >= ZIGBEE_EVENT_RING_CAPACITY) {
+        atomic_fetch_add_explicit(&ring->dropped_total, 1u, memory_order_relaxed);
+        return false;
+    }
+
+    ring->slots[head & RING_MASK] = *event;
+    atomic_store_explicit(&ring->head, head + 1u, memory_order_release);
+    atomic_fetch_add_explicit(&ring->pushed_total, 1u, memory_order_relaxed);
+    if (depth + 1u > atomic_load_explicit(&ring->depth_peak, memory_order_relaxed)) {
+        atomic_store_explicit(&ring->depth_peak, depth + 1u, memory_order_relaxed);
+    }
+    return true;
+}
+
+bool zigbee_event_ring_pop(zigbee_event_ring_t *ring, zigbee_event_t *out)
+{
+    if (!ring || !out) {
+        return false;
+    }
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    *out = ring->slots[tail & RING_MASK];
+    atomic_store_explicit(&ring->tail, tail + 1u, memory_order_release);
+    return true;
+}
+
+void zigbee_event_ring_get_stats(zigbee_event_ring_t *ring, gateway_zigbee_event_stats_t *out)
+{
+    if (!ring || !out) {
+        return;
+    }
+    out->capacity = ZIGBEE_EVENT_RING_CAPACITY;
+    out->pushed_total = atomic_load_explicit(&ring->pushed_total, memory_order_relaxed);
+    out->dropped_total = atomic_load_explicit(&ring->dropped_total, memory_order_relaxed);
+    out->depth_peak = atomic_load_explicit(&ring->depth_peak, memory_order_relaxed);
+}
@@ -0,0 +1,144 @@
+#include "zigbee_group_rules.h"
+
+#include <string.h>
+
+int zigbee_group_rules_find(const gateway_group_record_t *groups, int group_count, uint16_t group_id)
+{
+    if (!groups) {
+        return -1;
+    }
+    for (int i = 0; i < group_count; i++) {
+        if (groups[i].group_id == group_id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static uint16_t lowest_free_group_id(const gateway_group_record_t *groups, int group_count)
+{
+    /* The table holds at most GATEWAY_MAX_GROUPS entries, so a free id is found within the first few candidates. */
+    for (uint16_t id = 1; id <= GATEWAY_GROUP_ID_MAX; id++) {
+        if (zigbee_group_rules_find(groups, group_count, id) < 0) {
+            return id;
+        }
+    }
+    return 0;
+}
+
+gateway_status_t zigbee_group_rules_create(gateway_group_record_t *groups, int *group_count, size_t max_groups,
+                                           const char *name, uint16_t *out_group_id)
+{
+    if (!groups || !group_count || !name || !out_group_id) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    size_t name_len = strlen(name);
+    if (name_len == 0 || name_len > GATEWAY_GROUP_NAME_MAX_LEN) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    if (*group_count < 0 || (size_t)*group_count >= max_groups) {
+        return GATEWAY_STATUS_NO_MEM;
+    }
+
+    uint16_t id = lowest_free_group_id(groups, *group_count);
+    if (id == 0) {
+        return GATEWAY_STATUS_NO_MEM;
+    }
+
+    gateway_group_record_t *group = &groups[*group_count];
+    memset(group, 0, sizeof(*group));
+    group->group_id = id;
+    memcpy(group->name, name, name_len + 1);
+    (*group_count)++;
+    *out_group_id = id;
+    return GATEWAY_STATUS_OK;
+}
+
+gateway_status_t zigbee_group_rules_delete(gateway_group_record_t *groups, int *group_count, uint16_t group_id,
+                                           gateway_group_record_t *deleted_record)
+{
+    if (!groups || !group_count) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    int idx = zigbee_group_rules_find(groups, *group_count, group_id);
+    if (idx < 0) {
+        return GATEWAY_STATUS_NOT_FOUND;
+    }
+
+    if (deleted_record) {
+        *deleted_record = groups[idx];
+    }
+    for (int i = idx; i < *group_count - 1; i++) {
+        groups[i] = groups[i + 1];
+    }
+    (*group_count)--;
+    memset(&groups[*group_count], 0, sizeof(groups[*group_count]));
+    return GATEWAY_STATUS_OK;
+}
+
+static int find_member(const gateway_group_record_t *group, uint16_t short_addr, uint8_t endpoint)
+{
+    for (int i = 0; i < group->member_count; i++) {
+        if (group->members[i].short_addr == short_addr && group->members[i].endpoint == endpoint) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+gateway_status_t zigbee_group_rules_add_member(gateway_group_record_t *group, uint16_t short_addr, uint8_t endpoint)
+{
+    if (!group || short_addr == 0 || endpoint == 0) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    if (find_member(group, short_addr, endpoint) >= 0) {
+        return GATEWAY_STATUS_OK;
+    }
+    if (group->member_count >= GATEWAY_GROUP_MAX_MEMBERS) {
+        return GATEWAY_STATUS_NO_MEM;
+    }
+
+    group->members[group->member_count].short_addr = short_addr;
+    group->members[group->member_count].endpoint = endpoint;
+    group->member_count++;
+    return GATEWAY_STATUS_OK;
+}
+
+static void remove_member_at(gateway_group_record_t *group, int idx)
+{
+    for (int i = idx; i < group->member_count - 1; i++) {
+        group->members[i] = group->members[i + 1];
+    }
+    group->member_count--;
+    group->members[group->member_count] = (gateway_group_member_t){0};
+}
+
+gateway_status_t zigbee_group_rules_remove_member(gateway_group_record_t *group, uint16_t short_addr, uint8_t endpoint)
+{
+    if (!group) {
+        return GATEWAY_STATUS_INVALID_ARG;
+    }
+    int idx = find_member(group, short_addr, endpoint);
+    if (idx < 0) {
+        return GATEWAY_STATUS_NOT_FOUND;
+    }
+    remove_member_at(group, idx);
+    return GATEWAY_STATUS_OK;
+}
+
+int zigbee_group_rules_remove_device(gateway_group_record_t *groups, int group_count, uint16_t short_addr)
+{
+    if (!groups) {
+        return 0;
+    }
+    int removed = 0;
+    for (int g = 0; g < group_count; g++) {
+        for (int i = groups[g].member_count - 1; i >= 0; i--) {
+            if (groups[g].members[i].short_addr == short_addr) {
+                remove_member_at(&groups[g], i);
+                removed++;
+            }
+        }
+    }
+    return removed;
+}
@@ -0,0 +1,286 @@
+#include "zigbee_interview.h"
+
+#include <string.h>
+
+#define ZIGBEE_INTERVIEW_GREEN_POWER_ENDPOINT 242
+
+static bool step_active(const zigbee_interview_t *iv)
+{
+    return iv->step == ZIGBEE_INTERVIEW_STEP_ACTIVE_EP || iv->step == ZIGBEE_INTERVIEW_STEP_SIMPLE_DESC ||
+           iv->step == ZIGBEE_INTERVIEW_STEP_BASIC;
+}
+
+static bool request_matches(const zigbee_interview_t *iv, uint32_t token, uint8_t step)
+{
+    return iv && token != 0 && iv->step == step && iv->in_flight && iv->token == token;
+}
+
+static void copy_string(char *dst, size_t dst_size, const char *src)
+{
+    if (!src) {
+        return;
+    }
+    size_t len = 0;
+    while (len + 1 < dst_size && src[len] != '\0') {
+        len++;
+    }
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+static void enter_step(zigbee_interview_t *iv, uint8_t step)
+{
+    iv->step = step;
+    iv->in_flight = false;
+    iv->attempts = 0;
+}
+
+static uint8_t basic_endpoint(const gateway_device_interview_t *record)
+{
+    uint8_t endpoint = zigbee_interview_find_endpoint(record, ZIGBEE_INTERVIEW_CLUSTER_BASIC);
+    return endpoint ? endpoint : record->endpoints[0].endpoint;
+}
+
+static void step_done(zigbee_interview_t *iv)
+{
+    switch (iv->step) {
+    case ZIGBEE_INTERVIEW_STEP_ACTIVE_EP:
+        iv->desc_index = 0;
+        enter_step(iv, iv->record.endpoint_count > 0 ? ZIGBEE_INTERVIEW_STEP_SIMPLE_DESC
+                                                     : ZIGBEE_INTERVIEW_STEP_FINISHED);
+        break;
+    case ZIGBEE_INTERVIEW_STEP_SIMPLE_DESC:
+        if (++iv->desc_index < iv->record.endpoint_count) {
+            enter_step(iv, ZIGBEE_INTERVIEW_STEP_SIMPLE_DESC);
+        } else {
+            enter_step(iv, ZIGBEE_INTERVIEW_STEP_BASIC);
+        }
+        break;
+    default:
+        enter_step(iv, ZIGBEE_INTERVIEW_STEP_FINISHED);
+        break;
+    }
+}
+
+static void request_failed(zigbee_interview_t *iv)
+{
+    iv->in_flight = false;
+    if (iv->attempts < ZIGBEE_INTERVIEW_MAX_ATTEMPTS) {
+        return;
+    }
+    /* Without the endpoint list there is nothing worth keeping; the next announce starts over. */
+    if (iv->step == ZIGBEE_INTERVIEW_STEP_ACTIVE_EP) {
+        enter_step(iv, ZIGBEE_INTERVIEW_STEP_IDLE);
+        return;
+    }
+    iv->partial = true;
+    step_done(iv);
+}
+
+static void begin_next(zigbee_interview_t *iv)
+{
+    if (iv->step != ZIGBEE_INTERVIEW_STEP_IDLE || iv->queue_count == 0) {
+        return;
+    }
+    memset(&iv->record, 0, sizeof(iv->record));
+    iv->record.short_addr = iv->queue[0].short_addr;
+    memcpy(iv->record.ieee_addr, iv->queue[0].ieee_addr, sizeof(iv->record.ieee_addr));
+    iv->queue_count--;
+    memmove(&iv->queue[0], &iv->queue[1], iv->queue_count * sizeof(iv->queue[0]));
+    iv->partial = false;
+    iv->desc_index = 0;
+    enter_step(iv, ZIGBEE_INTERVIEW_STEP_ACTIVE_EP);
+}
+
+void zigbee_interview_init(zigbee_interview_t *iv)
+{
+    if (!iv) {
+        return;
+    }
+    memset(iv, 0, sizeof(*iv));
+}
+
+bool zigbee_interview_enqueue(zigbee_interview_t *iv, uint16_t short_addr, const gateway_ieee_addr_t ieee_addr)
+{
+    if (!iv || !ieee_addr) {
+        return false;
+    }
+    /* A rejoin mid-interview only moves the address; requests still in flight time out and go to the new one. */
+    if (iv->step != ZIGBEE_INTERVIEW_STEP_IDLE && memcmp(iv->record.ieee_addr, ieee_addr, sizeof(gateway_ieee_addr_t)) == 0) {
+        iv->record.short_addr = short_addr;
+        return true;
+    }
+    for (uint8_t i = 0; i < iv->queue_count; i++) {
+        if (memcmp(iv->queue[i].ieee_addr, ieee_addr, sizeof(gateway_ieee_addr_t)) == 0) {
+            iv->queue[i].short_addr = short_addr;
+            return true;
+        }
+    }
+    if (iv->queue_count >= ZIGBEE_INTERVIEW_QUEUE_DEPTH) {
+        return false;
+    }
+    iv->queue[iv->queue_count].short_addr = short_addr;
+    memcpy(iv->queue[iv->queue_count].ieee_addr, ieee_addr, sizeof(gateway_ieee_addr_t));
+    iv->queue_count++;
+    return true;
+}
+
+bool zigbee_interview_cancel(zigbee_interview_t *iv, uint16_t short_addr)
+{
+    if (!iv) {
+        return false;
+    }
+    bool found = false;
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < iv->queue_count; i++) {
+        if (iv->queue[i].short_addr == short_addr) {
+            found = true;
+        } else {
+            iv->queue[kept++] = iv->queue[i];
+        }
+    }
+    iv->queue_count = kept;
+    if (iv->step != ZIGBEE_INTERVIEW_STEP_IDLE && iv->record.short_addr == short_addr) {
+        enter_step(iv, ZIGBEE_INTERVIEW_STEP_IDLE);
+        found = true;
+    }
+    return found;
+}
+
+bool zigbee_interview_next(zigbee_interview_t *iv, uint64_t now_ms, zigbee_interview_request_t *out)
+{
+    if (!iv || !out) {
+        return false;
+    }
+    begin_next(iv);
+    if (!step_active(iv) || iv->in_flight) {
+        return false;
+    }
+
+    if (++iv->next_token == 0) {
+        iv->next_token = 1;
+    }
+    iv->token = iv->next_token;
+    iv->in_flight = true;
+    iv->attempts++;
+    iv->due_ms = now_ms + ZIGBEE_INTERVIEW_TIMEOUT_MS;
+
+    memset(out, 0, sizeof(*out));
+    out->token = iv->token;
+    out->short_addr = iv->record.short_addr;
+    switch (iv->step) {
+    case ZIGBEE_INTERVIEW_STEP_ACTIVE_EP:
+        out->kind = ZIGBEE_INTERVIEW_REQ_ACTIVE_EP;
+        break;
+    case ZIGBEE_INTERVIEW_STEP_SIMPLE_DESC:
+        out->kind = ZIGBEE_INTERVIEW_REQ_SIMPLE_DESC;
+        out->endpoint = iv->record.endpoints[iv->desc_index].endpoint;
+        break;
+    default:
+        out->kind = ZIGBEE_INTERVIEW_REQ_BASIC;
+        out->endpoint = basic_endpoint(&iv->record);
+        break;
+    }
+    return true;
+}
+
+bool zigbee_interview_on_active_ep(zigbee_interview_t *iv, uint32_t token, const uint8_t *endpoints, uint8_t count)
+{
+    if (!request_matches(iv, token, ZIGBEE_INTERVIEW_STEP_ACTIVE_EP) || (count > 0 && !endpoints)) {
+        return false;
+    }
+    iv->record.endpoint_count = 0;
+    for (uint8_t i = 0; i < count && iv->record.endpoint_count < GATEWAY_INTERVIEW_MAX_ENDPOINTS; i++) {
+        if (endpoints[i] == 0 || endpoints[i] == ZIGBEE_INTERVIEW_GREEN_POWER_ENDPOINT) {
+            continue;
+        }
+        iv->record.endpoints[iv->record.endpoint_count++].endpoint = endpoints[i];
+    }
+    step_done(iv);
+    return true;
+}
+
+bool zigbee_interview_on_simple_desc(zigbee_interview_t *iv, uint32_t token, const gateway_endpoint_desc_t *desc)
+{
+    if (!request_matches(iv, token, ZIGBEE_INTERVIEW_STEP_SIMPLE_DESC) || !desc) {
+        return false;
+    }
+    gateway_endpoint_desc_t *slot = &iv->record.endpoints[iv->desc_index];
+    uint8_t endpoint = slot->endpoint;
+    *slot = *desc;
+    slot->endpoint = endpoint;
+    if (slot->in_count > GATEWAY_INTERVIEW_MAX_IN_CLUSTERS) {
+        slot->in_count = GATEWAY_INTERVIEW_MAX_IN_CLUSTERS;
+    }
+    if (slot->out_count > GATEWAY_INTERVIEW_MAX_OUT_CLUSTERS) {
+        slot->out_count = GATEWAY_INTERVIEW_MAX_OUT_CLUSTERS;
+    }
+    step_done(iv);
+    return true;
+}
+
+bool zigbee_interview_on_basic(zigbee_interview_t *iv, uint16_t short_addr, const char *manufacturer,
+                               const char *model)
+{
+    if (!iv || iv->step != ZIGBEE_INTERVIEW_STEP_BASIC || !iv->in_flight || iv->record.short_addr != short_addr) {
+        return false;
+    }
+    copy_string(iv->record.manufacturer, sizeof(iv->record.manufacturer), manufacturer);
+    copy_string(iv->record.model, sizeof(iv->record.model), model);
+    step_done(iv);
+    return true;
+}
+
+bool zigbee_interview_on_error(zigbee_interview_t *iv, uint32_t token)
+{
+    if (!iv || token == 0 || !step_active(iv) || !iv->in_flight || iv->token != token) {
+        return false;
+    }
+    request_failed(iv);
+    return true;
+}
+
+void zigbee_interview_tick(zigbee_interview_t *iv, uint64_t now_ms)
+{
+    if (iv && step_active(iv) && iv->in_flight && iv->due_ms <= now_ms) {
+        request_failed(iv);
+    }
+}
+
+uint64_t zigbee_interview_next_due_ms(const zigbee_interview_t *iv)
+{
+    if (!iv) {
+        return ZIGBEE_INTERVIEW_IDLE;
+    }
+    if (step_active(iv)) {
+        return iv->in_flight ? iv->due_ms : 0;
+    }
+    return iv->step == ZIGBEE_INTERVIEW_STEP_IDLE && iv->queue_count > 0 ? 0 : ZIGBEE_INTERVIEW_IDLE;
+}
+
+bool zigbee_interview_take_result(zigbee_interview_t *iv, gateway_device_interview_t *out)
+{
+    if (!iv || !out || iv->step != ZIGBEE_INTERVIEW_STEP_FINISHED) {
+        return false;
+    }
+    *out = iv->record;
+    out->state = iv->partial ? GATEWAY_INTERVIEW_PARTIAL : GATEWAY_INTERVIEW_COMPLETE;
+    enter_step(iv, ZIGBEE_INTERVIEW_STEP_IDLE);
+    return true;
+}
+
+uint8_t zigbee_interview_find_endpoint(const gateway_device_interview_t *record, uint16_t cluster_id)
+{
+    if (!record) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < record->endpoint_count && i < GATEWAY_INTERVIEW_MAX_ENDPOINTS; i++) {
+        const gateway_endpoint_desc_t *ep = &record->endpoints[i];
+        for (uint8_t j = 0; j < ep->in_count && j < GATEWAY_INTERVIEW_MAX_IN_CLUSTERS; j++) {
+            if (ep->in_clusters[j] == cluster_id) {
+                return ep->endpoint;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "zigbee_lqi_refresh.h"
+
+#include <string.h>
+
+static zigbee_lqi_page_t *find_page(zigbee_lqi_refresh_t *r, uint8_t start_index)
+{
+    for (size_t i = 0; i < ZIGBEE_LQI_REFRESH_MAX_IN_FLIGHT; i++) {
+        if (r->pages[i].used && r->pages[i].start_index == start_index) {
+            return &r->pages[i];
+        }
+    }
+    return NULL;
+}
+
+static bool index_requested(const zigbee_lqi_refresh_t *r, size_t index)
+{
+    for (size_t i = 0; i < ZIGBEE_LQI_REFRESH_MAX_IN_FLIGHT; i++) {
+        const zigbee_lqi_page_t *page = &r->pages[i];
+        if (page->used && index >= page->start_index && index < (size_t)page->start_index + page->span) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool any_in_flight(const zigbee_lqi_refresh_t *r)
+{
+    for (size_t i = 0; i < ZIGBEE_LQI_REFRESH_MAX_IN_FLIGHT; i++) {
+        if (r->pages[i].used) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void finish(zigbee_lqi_refresh_t *r, gateway_status_t status)
+{
+    r->state = ZIGBEE_LQI_REFRESH_STATE_DONE;
+    r->status = status;
+    memset(r->pages, 0, sizeof(r->pages));
+}
+
+static void finish_if_complete(zigbee_lqi_refresh_t *r)
+{
+    if (!r->total_known) {
+        return;
+    }
+    for (size_t i = 0; i < r->total; i++) {
+        if (!r->have[i]) {
+            return;
+        }
+    }
+    finish(r, GATEWAY_STATUS_OK);
+}
+
+void zigbee_lqi_refresh_begin(zigbee_lqi_refresh_t *r, uint64_t now_ms)
+{
+    if (!r) {
+        return;
+    }
+    memset(r, 0, sizeof(*r));
+    r->state = ZIGBEE_LQI_REFRESH_STATE_RUNNING;
+    r->status = GATEWAY_STATUS_OK;
+    r->deadline_ms = now_ms + ZIGBEE_LQI_REFRESH_PAGE_TIMEOUT_MS;
+}
+
+bool zigbee_lqi_refresh_next(zigbee_lqi_refresh_t *r, uint8_t *out_start_index)
+{
+    if (!r || !out_start_index || r->state != ZIGBEE_LQI_REFRESH_STATE_RUNNING) {
+        return false;
+    }
+
+    zigbee_lqi_page_t *free_page = NULL;
+    for (size_t i = 0; i < ZIGBEE_LQI_REFRESH_MAX_IN_FLIGHT && !free_page; i++) {
+        free_page = r->pages[i].used ? NULL : &r->pages[i];
+    }
+    if (!free_page) {
+        return false;
+    }
+
+    size_t start = 0;
+    uint8_t span = 1;
+    if (!r->total_known) {
+        /* Until the first page answers, the table size is unknown, so only page 0 goes out. */
+        if (any_in_flight(r)) {
+            return false;
+        }
+    } else {
+        while (start < r->total && (r->have[start] || index_requested(r, start))) {
+            start++;
+        }
+        if (start >= r->total) {
+            return false;
+        }
+        span = r->page_size;
+    }
+
+    if (r->requests >= ZIGBEE_LQI_REFRESH_MAX_REQUESTS) {
+        if (!any_in_flight(r)) {
+            finish(r, GATEWAY_STATUS_FAIL);
+        }
+        return false;
+    }
+
+    free_page->used = true;
+    free_page->start_index = (uint8_t)start;
+    free_page->span = span;
+    r->requests++;
+    *out_start_index = (uint8_t)start;
+    return true;
+}
+
+bool zigbee_lqi_refresh_on_page(zigbee_lqi_refresh_t *r, uint8_t start_index, uint8_t table_entries,
+                                const zigbee_neighbor_lqi_t *items, uint8_t count, uint64_t now_ms)
+{
+    zigbee_lqi_page_t *page = (r && r->state == ZIGBEE_LQI_REFRESH_STATE_RUNNING) ? find_page(r, start_index) : NULL;
+    if (!page || (count > 0 && !items)) {
+        return false;
+    }
+    memset(page, 0, sizeof(*page));
+    r->deadline_ms = now_ms + ZIGBEE_LQI_REFRESH_PAGE_TIMEOUT_MS;
+
+    size_t total = table_entries < MAX_DEVICES ? table_entries : MAX_DEVICES;
+    /* An empty page inside the table means it shrank since the first page: stop there. */
+    if (count == 0 && start_index < total) {
+        total = start_index;
+    }
+    if (!r->total_known || total < r->total) {
+        r->total = (uint8_t)total;
+    }
+    r->total_known = true;
+    if (count > r->page_size) {
+        r->page_size = count;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        size_t index = (size_t)start_index + i;
+        if (index >= r->total) {
+            break;
+        }
+        r->entries[index] = items[i];
+        r->have[index] = true;
+    }
+    finish_if_complete(r);
+    return true;
+}
+
+bool zigbee_lqi_refresh_on_error(zigbee_lqi_refresh_t *r, uint8_t start_index)
+{
+    if (!r || r->state != ZIGBEE_LQI_REFRESH_STATE_RUNNING || !find_page(r, start_index)) {
+        return false;
+    }
+    finish(r, GATEWAY_STATUS_FAIL);
+    return true;
+}
+
+void zigbee_lqi_refresh_tick(zigbee_lqi_refresh_t *r, uint64_t now_ms)
+{
+    if (r && r->state == ZIGBEE_LQI_REFRESH_STATE_RUNNING && r->deadline_ms <= now_ms) {
+        finish(r, GATEWAY_STATUS_TIMEOUT);
+    }
+}
+
+uint64_t zigbee_lqi_refresh_deadline_ms(const zigbee_lqi_refresh_t *r)
+{
+    if (!r || r->state != ZIGBEE_LQI_REFRESH_STATE_RUNNING) {
+        return ZIGBEE_LQI_REFRESH_IDLE;
+    }
+    return r->deadline_ms;
+}
+
+bool zigbee_lqi_refresh_result(const zigbee_lqi_refresh_t *r, gateway_status_t *out_status, size_t *out_count)
+{
+    if (!r || !out_status || !out_count || r->state != ZIGBEE_LQI_REFRESH_STATE_DONE) {
+        return false;
+    }
+    *out_status = r->status;
+    *out_count = r->status == GATEWAY_STATUS_OK ? r->total : 0;
+    return true;
+}
@@ -1,14 +1,23 @@
 #include "zigbee_service.h"
 
+#include <stdatomic.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "gateway_status_esp.h"
 #include "state_store.h"
+#include "zigbee_cmd_scheduler.h"
+#include "zigbee_group_rules.h"
+#include "zigbee_interview.h"
+#include "zigbee_lqi_refresh.h"
+#include "zigbee_topology_crawl.h"
+#include "esp_random.h"
 #include "esp_timer.h"
 #include "esp_zigbee_core.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "nwk/esp_zigbee_nwk.h"
 #include "zdo/esp_zigbee_zdo_command.h"
 
@@ -16,6 +25,36 @@ struct zigbee_service {
     device_service_handle_t device_service;
     gateway_state_handle_t gateway_state;
     const zigbee_service_runtime_ops_t *runtime_ops;
+    uint32_t boot_epoch;
+    const zigbee_group_repo_port_t *group_repo;
+    SemaphoreHandle_t groups_lock;
+    zigbee_group_t groups[GATEWAY_MAX_GROUPS];
+    int group_count;
+    /*
+     * Lock order: the Zigbee stack lock before cmd_lock, never the reverse. The Zigbee task takes none of
+     * the service locks: its callbacks and timers reach the service through the runtime's event task.
+     */
+    SemaphoreHandle_t cmd_lock;
+    zigbee_cmd_scheduler_t cmd_sched;
+    /* Same order for lqi_lock; the gateway_state lock is a leaf under both. */
+    SemaphoreHandle_t lqi_lock;
+    zigbee_lqi_refresh_t lqi_refresh;
+    uint16_t lqi_dst_addr;
+    zigbee_service_done_fn_t lqi_done;
+    void *lqi_done_ctx;
+    /* Same order again; the crawl arena is allocated on the first crawl and kept. */
+    SemaphoreHandle_t topo_lock;
+    zigbee_topology_crawl_t *topo;
+    zigbee_service_done_fn_t topo_done;
+    void *topo_done_ctx;
+    /* Same order for interview_lock; the Zigbee task never takes interview_cache_lock, which guards NVS writes. */
+    SemaphoreHandle_t interview_lock;
+    zigbee_interview_t interview;
+    const zigbee_interview_repo_port_t *interview_repo;
+    SemaphoreHandle_t interview_cache_lock;
+    gateway_device_interview_t interviews[GATEWAY_MAX_DEVICES];
+    int interview_count;
+    uint32_t interview_generation;
 };
 
 static esp_err_t runtime_send_on_off_not_supported(uint16_t short_addr, uint8_t endpoint, uint8_t on_off)
@@ -45,11 +84,56 @@ static const zigbee_service_runtime_ops_t s_default_runtime_ops = {
     .rename_device = runtime_rename_device_not_supported,
 };
 
+static void cmd_completed(void *ctx, const zigbee_cmd_completion_t *completion)
+{
+    zigbee_service_handle_t handle = (zigbee_service_handle_t)ctx;
+    switch (completion->status) {
+    case GATEWAY_STATUS_OK:
+        (void)gateway_state_record_cmd(handle->gateway_state, completion->short_addr, GATEWAY_CMD_EVENT_ACKED,
+                                       completion->rtt_ms);
+        break;
+    case GATEWAY_STATUS_FAIL:
+        (void)gateway_state_record_cmd(handle->gateway_state, completion->short_addr, GATEWAY_CMD_EVENT_FAILED,
+                                       completion->rtt_ms);
+        break;
+    case GATEWAY_STATUS_TIMEOUT:
+        (void)gateway_state_record_cmd(handle->gateway_state, completion->short_addr, GATEWAY_CMD_EVENT_TIMEOUT, 0);
+        break;
+    default:
+        /* Superseded before it went out: not a link outcome. */
+        break;
+    }
+    if (completion->waiter) {
+        xTaskNotifyGive((TaskHandle_t)completion->waiter);
+    }
+}
+
 static bool service_ready(zigbee_service_handle_t handle)
 {
     return handle && handle->device_service && handle->gateway_state;
 }
 
+/*
+ * ZDP callbacks carry only the request token, so they find the service through an owner slot.
+ * The first instance to send claims it; another one is refused until the owner lets go.
+ */
+typedef _Atomic(zigbee_service_handle_t) zdo_owner_t;
+
+static zdo_owner_t s_interview_owner;
+static zdo_owner_t s_topology_owner;
+
+static bool zdo_claim_owner(zdo_owner_t *owner, zigbee_service_handle_t handle)
+{
+    zigbee_service_handle_t expected = NULL;
+    return atomic_compare_exchange_strong(owner, &expected, handle) || expected == handle;
+}
+
+static void zdo_release_owner(zdo_owner_t *owner, zigbee_service_handle_t handle)
+{
+    zigbee_service_handle_t expected = handle;
+    (void)atomic_compare_exchange_strong(owner, &expected, NULL);
+}
+
 esp_err_t zigbee_service_create(const zigbee_service_init_params_t *params, zigbee_service_handle_t *out_handle)
 {
     if (!params || !params->device_service || !params->gateway_state || !out_handle) {
@@ -64,12 +148,66 @@ esp_err_t zigbee_service_create(const zigbee_service_init_params_t *params, zigb
     handle->device_service = params->device_service;
     handle->gateway_state = params->gateway_state;
     handle->runtime_ops = params->runtime_ops ? params->runtime_ops : &s_default_runtime_ops;
+    handle->boot_epoch = esp_random();
+    handle->group_repo = params->group_repo;
+    handle->groups_lock = xSemaphoreCreateMutex();
+    handle->cmd_lock = xSemaphoreCreateMutex();
+    handle->lqi_lock = xSemaphoreCreateMutex();
+    handle->topo_lock = xSemaphoreCreateMutex();
+    handle->interview_repo = params->interview_repo;
+    handle->interview_lock = xSemaphoreCreateMutex();
+    handle->interview_cache_lock = xSemaphoreCreateMutex();
+    if (!handle->groups_lock || !handle->cmd_lock || !handle->lqi_lock || !handle->topo_lock ||
+        !handle->interview_lock || !handle->interview_cache_lock) {
+        zigbee_service_destroy(handle);
+        return ESP_ERR_NO_MEM;
+    }
+    zigbee_cmd_scheduler_init(&handle->cmd_sched, cmd_completed, handle);
+    if (handle->group_repo && handle->group_repo->load &&
+        handle->group_repo->load(handle->group_repo->ctx, handle->groups, GATEWAY_MAX_GROUPS, &handle->group_count) !=
+            GATEWAY_STATUS_OK) {
+        /* A damaged table must not block the stack; groups are recreated from the UI. */
+        memset(handle->groups, 0, sizeof(handle->groups));
+        handle->group_count = 0;
+    }
+    zigbee_interview_init(&handle->interview);
+    if (handle->interview_repo && handle->interview_repo->load &&
+        handle->interview_repo->load(handle->interview_repo->ctx, handle->interviews, GATEWAY_MAX_DEVICES,
+                                     &handle->interview_count) != GATEWAY_STATUS_OK) {
+        /* Lost descriptors only cost one interview per device on its next announce. */
+        memset(handle->interviews, 0, sizeof(handle->interviews));
+        handle->interview_count = 0;
+    }
     *out_handle = handle;
     return ESP_OK;
 }
 
 void zigbee_service_destroy(zigbee_service_handle_t handle)
 {
+    if (!handle) {
+        return;
+    }
+    if (handle->groups_lock) {
+        vSemaphoreDelete(handle->groups_lock);
+    }
+    if (handle->cmd_lock) {
+        vSemaphoreDelete(handle->cmd_lock);
+    }
+    if (handle->lqi_lock) {
+        vSemaphoreDelete(handle->lqi_lock);
+    }
+    if (handle->topo_lock) {
+        vSemaphoreDelete(handle->topo_lock);
+    }
+    if (handle->interview_lock) {
+        vSemaphoreDelete(handle->interview_lock);
+    }
+    if (handle->interview_cache_lock) {
+        vSemaphoreDelete(handle->interview_cache_lock);
+    }
+    zdo_release_owner(&s_interview_owner, handle);
+    zdo_release_owner(&s_topology_owner, handle);
+    free(handle->topo);
     free(handle);
 }
 
@@ -143,12 +281,163 @@ esp_err_t zigbee_service_permit_join(zigbee_service_handle_t handle, uint16_t se
     return ESP_OK;
 }
 
+static bool cmd_scheduler_enabled(zigbee_service_handle_t handle)
+{
+    return handle->cmd_lock && handle->runtime_ops->transmit_on_off && handle->runtime_ops->schedule_cmd_pump;
+}
+
+static uint64_t cmd_now_ms(void)
+{
+    return (uint64_t)(esp_timer_get_time() / 1000);
+}
+
+static void cmd_kick(zigbee_service_handle_t handle)
+{
+    /* A failed kick is not fatal: the queue is drained on the next pump. */
+    (void)handle->runtime_ops->schedule_cmd_pump(0);
+}
+
+static esp_err_t cmd_submit_locked(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint,
+                                   uint8_t on_off, void *waiter, uint32_t *out_ticket)
+{
+    zigbee_on_off_cmd_t cmd = {
+        .short_addr = short_addr,
+        .endpoint = endpoint,
+        .on_off = on_off,
+    };
+    return gateway_status_to_esp_err(
+        zigbee_cmd_scheduler_submit(&handle->cmd_sched, &cmd, cmd_now_ms(), waiter, out_ticket));
+}
+
 esp_err_t zigbee_service_send_on_off(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint, uint8_t on_off)
 {
     if (!handle || !handle->runtime_ops || !handle->runtime_ops->send_on_off) {
         return ESP_ERR_INVALID_STATE;
     }
-    return handle->runtime_ops->send_on_off(short_addr, endpoint, on_off);
+    if (!cmd_scheduler_enabled(handle)) {
+        return handle->runtime_ops->send_on_off(short_addr, endpoint, on_off);
+    }
+
+    uint32_t ticket = 0;
+    xSemaphoreTake(handle->cmd_lock, portMAX_DELAY);
+    esp_err_t ret = cmd_submit_locked(handle, short_addr, endpoint, on_off, NULL, &ticket);
+    xSemaphoreGive(handle->cmd_lock);
+    if (ret == ESP_OK) {
+        cmd_kick(handle);
+    }
+    return ret;
+}
+
+esp_err_t zigbee_service_send_on_off_confirmed(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint,
+                                               uint8_t on_off, uint32_t timeout_ms)
+{
+    if (!handle || !handle->runtime_ops) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!cmd_scheduler_enabled(handle)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    void *waiter = xTaskGetCurrentTaskHandle();
+    uint32_t ticket = 0;
+    xSemaphoreTake(handle->cmd_lock, portMAX_DELAY);
+    esp_err_t ret = cmd_submit_locked(handle, short_addr, endpoint, on_off, waiter, &ticket);
+    xSemaphoreGive(handle->cmd_lock);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    cmd_kick(handle);
+
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(timeout_ms);
+    for (;;) {
+        gateway_status_t status;
+        xSemaphoreTake(handle->cmd_lock, portMAX_DELAY);
+        bool done = zigbee_cmd_scheduler_result(&handle->cmd_sched, ticket, &status);
+        if (!done && (int32_t)(deadline - xTaskGetTickCount()) <= 0) {
+            /* Give up waiting, not the command: it keeps its retries, just without a listener. */
+            zigbee_cmd_scheduler_detach_waiter(&handle->cmd_sched, ticket);
+            xSemaphoreGive(handle->cmd_lock);
+            return ESP_ERR_TIMEOUT;
+        }
+        xSemaphoreGive(handle->cmd_lock);
+        if (done) {
+            return gateway_status_to_esp_err(status);
+        }
+        TickType_t now = xTaskGetTickCount();
+        (void)ulTaskNotifyTake(pdTRUE, (int32_t)(deadline - now) > 0 ? deadline - now : 0);
+    }
+}
+
+void zigbee_service_cmd_pump(zigbee_service_handle_t handle)
+{
+    if (!handle || !handle->runtime_ops || !cmd_scheduler_enabled(handle)) {
+        return;
+    }
+
+    xSemaphoreTake(handle->cmd_lock, portMAX_DELAY);
+    uint64_t now = cmd_now_ms();
+    zigbee_cmd_scheduler_tick(&handle->cmd_sched, now);
+    uint32_t ticket;
+    zigbee_on_off_cmd_t cmd;
+    while (zigbee_cmd_scheduler_next(&handle->cmd_sched, now, &ticket, &cmd)) {
+        uint8_t tsn = 0;
+        esp_err_t ret = handle->runtime_ops->transmit_on_off(&cmd, &tsn);
+        zigbee_cmd_scheduler_on_sent(&handle->cmd_sched, ticket, ret == ESP_OK, tsn, now);
+        if (ret == ESP_OK) {
+            (void)gateway_state_record_cmd(handle->gateway_state, cmd.short_addr, GATEWAY_CMD_EVENT_SENT, 0);
+        }
+    }
+    uint64_t due = zigbee_cmd_scheduler_next_due_ms(&handle->cmd_sched);
+    xSemaphoreGive(handle->cmd_lock);
+
+    if (due != ZIGBEE_CMD_SCHED_IDLE) {
+        (void)handle->runtime_ops->schedule_cmd_pump(due > now ? (uint32_t)(due - now) : 0);
+    }
+}
+
+void zigbee_service_on_cmd_response(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t tsn, bool success)
+{
+    if (!handle || !handle->runtime_ops || !cmd_scheduler_enabled(handle)) {
+        return;
+    }
+
+    xSemaphoreTake(handle->cmd_lock, portMAX_DELAY);
+    bool matched = zigbee_cmd_scheduler_on_response(&handle->cmd_sched, short_addr, tsn,
+                                                    success ? GATEWAY_STATUS_OK : GATEWAY_STATUS_FAIL, cmd_now_ms());
+    xSemaphoreGive(handle->cmd_lock);
+    /* The device is free again: its next queued command need not wait for the timer. */
+    if (matched) {
+        cmd_kick(handle);
+    }
+}
+
+esp_err_t zigbee_service_send_on_off_batch(zigbee_service_handle_t handle, const zigbee_on_off_cmd_t *cmds, size_t count,
+                                           esp_err_t *out_results)
+{
+    if (!cmds || count == 0 || !out_results) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!handle || !handle->runtime_ops || !handle->runtime_ops->send_on_off) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cmd_scheduler_enabled(handle)) {
+        uint32_t ticket;
+        xSemaphoreTake(handle->cmd_lock, portMAX_DELAY);
+        for (size_t i = 0; i < count; i++) {
+            out_results[i] = cmd_submit_locked(handle, cmds[i].short_addr, cmds[i].endpoint, cmds[i].on_off, NULL,
+                                               &ticket);
+        }
+        xSemaphoreGive(handle->cmd_lock);
+        cmd_kick(handle);
+        return ESP_OK;
+    }
+    if (handle->runtime_ops->send_on_off_batch) {
+        return handle->runtime_ops->send_on_off_batch(cmds, count, out_results);
+    }
+    for (size_t i = 0; i < count; i++) {
+        out_results[i] = handle->runtime_ops->send_on_off(cmds[i].short_addr, cmds[i].endpoint, cmds[i].on_off);
+    }
+    return ESP_OK;
 }
 
 int zigbee_service_get_devices_snapshot(zigbee_service_handle_t handle, zb_device_t *out, size_t max_items)
@@ -159,6 +448,74 @@ int zigbee_service_get_devices_snapshot(zigbee_service_handle_t handle, zb_devic
     return device_service_get_snapshot(handle->device_service, out, max_items);
 }
 
+int zigbee_service_get_cmd_stats_snapshot(zigbee_service_handle_t handle, gateway_cmd_stats_t *out, size_t max_items)
+{
+    if (!service_ready(handle)) {
+        return 0;
+    }
+    return gateway_state_get_cmd_stats_snapshot(handle->gateway_state, out, max_items);
+}
+
+/* Data, bool, bitmap, uint, int and enum types. */
+size_t zigbee_service_zcl_scalar_width(uint8_t zcl_type)
+{
+    if (zcl_type >= 0x08 && zcl_type <= 0x0b) {
+        return (size_t)(zcl_type - 0x07);
+    }
+    if (zcl_type >= 0x18 && zcl_type <= 0x1b) {
+        return (size_t)(zcl_type - 0x17);
+    }
+    if (zcl_type >= 0x20 && zcl_type <= 0x23) {
+        return (size_t)(zcl_type - 0x1f);
+    }
+    if (zcl_type >= 0x28 && zcl_type <= 0x2b) {
+        return (size_t)(zcl_type - 0x27);
+    }
+    if (zcl_type == 0x10 || zcl_type == 0x30) {
+        return 1;
+    }
+    return zcl_type == 0x31 ? 2 : 0;
+}
+
+esp_err_t zigbee_service_on_attr_value(zigbee_service_handle_t handle, uint16_t short_addr, uint8_t endpoint,
+                                       uint16_t cluster_id, uint16_t attr_id, uint8_t zcl_type, const void *value,
+                                       size_t size, gateway_attr_source_t source, bool *out_changed)
+{
+    if (!value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!service_ready(handle)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    size_t width = zigbee_service_zcl_scalar_width(zcl_type);
+    if (width == 0 || (size != 0 && size < width)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /* Little-endian target: the low bytes of value are the attribute, the rest stay zero. */
+    gateway_attr_entry_t entry = {
+        .short_addr = short_addr,
+        .cluster_id = cluster_id,
+        .attr_id = attr_id,
+        .endpoint = endpoint,
+        .zcl_type = zcl_type,
+        .source = (uint8_t)source,
+    };
+    memcpy(&entry.value, value, width);
+    return gateway_status_to_esp_err(gateway_state_update_attr(handle->gateway_state, &entry, out_changed));
+}
+
+int zigbee_service_get_attr_snapshot(zigbee_service_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                     gateway_attr_entry_t *out, size_t max_items)
+{
+    if (!service_ready(handle)) {
+        return 0;
+    }
+    return gateway_state_get_attr_snapshot(handle->gateway_state, cluster_id, attr_id, out, max_items);
+}
+
+#define ZIGBEE_LQI_LOCK_TIMEOUT_MS 2000
+
 int zigbee_service_get_neighbor_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out, size_t max_items)
 {
     if (!out || max_items == 0) {
@@ -173,6 +530,10 @@ int zigbee_service_get_neighbor_lqi_snapshot(zigbee_service_handle_t handle, zig
         return 0;
     }
 
+    /* Callers are outside the Zigbee task; the table is read under the stack lock, the cache is updated after it. */
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_LQI_LOCK_TIMEOUT_MS))) {
+        return 0;
+    }
     esp_zb_nwk_info_iterator_t it = ESP_ZB_NWK_INFO_ITERATOR_INIT;
     int count = 0;
     uint64_t now_ms = (uint64_t)(esp_timer_get_time() / 1000);
@@ -192,64 +553,307 @@ int zigbee_service_get_neighbor_lqi_snapshot(zigbee_service_handle_t handle, zig
         out[count].source = ZIGBEE_LQI_SOURCE_NEIGHBOR_TABLE;
         count++;
     }
+    esp_zb_lock_release();
 
     update_gateway_lqi_from_snapshot(handle, out, count, ZIGBEE_LQI_SOURCE_NEIGHBOR_TABLE);
     return count;
 }
 
 typedef struct {
-    SemaphoreHandle_t done_sem;
-    zigbee_neighbor_lqi_t *out;
-    size_t max_items;
-    size_t count;
-    uint8_t next_start_index;
-    uint8_t total_entries;
+    zigbee_service_done_fn_t done;
+    void *ctx;
     esp_err_t err;
-} lqi_req_ctx_t;
+    int count;
+} service_completion_t;
 
-static void mgmt_lqi_rsp_cb(const esp_zb_zdo_mgmt_lqi_rsp_t *rsp, void *user_ctx)
+/* Called with lqi_lock held; the owner's callback runs only after the lock is dropped. */
+static bool lqi_take_completion_locked(zigbee_service_handle_t handle, service_completion_t *out)
 {
-    lqi_req_ctx_t *ctx = (lqi_req_ctx_t *)user_ctx;
-    if (!ctx) {
-        return;
+    gateway_status_t status;
+    size_t count = 0;
+    if (!handle->lqi_done || !zigbee_lqi_refresh_result(&handle->lqi_refresh, &status, &count)) {
+        return false;
+    }
+    if (status == GATEWAY_STATUS_OK) {
+        update_gateway_lqi_from_snapshot(handle, handle->lqi_refresh.entries, (int)count, ZIGBEE_LQI_SOURCE_MGMT_LQI);
     }
+    out->done = handle->lqi_done;
+    out->ctx = handle->lqi_done_ctx;
+    out->err = gateway_status_to_esp_err(status);
+    out->count = (int)count;
+    handle->lqi_done = NULL;
+    handle->lqi_done_ctx = NULL;
+    return true;
+}
 
-    if (!rsp || rsp->status != 0) {
-        ctx->err = ESP_FAIL;
-        if (ctx->done_sem) {
-            xSemaphoreGive(ctx->done_sem);
-        }
+static void mgmt_lqi_rsp_cb(const esp_zb_zdo_mgmt_lqi_rsp_t *rsp, void *user_ctx);
+
+/* Runs under the stack lock with lqi_lock held. */
+static void lqi_send_pages_locked(zigbee_service_handle_t handle)
+{
+    uint8_t start_index = 0;
+    while (zigbee_lqi_refresh_next(&handle->lqi_refresh, &start_index)) {
+        esp_zb_zdo_mgmt_lqi_req_param_t req = {
+            .start_index = start_index,
+            .dst_addr = handle->lqi_dst_addr,
+        };
+        esp_zb_zdo_mgmt_lqi_req(&req, mgmt_lqi_rsp_cb, handle);
+    }
+}
+
+/* ZDO callbacks run in the Zigbee task: they only copy the answer and hand it to the event task. */
+static void zdo_defer(zigbee_service_handle_t handle, const zigbee_event_t *event)
+{
+    if (handle->runtime_ops->post_event) {
+        /* A dropped answer is handled like a lost one: its request times out. */
+        (void)handle->runtime_ops->post_event(event);
         return;
     }
+    zigbee_service_on_zdo_event(handle, event);
+}
 
-    ctx->total_entries = rsp->neighbor_table_entries;
-    for (uint8_t i = 0; i < rsp->neighbor_table_list_count && ctx->count < ctx->max_items; i++) {
+static void mgmt_lqi_page_event(const esp_zb_zdo_mgmt_lqi_rsp_t *rsp, uint8_t kind, uint32_t token, zigbee_event_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->kind = kind;
+    out->origin_us = esp_timer_get_time();
+    out->u.lqi_page.token = token;
+    out->u.lqi_page.status = (uint8_t)rsp->status;
+    out->u.lqi_page.start_index = rsp->start_index;
+    out->u.lqi_page.total = rsp->neighbor_table_entries;
+    for (uint8_t i = 0; rsp->status == 0 && i < rsp->neighbor_table_list_count &&
+                        out->u.lqi_page.count < ZIGBEE_EVENT_LQI_PAGE_MAX;
+         i++) {
         const esp_zb_zdo_neighbor_table_list_record_t *rec = &rsp->neighbor_table_list[i];
-        ctx->out[ctx->count].short_addr = rec->network_addr;
-        ctx->out[ctx->count].lqi = (int)rec->lqi;
-        ctx->out[ctx->count].rssi = 127;
-        ctx->out[ctx->count].relationship = rec->relationship;
-        ctx->out[ctx->count].depth = rec->depth;
-        ctx->out[ctx->count].updated_ms = (uint64_t)(esp_timer_get_time() / 1000);
-        ctx->out[ctx->count].source = ZIGBEE_LQI_SOURCE_MGMT_LQI;
-        ctx->count++;
+        zigbee_event_neighbor_t *item = &out->u.lqi_page.records[out->u.lqi_page.count++];
+        item->short_addr = rec->network_addr;
+        item->lqi = rec->lqi;
+        item->relationship = rec->relationship;
+        item->depth = rec->depth;
+        item->device_type = rec->device_type;
+    }
+}
+
+static void mgmt_lqi_rsp_cb(const esp_zb_zdo_mgmt_lqi_rsp_t *rsp, void *user_ctx)
+{
+    zigbee_service_handle_t handle = (zigbee_service_handle_t)user_ctx;
+    if (!handle || !handle->lqi_lock || !rsp) {
+        return;
+    }
+    zigbee_event_t event;
+    mgmt_lqi_page_event(rsp, ZIGBEE_EVENT_LQI_PAGE, 0, &event);
+    zdo_defer(handle, &event);
+}
+
+static void lqi_apply_page(zigbee_service_handle_t handle, const zigbee_event_t *event)
+{
+    uint64_t now_ms = (uint64_t)(esp_timer_get_time() / 1000);
+    zigbee_neighbor_lqi_t items[ZIGBEE_EVENT_LQI_PAGE_MAX];
+    uint8_t count = event->u.lqi_page.count;
+    for (uint8_t i = 0; i < count; i++) {
+        const zigbee_event_neighbor_t *rec = &event->u.lqi_page.records[i];
+        items[i].short_addr = rec->short_addr;
+        items[i].lqi = (int)rec->lqi;
+        items[i].rssi = 127;
+        items[i].relationship = rec->relationship;
+        items[i].depth = rec->depth;
+        items[i].updated_ms = now_ms;
+        items[i].source = ZIGBEE_LQI_SOURCE_MGMT_LQI;
+    }
+
+    /* The next pages go on air from here, so the stack lock comes first; without it the refresh times out. */
+    bool stack_locked = esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_LQI_LOCK_TIMEOUT_MS));
+    service_completion_t completion;
+    xSemaphoreTake(handle->lqi_lock, portMAX_DELAY);
+    if (event->u.lqi_page.status != 0) {
+        (void)zigbee_lqi_refresh_on_error(&handle->lqi_refresh, event->u.lqi_page.start_index);
+    } else if (zigbee_lqi_refresh_on_page(&handle->lqi_refresh, event->u.lqi_page.start_index,
+                                          event->u.lqi_page.total, items, count, now_ms) &&
+               stack_locked) {
+        lqi_send_pages_locked(handle);
+    }
+    bool finished = lqi_take_completion_locked(handle, &completion);
+    xSemaphoreGive(handle->lqi_lock);
+    if (stack_locked) {
+        esp_zb_lock_release();
+    }
+
+    if (finished) {
+        completion.done(completion.ctx, completion.err, completion.count);
+    }
+}
+
+esp_err_t zigbee_service_start_lqi_refresh(zigbee_service_handle_t handle, zigbee_service_done_fn_t done, void *ctx)
+{
+    if (!done) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!service_ready(handle) || !handle->lqi_lock) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    gateway_network_state_t state = {0};
+    esp_err_t sret = gateway_status_to_esp_err(gateway_state_get_network(handle->gateway_state, &state));
+    if (sret != ESP_OK || !state.zigbee_started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_LQI_LOCK_TIMEOUT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    xSemaphoreTake(handle->lqi_lock, portMAX_DELAY);
+    esp_err_t ret = ESP_OK;
+    if (handle->lqi_done) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        zigbee_lqi_refresh_begin(&handle->lqi_refresh, (uint64_t)(esp_timer_get_time() / 1000));
+        handle->lqi_dst_addr = (uint16_t)state.short_addr;
+        handle->lqi_done = done;
+        handle->lqi_done_ctx = ctx;
+        lqi_send_pages_locked(handle);
+    }
+    xSemaphoreGive(handle->lqi_lock);
+    esp_zb_lock_release();
+    return ret;
+}
+
+uint64_t zigbee_service_lqi_refresh_tick(zigbee_service_handle_t handle)
+{
+    if (!handle || !handle->lqi_lock) {
+        return ZIGBEE_LQI_REFRESH_IDLE;
     }
 
-    ctx->next_start_index = (uint8_t)(rsp->start_index + rsp->neighbor_table_list_count);
-    ctx->err = ESP_OK;
-    if (ctx->done_sem) {
-        xSemaphoreGive(ctx->done_sem);
+    service_completion_t completion;
+    xSemaphoreTake(handle->lqi_lock, portMAX_DELAY);
+    zigbee_lqi_refresh_tick(&handle->lqi_refresh, (uint64_t)(esp_timer_get_time() / 1000));
+    bool finished = lqi_take_completion_locked(handle, &completion);
+    uint64_t deadline = zigbee_lqi_refresh_deadline_ms(&handle->lqi_refresh);
+    xSemaphoreGive(handle->lqi_lock);
+
+    if (finished) {
+        completion.done(completion.ctx, completion.err, completion.count);
     }
+    return deadline;
 }
 
-esp_err_t zigbee_service_refresh_neighbor_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out,
-                                                       size_t max_items, int *out_count)
+esp_err_t zigbee_service_get_lqi_refresh_result(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out,
+                                                size_t max_items, int *out_count)
 {
     if (!out || max_items == 0 || !out_count) {
         return ESP_ERR_INVALID_ARG;
     }
     *out_count = 0;
-    if (!service_ready(handle)) {
+    if (!handle || !handle->lqi_lock) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    gateway_status_t status;
+    size_t count = 0;
+    xSemaphoreTake(handle->lqi_lock, portMAX_DELAY);
+    bool done = zigbee_lqi_refresh_result(&handle->lqi_refresh, &status, &count);
+    if (done && status == GATEWAY_STATUS_OK) {
+        count = count < max_items ? count : max_items;
+        memcpy(out, handle->lqi_refresh.entries, count * sizeof(out[0]));
+        *out_count = (int)count;
+    }
+    xSemaphoreGive(handle->lqi_lock);
+    if (!done) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return gateway_status_to_esp_err(status);
+}
+
+/* Mgmt_Lqi responses carry only the request token; the crawl owner slot is released when the crawl ends. */
+static void topology_rsp_cb(const esp_zb_zdo_mgmt_lqi_rsp_t *rsp, void *user_ctx);
+
+/* Runs under the stack lock with topo_lock held. */
+static void topology_send_locked(zigbee_service_handle_t handle, uint64_t now_ms)
+{
+    uint32_t token = 0;
+    uint16_t dst_addr = 0;
+    uint8_t start_index = 0;
+    while (zigbee_topology_crawl_next(handle->topo, now_ms, &token, &dst_addr, &start_index)) {
+        esp_zb_zdo_mgmt_lqi_req_param_t req = {
+            .start_index = start_index,
+            .dst_addr = dst_addr,
+        };
+        esp_zb_zdo_mgmt_lqi_req(&req, topology_rsp_cb, (void *)(uintptr_t)token);
+    }
+}
+
+static bool topology_take_completion_locked(zigbee_service_handle_t handle, service_completion_t *out)
+{
+    if (!handle->topo_done || !handle->topo || handle->topo->summary.state == GATEWAY_TOPOLOGY_CRAWL_RUNNING) {
+        return false;
+    }
+    out->done = handle->topo_done;
+    out->ctx = handle->topo_done_ctx;
+    out->err = handle->topo->summary.state == GATEWAY_TOPOLOGY_CRAWL_DONE ? ESP_OK : ESP_FAIL;
+    out->count = handle->topo->summary.node_count;
+    handle->topo_done = NULL;
+    handle->topo_done_ctx = NULL;
+    zdo_release_owner(&s_topology_owner, handle);
+    return true;
+}
+
+static void topology_rsp_cb(const esp_zb_zdo_mgmt_lqi_rsp_t *rsp, void *user_ctx)
+{
+    zigbee_service_handle_t handle = atomic_load(&s_topology_owner);
+    if (!handle || !handle->topo || !rsp) {
+        return;
+    }
+    zigbee_event_t event;
+    mgmt_lqi_page_event(rsp, ZIGBEE_EVENT_TOPOLOGY_PAGE, (uint32_t)(uintptr_t)user_ctx, &event);
+    zdo_defer(handle, &event);
+}
+
+static void topology_apply_page(zigbee_service_handle_t handle, const zigbee_event_t *event)
+{
+    if (!handle->topo_lock || !handle->topo) {
+        return;
+    }
+    zigbee_topology_neighbor_t items[ZIGBEE_EVENT_LQI_PAGE_MAX];
+    uint8_t count = event->u.lqi_page.count;
+    for (uint8_t i = 0; i < count; i++) {
+        const zigbee_event_neighbor_t *rec = &event->u.lqi_page.records[i];
+        items[i].short_addr = rec->short_addr;
+        items[i].device_type = rec->device_type;
+        items[i].relationship = rec->relationship;
+        items[i].depth = rec->depth;
+        items[i].lqi = rec->lqi;
+    }
+
+    /* Same as the tick: without the stack lock only the page is recorded and the tick sends later. */
+    bool stack_locked = esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_LQI_LOCK_TIMEOUT_MS));
+    uint64_t now_ms = (uint64_t)(esp_timer_get_time() / 1000);
+    uint32_t token = event->u.lqi_page.token;
+    service_completion_t completion;
+    xSemaphoreTake(handle->topo_lock, portMAX_DELAY);
+    if (event->u.lqi_page.status != 0) {
+        (void)zigbee_topology_crawl_on_error(handle->topo, token, now_ms);
+    } else {
+        (void)zigbee_topology_crawl_on_page(handle->topo, token, event->u.lqi_page.total, items, count, now_ms);
+    }
+    if (stack_locked) {
+        topology_send_locked(handle, now_ms);
+    }
+    bool finished = topology_take_completion_locked(handle, &completion);
+    xSemaphoreGive(handle->topo_lock);
+    if (stack_locked) {
+        esp_zb_lock_release();
+    }
+
+    if (finished) {
+        completion.done(completion.ctx, completion.err, completion.count);
+    }
+}
+
+esp_err_t zigbee_service_start_topology_crawl(zigbee_service_handle_t handle, zigbee_service_done_fn_t done, void *ctx)
+{
+    if (!done) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!service_ready(handle) || !handle->topo_lock) {
         return ESP_ERR_INVALID_STATE;
     }
 
@@ -259,56 +863,463 @@ esp_err_t zigbee_service_refresh_neighbor_lqi_snapshot(zigbee_service_handle_t h
         return ESP_ERR_INVALID_STATE;
     }
 
-    memset(out, 0, sizeof(zigbee_neighbor_lqi_t) * max_items);
+    if (!esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_LQI_LOCK_TIMEOUT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    xSemaphoreTake(handle->topo_lock, portMAX_DELAY);
+    esp_err_t ret = ESP_OK;
+    if (!handle->topo) {
+        handle->topo = (zigbee_topology_crawl_t *)calloc(1, sizeof(*handle->topo));
+    }
+    if (!handle->topo) {
+        ret = ESP_ERR_NO_MEM;
+    } else if (handle->topo_done || !zdo_claim_owner(&s_topology_owner, handle)) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        uint64_t now_ms = (uint64_t)(esp_timer_get_time() / 1000);
+        zigbee_topology_crawl_begin(handle->topo, (uint16_t)state.short_addr, now_ms);
+        handle->topo_done = done;
+        handle->topo_done_ctx = ctx;
+        topology_send_locked(handle, now_ms);
+    }
+    xSemaphoreGive(handle->topo_lock);
+    esp_zb_lock_release();
+    return ret;
+}
+
+uint64_t zigbee_service_topology_tick(zigbee_service_handle_t handle)
+{
+    if (!handle || !handle->topo_lock || !handle->topo) {
+        return ZIGBEE_TOPOLOGY_IDLE;
+    }
+
+    /* Retries go on air from here, so the stack lock comes first; without it only timeouts advance. */
+    bool stack_locked = esp_zb_lock_acquire(pdMS_TO_TICKS(ZIGBEE_LQI_LOCK_TIMEOUT_MS));
+    uint64_t now_ms = (uint64_t)(esp_timer_get_time() / 1000);
+    service_completion_t completion;
+    xSemaphoreTake(handle->topo_lock, portMAX_DELAY);
+    zigbee_topology_crawl_tick(handle->topo, now_ms);
+    if (stack_locked) {
+        topology_send_locked(handle, now_ms);
+    }
+    bool finished = topology_take_completion_locked(handle, &completion);
+    uint64_t due = zigbee_topology_crawl_next_due_ms(handle->topo);
+    xSemaphoreGive(handle->topo_lock);
+    if (stack_locked) {
+        esp_zb_lock_release();
+    }
+
+    if (finished) {
+        completion.done(completion.ctx, completion.err, completion.count);
+    }
+    return due;
+}
+
+esp_err_t zigbee_service_get_topology_summary(zigbee_service_handle_t handle, gateway_topology_summary_t *out)
+{
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!handle || !handle->topo_lock) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    memset(out, 0, sizeof(*out));
+    xSemaphoreTake(handle->topo_lock, portMAX_DELAY);
+    if (handle->topo) {
+        *out = handle->topo->summary;
+    }
+    xSemaphoreGive(handle->topo_lock);
+    return ESP_OK;
+}
+
+int zigbee_service_get_topology_nodes(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                      gateway_topology_node_t *out, size_t max_items)
+{
+    if (!handle || !handle->topo_lock || !out) {
+        return -1;
+    }
+    int count = -1;
+    xSemaphoreTake(handle->topo_lock, portMAX_DELAY);
+    if (handle->topo && handle->topo->summary.crawl_id == crawl_id) {
+        size_t available = from < handle->topo->summary.node_count ? handle->topo->summary.node_count - from : 0;
+        count = (int)(available < max_items ? available : max_items);
+        if (count > 0) {
+            memcpy(out, &handle->topo->nodes[from], (size_t)count * sizeof(out[0]));
+        }
+    }
+    xSemaphoreGive(handle->topo_lock);
+    return count;
+}
+
+int zigbee_service_get_topology_edges(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                      gateway_topology_edge_t *out, size_t max_items)
+{
+    if (!handle || !handle->topo_lock || !out) {
+        return -1;
+    }
+    int count = -1;
+    xSemaphoreTake(handle->topo_lock, portMAX_DELAY);
+    if (handle->topo && handle->topo->summary.crawl_id == crawl_id) {
+        size_t available = from < handle->topo->summary.edge_count ? handle->topo->summary.edge_count - from : 0;
+        count = (int)(available < max_items ? available : max_items);
+        if (count > 0) {
+            memcpy(out, &handle->topo->edges[from], (size_t)count * sizeof(out[0]));
+        }
+    }
+    xSemaphoreGive(handle->topo_lock);
+    return count;
+}
+
+static bool interview_enabled(zigbee_service_handle_t handle)
+{
+    return handle && handle->interview_lock && handle->runtime_ops->read_basic_identity &&
+           handle->runtime_ops->schedule_interview_pump;
+}
+
+static void interview_kick(zigbee_service_handle_t handle)
+{
+    /* A failed kick is not fatal: the next announce or answer schedules the pump again. */
+    (void)handle->runtime_ops->schedule_interview_pump(0);
+}
+
+static void interview_active_ep_cb(esp_zb_zdp_status_t zdo_status, uint8_t ep_count, uint8_t *ep_id_list,
+                                   void *user_ctx)
+{
+    zigbee_service_handle_t handle = atomic_load(&s_interview_owner);
+    if (!handle) {
+        return;
+    }
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_ACTIVE_EP,
+        .origin_us = esp_timer_get_time(),
+    };
+    event.u.active_ep.token = (uint32_t)(uintptr_t)user_ctx;
+    event.u.active_ep.status = (uint8_t)zdo_status;
+    event.u.active_ep.count = ep_count < ZIGBEE_EVENT_ACTIVE_EP_MAX ? ep_count : ZIGBEE_EVENT_ACTIVE_EP_MAX;
+    if (ep_id_list) {
+        memcpy(event.u.active_ep.endpoints, ep_id_list, event.u.active_ep.count);
+    } else {
+        event.u.active_ep.count = 0;
+    }
+    zdo_defer(handle, &event);
+}
+
+static void interview_simple_desc_cb(esp_zb_zdp_status_t zdo_status, esp_zb_af_simple_desc_1_1_t *simple_desc,
+                                     void *user_ctx)
+{
+    zigbee_service_handle_t handle = atomic_load(&s_interview_owner);
+    if (!handle) {
+        return;
+    }
 
-    lqi_req_ctx_t ctx = {
-        .done_sem = xSemaphoreCreateBinary(),
-        .out = out,
-        .max_items = max_items,
-        .count = 0,
-        .next_start_index = 0,
-        .total_entries = 0,
-        .err = ESP_FAIL,
+    zigbee_event_t event = {
+        .kind = ZIGBEE_EVENT_SIMPLE_DESC,
+        .origin_us = esp_timer_get_time(),
     };
-    if (!ctx.done_sem) {
-        return ESP_ERR_NO_MEM;
+    event.u.simple_desc.token = (uint32_t)(uintptr_t)user_ctx;
+    event.u.simple_desc.ok = zdo_status == ESP_ZB_ZDP_STATUS_SUCCESS && simple_desc;
+    if (event.u.simple_desc.ok) {
+        gateway_endpoint_desc_t *desc = &event.u.simple_desc.desc;
+        /* The descriptor is packed: input clusters first, output clusters right after, read bytewise. */
+        const uint8_t *clusters = (const uint8_t *)simple_desc + offsetof(esp_zb_af_simple_desc_1_1_t, app_cluster_list);
+        uint8_t in_total = simple_desc->app_input_cluster_count;
+        desc->endpoint = simple_desc->endpoint;
+        desc->profile_id = simple_desc->app_profile_id;
+        desc->device_id = simple_desc->app_device_id;
+        desc->in_count = in_total < GATEWAY_INTERVIEW_MAX_IN_CLUSTERS ? in_total : GATEWAY_INTERVIEW_MAX_IN_CLUSTERS;
+        desc->out_count = simple_desc->app_output_cluster_count < GATEWAY_INTERVIEW_MAX_OUT_CLUSTERS
+                              ? simple_desc->app_output_cluster_count
+                              : GATEWAY_INTERVIEW_MAX_OUT_CLUSTERS;
+        memcpy(desc->in_clusters, clusters, desc->in_count * sizeof(uint16_t));
+        memcpy(desc->out_clusters, clusters + in_total * sizeof(uint16_t), desc->out_count * sizeof(uint16_t));
     }
+    zdo_defer(handle, &event);
+}
 
-    esp_err_t ret = ESP_OK;
-    uint8_t pages = 0;
-    do {
-        esp_zb_zdo_mgmt_lqi_req_param_t req = {
-            .start_index = ctx.next_start_index,
-            .dst_addr = (uint16_t)state.short_addr,
+static void interview_apply_answer(zigbee_service_handle_t handle, const zigbee_event_t *event)
+{
+    if (!interview_enabled(handle)) {
+        return;
+    }
+    bool matched;
+    xSemaphoreTake(handle->interview_lock, portMAX_DELAY);
+    if (event->kind == ZIGBEE_EVENT_ACTIVE_EP) {
+        uint32_t token = event->u.active_ep.token;
+        matched = event->u.active_ep.status == ESP_ZB_ZDP_STATUS_SUCCESS
+                      ? zigbee_interview_on_active_ep(&handle->interview, token, event->u.active_ep.endpoints,
+                                                      event->u.active_ep.count)
+                      : zigbee_interview_on_error(&handle->interview, token);
+    } else {
+        uint32_t token = event->u.simple_desc.token;
+        matched = event->u.simple_desc.ok
+                      ? zigbee_interview_on_simple_desc(&handle->interview, token, &event->u.simple_desc.desc)
+                      : zigbee_interview_on_error(&handle->interview, token);
+    }
+    xSemaphoreGive(handle->interview_lock);
+    if (matched) {
+        interview_kick(handle);
+    }
+}
+
+/* Runs under the stack lock with interview_lock held. A send that never left times out like a lost answer. */
+static void interview_send_locked(zigbee_service_handle_t handle, const zigbee_interview_request_t *req)
+{
+    switch (req->kind) {
+    case ZIGBEE_INTERVIEW_REQ_ACTIVE_EP: {
+        esp_zb_zdo_active_ep_req_param_t param = {
+            .addr_of_interest = req->short_addr,
+        };
+        esp_zb_zdo_active_ep_req(&param, interview_active_ep_cb, (void *)(uintptr_t)req->token);
+        break;
+    }
+    case ZIGBEE_INTERVIEW_REQ_SIMPLE_DESC: {
+        esp_zb_zdo_simple_desc_req_param_t param = {
+            .addr_of_interest = req->short_addr,
+            .endpoint = req->endpoint,
         };
+        esp_zb_zdo_simple_desc_req(&param, interview_simple_desc_cb, (void *)(uintptr_t)req->token);
+        break;
+    }
+    default:
+        (void)handle->runtime_ops->read_basic_identity(req->short_addr, req->endpoint);
+        break;
+    }
+}
 
-        if (!esp_zb_lock_acquire(pdMS_TO_TICKS(2000))) {
-            ret = ESP_ERR_TIMEOUT;
-            break;
+bool zigbee_service_interview_pump(zigbee_service_handle_t handle)
+{
+    if (!interview_enabled(handle) || !zdo_claim_owner(&s_interview_owner, handle)) {
+        return false;
+    }
+
+    uint64_t now_ms = (uint64_t)(esp_timer_get_time() / 1000);
+    zigbee_interview_request_t req;
+    xSemaphoreTake(handle->interview_lock, portMAX_DELAY);
+    zigbee_interview_tick(&handle->interview, now_ms);
+    if (zigbee_interview_next(&handle->interview, now_ms, &req)) {
+        interview_send_locked(handle, &req);
+    }
+    bool finished = handle->interview.step == ZIGBEE_INTERVIEW_STEP_FINISHED;
+    uint64_t due = zigbee_interview_next_due_ms(&handle->interview);
+    xSemaphoreGive(handle->interview_lock);
+
+    if (due != ZIGBEE_INTERVIEW_IDLE) {
+        (void)handle->runtime_ops->schedule_interview_pump(due > now_ms ? (uint32_t)(due - now_ms) : 0);
+    }
+    return finished;
+}
+
+void zigbee_service_interview_on_basic(zigbee_service_handle_t handle, uint16_t short_addr, const char *manufacturer,
+                                       const char *model)
+{
+    if (!interview_enabled(handle)) {
+        return;
+    }
+    xSemaphoreTake(handle->interview_lock, portMAX_DELAY);
+    bool matched = zigbee_interview_on_basic(&handle->interview, short_addr, manufacturer, model);
+    xSemaphoreGive(handle->interview_lock);
+    if (matched) {
+        interview_kick(handle);
+    }
+}
+
+void zigbee_service_on_zdo_event(zigbee_service_handle_t handle, const zigbee_event_t *event)
+{
+    if (!handle || !event) {
+        return;
+    }
+    switch (event->kind) {
+    case ZIGBEE_EVENT_LQI_PAGE:
+        if (handle->lqi_lock) {
+            lqi_apply_page(handle, event);
         }
-        esp_zb_zdo_mgmt_lqi_req(&req, mgmt_lqi_rsp_cb, &ctx);
-        esp_zb_lock_release();
+        break;
+    case ZIGBEE_EVENT_TOPOLOGY_PAGE:
+        topology_apply_page(handle, event);
+        break;
+    case ZIGBEE_EVENT_ACTIVE_EP:
+    case ZIGBEE_EVENT_SIMPLE_DESC:
+        interview_apply_answer(handle, event);
+        break;
+    default:
+        break;
+    }
+}
 
-        if (xSemaphoreTake(ctx.done_sem, pdMS_TO_TICKS(3500)) != pdTRUE) {
-            ret = ESP_ERR_TIMEOUT;
-            break;
+static int interview_find_ieee_locked(zigbee_service_handle_t handle, const gateway_ieee_addr_t ieee_addr)
+{
+    for (int i = 0; i < handle->interview_count; i++) {
+        if (memcmp(handle->interviews[i].ieee_addr, ieee_addr, sizeof(gateway_ieee_addr_t)) == 0) {
+            return i;
         }
-        if (ctx.err != ESP_OK) {
-            ret = ctx.err;
-            break;
+    }
+    return -1;
+}
+
+static void interview_remove_locked(zigbee_service_handle_t handle, int index)
+{
+    handle->interview_count--;
+    memmove(&handle->interviews[index], &handle->interviews[index + 1],
+            (size_t)(handle->interview_count - index) * sizeof(handle->interviews[0]));
+    memset(&handle->interviews[handle->interview_count], 0, sizeof(handle->interviews[0]));
+}
+
+/* An address now owned by another IEEE belongs to a device that has since left. */
+static void interview_drop_stale_addr_locked(zigbee_service_handle_t handle, uint16_t short_addr,
+                                             const gateway_ieee_addr_t ieee_addr)
+{
+    for (int i = handle->interview_count - 1; i >= 0; i--) {
+        if (handle->interviews[i].short_addr == short_addr &&
+            memcmp(handle->interviews[i].ieee_addr, ieee_addr, sizeof(gateway_ieee_addr_t)) != 0) {
+            interview_remove_locked(handle, i);
         }
-        pages++;
-    } while (ctx.next_start_index < ctx.total_entries && ctx.count < max_items && pages < 8);
+    }
+}
 
-    if (ret == ESP_OK) {
-        *out_count = (int)ctx.count;
-        update_gateway_lqi_from_snapshot(handle, out, *out_count, ZIGBEE_LQI_SOURCE_MGMT_LQI);
+static esp_err_t interview_save_locked(zigbee_service_handle_t handle)
+{
+    handle->interview_generation++;
+    if (!handle->interview_repo || !handle->interview_repo->save) {
+        return ESP_OK;
+    }
+    return gateway_status_to_esp_err(handle->interview_repo->save(handle->interview_repo->ctx, handle->interviews,
+                                                                  GATEWAY_MAX_DEVICES, handle->interview_count));
+}
+
+esp_err_t zigbee_service_on_device_announce(zigbee_service_handle_t handle, uint16_t short_addr,
+                                            const gateway_ieee_addr_t ieee_addr, bool *out_changed)
+{
+    if (out_changed) {
+        *out_changed = false;
+    }
+    if (!ieee_addr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!handle || !handle->interview_cache_lock) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(handle->interview_cache_lock, portMAX_DELAY);
+    int index = interview_find_ieee_locked(handle, ieee_addr);
+    bool cached = index >= 0 && handle->interviews[index].state == GATEWAY_INTERVIEW_COMPLETE;
+    if (index >= 0 && handle->interviews[index].short_addr != short_addr) {
+        /* A rejoin under a new address keeps the descriptors; only the address moves. */
+        handle->interviews[index].short_addr = short_addr;
+        interview_drop_stale_addr_locked(handle, short_addr, ieee_addr);
+        ret = interview_save_locked(handle);
+        if (out_changed) {
+            *out_changed = true;
+        }
+    }
+    xSemaphoreGive(handle->interview_cache_lock);
+    if (cached) {
+        return ret;
     }
 
-    vSemaphoreDelete(ctx.done_sem);
+    if (!interview_enabled(handle)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    xSemaphoreTake(handle->interview_lock, portMAX_DELAY);
+    bool queued = zigbee_interview_enqueue(&handle->interview, short_addr, ieee_addr);
+    xSemaphoreGive(handle->interview_lock);
+    if (!queued) {
+        return ESP_ERR_NO_MEM;
+    }
+    interview_kick(handle);
     return ret;
 }
 
+esp_err_t zigbee_service_interview_collect(zigbee_service_handle_t handle, bool *out_changed)
+{
+    if (out_changed) {
+        *out_changed = false;
+    }
+    if (!interview_enabled(handle)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (!handle->interview_cache_lock) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    gateway_device_interview_t record;
+    xSemaphoreTake(handle->interview_lock, portMAX_DELAY);
+    bool taken = zigbee_interview_take_result(&handle->interview, &record);
+    bool pending = zigbee_interview_next_due_ms(&handle->interview) != ZIGBEE_INTERVIEW_IDLE;
+    xSemaphoreGive(handle->interview_lock);
+    if (pending) {
+        interview_kick(handle);
+    }
+    if (!taken) {
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(handle->interview_cache_lock, portMAX_DELAY);
+    interview_drop_stale_addr_locked(handle, record.short_addr, record.ieee_addr);
+    int index = interview_find_ieee_locked(handle, record.ieee_addr);
+    if (index < 0 && handle->interview_count >= GATEWAY_MAX_DEVICES) {
+        /* Records are appended in interview order, so the first one is the oldest. */
+        interview_remove_locked(handle, 0);
+    }
+    if (index < 0) {
+        index = handle->interview_count++;
+    }
+    handle->interviews[index] = record;
+    esp_err_t ret = interview_save_locked(handle);
+    xSemaphoreGive(handle->interview_cache_lock);
+    if (out_changed) {
+        *out_changed = true;
+    }
+    return ret;
+}
+
+static void interview_forget(zigbee_service_handle_t handle, uint16_t short_addr)
+{
+    if (handle->interview_lock) {
+        xSemaphoreTake(handle->interview_lock, portMAX_DELAY);
+        (void)zigbee_interview_cancel(&handle->interview, short_addr);
+        xSemaphoreGive(handle->interview_lock);
+    }
+    if (!handle->interview_cache_lock) {
+        return;
+    }
+    xSemaphoreTake(handle->interview_cache_lock, portMAX_DELAY);
+    bool removed = false;
+    for (int i = handle->interview_count - 1; i >= 0; i--) {
+        if (handle->interviews[i].short_addr == short_addr) {
+            interview_remove_locked(handle, i);
+            removed = true;
+        }
+    }
+    if (removed) {
+        (void)interview_save_locked(handle);
+    }
+    xSemaphoreGive(handle->interview_cache_lock);
+}
+
+int zigbee_service_get_device_profiles(zigbee_service_handle_t handle, gateway_device_profile_t *out, size_t max_items)
+{
+    if (!handle || !handle->interview_cache_lock || !out) {
+        return -1;
+    }
+    int count = 0;
+    xSemaphoreTake(handle->interview_cache_lock, portMAX_DELAY);
+    for (int i = 0; i < handle->interview_count && (size_t)count < max_items; i++) {
+        const gateway_device_interview_t *record = &handle->interviews[i];
+        gateway_device_profile_t *profile = &out[count++];
+        memset(profile, 0, sizeof(*profile));
+        profile->short_addr = record->short_addr;
+        profile->state = record->state;
+        profile->on_off_endpoint = zigbee_interview_find_endpoint(record, GATEWAY_ZCL_CLUSTER_ON_OFF);
+        memcpy(profile->manufacturer, record->manufacturer, sizeof(profile->manufacturer));
+        memcpy(profile->model, record->model, sizeof(profile->model));
+        profile->manufacturer[sizeof(profile->manufacturer) - 1] = '\0';
+        profile->model[sizeof(profile->model) - 1] = '\0';
+    }
+    xSemaphoreGive(handle->interview_cache_lock);
+    return count;
+}
+
 esp_err_t zigbee_service_get_cached_lqi_snapshot(zigbee_service_handle_t handle, zigbee_neighbor_lqi_t *out,
                                                  size_t max_items, int *out_count, zigbee_lqi_source_t *out_source,
                                                  uint64_t *out_updated_ms)
@@ -363,12 +1374,59 @@ esp_err_t zigbee_service_refresh_neighbor_lqi_from_table(zigbee_service_handle_t
     return ESP_OK;
 }
 
+esp_err_t zigbee_service_get_state_generation(zigbee_service_handle_t handle, zigbee_state_generation_t *out)
+{
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!service_ready(handle)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = gateway_status_to_esp_err(gateway_state_get_generations(handle->gateway_state, &out->network, &out->lqi,
+                                                                            &out->cmd_stats, &out->attrs));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    /* A finished interview changes the device rows as much as a rename does. */
+    xSemaphoreTake(handle->interview_cache_lock, portMAX_DELAY);
+    uint32_t interview_generation = handle->interview_generation;
+    xSemaphoreGive(handle->interview_cache_lock);
+    out->devices = device_service_get_generation(handle->device_service) + interview_generation;
+    out->epoch = handle->boot_epoch;
+    return ESP_OK;
+}
+
+static esp_err_t groups_save_locked(zigbee_service_handle_t handle)
+{
+    if (!handle->group_repo || !handle->group_repo->save) {
+        return ESP_OK;
+    }
+    return gateway_status_to_esp_err(
+        handle->group_repo->save(handle->group_repo->ctx, handle->groups, GATEWAY_MAX_GROUPS, handle->group_count));
+}
+
 esp_err_t zigbee_service_delete_device(zigbee_service_handle_t handle, uint16_t short_addr)
 {
     if (!handle || !handle->runtime_ops || !handle->runtime_ops->delete_device) {
         return ESP_ERR_INVALID_STATE;
     }
-    return handle->runtime_ops->delete_device(short_addr);
+    esp_err_t ret = handle->runtime_ops->delete_device(short_addr);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    (void)gateway_state_forget_attrs(handle->gateway_state, short_addr);
+    (void)gateway_state_forget_cmd_stats(handle->gateway_state, short_addr);
+    interview_forget(handle, short_addr);
+
+    /* The device has left the network, so its memberships are dropped without talking to it. */
+    xSemaphoreTake(handle->groups_lock, portMAX_DELAY);
+    if (zigbee_group_rules_remove_device(handle->groups, handle->group_count, short_addr) > 0) {
+        (void)groups_save_locked(handle);
+    }
+    xSemaphoreGive(handle->groups_lock);
+    return ESP_OK;
 }
 
 esp_err_t zigbee_service_rename_device(zigbee_service_handle_t handle, uint16_t short_addr, const char *name)
@@ -381,3 +1439,138 @@ esp_err_t zigbee_service_rename_device(zigbee_service_handle_t handle, uint16_t
     }
     return handle->runtime_ops->rename_device(short_addr, name);
 }
+
+static bool groups_supported(zigbee_service_handle_t handle)
+{
+    return handle && handle->groups_lock && handle->runtime_ops && handle->runtime_ops->group_add_member &&
+           handle->runtime_ops->group_remove_member && handle->runtime_ops->send_group_on_off;
+}
+
+esp_err_t zigbee_service_group_create(zigbee_service_handle_t handle, const char *name, uint16_t *out_group_id)
+{
+    if (!name || !out_group_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!groups_supported(handle)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    xSemaphoreTake(handle->groups_lock, portMAX_DELAY);
+    esp_err_t ret = gateway_status_to_esp_err(
+        zigbee_group_rules_create(handle->groups, &handle->group_count, GATEWAY_MAX_GROUPS, name, out_group_id));
+    if (ret == ESP_OK) {
+        ret = groups_save_locked(handle);
+        if (ret != ESP_OK) {
+            (void)zigbee_group_rules_delete(handle->groups, &handle->group_count, *out_group_id, NULL);
+        }
+    }
+    xSemaphoreGive(handle->groups_lock);
+    return ret;
+}
+
+esp_err_t zigbee_service_group_delete(zigbee_service_handle_t handle, uint16_t group_id)
+{
+    if (!groups_supported(handle)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    xSemaphoreTake(handle->groups_lock, portMAX_DELAY);
+    zigbee_group_t deleted;
+    esp_err_t ret = gateway_status_to_esp_err(
+        zigbee_group_rules_delete(handle->groups, &handle->group_count, group_id, &deleted));
+    if (ret == ESP_OK) {
+        ret = groups_save_locked(handle);
+        if (ret == ESP_OK) {
+            /* Best effort: an unreachable member keeps a stale group id, which nothing sends to any more. */
+            for (int i = 0; i < deleted.member_count; i++) {
+                (void)handle->runtime_ops->group_remove_member(group_id, deleted.members[i].short_addr,
+                                                               deleted.members[i].endpoint);
+            }
+        } else {
+            handle->groups[handle->group_count++] = deleted;
+        }
+    }
+    xSemaphoreGive(handle->groups_lock);
+    return ret;
+}
+
+typedef enum {
+    GROUP_MEMBER_ADD,
+    GROUP_MEMBER_REMOVE,
+} group_member_op_t;
+
+static esp_err_t group_change_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                     uint8_t endpoint, group_member_op_t op)
+{
+    if (!groups_supported(handle)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    xSemaphoreTake(handle->groups_lock, portMAX_DELAY);
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    int idx = zigbee_group_rules_find(handle->groups, handle->group_count, group_id);
+    if (idx >= 0) {
+        /* Rules run on a copy: the table only changes once the command has been handed to the stack. */
+        zigbee_group_t updated = handle->groups[idx];
+        ret = gateway_status_to_esp_err(op == GROUP_MEMBER_ADD
+                                            ? zigbee_group_rules_add_member(&updated, short_addr, endpoint)
+                                            : zigbee_group_rules_remove_member(&updated, short_addr, endpoint));
+        if (ret == ESP_OK) {
+            ret = op == GROUP_MEMBER_ADD ? handle->runtime_ops->group_add_member(group_id, short_addr, endpoint)
+                                         : handle->runtime_ops->group_remove_member(group_id, short_addr, endpoint);
+        }
+        if (ret == ESP_OK) {
+            zigbee_group_t previous = handle->groups[idx];
+            handle->groups[idx] = updated;
+            ret = groups_save_locked(handle);
+            if (ret != ESP_OK) {
+                handle->groups[idx] = previous;
+            }
+        }
+    }
+    xSemaphoreGive(handle->groups_lock);
+    return ret;
+}
+
+esp_err_t zigbee_service_group_add_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                          uint8_t endpoint)
+{
+    return group_change_member(handle, group_id, short_addr, endpoint, GROUP_MEMBER_ADD);
+}
+
+esp_err_t zigbee_service_group_remove_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                             uint8_t endpoint)
+{
+    return group_change_member(handle, group_id, short_addr, endpoint, GROUP_MEMBER_REMOVE);
+}
+
+esp_err_t zigbee_service_group_send_on_off(zigbee_service_handle_t handle, uint16_t group_id, uint8_t on_off)
+{
+    if (!groups_supported(handle)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    xSemaphoreTake(handle->groups_lock, portMAX_DELAY);
+    bool known = zigbee_group_rules_find(handle->groups, handle->group_count, group_id) >= 0;
+    xSemaphoreGive(handle->groups_lock);
+    if (!known) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return handle->runtime_ops->send_group_on_off(group_id, on_off);
+}
+
+int zigbee_service_get_groups_snapshot(zigbee_service_handle_t handle, zigbee_group_t *out, size_t max_items)
+{
+    if (!handle || !handle->groups_lock || !out || max_items == 0) {
+        return 0;
+    }
+
+    xSemaphoreTake(handle->groups_lock, portMAX_DELAY);
+    int count = handle->group_count;
+    if ((size_t)count > max_items) {
+        count = (int)max_items;
+    }
+    memcpy(out, handle->groups, sizeof(zigbee_group_t) * (size_t)count);
+    xSemaphoreGive(handle->groups_lock);
+    return count;
+}
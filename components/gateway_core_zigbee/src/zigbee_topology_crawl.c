@@ -0,0 +1,229 @@
+#include "zigbee_topology_crawl.h"
+
+#include <string.h>
+
+static bool crawl_running(const zigbee_topology_crawl_t *c)
+{
+    return c && c->summary.state == GATEWAY_TOPOLOGY_CRAWL_RUNNING;
+}
+
+static zigbee_topology_request_t *find_request(zigbee_topology_crawl_t *c, uint32_t token)
+{
+    for (size_t i = 0; token != 0 && i < ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT; i++) {
+        if (c->in_flight[i].token == token) {
+            return &c->in_flight[i];
+        }
+    }
+    return NULL;
+}
+
+static int find_node(const zigbee_topology_crawl_t *c, uint16_t short_addr)
+{
+    for (uint16_t i = 0; i < c->summary.node_count; i++) {
+        if (c->nodes[i].short_addr == short_addr) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool is_router(uint8_t device_type)
+{
+    return device_type == GATEWAY_TOPOLOGY_DEVICE_COORDINATOR || device_type == GATEWAY_TOPOLOGY_DEVICE_ROUTER;
+}
+
+static int add_node(zigbee_topology_crawl_t *c, const zigbee_topology_neighbor_t *rec)
+{
+    if (c->summary.node_count >= GATEWAY_TOPOLOGY_MAX_NODES) {
+        c->summary.truncated = true;
+        return -1;
+    }
+    gateway_topology_node_t *node = &c->nodes[c->summary.node_count];
+    memset(node, 0, sizeof(*node));
+    node->short_addr = rec->short_addr;
+    node->device_type = rec->device_type;
+    node->depth = rec->depth;
+    /* Only routers keep a neighbor table worth asking; appending keeps the walk breadth-first. */
+    node->state = is_router(rec->device_type) ? GATEWAY_TOPOLOGY_NODE_PENDING : GATEWAY_TOPOLOGY_NODE_LEAF;
+    return c->summary.node_count++;
+}
+
+static void add_edge(zigbee_topology_crawl_t *c, uint16_t from, const zigbee_topology_neighbor_t *rec)
+{
+    int to = find_node(c, rec->short_addr);
+    if (to < 0) {
+        to = add_node(c, rec);
+    }
+    if (to < 0) {
+        return;
+    }
+    if (c->summary.edge_count >= GATEWAY_TOPOLOGY_MAX_EDGES) {
+        c->summary.truncated = true;
+        return;
+    }
+    c->edges[c->summary.edge_count++] = (gateway_topology_edge_t){
+        .from = from,
+        .to = (uint16_t)to,
+        .lqi = rec->lqi,
+        .depth = rec->depth,
+        .relationship = rec->relationship,
+    };
+}
+
+static void finish_if_idle(zigbee_topology_crawl_t *c, uint64_t now_ms)
+{
+    for (uint16_t i = 0; i < c->summary.node_count; i++) {
+        uint8_t state = c->nodes[i].state;
+        if (state == GATEWAY_TOPOLOGY_NODE_PENDING || state == GATEWAY_TOPOLOGY_NODE_QUERYING) {
+            return;
+        }
+    }
+    /* Without the coordinator's own table there is no graph to speak of. */
+    c->summary.state = c->nodes[0].state == GATEWAY_TOPOLOGY_NODE_FAILED ? GATEWAY_TOPOLOGY_CRAWL_FAILED
+                                                                           : GATEWAY_TOPOLOGY_CRAWL_DONE;
+    c->summary.finished_ms = now_ms;
+}
+
+static void request_failed(zigbee_topology_crawl_t *c, zigbee_topology_request_t *req)
+{
+    gateway_topology_node_t *node = &c->nodes[req->node];
+    memset(req, 0, sizeof(*req));
+    if (node->attempts >= ZIGBEE_TOPOLOGY_MAX_ATTEMPTS) {
+        node->state = GATEWAY_TOPOLOGY_NODE_FAILED;
+        c->summary.routers_failed++;
+    } else {
+        node->state = GATEWAY_TOPOLOGY_NODE_PENDING;
+    }
+}
+
+void zigbee_topology_crawl_begin(zigbee_topology_crawl_t *c, uint16_t root_addr, uint64_t now_ms)
+{
+    if (!c) {
+        return;
+    }
+    uint32_t crawl_id = c->summary.crawl_id + 1;
+    uint32_t next_token = c->next_token;
+    memset(&c->summary, 0, sizeof(c->summary));
+    memset(c->in_flight, 0, sizeof(c->in_flight));
+    /* Tokens keep counting across crawls, so an answer to the previous crawl never matches. */
+    c->next_token = next_token;
+    c->summary.crawl_id = crawl_id ? crawl_id : 1;
+    c->summary.state = GATEWAY_TOPOLOGY_CRAWL_RUNNING;
+    c->summary.started_ms = now_ms;
+
+    zigbee_topology_neighbor_t root = {
+        .short_addr = root_addr,
+        .device_type = GATEWAY_TOPOLOGY_DEVICE_COORDINATOR,
+    };
+    (void)add_node(c, &root);
+}
+
+bool zigbee_topology_crawl_next(zigbee_topology_crawl_t *c, uint64_t now_ms, uint32_t *out_token, uint16_t *out_addr,
+                                uint8_t *out_start_index)
+{
+    if (!crawl_running(c) || !out_token || !out_addr || !out_start_index) {
+        return false;
+    }
+    zigbee_topology_request_t *req = NULL;
+    for (size_t i = 0; !req && i < ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT; i++) {
+        req = c->in_flight[i].token == 0 ? &c->in_flight[i] : NULL;
+    }
+    if (!req) {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < c->summary.node_count; i++) {
+        gateway_topology_node_t *node = &c->nodes[i];
+        if (node->state != GATEWAY_TOPOLOGY_NODE_PENDING) {
+            continue;
+        }
+        if (++c->next_token == 0) {
+            c->next_token = 1;
+        }
+        node->state = GATEWAY_TOPOLOGY_NODE_QUERYING;
+        node->attempts++;
+        req->token = c->next_token;
+        req->node = i;
+        req->due_ms = now_ms + ZIGBEE_TOPOLOGY_PAGE_TIMEOUT_MS;
+        *out_token = req->token;
+        *out_addr = node->short_addr;
+        *out_start_index = node->next_start_index;
+        return true;
+    }
+    return false;
+}
+
+bool zigbee_topology_crawl_on_page(zigbee_topology_crawl_t *c, uint32_t token, uint8_t table_entries,
+                                   const zigbee_topology_neighbor_t *items, uint8_t count, uint64_t now_ms)
+{
+    zigbee_topology_request_t *req = crawl_running(c) ? find_request(c, token) : NULL;
+    if (!req || (count > 0 && !items)) {
+        return false;
+    }
+    uint16_t from = req->node;
+    memset(req, 0, sizeof(*req));
+
+    for (uint8_t i = 0; i < count; i++) {
+        add_edge(c, from, &items[i]);
+    }
+
+    gateway_topology_node_t *node = &c->nodes[from];
+    node->table_entries = table_entries;
+    node->attempts = 0;
+    unsigned next = (unsigned)node->next_start_index + count;
+    node->next_start_index = next > UINT8_MAX ? UINT8_MAX : (uint8_t)next;
+    if (count > 0 && next < table_entries) {
+        node->state = GATEWAY_TOPOLOGY_NODE_PENDING;
+    } else {
+        node->state = GATEWAY_TOPOLOGY_NODE_DONE;
+        c->summary.routers_done++;
+    }
+    finish_if_idle(c, now_ms);
+    return true;
+}
+
+bool zigbee_topology_crawl_on_error(zigbee_topology_crawl_t *c, uint32_t token, uint64_t now_ms)
+{
+    zigbee_topology_request_t *req = crawl_running(c) ? find_request(c, token) : NULL;
+    if (!req) {
+        return false;
+    }
+    request_failed(c, req);
+    finish_if_idle(c, now_ms);
+    return true;
+}
+
+void zigbee_topology_crawl_tick(zigbee_topology_crawl_t *c, uint64_t now_ms)
+{
+    if (!crawl_running(c)) {
+        return;
+    }
+    for (size_t i = 0; i < ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT; i++) {
+        if (c->in_flight[i].token != 0 && c->in_flight[i].due_ms <= now_ms) {
+            request_failed(c, &c->in_flight[i]);
+        }
+    }
+    finish_if_idle(c, now_ms);
+}
+
+uint64_t zigbee_topology_crawl_next_due_ms(const zigbee_topology_crawl_t *c)
+{
+    uint64_t due = ZIGBEE_TOPOLOGY_IDLE;
+    if (!crawl_running(c)) {
+        return due;
+    }
+    bool slot_free = false;
+    for (size_t i = 0; i < ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT; i++) {
+        slot_free |= c->in_flight[i].token == 0;
+        if (c->in_flight[i].token != 0 && c->in_flight[i].due_ms < due) {
+            due = c->in_flight[i].due_ms;
+        }
+    }
+    /* A router waiting for a free slot that is already there means the last send did not happen. */
+    for (uint16_t i = 0; slot_free && i < c->summary.node_count; i++) {
+        if (c->nodes[i].state == GATEWAY_TOPOLOGY_NODE_PENDING) {
+            return 0;
+        }
+    }
+    return due;
+}
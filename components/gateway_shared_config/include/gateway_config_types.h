@@ -7,6 +7,11 @@
 #define GATEWAY_WIFI_SSID_MAX_LEN 32
 #define GATEWAY_WIFI_PASSWORD_MAX_LEN 64
 #define GATEWAY_DEVICE_NAME_MAX_LEN 31
+#define GATEWAY_GROUP_NAME_MAX_LEN 31
+#define GATEWAY_MAX_GROUPS 8
+#define GATEWAY_GROUP_MAX_MEMBERS 16
+/* Zigbee reserves group ids 0xFFF8-0xFFFF; 0x0000 is never assigned. */
+#define GATEWAY_GROUP_ID_MAX 0xFFF7
 
 #ifdef CONFIG_GATEWAY_MAX_DEVICES
 #define GATEWAY_MAX_DEVICES CONFIG_GATEWAY_MAX_DEVICES
@@ -28,6 +33,53 @@ typedef struct {
     char name[GATEWAY_DEVICE_NAME_MAX_LEN + 1];
 } gateway_device_record_t;
 
+typedef struct {
+    uint16_t short_addr;
+    uint8_t endpoint;
+} gateway_group_member_t;
+
+typedef struct {
+    uint16_t group_id;
+    uint8_t member_count;
+    char name[GATEWAY_GROUP_NAME_MAX_LEN + 1];
+    gateway_group_member_t members[GATEWAY_GROUP_MAX_MEMBERS];
+} gateway_group_record_t;
+
+/*
+ * Device interview result (Active_EP, Simple_Desc, Basic). Keyed by IEEE, so a record survives a
+ * rejoin under a new short address. Cluster lists are cut at the MAX_*_CLUSTERS limits.
+ */
+#define GATEWAY_INTERVIEW_MAX_ENDPOINTS 4
+#define GATEWAY_INTERVIEW_MAX_IN_CLUSTERS 12
+#define GATEWAY_INTERVIEW_MAX_OUT_CLUSTERS 6
+#define GATEWAY_INTERVIEW_STRING_MAX_LEN 32
+
+typedef enum {
+    GATEWAY_INTERVIEW_NONE = 0,
+    GATEWAY_INTERVIEW_PARTIAL,  /* a Simple_Desc or the Basic read failed; asked again on the next announce */
+    GATEWAY_INTERVIEW_COMPLETE, /* reused as is, never asked again */
+} gateway_interview_state_t;
+
+typedef struct {
+    uint8_t endpoint;
+    uint8_t in_count;
+    uint8_t out_count;
+    uint16_t profile_id;
+    uint16_t device_id;
+    uint16_t in_clusters[GATEWAY_INTERVIEW_MAX_IN_CLUSTERS];
+    uint16_t out_clusters[GATEWAY_INTERVIEW_MAX_OUT_CLUSTERS];
+} gateway_endpoint_desc_t;
+
+typedef struct {
+    gateway_ieee_addr_t ieee_addr;
+    uint16_t short_addr;
+    uint8_t state; /* gateway_interview_state_t */
+    uint8_t endpoint_count;
+    gateway_endpoint_desc_t endpoints[GATEWAY_INTERVIEW_MAX_ENDPOINTS];
+    char manufacturer[GATEWAY_INTERVIEW_STRING_MAX_LEN + 1];
+    char model[GATEWAY_INTERVIEW_STRING_MAX_LEN + 1];
+} gateway_device_interview_t;
+
 typedef struct {
     gateway_status_t wifi_err;
     gateway_status_t devices_err;
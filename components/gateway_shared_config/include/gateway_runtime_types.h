@@ -13,7 +13,12 @@
 #define GATEWAY_STATE_LQI_CACHE_CAPACITY GATEWAY_MAX_DEVICES
 #endif
 
+#ifndef GATEWAY_STATE_ATTR_CACHE_CAPACITY
+#define GATEWAY_STATE_ATTR_CACHE_CAPACITY (GATEWAY_MAX_DEVICES * 4)
+#endif
+
 typedef gateway_device_record_t zb_device_t;
+typedef gateway_group_record_t zigbee_group_t;
 
 typedef struct {
     uint32_t pan_id;
@@ -37,6 +42,23 @@ typedef struct {
     zigbee_lqi_source_t source;
 } zigbee_neighbor_lqi_t;
 
+/* One On/Off command of a batch. */
+typedef struct {
+    uint16_t short_addr;
+    uint8_t endpoint;
+    uint8_t on_off;
+} zigbee_on_off_cmd_t;
+
+/* Generation of the /status and /lqi state; epoch is random per boot so values never repeat across runs. */
+typedef struct {
+    uint32_t epoch;
+    uint32_t devices;
+    uint32_t network;
+    uint32_t lqi;
+    uint32_t cmd_stats;
+    uint32_t attrs;
+} zigbee_state_generation_t;
+
 typedef struct {
     char ssid[33];
     int8_t rssi;
@@ -71,3 +93,128 @@ typedef struct {
     uint64_t updated_ms;
     gateway_lqi_source_t source;
 } gateway_lqi_cache_entry_t;
+
+/* Unicast command stats; sent counts every transmission, acked/failed/timeout count outcomes, RTT ends at the Default Response. */
+typedef enum {
+    GATEWAY_CMD_EVENT_SENT = 0,
+    GATEWAY_CMD_EVENT_ACKED,
+    GATEWAY_CMD_EVENT_FAILED,
+    GATEWAY_CMD_EVENT_TIMEOUT,
+} gateway_cmd_event_t;
+
+/* RTT bucket bounds (ms); the last bucket holds everything longer. */
+#define GATEWAY_CMD_RTT_BUCKET_BOUNDS_MS {25, 50, 100, 200, 400, 800, 1600, 3200}
+#define GATEWAY_CMD_RTT_BUCKET_COUNT 9
+
+typedef struct {
+    uint16_t short_addr;
+    uint32_t sent;
+    uint32_t acked;
+    uint32_t failed;
+    uint32_t timeout;
+    uint32_t rtt_buckets[GATEWAY_CMD_RTT_BUCKET_COUNT];
+    uint32_t rtt_max_ms;
+    /* Filled from the histogram at snapshot time; 0 until a reply arrives. */
+    uint32_t rtt_p50_ms;
+    uint32_t rtt_p95_ms;
+    uint64_t updated_ms;
+} gateway_cmd_stats_t;
+
+#define GATEWAY_ZCL_CLUSTER_ON_OFF 0x0006u
+#define GATEWAY_ZCL_ATTR_ON_OFF 0x0000u
+
+typedef enum {
+    GATEWAY_ATTR_SOURCE_REPORT = 0,
+    GATEWAY_ATTR_SOURCE_READ = 1,
+} gateway_attr_source_t;
+
+/* Last ZCL attribute value keyed by (short_addr, endpoint, cluster_id, attr_id); raw bits of scalars up to 32 bits. */
+typedef struct {
+    uint16_t short_addr;
+    uint16_t cluster_id;
+    uint16_t attr_id;
+    uint8_t endpoint;
+    uint8_t zcl_type;
+    uint8_t source; /* gateway_attr_source_t */
+    uint32_t value;
+    uint64_t updated_ms; /* 0 marks a free slot */
+} gateway_attr_entry_t;
+
+/* Mgmt_Lqi crawl graph; nodes and edges only append within a crawl_id, so clients page by index. */
+#ifndef GATEWAY_TOPOLOGY_MAX_NODES
+#define GATEWAY_TOPOLOGY_MAX_NODES 256
+#endif
+#ifndef GATEWAY_TOPOLOGY_MAX_EDGES
+#define GATEWAY_TOPOLOGY_MAX_EDGES 1024
+#endif
+
+/* Values of the ZDP device_type field. */
+typedef enum {
+    GATEWAY_TOPOLOGY_DEVICE_COORDINATOR = 0,
+    GATEWAY_TOPOLOGY_DEVICE_ROUTER = 1,
+    GATEWAY_TOPOLOGY_DEVICE_END_DEVICE = 2,
+    GATEWAY_TOPOLOGY_DEVICE_UNKNOWN = 3,
+} gateway_topology_device_type_t;
+
+typedef enum {
+    GATEWAY_TOPOLOGY_NODE_PENDING = 0, /* router still to be queried */
+    GATEWAY_TOPOLOGY_NODE_QUERYING,
+    GATEWAY_TOPOLOGY_NODE_DONE,
+    GATEWAY_TOPOLOGY_NODE_FAILED,
+    GATEWAY_TOPOLOGY_NODE_LEAF, /* end device without a neighbor table */
+} gateway_topology_node_state_t;
+
+typedef struct {
+    uint16_t short_addr;
+    uint8_t device_type;
+    uint8_t depth;
+    uint8_t state;
+    uint8_t next_start_index;
+    uint8_t table_entries;
+    uint8_t attempts;
+} gateway_topology_node_t;
+
+/* Edge "from sees to" as node indices; relationship as in the ZDP record. */
+typedef struct {
+    uint16_t from;
+    uint16_t to;
+    uint8_t lqi;
+    uint8_t depth;
+    uint8_t relationship;
+} gateway_topology_edge_t;
+
+typedef enum {
+    GATEWAY_TOPOLOGY_CRAWL_IDLE = 0,
+    GATEWAY_TOPOLOGY_CRAWL_RUNNING,
+    GATEWAY_TOPOLOGY_CRAWL_DONE,
+    GATEWAY_TOPOLOGY_CRAWL_FAILED,
+} gateway_topology_crawl_state_t;
+
+typedef struct {
+    uint32_t crawl_id;
+    uint8_t state;
+    bool truncated; /* nodes or edges exceeded GATEWAY_TOPOLOGY_MAX_* */
+    uint16_t node_count;
+    uint16_t edge_count;
+    uint16_t routers_done;
+    uint16_t routers_failed;
+    uint64_t started_ms;
+    uint64_t finished_ms;
+} gateway_topology_summary_t;
+
+/* Interview result for /status rows: the On/Off endpoint and Basic cluster strings. */
+typedef struct {
+    uint16_t short_addr;
+    uint8_t state;           /* gateway_interview_state_t */
+    uint8_t on_off_endpoint; /* 0 when no On/Off server was found */
+    char manufacturer[GATEWAY_INTERVIEW_STRING_MAX_LEN + 1];
+    char model[GATEWAY_INTERVIEW_STRING_MAX_LEN + 1];
+} gateway_device_profile_t;
+
+/* Zigbee event queue counters; dropped_total counts events that did not fit. */
+typedef struct {
+    uint32_t capacity;
+    uint32_t pushed_total;
+    uint32_t dropped_total;
+    uint32_t depth_peak;
+} gateway_zigbee_event_stats_t;
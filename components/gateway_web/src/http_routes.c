@@ -45,11 +45,19 @@ bool http_routes_register(httpd_handle_t server, ws_manager_handle_t ws_manager,
 
     REGISTER_API_ROUTE_BOTH(server, "/status", HTTP_GET, api_status_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/lqi", HTTP_GET, api_lqi_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/topology", HTTP_GET, api_topology_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/health", HTTP_GET, api_health_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/permit_join", HTTP_POST, api_permit_join_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/control", HTTP_POST, api_control_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/control/batch", HTTP_POST, api_control_batch_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/delete", HTTP_POST, api_delete_device_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/rename", HTTP_POST, api_rename_device_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/groups", HTTP_GET, api_groups_list_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/groups", HTTP_POST, api_group_create_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/groups/delete", HTTP_POST, api_group_delete_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/groups/add_member", HTTP_POST, api_group_add_member_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/groups/remove_member", HTTP_POST, api_group_remove_member_handler, usecases, ok);
+    REGISTER_API_ROUTE_BOTH(server, "/groups/control", HTTP_POST, api_group_control_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/wifi/scan", HTTP_GET, api_wifi_scan_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/settings/wifi", HTTP_POST, api_wifi_save_handler, usecases, ok);
     REGISTER_API_ROUTE_BOTH(server, "/reboot", HTTP_POST, api_reboot_handler, usecases, ok);
@@ -65,12 +73,22 @@ bool http_routes_register(httpd_handle_t server, ws_manager_handle_t ws_manager,
     };
     ok &= register_uri_handler_checked(server, &uri_jobs_get_legacy);
 
+    httpd_uri_t uri_diagnostics_v1 = {
+        .uri = "/api/v1/diagnostics/*", .method = HTTP_GET, .handler = api_device_diagnostics_handler, .user_ctx = usecases
+    };
+    ok &= register_uri_handler_checked(server, &uri_diagnostics_v1);
+    httpd_uri_t uri_diagnostics_legacy = {
+        .uri = "/api/diagnostics/*", .method = HTTP_GET, .handler = api_device_diagnostics_handler, .user_ctx = usecases
+    };
+    ok &= register_uri_handler_checked(server, &uri_diagnostics_legacy);
+
     httpd_uri_t uri_ws = {
         .uri = "/ws",
         .method = HTTP_GET,
         .handler = ws_handler_route,
         .user_ctx = ws_manager,
-        .is_websocket = true
+        .is_websocket = true,
+        .handle_ws_control_frames = true
     };
     ok &= register_uri_handler_checked(server, &uri_ws);
 
@@ -38,7 +38,7 @@ void start_web_server(ws_manager_handle_t ws_manager, api_usecases_handle_t usec
     // Keep extra margin for telemetry/status JSON and WS handling.
     httpd_config.stack_size += 2048;
     // Static + WS + API(v1 + legacy aliases) + wildcard routes require higher capacity.
-    httpd_config.max_uri_handlers = 48;
+    httpd_config.max_uri_handlers = 64;
     // Enable wildcard matching for dynamic routes like /api/v1/jobs/*.
     httpd_config.uri_match_fn = httpd_uri_match_wildcard;
     httpd_config.global_user_ctx = ws_manager;
@@ -7,6 +7,8 @@
 #include "lqi_json_mapper.h"
 #include "error_ring.h"
 #include "device_service.h"
+#include "esp_timer.h"
+#include "gateway_events.h"
 #include "gateway_status.h"
 #include "gateway_persistence_adapter.h"
 #include "gateway_wifi_system_facade.h"
@@ -220,6 +222,39 @@ static void test_devices_json_builder_ok(void)
     TEST_ASSERT_NOT_NULL(strstr(buf, "\"devices\""));
 }
 
+static void test_devices_json_joins_cached_on_off_state(void)
+{
+    zb_device_t devices[] = {{.short_addr = 0x2101, .name = "Lamp"}, {.short_addr = 0x2102, .name = "Plug"}};
+    test_seed_devices(devices, 2, true);
+
+    gateway_attr_entry_t entry = {
+        .short_addr = 0x2101,
+        .endpoint = 1,
+        .cluster_id = GATEWAY_ZCL_CLUSTER_ON_OFF,
+        .attr_id = GATEWAY_ZCL_ATTR_ON_OFF,
+        .zcl_type = 0x10,
+        .source = GATEWAY_ATTR_SOURCE_REPORT,
+        .value = 1,
+        .updated_ms = 5000,
+    };
+    bool changed = false;
+    TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_update_attr(s_gateway_state, &entry, &changed));
+    TEST_ASSERT_TRUE(changed);
+    /* The same value again is not a change. */
+    entry.updated_ms = 6000;
+    TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_update_attr(s_gateway_state, &entry, &changed));
+    TEST_ASSERT_FALSE(changed);
+
+    char buf[1024];
+    size_t out_len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, build_devices_json_compact(s_api_usecases, buf, sizeof(buf), &out_len));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"on_off\":1,\"on_off_ms\":6000"));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"on_off\":null"));
+
+    TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_forget_attrs(s_gateway_state, 0x2101));
+    test_reset_devices();
+}
+
 static void test_status_json_builder_ok(void)
 {
     ensure_stateful_handles();
@@ -234,6 +269,55 @@ static void test_status_json_builder_ok(void)
     TEST_ASSERT_NOT_NULL(strstr(buf, "\"devices\""));
 }
 
+typedef struct {
+    char data[2048];
+    size_t len;
+    uint32_t chunks;
+} stream_capture_t;
+
+static bool stream_capture_sink(void *ctx, const char *data, size_t len)
+{
+    stream_capture_t *capture = (stream_capture_t *)ctx;
+    if (capture->len + len > sizeof(capture->data)) {
+        return false;
+    }
+    memcpy(capture->data + capture->len, data, len);
+    capture->len += len;
+    capture->chunks++;
+    return true;
+}
+
+static void test_status_json_streams_through_small_window_like_buffered(void)
+{
+    zb_device_t devices[MAX_DEVICES];
+    int count = (MAX_DEVICES > 8) ? 8 : MAX_DEVICES;
+    memset(devices, 0, sizeof(devices));
+    for (int i = 0; i < count; i++) {
+        devices[i].short_addr = (uint16_t)(0x3000 + i);
+        snprintf(devices[i].name, sizeof(devices[i].name), "Streamed \"node\" %02d", i);
+    }
+    test_seed_devices(devices, count, true);
+
+    char buffered[2048];
+    size_t buffered_len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, build_status_json_compact(s_api_usecases, buffered, sizeof(buffered), &buffered_len));
+
+    /* A window far smaller than the document: every device row crosses a chunk boundary. */
+    static stream_capture_t capture;
+    memset(&capture, 0, sizeof(capture));
+    char window[32];
+    json_writer_t w;
+    json_writer_init_stream(&w, window, sizeof(window), stream_capture_sink, &capture);
+    TEST_ASSERT_EQUAL(ESP_OK, write_status_json(s_api_usecases, &w));
+    size_t streamed_len = 0;
+    TEST_ASSERT_TRUE(json_writer_finish(&w, &streamed_len));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)buffered_len, (uint32_t)streamed_len);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)buffered_len, (uint32_t)capture.len);
+    TEST_ASSERT_EQUAL_MEMORY(buffered, capture.data, buffered_len);
+    TEST_ASSERT_TRUE(capture.chunks > 1);
+    test_reset_devices();
+}
+
 static void test_health_json_builder_with_large_error_ring_truncates_and_stays_valid(void)
 {
     ensure_stateful_handles();
@@ -295,6 +379,12 @@ static void test_lqi_json_mapper_uses_cached_snapshot_contract(void)
     TEST_ASSERT_EQUAL(
         GATEWAY_STATUS_OK,
         gateway_state_update_lqi(s_gateway_state, 0x1002, 70, -80, GATEWAY_LQI_SOURCE_NEIGHBOR_TABLE, 900));
+    for (uint32_t rtt_ms = 20; rtt_ms <= 200; rtt_ms += 20) {
+        TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_record_cmd(s_gateway_state, 0x1001, GATEWAY_CMD_EVENT_SENT, 0));
+        TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK,
+                          gateway_state_record_cmd(s_gateway_state, 0x1001, GATEWAY_CMD_EVENT_ACKED, rtt_ms));
+    }
+    TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_record_cmd(s_gateway_state, 0x1001, GATEWAY_CMD_EVENT_TIMEOUT, 0));
 
     char buf[2048];
     size_t out_len = 0;
@@ -319,6 +409,14 @@ static void test_lqi_json_mapper_uses_cached_snapshot_contract(void)
     TEST_ASSERT_TRUE(cJSON_IsNull(cJSON_GetObjectItem(a, "rssi")));
     TEST_ASSERT_EQUAL_STRING("warn", cJSON_GetObjectItem(a, "quality")->valuestring);
     TEST_ASSERT_EQUAL_STRING("mgmt_lqi", cJSON_GetObjectItem(a, "source")->valuestring);
+    TEST_ASSERT_EQUAL_INT(10, cJSON_GetObjectItem(a, "cmd_sent")->valueint);
+    TEST_ASSERT_EQUAL_INT(10, cJSON_GetObjectItem(a, "cmd_acked")->valueint);
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetObjectItem(a, "cmd_timeout")->valueint);
+    /* 20..200 ms: the median falls in the 100 ms bucket, p95 is capped by the 200 ms maximum. */
+    TEST_ASSERT_EQUAL_INT(100, cJSON_GetObjectItem(a, "rtt_p50_ms")->valueint);
+    TEST_ASSERT_EQUAL_INT(200, cJSON_GetObjectItem(a, "rtt_p95_ms")->valueint);
+    TEST_ASSERT_TRUE(cJSON_IsNull(cJSON_GetObjectItem(b, "rtt_p50_ms")));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetObjectItem(b, "cmd_sent")->valueint);
 
     TEST_ASSERT_TRUE(cJSON_IsNumber(cJSON_GetObjectItem(b, "lqi")));
     TEST_ASSERT_EQUAL_INT(70, cJSON_GetObjectItem(b, "lqi")->valueint);
@@ -329,8 +427,58 @@ static void test_lqi_json_mapper_uses_cached_snapshot_contract(void)
 
     TEST_ASSERT_EQUAL_STRING("mgmt_lqi", cJSON_GetObjectItem(root, "source")->valuestring);
     TEST_ASSERT_EQUAL_INT(1000, cJSON_GetObjectItem(root, "updated_ms")->valueint);
+    cJSON_Delete(root);
 
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(ESP_OK, write_device_diagnostics_json(s_api_usecases, 0x1001, &w));
+    TEST_ASSERT_TRUE(json_writer_finish(&w, &out_len));
+    root = cJSON_ParseWithLength(buf, out_len);
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_EQUAL_STRING("Dev A", cJSON_GetObjectItem(root, "name")->valuestring);
+    TEST_ASSERT_EQUAL_INT(90, cJSON_GetObjectItem(root, "success_pct")->valueint);
+    TEST_ASSERT_EQUAL_INT(200, cJSON_GetObjectItem(root, "rtt_max_ms")->valueint);
+    cJSON *buckets = cJSON_GetObjectItem(cJSON_GetObjectItem(root, "rtt"), "buckets");
+    TEST_ASSERT_EQUAL_INT(GATEWAY_CMD_RTT_BUCKET_COUNT, cJSON_GetArraySize(buckets));
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetObjectItem(cJSON_GetArrayItem(buckets, 0), "count")->valueint);
     cJSON_Delete(root);
+
+    json_writer_init(&w, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, write_device_diagnostics_json(s_api_usecases, 0x7777, &w));
+}
+
+static bool cmd_stats_has_addr(const gateway_cmd_stats_t *stats, int count, uint16_t short_addr)
+{
+    for (int i = 0; i < count; i++) {
+        if (stats[i].short_addr == short_addr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_cmd_stats_evict_idle_entry_and_forget(void)
+{
+    ensure_stateful_handles();
+    gateway_cmd_stats_t stats[GATEWAY_STATE_LQI_CACHE_CAPACITY];
+    /* One address more than fits: the newest one is still recorded. */
+    for (uint16_t i = 0; i <= GATEWAY_STATE_LQI_CACHE_CAPACITY; i++) {
+        TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK,
+                          gateway_state_record_cmd(s_gateway_state, (uint16_t)(0x3000 + i), GATEWAY_CMD_EVENT_SENT, 0));
+    }
+    uint16_t newest = (uint16_t)(0x3000 + GATEWAY_STATE_LQI_CACHE_CAPACITY);
+    int count = gateway_state_get_cmd_stats_snapshot(s_gateway_state, stats, GATEWAY_STATE_LQI_CACHE_CAPACITY);
+    TEST_ASSERT_EQUAL_INT(GATEWAY_STATE_LQI_CACHE_CAPACITY, count);
+    TEST_ASSERT_TRUE(cmd_stats_has_addr(stats, count, newest));
+
+    TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_forget_cmd_stats(s_gateway_state, newest));
+    count = gateway_state_get_cmd_stats_snapshot(s_gateway_state, stats, GATEWAY_STATE_LQI_CACHE_CAPACITY);
+    TEST_ASSERT_EQUAL_INT(GATEWAY_STATE_LQI_CACHE_CAPACITY - 1, count);
+    TEST_ASSERT_FALSE(cmd_stats_has_addr(stats, count, newest));
+
+    for (uint16_t i = 0; i < GATEWAY_STATE_LQI_CACHE_CAPACITY; i++) {
+        TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_forget_cmd_stats(s_gateway_state, (uint16_t)(0x3000 + i)));
+    }
 }
 
 static void test_health_snapshot_usecase_contract(void)
@@ -351,6 +499,8 @@ static void test_health_snapshot_usecase_contract(void)
     ensure_stateful_handles();
     TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_set_network(s_gateway_state, &net));
     TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_set_wifi(s_gateway_state, &wifi));
+    gateway_zigbee_event_stats_t events = {.capacity = 32, .pushed_total = 120, .dropped_total = 3, .depth_peak = 32};
+    TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK, gateway_state_set_zigbee_events(s_gateway_state, &events));
 
     api_health_snapshot_t snap = {0};
     esp_err_t ret = api_usecase_collect_health_snapshot(s_api_usecases, &snap);
@@ -359,6 +509,8 @@ static void test_health_snapshot_usecase_contract(void)
     TEST_ASSERT_TRUE(snap.zigbee_started);
     TEST_ASSERT_EQUAL_UINT16(0x1234, (uint16_t)snap.zigbee_pan_id);
     TEST_ASSERT_EQUAL_UINT8(15, (uint8_t)snap.zigbee_channel);
+    TEST_ASSERT_EQUAL_UINT32(120, snap.zigbee_events.pushed_total);
+    TEST_ASSERT_EQUAL_UINT32(3, snap.zigbee_events.dropped_total);
     TEST_ASSERT_TRUE(snap.wifi_sta_connected);
     TEST_ASSERT_FALSE(snap.wifi_fallback_ap_active);
     TEST_ASSERT_EQUAL_STRING("SelfTestNet", snap.wifi_active_ssid);
@@ -419,6 +571,103 @@ static void test_contract_boundaries_rename(void)
     TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_rename_json("{\"short_addr\":1,\"name\":\"AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\"}", &req));
 }
 
+/* The HTTP body parsers must accept and reject exactly what the cJSON path (still used for WS RPC params) does. */
+static const char *const s_parser_corpus[] = {
+    "{\"addr\":1,\"ep\":1,\"cmd\":0}",
+    " {\"ADDR\":513 , \"Ep\":11,\"cmd\":1} trailing",
+    "\xEF\xBB\xBF{\"addr\":1.9,\"ep\":1e1,\"cmd\":-0}",
+    "{\"addr\":1,\"addr\":2,\"ep\":3,\"cmd\":1}",
+    "{\"addr\":\"1\",\"ep\":1,\"cmd\":1}",
+    "{\"addr\":1,\"ep\":1}",
+    "{\"addr\":99999999999,\"ep\":1,\"cmd\":1}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,}",
+    "{\"addr\":01,\"ep\":-.5,\"cmd\":1.}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,\"confirm\":true}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,\"Confirm\":false}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,\"confirm\":1}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,\"confirm\":null}",
+    "{\"short_addr\":4660}",
+    "{\"short_addr\":4660,\"extra\":{\"a\":[1,{\"b\":null}],\"c\":true}}",
+    "{\"short_addr\":null}",
+    "{\"short_addr\":4660,\"name\":\"Lamp\"}",
+    "{\"short_addr\":4660,\"name\":\"\\u041b\\u0430\\u043c\\u043f\\u0430 \\ud83d\\udca1\"}",
+    "{\"short_addr\":4660,\"name\":\"a\\\"b\\\\c\\/d\\n\"}",
+    "{\"short_addr\":4660,\"name\":\"\\udc00\"}",
+    "{\"short_addr\":4660,\"name\":\"AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\"}",
+    "{\"short_addr\":4660,\"name\":\"\"}",
+    "{\"type\":\"scan\"}",
+    "{\"type\":\"reboot\",\"reboot_delay_ms\":2500}",
+    "{\"type\":\"reboot\",\"reboot_delay_ms\":60001}",
+    "{\"type\":\"reboot\",\"reboot_delay_ms\":\"5\"}",
+    "{\"type\":\"lqi_refresh\"}",
+    "{\"type\":\"factory_reset\"}",
+    "{\"type\":\"update\"}",
+    "{\"type\":\"updatE\"}",
+    "{\"type\":\"lqi_refresx\"}",
+    "{\"type\":1}",
+    "[]",
+    "",
+    "{",
+    "{\"addr\":1 \"ep\":1}",
+};
+
+#define PARSER_CORPUS_LEN (sizeof(s_parser_corpus) / sizeof(s_parser_corpus[0]))
+
+static void test_contract_body_parsers_match_cjson_path(void)
+{
+    for (size_t i = 0; i < PARSER_CORPUS_LEN; i++) {
+        const char *body = s_parser_corpus[i];
+        cJSON *root = cJSON_Parse(body);
+        char msg[64];
+        snprintf(msg, sizeof(msg), "corpus[%u]", (unsigned)i);
+
+        api_control_request_t control_a = {0};
+        api_control_request_t control_b = {0};
+        esp_err_t ref = root ? api_parse_control_params(root, &control_b) : ESP_ERR_INVALID_ARG;
+        TEST_ASSERT_EQUAL_MESSAGE(ref, api_parse_control_json(body, &control_a), msg);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&control_b, &control_a, sizeof(control_a), msg);
+
+        api_delete_request_t delete_a = {0};
+        api_delete_request_t delete_b = {0};
+        ref = root ? api_parse_delete_params(root, &delete_b) : ESP_ERR_INVALID_ARG;
+        TEST_ASSERT_EQUAL_MESSAGE(ref, api_parse_delete_json(body, &delete_a), msg);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&delete_b, &delete_a, sizeof(delete_a), msg);
+
+        api_rename_request_t rename_a = {0};
+        api_rename_request_t rename_b = {0};
+        ref = root ? api_parse_rename_params(root, &rename_b) : ESP_ERR_INVALID_ARG;
+        TEST_ASSERT_EQUAL_MESSAGE(ref, api_parse_rename_json(body, &rename_a), msg);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&rename_b, &rename_a, sizeof(rename_a), msg);
+
+        api_job_submit_request_t job_a = {0};
+        api_job_submit_request_t job_b = {0};
+        ref = root ? api_parse_job_submit_params(root, &job_b) : ESP_ERR_INVALID_ARG;
+        TEST_ASSERT_EQUAL_MESSAGE(ref, api_parse_job_submit_json(body, &job_a), msg);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&job_b, &job_a, sizeof(job_a), msg);
+
+        cJSON_Delete(root);
+    }
+
+    api_wifi_save_request_t wifi = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_parse_wifi_save_json("{\"SSID\":\"Home\\u0020Net\",\"password\":\"pa\\\"ss word\"}", &wifi));
+    TEST_ASSERT_EQUAL_STRING("Home Net", wifi.ssid);
+    TEST_ASSERT_EQUAL_STRING("pa\"ss word", wifi.password);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_wifi_save_json("{\"ssid\":1,\"password\":\"12345678\"}", &wifi));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_wifi_save_json("{\"ssid\":\"S\"}", &wifi));
+}
+
+static void test_job_type_lookup_maps_every_name(void)
+{
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_WIFI_SCAN, api_job_type_from_name("scan"));
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_FACTORY_RESET, api_job_type_from_name("factory_reset"));
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_REBOOT, api_job_type_from_name("reboot"));
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_UPDATE, api_job_type_from_name("update"));
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_LQI_REFRESH, api_job_type_from_name("lqi_refresh"));
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_TOPOLOGY_CRAWL, api_job_type_from_name("topology_crawl"));
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_WIFI_SCAN, api_job_type_from_name("unknown"));
+    TEST_ASSERT_EQUAL(GATEWAY_CORE_JOB_TYPE_WIFI_SCAN, api_job_type_from_name(NULL));
+}
+
 static void test_factory_reset_report_smoke(void)
 {
     ensure_stateful_handles();
@@ -517,12 +766,36 @@ static ws_manager_handle_t s_ws_manager_handle = NULL;
 static int s_ws_test_active_fd = 0;
 static int s_ws_test_send_calls = 0;
 static int s_ws_test_fail_fd = -1;
+static int s_ws_test_blocked_fd = -1;
 static int s_ws_test_close_calls = 0;
 static bool s_ws_test_stress_mode = false;
 static int s_ws_stress_send_calls = 0;
 static int s_ws_stress_send_fd_301 = 0;
 static int s_ws_stress_send_fd_302 = 0;
 static int s_ws_stress_send_fd_303 = 0;
+static const char *s_ws_test_rx_payload = NULL;
+/* Above both WS_RX_MAX_LEN and WS_CONTROL_MAX_LEN. */
+#define WS_TEST_OVERSIZED_LEN 300
+static int s_ws_test_watch_fd = -1;
+static int s_ws_test_watch_fd_sends = 0;
+static const char *s_ws_test_query = NULL;
+static httpd_ws_type_t s_ws_test_rx_type = HTTPD_WS_TYPE_TEXT;
+static int s_ws_test_ping_sends = 0;
+static int s_ws_test_close_frames = 0;
+static uint16_t s_ws_test_last_close_code = 0;
+static char s_ws_test_last_ping[16] = {0};
+static char s_ws_test_reassembly[4096];
+static size_t s_ws_test_reassembly_len = 0;
+static int s_ws_test_fragments = 0;
+static int s_ws_test_fragmented_messages = 0;
+static int s_ws_test_cbor_fd = -1;
+static int s_ws_test_binary_sends = 0;
+static int s_ws_test_binary_to_json_fd = 0;
+static uint32_t s_ws_test_binary_schemas = 0;
+static char s_ws_test_last_rpc[256] = {0};
+static int s_ws_test_frames_by_type[5] = {0};
+static const char *const s_ws_test_frame_types[5] = {"devices_delta", "health_state", "lqi_update", "subscription",
+                                                      "resync"};
 
 static ws_manager_handle_t ws_test_create_manager(void)
 {
@@ -533,6 +806,12 @@ static ws_manager_handle_t ws_test_create_manager(void)
     return s_ws_manager_handle;
 }
 
+/* Broadcasts run on the WS broadcaster task; give it time to drain the pending tick. */
+static void ws_test_wait_broadcaster(void)
+{
+    usleep(100000);
+}
+
 static void ws_test_destroy_manager(void)
 {
     if (s_ws_manager_handle) {
@@ -553,10 +832,59 @@ static void ws_seed_large_device_snapshot(uint32_t iter)
     test_seed_devices(devices, count, true);
 }
 
+static bool ws_test_frame_has_type(const httpd_ws_frame_t *frame, const char *type)
+{
+    char needle[48];
+    int needle_len = snprintf(needle, sizeof(needle), "\"type\":\"%s\"", type);
+    if (!frame || !frame->payload || needle_len <= 0 || (size_t)needle_len > frame->len) {
+        return false;
+    }
+    for (size_t i = 0; i + (size_t)needle_len <= frame->len; i++) {
+        if (memcmp(frame->payload + i, needle, (size_t)needle_len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void ws_test_track_fragment(const httpd_ws_frame_t *frame)
+{
+    s_ws_test_fragments++;
+    if (frame->type == HTTPD_WS_TYPE_TEXT) {
+        s_ws_test_reassembly_len = 0;
+    }
+    if (s_ws_test_reassembly_len + frame->len <= sizeof(s_ws_test_reassembly)) {
+        memcpy(s_ws_test_reassembly + s_ws_test_reassembly_len, frame->payload, frame->len);
+        s_ws_test_reassembly_len += frame->len;
+    }
+    if (!frame->final) {
+        return;
+    }
+    cJSON *root = cJSON_ParseWithLength(s_ws_test_reassembly, s_ws_test_reassembly_len);
+    if (root && cJSON_IsString(cJSON_GetObjectItem(root, "type"))) {
+        s_ws_test_fragmented_messages++;
+    }
+    cJSON_Delete(root);
+}
+
 static esp_err_t ws_test_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame)
 {
     (void)hd;
-    (void)frame;
+    if (frame->type == HTTPD_WS_TYPE_PING) {
+        s_ws_test_ping_sends++;
+        size_t len = (frame->len < sizeof(s_ws_test_last_ping)) ? frame->len : sizeof(s_ws_test_last_ping) - 1;
+        memcpy(s_ws_test_last_ping, frame->payload, len);
+        s_ws_test_last_ping[len] = '\0';
+    }
+    if (frame->type == HTTPD_WS_TYPE_CLOSE && frame->len >= 2) {
+        s_ws_test_close_frames++;
+        s_ws_test_last_close_code = (uint16_t)((frame->payload[0] << 8) | frame->payload[1]);
+    }
+    for (size_t i = 0; i < sizeof(s_ws_test_frame_types) / sizeof(s_ws_test_frame_types[0]); i++) {
+        if (ws_test_frame_has_type(frame, s_ws_test_frame_types[i])) {
+            s_ws_test_frames_by_type[i]++;
+        }
+    }
     if (s_ws_test_stress_mode) {
         s_ws_stress_send_calls++;
         if (fd == 301) {
@@ -580,6 +908,29 @@ static esp_err_t ws_test_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_fr
         return ESP_OK;
     }
     s_ws_test_send_calls++;
+    if (ws_test_frame_has_type(frame, "rpc_result")) {
+        size_t len = (frame->len < sizeof(s_ws_test_last_rpc)) ? frame->len : sizeof(s_ws_test_last_rpc) - 1;
+        memcpy(s_ws_test_last_rpc, frame->payload, len);
+        s_ws_test_last_rpc[len] = '\0';
+    }
+    if (frame->type == HTTPD_WS_TYPE_BINARY) {
+        if (fd != s_ws_test_cbor_fd) {
+            s_ws_test_binary_to_json_fd++;
+        } else if (frame->len > 2 && frame->payload[0] == 0x85 && frame->payload[2] < 24) {
+            /* Envelope [version, schema, ...]: byte 2 is the schema id as a tiny uint. */
+            s_ws_test_binary_sends++;
+            s_ws_test_binary_schemas |= 1u << frame->payload[2];
+        }
+    }
+    if (fd == s_ws_test_watch_fd) {
+        s_ws_test_watch_fd_sends++;
+        if (frame->fragmented) {
+            ws_test_track_fragment(frame);
+        }
+    }
+    if (fd == s_ws_test_blocked_fd) {
+        return ESP_ERR_TIMEOUT;
+    }
     if (fd == s_ws_test_fail_fd) {
         return ESP_FAIL;
     }
@@ -595,8 +946,23 @@ static int ws_test_req_to_sockfd(httpd_req_t *req)
 static esp_err_t ws_test_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len)
 {
     (void)req;
-    (void)max_len;
-    pkt->type = HTTPD_WS_TYPE_TEXT;
+    pkt->type = s_ws_test_rx_type;
+    if (s_ws_test_rx_payload) {
+        pkt->len = strlen(s_ws_test_rx_payload);
+        if (max_len > 0 && pkt->payload) {
+            memcpy(pkt->payload, s_ws_test_rx_payload, pkt->len);
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t ws_test_req_get_url_query(httpd_req_t *req, char *buf, size_t buf_len)
+{
+    (void)req;
+    if (!s_ws_test_query || strlen(s_ws_test_query) >= buf_len) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    memcpy(buf, s_ws_test_query, strlen(s_ws_test_query) + 1);
     return ESP_OK;
 }
 
@@ -648,6 +1014,7 @@ static void test_ws_runtime_socket_lifecycle_disconnect_reconnect_backpressure(v
     usleep(280000);
     s_ws_test_fail_fd = s_ws_test_active_fd;
     ws_broadcast_status_with_handle(ws);
+    ws_test_wait_broadcaster();
     TEST_ASSERT_EQUAL_INT(0, ws_manager_get_client_count_with_handle(ws));
     TEST_ASSERT_GREATER_THAN_INT(0, s_ws_test_send_calls);
 
@@ -664,6 +1031,63 @@ static void test_ws_runtime_socket_lifecycle_disconnect_reconnect_backpressure(v
     ws_test_destroy_manager();
 }
 
+static uint32_t ws_test_client_queue_depth(int fd)
+{
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    for (uint32_t i = 0; i < hs.ws_metrics.client_count; i++) {
+        if (hs.ws_metrics.clients[i].fd == fd) {
+            return hs.ws_metrics.clients[i].queue_depth;
+        }
+    }
+    TEST_FAIL_MESSAGE("ws client not found");
+    return 0;
+}
+
+static void test_ws_blocked_client_does_not_stall_others_and_is_retried(void)
+{
+    s_ws_test_fail_fd = -1;
+    s_ws_test_blocked_fd = 701;
+    s_ws_test_watch_fd = 702;
+    s_ws_test_watch_fd_sends = 0;
+
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 701;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    s_ws_test_active_fd = 702;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+
+    ws_broadcast_status_with_handle(ws);
+    ws_test_wait_broadcaster();
+    /* A full socket buffer keeps 701's frames queued without delaying 702 or closing 701. */
+    TEST_ASSERT_GREATER_THAN_INT(0, s_ws_test_watch_fd_sends);
+    TEST_ASSERT_EQUAL_UINT32(0, ws_test_client_queue_depth(702));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, ws_test_client_queue_depth(701));
+    TEST_ASSERT_EQUAL_INT(2, ws_manager_get_client_count_with_handle(ws));
+
+    /* Once the socket drains, the broadcaster's retry delivers the backlog without a new broadcast. */
+    s_ws_test_blocked_fd = -1;
+    usleep(200000);
+    TEST_ASSERT_EQUAL_UINT32(0, ws_test_client_queue_depth(701));
+    TEST_ASSERT_EQUAL_INT(2, ws_manager_get_client_count_with_handle(ws));
+
+    s_ws_test_watch_fd = -1;
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
 static void test_ws_runtime_backpressure_stress_prunes_clients_and_stays_responsive(void)
 {
     s_ws_test_stress_mode = true;
@@ -705,10 +1129,528 @@ static void test_ws_runtime_backpressure_stress_prunes_clients_and_stays_respons
     TEST_ASSERT_GREATER_THAN_INT(16, s_ws_stress_send_fd_303);
     TEST_ASSERT_EQUAL_INT(1, ws_manager_get_client_count_with_handle(ws));
 
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    TEST_ASSERT_TRUE(hs.ws_metrics.slow_consumer_evictions_total >= 2);
+    TEST_ASSERT_EQUAL_UINT32(1, hs.ws_metrics.client_count);
+    TEST_ASSERT_EQUAL_INT32(301, hs.ws_metrics.clients[0].fd);
+    TEST_ASSERT_EQUAL_UINT32(0, hs.ws_metrics.clients[0].queue_depth);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, hs.ws_metrics.broadcast_ticks_total);
+    TEST_ASSERT_TRUE(hs.ws_metrics.broadcast_requests_total >= hs.ws_metrics.broadcast_ticks_total);
+
     s_ws_test_stress_mode = false;
     ws_manager_reset_transport_ops_for_test_with_handle(ws);
     ws_test_destroy_manager();
 }
+
+static void test_ws_unsubscribed_topics_are_not_built_or_sent(void)
+{
+    s_ws_test_active_fd = 501;
+    s_ws_test_fail_fd = -1;
+    memset(s_ws_test_frames_by_type, 0, sizeof(s_ws_test_frames_by_type));
+
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+
+    req.method = 0;
+    s_ws_test_rx_payload = "{\"type\":\"unsubscribe\",\"topics\":[\"health\",\"lqi\"]}";
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    s_ws_test_rx_payload = NULL;
+    TEST_ASSERT_EQUAL_INT(1, s_ws_test_frames_by_type[3]);
+
+    memset(s_ws_test_frames_by_type, 0, sizeof(s_ws_test_frames_by_type));
+    for (int i = 0; i < 4; i++) {
+        ws_seed_large_device_snapshot((uint32_t)(100 + i));
+        usleep(300000);
+        ws_broadcast_status_with_handle(ws);
+    }
+    ws_test_wait_broadcaster();
+    TEST_ASSERT_GREATER_THAN_INT(0, s_ws_test_frames_by_type[0]);
+    TEST_ASSERT_EQUAL_INT(0, s_ws_test_frames_by_type[1]);
+    TEST_ASSERT_EQUAL_INT(0, s_ws_test_frames_by_type[2]);
+    TEST_ASSERT_EQUAL_INT(1, ws_manager_get_client_count_with_handle(ws));
+
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static void test_ws_new_client_gets_cached_snapshot_without_global_rebroadcast(void)
+{
+    s_ws_test_fail_fd = -1;
+    s_ws_test_send_calls = 0;
+
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 601;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    ws_test_wait_broadcaster();
+    TEST_ASSERT_GREATER_THAN_INT(0, s_ws_test_send_calls);
+
+    s_ws_test_watch_fd = 601;
+    s_ws_test_watch_fd_sends = 0;
+    s_ws_test_active_fd = 602;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    TEST_ASSERT_EQUAL_INT(2, ws_manager_get_client_count_with_handle(ws));
+    TEST_ASSERT_EQUAL_INT(0, s_ws_test_watch_fd_sends);
+
+    s_ws_test_watch_fd = 602;
+    s_ws_test_watch_fd_sends = 0;
+    s_ws_test_active_fd = 603;
+    memset(s_ws_test_frames_by_type, 0, sizeof(s_ws_test_frames_by_type));
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    TEST_ASSERT_EQUAL_INT(0, s_ws_test_watch_fd_sends);
+    TEST_ASSERT_EQUAL_INT(1, s_ws_test_frames_by_type[0]);
+
+    s_ws_test_watch_fd = -1;
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static void test_ws_resume_since_sends_newest_frames_or_resyncs(void)
+{
+    s_ws_test_fail_fd = -1;
+
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+        .req_get_url_query = ws_test_req_get_url_query,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 701;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    ws_test_wait_broadcaster();
+    ws_seed_large_device_snapshot(200);
+    usleep(300000);
+    ws_broadcast_status_with_handle(ws);
+    ws_test_wait_broadcaster();
+
+    memset(s_ws_test_frames_by_type, 0, sizeof(s_ws_test_frames_by_type));
+    s_ws_test_query = "since=0";
+    s_ws_test_active_fd = 702;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    /* Only the newest devices list is resent, however many changed since seq 0. */
+    TEST_ASSERT_EQUAL_INT(0, s_ws_test_frames_by_type[4]);
+    TEST_ASSERT_EQUAL_INT(1, s_ws_test_frames_by_type[0]);
+
+    memset(s_ws_test_frames_by_type, 0, sizeof(s_ws_test_frames_by_type));
+    s_ws_test_query = "since=4000000000";
+    s_ws_test_active_fd = 703;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    s_ws_test_query = NULL;
+    TEST_ASSERT_EQUAL_INT(1, s_ws_test_frames_by_type[4]);
+    TEST_ASSERT_EQUAL_INT(1, s_ws_test_frames_by_type[0]);
+
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    TEST_ASSERT_EQUAL_UINT32(1, hs.ws_metrics.replay_resumes_total);
+    TEST_ASSERT_EQUAL_UINT32(1, hs.ws_metrics.replay_resyncs_total);
+    TEST_ASSERT_EQUAL_INT(3, ws_manager_get_client_count_with_handle(ws));
+
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static void test_ws_keepalive_reaps_silent_client_and_tracks_rtt(void)
+{
+    s_ws_test_fail_fd = -1;
+
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 801;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    s_ws_test_active_fd = 802;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    ws_test_wait_broadcaster();
+    TEST_ASSERT_EQUAL_INT(2, ws_manager_get_client_count_with_handle(ws));
+
+    /* 801 answers every ping, 802 stays silent until it is reaped. */
+    req.method = 0;
+    for (int round = 0; round < 10 && ws_manager_get_client_count_with_handle(ws) > 1; round++) {
+        s_ws_test_ping_sends = 0;
+        ws_manager_ping_clients_with_handle(ws);
+        ws_test_wait_broadcaster();
+        TEST_ASSERT_GREATER_THAN_INT(0, s_ws_test_ping_sends);
+
+        s_ws_test_rx_type = HTTPD_WS_TYPE_PONG;
+        s_ws_test_rx_payload = s_ws_test_last_ping;
+        s_ws_test_active_fd = 801;
+        TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    }
+    s_ws_test_rx_type = HTTPD_WS_TYPE_TEXT;
+    s_ws_test_rx_payload = NULL;
+    TEST_ASSERT_EQUAL_INT(1, ws_manager_get_client_count_with_handle(ws));
+
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    TEST_ASSERT_EQUAL_UINT32(1, hs.ws_metrics.idle_reaped_total);
+    TEST_ASSERT_EQUAL_INT32(801, hs.ws_metrics.clients[0].fd);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, hs.ws_metrics.clients[0].srtt_us);
+    TEST_ASSERT_EQUAL_UINT32(0, hs.ws_metrics.clients[0].missed_pongs);
+
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static void test_ws_large_payload_is_sent_as_continuation_fragments(void)
+{
+    s_ws_test_fail_fd = -1;
+    s_ws_test_fragments = 0;
+    s_ws_test_fragmented_messages = 0;
+    s_ws_test_reassembly_len = 0;
+
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    /* Health with eight clients and a full error tail no longer fits one pooled frame. */
+    for (int i = 0; i < 5; i++) {
+        gateway_error_ring_add("ws", (int32_t)ESP_ERR_TIMEOUT, "fragmentation self-test filler entry");
+    }
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    for (int fd = 901; fd < 909; fd++) {
+        s_ws_test_active_fd = fd;
+        TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    }
+    s_ws_test_watch_fd = 901;
+    usleep(900000);
+    ws_broadcast_status_with_handle(ws);
+    ws_test_wait_broadcaster();
+    s_ws_test_watch_fd = -1;
+
+    TEST_ASSERT_GREATER_THAN_INT(1, s_ws_test_fragments);
+    TEST_ASSERT_GREATER_THAN_INT(0, s_ws_test_fragmented_messages);
+    TEST_ASSERT_EQUAL_INT(8, ws_manager_get_client_count_with_handle(ws));
+
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, hs.ws_metrics.large_frames_total);
+
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static void test_ws_cbor_client_gets_binary_frames_at_half_the_size(void)
+{
+    zb_device_t devices[MAX_DEVICES];
+    int count = (MAX_DEVICES > 10) ? 10 : MAX_DEVICES;
+    memset(devices, 0, sizeof(devices));
+    for (int i = 0; i < count; i++) {
+        devices[i].short_addr = (uint16_t)(0x3000 + i);
+        snprintf(devices[i].name, sizeof(devices[i].name), "Lamp-%02d", i);
+    }
+    test_seed_devices(devices, count, true);
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL(GATEWAY_STATUS_OK,
+                          gateway_state_update_lqi(s_gateway_state, devices[i].short_addr, 100 + i, -60,
+                                                   GATEWAY_LQI_SOURCE_MGMT_LQI, 5000));
+    }
+
+    char json_buf[4096];
+    char cbor_buf[4096];
+    size_t json_len = 0;
+    size_t cbor_len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, build_lqi_json_compact(s_api_usecases, json_buf, sizeof(json_buf), &json_len));
+    TEST_ASSERT_EQUAL(ESP_OK, build_lqi_cbor_compact(s_api_usecases, cbor_buf, sizeof(cbor_buf), &cbor_len));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, (uint32_t)cbor_len);
+    TEST_ASSERT_TRUE(cbor_len * 2 <= json_len);
+    /* [updated_ms, source, rows] with updated_ms = 5000 as a 16-bit uint. */
+    TEST_ASSERT_EQUAL_HEX8(0x83, (uint8_t)cbor_buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x19, (uint8_t)cbor_buf[1]);
+
+    s_ws_test_fail_fd = -1;
+    s_ws_test_cbor_fd = 1102;
+    s_ws_test_binary_sends = 0;
+    s_ws_test_binary_to_json_fd = 0;
+    s_ws_test_binary_schemas = 0;
+
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+        .req_get_url_query = ws_test_req_get_url_query,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 1101;
+    s_ws_test_query = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    s_ws_test_active_fd = 1102;
+    s_ws_test_query = "enc=cbor";
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    s_ws_test_query = NULL;
+    usleep(900000);
+    ws_broadcast_status_with_handle(ws);
+    ws_test_wait_broadcaster();
+
+    TEST_ASSERT_GREATER_THAN_INT(0, s_ws_test_binary_sends);
+    TEST_ASSERT_EQUAL_INT(0, s_ws_test_binary_to_json_fd);
+    TEST_ASSERT_TRUE((s_ws_test_binary_schemas & (1u << API_CBOR_SCHEMA_DEVICES)) != 0);
+    TEST_ASSERT_TRUE((s_ws_test_binary_schemas & (1u << API_CBOR_SCHEMA_LQI)) != 0);
+
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, hs.ws_metrics.binary_frames_total);
+    /* JSON and CBOR snapshots of every kind are cached as heap copies and leave the pool free. */
+    TEST_ASSERT_EQUAL_UINT32(0, hs.ws_metrics.frame_pool_misses_total);
+
+    s_ws_test_cbor_fd = -1;
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static void test_ws_oversized_frames_close_the_session(void)
+{
+    static char big[WS_TEST_OVERSIZED_LEN + 1];
+    memset(big, 'x', WS_TEST_OVERSIZED_LEN);
+    big[WS_TEST_OVERSIZED_LEN] = '\0';
+
+    s_ws_test_fail_fd = -1;
+    s_ws_test_close_frames = 0;
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    /* The unread payload would be parsed as the next header: the session ends with 1009 instead. */
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 1101;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    req.method = 0;
+    s_ws_test_rx_payload = big;
+    TEST_ASSERT_EQUAL(ESP_FAIL, ws_handler_with_handle(ws, &req));
+    TEST_ASSERT_EQUAL_INT(1, s_ws_test_close_frames);
+    TEST_ASSERT_EQUAL_UINT16(1009, s_ws_test_last_close_code);
+    TEST_ASSERT_EQUAL_INT(0, ws_manager_get_client_count_with_handle(ws));
+
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 1102;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    req.method = 0;
+    s_ws_test_rx_type = HTTPD_WS_TYPE_PING;
+    TEST_ASSERT_EQUAL(ESP_FAIL, ws_handler_with_handle(ws, &req));
+    TEST_ASSERT_EQUAL_UINT16(1009, s_ws_test_last_close_code);
+
+    req.method = HTTP_GET;
+    s_ws_test_active_fd = 1103;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    req.method = 0;
+    s_ws_test_rx_type = HTTPD_WS_TYPE_BINARY;
+    s_ws_test_rx_payload = "\x01\x02";
+    TEST_ASSERT_EQUAL(ESP_FAIL, ws_handler_with_handle(ws, &req));
+    TEST_ASSERT_EQUAL_UINT16(1003, s_ws_test_last_close_code);
+    TEST_ASSERT_EQUAL_INT(0, ws_manager_get_client_count_with_handle(ws));
+
+    s_ws_test_rx_type = HTTPD_WS_TYPE_TEXT;
+    s_ws_test_rx_payload = NULL;
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static cJSON *ws_test_rpc_call(ws_manager_handle_t ws, httpd_req_t *req, const char *msg)
+{
+    s_ws_test_last_rpc[0] = '\0';
+    s_ws_test_rx_payload = msg;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, req));
+    s_ws_test_rx_payload = NULL;
+    cJSON *root = cJSON_Parse(s_ws_test_last_rpc);
+    TEST_ASSERT_NOT_NULL(root);
+    cJSON *data = cJSON_GetObjectItem(root, "data");
+    TEST_ASSERT_TRUE(cJSON_IsObject(data));
+    return root;
+}
+
+static void test_ws_rpc_replies_are_correlated_on_the_same_socket(void)
+{
+    zb_device_t devices[1] = {
+        {.short_addr = 0x1201, .name = "Rpc Lamp"},
+    };
+    test_seed_devices(devices, 1, true);
+
+    s_ws_test_fail_fd = -1;
+    s_ws_test_active_fd = 1201;
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    ws_test_wait_broadcaster();
+    req.method = 0;
+
+    cJSON *root = ws_test_rpc_call(
+        ws, &req, "{\"id\":7,\"method\":\"rename\",\"params\":{\"short_addr\":4609,\"name\":\"Desk Lamp\"}}");
+    cJSON *data = cJSON_GetObjectItem(root, "data");
+    TEST_ASSERT_EQUAL_INT(7, cJSON_GetObjectItem(data, "id")->valueint);
+    TEST_ASSERT_TRUE(cJSON_IsTrue(cJSON_GetObjectItem(data, "ok")));
+    cJSON_Delete(root);
+    zb_device_t snapshot[MAX_DEVICES] = {0};
+    int count = api_usecase_get_devices_snapshot(s_api_usecases, snapshot, MAX_DEVICES);
+    TEST_ASSERT_EQUAL_INT(1, count);
+    TEST_ASSERT_EQUAL_STRING("Desk Lamp", snapshot[0].name);
+
+    root = ws_test_rpc_call(ws, &req, "{\"id\":8,\"method\":\"reboot_now\"}");
+    data = cJSON_GetObjectItem(root, "data");
+    TEST_ASSERT_EQUAL_INT(8, cJSON_GetObjectItem(data, "id")->valueint);
+    TEST_ASSERT_TRUE(cJSON_IsFalse(cJSON_GetObjectItem(data, "ok")));
+    TEST_ASSERT_EQUAL_STRING("unknown_method",
+                             cJSON_GetObjectItem(cJSON_GetObjectItem(data, "error"), "code")->valuestring);
+    cJSON_Delete(root);
+
+    root = ws_test_rpc_call(ws, &req, "{\"id\":9,\"method\":\"control\",\"params\":{\"addr\":0,\"ep\":1,\"cmd\":1}}");
+    data = cJSON_GetObjectItem(root, "data");
+    TEST_ASSERT_EQUAL_INT(9, cJSON_GetObjectItem(data, "id")->valueint);
+    TEST_ASSERT_EQUAL_STRING("invalid_argument",
+                             cJSON_GetObjectItem(cJSON_GetObjectItem(data, "error"), "code")->valuestring);
+    cJSON_Delete(root);
+
+    root = ws_test_rpc_call(ws, &req, "{\"method\":\"delete\",\"params\":{\"short_addr\":4609}}");
+    data = cJSON_GetObjectItem(root, "data");
+    TEST_ASSERT_TRUE(cJSON_IsNull(cJSON_GetObjectItem(data, "id")));
+    TEST_ASSERT_TRUE(cJSON_IsFalse(cJSON_GetObjectItem(data, "ok")));
+    cJSON_Delete(root);
+    TEST_ASSERT_EQUAL_INT(1, api_usecase_get_devices_snapshot(s_api_usecases, snapshot, MAX_DEVICES));
+
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    TEST_ASSERT_EQUAL_UINT32(4, hs.ws_metrics.rpc_requests_total);
+    TEST_ASSERT_EQUAL_UINT32(3, hs.ws_metrics.rpc_errors_total);
+
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
+
+static void test_ws_latency_is_measured_from_event_origin(void)
+{
+    zb_device_t devices[1] = {
+        {.short_addr = 0x1301, .name = "Latency Lamp"},
+    };
+    test_seed_devices(devices, 1, true);
+
+    s_ws_test_fail_fd = -1;
+    s_ws_test_active_fd = 1301;
+    ws_manager_transport_ops_t ops = {
+        .send_frame_async = ws_test_send_frame_async,
+        .req_to_sockfd = ws_test_req_to_sockfd,
+        .ws_recv_frame = ws_test_recv_frame,
+        .resp_set_status = ws_test_resp_set_status,
+        .resp_send = ws_test_resp_send,
+        .close_socket = ws_test_close_socket,
+    };
+    ws_manager_handle_t ws = ws_test_create_manager();
+    ws_manager_set_transport_ops_for_test_with_handle(ws, &ops);
+
+    httpd_req_t req = {0};
+    req.method = HTTP_GET;
+    TEST_ASSERT_EQUAL(ESP_OK, ws_handler_with_handle(ws, &req));
+    ws_test_wait_broadcaster();
+
+    /* An unchanged list is not a delivery: the stamped origin must be discarded. */
+    TEST_ASSERT_EQUAL(ESP_OK, gateway_event_post_changed(GATEWAY_EVENT_DEVICE_LIST_CHANGED, esp_timer_get_time()));
+    usleep(300000);
+    api_health_snapshot_t hs = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    TEST_ASSERT_EQUAL_UINT32(0, hs.ws_metrics.latency[API_WS_LATENCY_DEVICES].sent.count);
+
+    device_service_update_name(s_device_service, 0x1301, "Latency Lamp 2");
+    TEST_ASSERT_EQUAL(ESP_OK,
+                      gateway_event_post_changed(GATEWAY_EVENT_DEVICE_LIST_CHANGED, esp_timer_get_time() - 40000));
+    usleep(300000);
+
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_collect_health_snapshot(s_api_usecases, &hs));
+    const api_ws_event_latency_t *latency = &hs.ws_metrics.latency[API_WS_LATENCY_DEVICES];
+    TEST_ASSERT_EQUAL_UINT32(1, latency->sent.count);
+    TEST_ASSERT_EQUAL_UINT32(1, latency->serialize.count);
+    TEST_ASSERT_TRUE(latency->sent.max_us >= 40000);
+    TEST_ASSERT_TRUE(latency->serialize.max_us <= latency->sent.max_us);
+    TEST_ASSERT_TRUE(api_latency_histogram_percentile_ms(&latency->sent, 95) >= 40);
+
+    char buf[4096];
+    size_t out_len = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, build_health_json_compact(s_api_usecases, buf, sizeof(buf), &out_len));
+    cJSON *root = cJSON_ParseWithLength(buf, out_len);
+    TEST_ASSERT_NOT_NULL(root);
+    cJSON *ws_json = cJSON_GetObjectItem(cJSON_GetObjectItem(root, "runtime"), "ws");
+    cJSON *devices_latency = cJSON_GetObjectItem(cJSON_GetObjectItem(ws_json, "latency"), "devices_delta");
+    TEST_ASSERT_TRUE(cJSON_IsObject(devices_latency));
+    cJSON *sent = cJSON_GetObjectItem(devices_latency, "sent");
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetObjectItem(sent, "count")->valueint);
+    TEST_ASSERT_EQUAL_INT(API_LATENCY_BUCKET_COUNT, cJSON_GetArraySize(cJSON_GetObjectItem(sent, "buckets")));
+    cJSON_Delete(root);
+
+    ws_manager_reset_transport_ops_for_test_with_handle(ws);
+    ws_test_destroy_manager();
+}
 #endif
 
 #if CONFIG_GATEWAY_SELF_TEST_APP
@@ -824,14 +1766,19 @@ void gateway_web_register_self_tests(void)
     RUN_TEST(test_devices_json_builder_small_buffer_fails);
     RUN_TEST(test_status_json_builder_small_buffer_fails);
     RUN_TEST(test_devices_json_builder_ok);
+    RUN_TEST(test_devices_json_joins_cached_on_off_state);
     RUN_TEST(test_status_json_builder_ok);
+    RUN_TEST(test_status_json_streams_through_small_window_like_buffered);
     RUN_TEST(test_health_json_builder_with_large_error_ring_truncates_and_stays_valid);
     RUN_TEST(test_lqi_json_mapper_uses_cached_snapshot_contract);
+    RUN_TEST(test_cmd_stats_evict_idle_entry_and_forget);
     RUN_TEST(test_health_snapshot_usecase_contract);
     RUN_TEST(test_health_json_wifi_active_ssid_is_canonical);
     RUN_TEST(test_contract_boundaries_control);
     RUN_TEST(test_contract_boundaries_wifi_settings);
     RUN_TEST(test_contract_boundaries_rename);
+    RUN_TEST(test_contract_body_parsers_match_cjson_path);
+    RUN_TEST(test_job_type_lookup_maps_every_name);
     RUN_TEST(test_factory_reset_report_smoke);
     RUN_TEST(test_frontend_contract_status_envelope_smoke);
     RUN_TEST(test_frontend_contract_scan_envelope_smoke);
@@ -839,7 +1786,17 @@ void gateway_web_register_self_tests(void)
     RUN_TEST(test_ws_lqi_update_envelope_smoke);
 #if CONFIG_GATEWAY_SELF_TEST_APP
     RUN_TEST(test_ws_runtime_socket_lifecycle_disconnect_reconnect_backpressure);
+    RUN_TEST(test_ws_blocked_client_does_not_stall_others_and_is_retried);
     RUN_TEST(test_ws_runtime_backpressure_stress_prunes_clients_and_stays_responsive);
+    RUN_TEST(test_ws_unsubscribed_topics_are_not_built_or_sent);
+    RUN_TEST(test_ws_new_client_gets_cached_snapshot_without_global_rebroadcast);
+    RUN_TEST(test_ws_resume_since_sends_newest_frames_or_resyncs);
+    RUN_TEST(test_ws_keepalive_reaps_silent_client_and_tracks_rtt);
+    RUN_TEST(test_ws_large_payload_is_sent_as_continuation_fragments);
+    RUN_TEST(test_ws_cbor_client_gets_binary_frames_at_half_the_size);
+    RUN_TEST(test_ws_oversized_frames_close_the_session);
+    RUN_TEST(test_ws_rpc_replies_are_correlated_on_the_same_socket);
+    RUN_TEST(test_ws_latency_is_measured_from_event_origin);
     RUN_TEST(test_ws_runtime_socket_lifecycle_real_stack_disconnect_reconnect_backpressure);
 #endif
 }
@@ -2,16 +2,26 @@
 
 #include "esp_err.h"
 #include "esp_http_server.h"
+#include "gateway_jobs_facade.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+struct cJSON;
+
 #define API_WIFI_SSID_MAX_LEN 32
 #define API_WIFI_PASSWORD_MAX_LEN 64
 #define API_DEVICE_NAME_MAX_LEN 31
+#define API_CONTROL_BATCH_MAX 32
+#define API_GROUP_NAME_MAX_LEN 31
+#define API_GROUP_ID_MAX 0xFFF7
+#define API_CONTROL_CONFIRM_TIMEOUT_MS 5000
 
 typedef struct {
     uint16_t addr;
     uint8_t ep;
     uint8_t cmd;
+    bool confirm; /* wait for the Default Response, up to API_CONTROL_CONFIRM_TIMEOUT_MS */
 } api_control_request_t;
 
 typedef struct {
@@ -33,14 +43,59 @@ typedef struct {
     uint32_t reboot_delay_ms;
 } api_job_submit_request_t;
 
+typedef struct {
+    char name[API_GROUP_NAME_MAX_LEN + 1];
+} api_group_create_request_t;
+
+typedef struct {
+    uint16_t group_id;
+} api_group_delete_request_t;
+
+typedef struct {
+    uint16_t group_id;
+    uint16_t addr;
+    uint8_t ep;
+} api_group_member_request_t;
+
+typedef struct {
+    uint16_t group_id;
+    uint8_t cmd;
+} api_group_control_request_t;
+
+/* /control/batch; results[i] is ESP_ERR_INVALID_ARG for items rejected by the parser, else the send result. */
+typedef struct {
+    size_t count;
+    api_control_request_t items[API_CONTROL_BATCH_MAX];
+    esp_err_t results[API_CONTROL_BATCH_MAX];
+} api_control_batch_t;
+
 esp_err_t api_parse_control_request(httpd_req_t *req, api_control_request_t *out);
 esp_err_t api_parse_delete_request(httpd_req_t *req, api_delete_request_t *out);
 esp_err_t api_parse_rename_request(httpd_req_t *req, api_rename_request_t *out);
 esp_err_t api_parse_wifi_save_request(httpd_req_t *req, api_wifi_save_request_t *out);
 esp_err_t api_parse_job_submit_request(httpd_req_t *req, api_job_submit_request_t *out);
+esp_err_t api_parse_control_batch_request(httpd_req_t *req, api_control_batch_t *out);
+esp_err_t api_parse_group_create_request(httpd_req_t *req, api_group_create_request_t *out);
+esp_err_t api_parse_group_delete_request(httpd_req_t *req, api_group_delete_request_t *out);
+esp_err_t api_parse_group_member_request(httpd_req_t *req, api_group_member_request_t *out);
+esp_err_t api_parse_group_control_request(httpd_req_t *req, api_group_control_request_t *out);
 
 esp_err_t api_parse_control_json(const char *json, api_control_request_t *out);
 esp_err_t api_parse_delete_json(const char *json, api_delete_request_t *out);
 esp_err_t api_parse_rename_json(const char *json, api_rename_request_t *out);
 esp_err_t api_parse_wifi_save_json(const char *json, api_wifi_save_request_t *out);
 esp_err_t api_parse_job_submit_json(const char *json, api_job_submit_request_t *out);
+/* Body is an array of {addr, ep, cmd}; fails only on broken JSON or an empty or oversized array. */
+esp_err_t api_parse_control_batch_json(const char *json, api_control_batch_t *out);
+/* group_id must be 1..API_GROUP_ID_MAX; higher ids are reserved ZCL addresses. */
+esp_err_t api_parse_group_create_json(const char *json, api_group_create_request_t *out);
+esp_err_t api_parse_group_delete_json(const char *json, api_group_delete_request_t *out);
+esp_err_t api_parse_group_member_json(const char *json, api_group_member_request_t *out);
+esp_err_t api_parse_group_control_json(const char *json, api_group_control_request_t *out);
+
+/* WS RPC params of an already parsed object; same validation as the HTTP bodies. */
+esp_err_t api_parse_control_params(const struct cJSON *params, api_control_request_t *out);
+esp_err_t api_parse_delete_params(const struct cJSON *params, api_delete_request_t *out);
+esp_err_t api_parse_rename_params(const struct cJSON *params, api_rename_request_t *out);
+esp_err_t api_parse_job_submit_params(const struct cJSON *params, api_job_submit_request_t *out);
+gateway_core_job_type_t api_job_type_from_name(const char *type);
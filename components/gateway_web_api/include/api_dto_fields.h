@@ -0,0 +1,207 @@
+#pragma once
+
+#include "api_usecases.h"
+#include "error_ring.h"
+#include "gateway_jobs_facade.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* DTO field tables for dto_codec.h; row order is key and CBOR position order, so schema tables only append. */
+
+/* Link quality codes of the CBOR schema; fixed order, like the JSON "quality" labels. */
+typedef enum {
+    LQI_QUALITY_UNKNOWN = 0,
+    LQI_QUALITY_GOOD,
+    LQI_QUALITY_WARN,
+    LQI_QUALITY_BAD,
+} lqi_quality_t;
+
+/* LQI table row: a device with its parsed neighbor values. */
+typedef struct {
+    uint16_t short_addr;
+    const char *name;
+    bool has_lqi;
+    int lqi;
+    bool has_rssi;
+    int rssi;
+    lqi_quality_t quality;
+    bool direct;
+    zigbee_lqi_source_t source;
+    uint64_t updated_ms;
+    gateway_cmd_stats_t cmd; /* zero until a command is sent */
+    bool has_rtt;
+} api_lqi_row_t;
+
+/* Device row of /status and devices_delta: On/Off from the attribute cache plus interview data. */
+typedef struct {
+    uint16_t short_addr;
+    const char *name;
+    bool has_on_off; /* false until reported or read */
+    int on_off;
+    uint64_t on_off_ms;
+    bool has_ep; /* false if not interviewed or without On/Off */
+    int ep;
+    bool has_manufacturer;
+    const char *manufacturer;
+    bool has_model;
+    const char *model;
+} api_device_row_t;
+
+/* ENUM field labels; code order is fixed by the CBOR schemas. */
+const char *api_lqi_quality_label(lqi_quality_t quality);
+const char *api_lqi_source_label(zigbee_lqi_source_t source);
+const char *api_wifi_link_quality_label(api_system_wifi_link_quality_t quality);
+const char *api_ws_encoding_label(bool binary);
+
+#define API_DTO_NETWORK_STATUS_FIELDS(X) \
+    X(U32, "pan_id", v->pan_id, 0)       \
+    X(U32, "channel", v->channel, 0)     \
+    X(U32, "short_addr", v->short_addr, 0)
+
+/* Device object in /status and devices_delta JSON: name first, as the hand-written builder had it. */
+#define API_DTO_DEVICE_FIELDS(X)                                        \
+    X(TEXT, "name", v->name, 0)                                         \
+    X(U32, "short_addr", v->short_addr, 0)                              \
+    X(OPT_I32, "on_off", v->on_off, v->has_on_off)                      \
+    X(U64, "on_off_ms", v->on_off_ms, 0)                                \
+    X(OPT_I32, "ep", v->ep, v->has_ep)                                  \
+    X(OPT_TEXT, "manufacturer", v->manufacturer, v->has_manufacturer)   \
+    X(OPT_TEXT, "model", v->model, v->has_model)
+
+/* CBOR schema API_CBOR_SCHEMA_DEVICES: the same fields with short_addr at position 0. */
+#define API_DTO_DEVICE_CBOR_FIELDS(X)                                   \
+    X(U32, "short_addr", v->short_addr, 0)                              \
+    X(TEXT, "name", v->name, 0)                                         \
+    X(OPT_I32, "on_off", v->on_off, v->has_on_off)                      \
+    X(U64, "on_off_ms", v->on_off_ms, 0)                                \
+    X(OPT_I32, "ep", v->ep, v->has_ep)                                  \
+    X(OPT_TEXT, "manufacturer", v->manufacturer, v->has_manufacturer)   \
+    X(OPT_TEXT, "model", v->model, v->has_model)
+
+/* CBOR schema API_CBOR_SCHEMA_LQI (one neighbor row). */
+#define API_DTO_LQI_ROW_FIELDS(X)                                  \
+    X(U32, "short_addr", v->short_addr, 0)                         \
+    X(TEXT, "name", v->name, 0)                                    \
+    X(OPT_I32, "lqi", v->lqi, v->has_lqi)                          \
+    X(OPT_I32, "rssi", v->rssi, v->has_rssi)                       \
+    X(ENUM, "quality", v->quality, api_lqi_quality_label)          \
+    X(BOOL, "direct", v->direct, 0)                                \
+    X(ENUM, "source", v->source, api_lqi_source_label)             \
+    X(U64, "updated_ms", v->updated_ms, 0)                         \
+    X(U32, "cmd_sent", v->cmd.sent, 0)                             \
+    X(U32, "cmd_acked", v->cmd.acked, 0)                           \
+    X(U32, "cmd_failed", v->cmd.failed, 0)                         \
+    X(U32, "cmd_timeout", v->cmd.timeout, 0)                       \
+    X(OPT_I32, "rtt_p50_ms", v->cmd.rtt_p50_ms, v->has_rtt)        \
+    X(OPT_I32, "rtt_p95_ms", v->cmd.rtt_p95_ms, v->has_rtt)
+
+/* /diagnostics/{addr}; the RTT histogram is appended separately. */
+#define API_DTO_DEVICE_DIAGNOSTICS_FIELDS(X)                       \
+    X(U32, "short_addr", v->short_addr, 0)                         \
+    X(U32, "sent", v->sent, 0)                                     \
+    X(U32, "acked", v->acked, 0)                                   \
+    X(U32, "failed", v->failed, 0)                                 \
+    X(U32, "timeout", v->timeout, 0)                               \
+    X(U32, "rtt_max_ms", v->rtt_max_ms, 0)                         \
+    X(U64, "updated_ms", v->updated_ms, 0)
+
+/* /jobs/{id} header; "result" is appended separately as raw JSON. */
+#define API_DTO_JOB_INFO_FIELDS(X)                                                                     \
+    X(U32, "job_id", v->id, 0)                                                                         \
+    X(ENUM, "type", v->type, gateway_jobs_type_to_string)                                              \
+    X(ENUM, "state", v->state, gateway_jobs_state_to_string)                                           \
+    X(BOOL, "done", v->state == GATEWAY_CORE_JOB_STATE_SUCCEEDED || v->state == GATEWAY_CORE_JOB_STATE_FAILED, 0) \
+    X(U64, "created_ms", v->created_ms, 0)                                                             \
+    X(U64, "updated_ms", v->updated_ms, 0)                                                             \
+    X(ENUM, "error", v->err, esp_err_to_name)
+
+#define API_DTO_ERROR_ENTRY_FIELDS(X)        \
+    X(U64, "ts_ms", v->ts_ms, 0)             \
+    X(TEXT, "source", v->source, 0)          \
+    X(I32, "code", v->code, 0)               \
+    X(TEXT, "message", v->message, 0)
+
+#define API_DTO_WS_CLIENT_FIELDS(X)                              \
+    X(I32, "fd", v->fd, 0)                                       \
+    X(U32, "queue_depth", v->queue_depth, 0)                     \
+    X(U32, "queue_depth_peak", v->queue_depth_peak, 0)           \
+    X(U32, "dropped_frames", v->dropped_frames, 0)               \
+    X(U32, "coalesced_frames", v->coalesced_frames, 0)           \
+    X(U32, "throttled_frames", v->throttled_frames, 0)           \
+    X(U32, "srtt_us", v->srtt_us, 0)                             \
+    X(U32, "missed_pongs", v->missed_pongs, 0)                   \
+    X(ENUM, "encoding", v->binary, api_ws_encoding_label)
+
+/* /health sections; every table below reads api_health_snapshot_t. */
+#define API_DTO_HEALTH_WIFI_FIELDS(X)                                                       \
+    X(BOOL, "sta_connected", v->wifi_sta_connected, 0)                                      \
+    X(BOOL, "fallback_ap_active", v->wifi_fallback_ap_active, 0)                            \
+    X(BOOL, "loaded_from_nvs", v->wifi_loaded_from_nvs, 0)                                  \
+    X(TEXT, "active_ssid", v->wifi_active_ssid, 0)                                          \
+    X(OPT_I32, "rssi", v->telemetry.wifi_rssi, v->telemetry.has_wifi_rssi)                  \
+    X(ENUM, "link_quality", v->telemetry.wifi_link_quality, api_wifi_link_quality_label)    \
+    X(OPT_TEXT, "ip", v->telemetry.wifi_ip, v->telemetry.has_wifi_ip)
+
+#define API_DTO_HEALTH_ZIGBEE_FIELDS(X)                          \
+    X(BOOL, "started", v->zigbee_started, 0)                     \
+    X(BOOL, "factory_new", v->zigbee_factory_new, 0)             \
+    X(U32, "pan_id", v->zigbee_pan_id, 0)                        \
+    X(U32, "channel", v->zigbee_channel, 0)                      \
+    X(U32, "short_addr", v->zigbee_short_addr, 0)                \
+    X(U32, "events_total", v->zigbee_events.pushed_total, 0)     \
+    X(U32, "events_dropped", v->zigbee_events.dropped_total, 0)  \
+    X(U32, "event_queue_peak", v->zigbee_events.depth_peak, 0)   \
+    X(U32, "event_queue_capacity", v->zigbee_events.capacity, 0)
+
+#define API_DTO_HEALTH_WEB_FIELDS(X)            \
+    X(U32, "ws_clients", v->ws_clients, 0)      \
+    X(BOOL, "ready", true, 0)
+
+#define API_DTO_HEALTH_NVS_FIELDS(X)                        \
+    X(BOOL, "ok", v->nvs_ok, 0)                             \
+    X(I32, "schema_version", v->nvs_schema_version, 0)
+
+#define API_DTO_HEALTH_SYSTEM_FIELDS(X)                                                         \
+    X(U64, "uptime_ms", v->telemetry.uptime_ms, 0)                                              \
+    X(U32, "heap_free", v->telemetry.heap_free, 0)                                              \
+    X(U32, "heap_min", v->telemetry.heap_min, 0)                                                \
+    X(U32, "heap_largest_block", v->telemetry.heap_largest_block, 0)                            \
+    X(I32, "main_stack_hwm_bytes", v->telemetry.main_stack_hwm_bytes, 0)                        \
+    X(I32, "httpd_stack_hwm_bytes", v->telemetry.httpd_stack_hwm_bytes, 0)                      \
+    X(OPT_FIXED2, "temperature_c", v->telemetry.temperature_c, v->telemetry.has_temperature_c)
+
+#define API_DTO_HEALTH_TELEMETRY_FIELDS(X) \
+    X(U64, "updated_ms", v->telemetry.uptime_ms, 0)
+
+#define API_DTO_HEALTH_JOBS_FIELDS(X)                                       \
+    X(U32, "submitted_total", v->jobs_metrics.submitted_total, 0)           \
+    X(U32, "dedup_reused_total", v->jobs_metrics.dedup_reused_total, 0)     \
+    X(U32, "completed_total", v->jobs_metrics.completed_total, 0)           \
+    X(U32, "failed_total", v->jobs_metrics.failed_total, 0)                 \
+    X(U32, "queue_depth", v->jobs_metrics.queue_depth_current, 0)           \
+    X(U32, "queue_depth_peak", v->jobs_metrics.queue_depth_peak, 0)         \
+    X(U32, "latency_p95_ms", v->jobs_metrics.latency_p95_ms, 0)
+
+/* runtime.ws counters; latency and clients follow them. */
+#define API_DTO_HEALTH_WS_FIELDS(X)                                                         \
+    X(U32, "dropped_frames_total", v->ws_metrics.dropped_frames_total, 0)                   \
+    X(U32, "reconnect_count", v->ws_metrics.reconnect_count, 0)                             \
+    X(U32, "connections_total", v->ws_metrics.connections_total, 0)                         \
+    X(U32, "broadcast_requests_total", v->ws_metrics.broadcast_requests_total, 0)           \
+    X(U32, "broadcast_ticks_total", v->ws_metrics.broadcast_ticks_total, 0)                 \
+    X(U32, "broadcast_tick_last_us", v->ws_metrics.broadcast_tick_last_us, 0)               \
+    X(U32, "broadcast_tick_max_us", v->ws_metrics.broadcast_tick_max_us, 0)                 \
+    X(U32, "replay_resumes_total", v->ws_metrics.replay_resumes_total, 0)                   \
+    X(U32, "replay_frames_total", v->ws_metrics.replay_frames_total, 0)                     \
+    X(U32, "replay_resyncs_total", v->ws_metrics.replay_resyncs_total, 0)                   \
+    X(U32, "idle_reaped_total", v->ws_metrics.idle_reaped_total, 0)                         \
+    X(U32, "throttled_frames_total", v->ws_metrics.throttled_frames_total, 0)               \
+    X(U32, "coalesced_frames_total", v->ws_metrics.coalesced_frames_total, 0)               \
+    X(U32, "slow_consumer_evictions_total", v->ws_metrics.slow_consumer_evictions_total, 0) \
+    X(U32, "frame_pool_misses_total", v->ws_metrics.frame_pool_misses_total, 0)             \
+    X(U32, "large_frames_total", v->ws_metrics.large_frames_total, 0)                       \
+    X(U32, "build_failures_total", v->ws_metrics.build_failures_total, 0)                   \
+    X(U32, "binary_frames_total", v->ws_metrics.binary_frames_total, 0)                     \
+    X(U32, "rpc_requests_total", v->ws_metrics.rpc_requests_total, 0)                       \
+    X(U32, "rpc_errors_total", v->ws_metrics.rpc_errors_total, 0)
@@ -7,10 +7,19 @@
 /* API Handlers */
 esp_err_t api_status_handler(httpd_req_t *req);
 esp_err_t api_lqi_handler(httpd_req_t *req);
+esp_err_t api_device_diagnostics_handler(httpd_req_t *req);
 esp_err_t api_permit_join_handler(httpd_req_t *req);
 esp_err_t api_control_handler(httpd_req_t *req);
+esp_err_t api_control_batch_handler(httpd_req_t *req);
 esp_err_t api_delete_device_handler(httpd_req_t *req);
 esp_err_t api_rename_device_handler(httpd_req_t *req);
+esp_err_t api_groups_list_handler(httpd_req_t *req);
+esp_err_t api_group_create_handler(httpd_req_t *req);
+esp_err_t api_group_delete_handler(httpd_req_t *req);
+esp_err_t api_group_add_member_handler(httpd_req_t *req);
+esp_err_t api_group_remove_member_handler(httpd_req_t *req);
+esp_err_t api_group_control_handler(httpd_req_t *req);
+esp_err_t api_topology_handler(httpd_req_t *req);
 esp_err_t api_wifi_scan_handler(httpd_req_t *req);
 esp_err_t api_wifi_save_handler(httpd_req_t *req);
 esp_err_t api_reboot_handler(httpd_req_t *req);
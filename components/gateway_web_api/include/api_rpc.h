@@ -0,0 +1,15 @@
+#pragma once
+
+#include "esp_err.h"
+#include "api_usecases.h"
+
+#include <stddef.h>
+
+struct cJSON;
+
+/**
+ * @brief Run an RPC method through the same usecases as REST; params may be NULL, result gets "null" when empty.
+ * @return ESP_ERR_NOT_SUPPORTED for an unknown method, otherwise the usecase error
+ */
+esp_err_t api_rpc_dispatch(api_usecases_handle_t usecases, const char *method, const struct cJSON *params,
+                           char *result, size_t result_size, const char **out_message);
@@ -5,6 +5,7 @@
 #include "gateway_device_zigbee_facade.h"
 #include "gateway_jobs_facade.h"
 #include "gateway_wifi_system_facade.h"
+#include "latency_histogram.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -55,11 +56,58 @@ typedef struct {
     uint32_t latency_p95_ms;
 } api_job_runtime_metrics_t;
 
+#define API_WS_METRICS_MAX_CLIENTS 8
+
+typedef struct {
+    int32_t fd;
+    uint32_t queue_depth;
+    uint32_t queue_depth_peak;
+    uint32_t dropped_frames;
+    uint32_t coalesced_frames;
+    uint32_t throttled_frames;
+    uint32_t srtt_us;
+    uint32_t missed_pongs;
+    bool binary;
+} api_ws_client_metrics_t;
+
+/* Same order as the devices_delta, health_state and lqi_update WS events. */
+typedef enum {
+    API_WS_LATENCY_DEVICES = 0,
+    API_WS_LATENCY_HEALTH,
+    API_WS_LATENCY_LQI,
+    API_WS_LATENCY_KIND_COUNT,
+} api_ws_latency_kind_t;
+
+/* Latency from the source event to a built payload (serialize) and to the socket (sent). */
+typedef struct {
+    api_latency_histogram_t serialize;
+    api_latency_histogram_t sent;
+} api_ws_event_latency_t;
+
 typedef struct {
     uint32_t dropped_frames_total;
     uint32_t reconnect_count;
     uint32_t connections_total;
-    uint32_t broadcast_lock_skips_total;
+    uint32_t broadcast_requests_total;
+    uint32_t broadcast_ticks_total;
+    uint32_t broadcast_tick_last_us;
+    uint32_t broadcast_tick_max_us;
+    uint32_t replay_resumes_total;
+    uint32_t replay_frames_total;
+    uint32_t replay_resyncs_total;
+    uint32_t idle_reaped_total;
+    uint32_t throttled_frames_total;
+    uint32_t coalesced_frames_total;
+    uint32_t slow_consumer_evictions_total;
+    uint32_t frame_pool_misses_total;
+    uint32_t large_frames_total;
+    uint32_t build_failures_total;
+    uint32_t binary_frames_total;
+    uint32_t rpc_requests_total;
+    uint32_t rpc_errors_total;
+    api_ws_event_latency_t latency[API_WS_LATENCY_KIND_COUNT];
+    uint32_t client_count;
+    api_ws_client_metrics_t clients[API_WS_METRICS_MAX_CLIENTS];
 } api_ws_runtime_metrics_t;
 
 typedef struct {
@@ -68,6 +116,7 @@ typedef struct {
     uint32_t zigbee_pan_id;
     uint32_t zigbee_channel;
     uint32_t zigbee_short_addr;
+    gateway_zigbee_event_stats_t zigbee_events;
 
     bool wifi_sta_connected;
     bool wifi_fallback_ap_active;
@@ -110,7 +159,10 @@ void api_usecases_set_runtime_handles(api_usecases_handle_t handle, zigbee_servi
 void api_usecases_set_ws_providers(api_usecases_handle_t handle, api_ws_client_count_provider_t count_provider,
                                    api_ws_metrics_provider_t metrics_provider, api_ws_provider_ctx_t *provider_ctx);
 
+/* With in->confirm, returns after the Default Response or ESP_ERR_TIMEOUT. */
 esp_err_t api_usecase_control(api_usecases_handle_t handle, const api_control_request_t *in);
+/* Sends items with results[i] == ESP_OK as one batch and stores their outcomes. */
+esp_err_t api_usecase_control_batch(api_usecases_handle_t handle, api_control_batch_t *batch);
 esp_err_t api_usecase_wifi_save(api_usecases_handle_t handle, const api_wifi_save_request_t *in);
 esp_err_t api_usecase_factory_reset(api_usecases_handle_t handle);
 esp_err_t api_usecase_get_network_status(api_usecases_handle_t handle, zigbee_network_status_t *out_status);
@@ -119,9 +171,31 @@ int api_usecase_get_neighbor_lqi_snapshot(api_usecases_handle_t handle, zigbee_n
 esp_err_t api_usecase_get_cached_lqi_snapshot(api_usecases_handle_t handle, zigbee_neighbor_lqi_t *out_neighbors,
                                               int max_neighbors, int *out_count, zigbee_lqi_source_t *out_source,
                                               uint64_t *out_updated_ms);
+int api_usecase_get_cmd_stats_snapshot(api_usecases_handle_t handle, gateway_cmd_stats_t *out_stats, int max_stats);
+/* Latest cached values of (cluster_id, attr_id) from reports and reads. */
+int api_usecase_get_attr_snapshot(api_usecases_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                  gateway_attr_entry_t *out_attrs, int max_attrs);
+/* Interview results (On/Off endpoint, manufacturer, model); devices not yet interviewed are absent. */
+int api_usecase_get_device_profiles(api_usecases_handle_t handle, gateway_device_profile_t *out_profiles,
+                                    int max_profiles);
+esp_err_t api_usecase_get_topology_summary(api_usecases_handle_t handle, gateway_topology_summary_t *out);
+/* Nodes or edges of crawl_id from index `from`; -1 once another crawl owns the graph. */
+int api_usecase_get_topology_nodes(api_usecases_handle_t handle, uint32_t crawl_id, size_t from,
+                                   gateway_topology_node_t *out, size_t max_items);
+int api_usecase_get_topology_edges(api_usecases_handle_t handle, uint32_t crawl_id, size_t from,
+                                   gateway_topology_edge_t *out, size_t max_items);
+esp_err_t api_usecase_get_state_generation(api_usecases_handle_t handle, zigbee_state_generation_t *out_generation);
 esp_err_t api_usecase_permit_join(api_usecases_handle_t handle, uint8_t duration_seconds);
 esp_err_t api_usecase_delete_device(api_usecases_handle_t handle, uint16_t short_addr);
 esp_err_t api_usecase_rename_device(api_usecases_handle_t handle, uint16_t short_addr, const char *name);
+esp_err_t api_usecase_group_create(api_usecases_handle_t handle, const api_group_create_request_t *in,
+                                   uint16_t *out_group_id);
+esp_err_t api_usecase_group_delete(api_usecases_handle_t handle, const api_group_delete_request_t *in);
+esp_err_t api_usecase_group_add_member(api_usecases_handle_t handle, const api_group_member_request_t *in);
+esp_err_t api_usecase_group_remove_member(api_usecases_handle_t handle, const api_group_member_request_t *in);
+/* One group-cast frame instead of a command per member. */
+esp_err_t api_usecase_group_control(api_usecases_handle_t handle, const api_group_control_request_t *in);
+int api_usecase_get_groups_snapshot(api_usecases_handle_t handle, zigbee_group_t *out_groups, int max_groups);
 esp_err_t api_usecase_wifi_scan(api_usecases_handle_t handle, wifi_ap_info_t **out_list, size_t *out_count);
 void api_usecase_wifi_scan_free(api_usecases_handle_t handle, wifi_ap_info_t *list);
 esp_err_t api_usecase_schedule_reboot(api_usecases_handle_t handle, uint32_t delay_ms);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Minimal CBOR (RFC 8949) encoder for WS frames; false means the item did not fit and nothing was written. */
+
+bool cbor_put_uint(uint8_t **cursor, size_t *remaining, uint64_t value);
+bool cbor_put_int(uint8_t **cursor, size_t *remaining, int64_t value);
+bool cbor_put_text(uint8_t **cursor, size_t *remaining, const char *text);
+bool cbor_put_array(uint8_t **cursor, size_t *remaining, size_t count);
+bool cbor_put_bool(uint8_t **cursor, size_t *remaining, bool value);
+bool cbor_put_null(uint8_t **cursor, size_t *remaining);
+/* IEEE 754 single precision (major type 7, 0xfa). */
+bool cbor_put_float(uint8_t **cursor, size_t *remaining, float value);
+
+/* Exact byte count of the matching cbor_put_*; bool/null are always 1 byte, float is 5. */
+size_t cbor_len_uint(uint64_t value);
+size_t cbor_len_int(int64_t value);
+size_t cbor_len_text(const char *text);
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "cbor_writer.h"
+#include "json_writer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Serializers generated from X-macro field tables (api_dto_fields.h); a row is X(KIND, "key", value, aux)
+ * over `v`. For ENUM aux maps the value to its JSON label; for OPT_* aux is the presence test (else null).
+ * DTO_DEFINE(prefix, type, FIELDS) emits prefix_put_json[_members], prefix_json_len, prefix_put_cbor and
+ * prefix_cbor_len; CBOR writes the values as an array in table order.
+ */
+
+#define DTO_JSON_KEY(key) ",\"" key "\":"
+#define DTO_JSON_KEY_LEN(key) (sizeof(DTO_JSON_KEY(key)) - 1)
+/* The first member skips the leading comma instead of patching it afterwards. */
+#define DTO_JSON_PUT_KEY(lit)                                  \
+    json_put_raw(w, (lit) + first, sizeof(lit) - 1 - first);   \
+    first = 0;
+
+#define DTO_JSON_PUT_BOOL(key, value, aux) DTO_JSON_PUT_KEY(DTO_JSON_KEY(key)) json_put_bool(w, (value));
+#define DTO_JSON_PUT_U32(key, value, aux) DTO_JSON_PUT_KEY(DTO_JSON_KEY(key)) json_put_u32(w, (value));
+#define DTO_JSON_PUT_U64(key, value, aux) DTO_JSON_PUT_KEY(DTO_JSON_KEY(key)) json_put_u64(w, (value));
+#define DTO_JSON_PUT_I32(key, value, aux) DTO_JSON_PUT_KEY(DTO_JSON_KEY(key)) json_put_i32(w, (value));
+#define DTO_JSON_PUT_TEXT(key, value, aux) \
+    DTO_JSON_PUT_KEY(DTO_JSON_KEY(key) "\"") json_put_escaped(w, (value)); json_put_lit(w, "\"");
+#define DTO_JSON_PUT_ENUM(key, value, aux) \
+    DTO_JSON_PUT_KEY(DTO_JSON_KEY(key) "\"") json_put_str(w, aux(value)); json_put_lit(w, "\"");
+#define DTO_JSON_PUT_OPT_I32(key, value, aux)         \
+    DTO_JSON_PUT_KEY(DTO_JSON_KEY(key))               \
+    if (aux) {                                        \
+        json_put_i32(w, (value));                     \
+    } else {                                          \
+        json_put_lit(w, "null");                      \
+    }
+#define DTO_JSON_PUT_OPT_TEXT(key, value, aux)        \
+    DTO_JSON_PUT_KEY(DTO_JSON_KEY(key))               \
+    if (aux) {                                        \
+        json_put_lit(w, "\"");                        \
+        json_put_escaped(w, (value));                 \
+        json_put_lit(w, "\"");                        \
+    } else {                                          \
+        json_put_lit(w, "null");                      \
+    }
+#define DTO_JSON_PUT_OPT_FIXED2(key, value, aux)      \
+    DTO_JSON_PUT_KEY(DTO_JSON_KEY(key))               \
+    if (aux) {                                        \
+        json_put_fixed2(w, (double)(value));          \
+    } else {                                          \
+        json_put_lit(w, "null");                      \
+    }
+
+#define DTO_JSON_LEN_BOOL(key, value, aux) + DTO_JSON_KEY_LEN(key) + json_len_bool(value)
+#define DTO_JSON_LEN_U32(key, value, aux) + DTO_JSON_KEY_LEN(key) + json_len_u32(value)
+#define DTO_JSON_LEN_U64(key, value, aux) + DTO_JSON_KEY_LEN(key) + json_len_u64(value)
+#define DTO_JSON_LEN_I32(key, value, aux) + DTO_JSON_KEY_LEN(key) + json_len_i32(value)
+#define DTO_JSON_LEN_TEXT(key, value, aux) + DTO_JSON_KEY_LEN(key) + 2 + json_len_escaped(value)
+#define DTO_JSON_LEN_ENUM(key, value, aux) + DTO_JSON_KEY_LEN(key) + 2 + strlen(aux(value))
+#define DTO_JSON_LEN_OPT_I32(key, value, aux) + DTO_JSON_KEY_LEN(key) + ((aux) ? json_len_i32(value) : 4)
+#define DTO_JSON_LEN_OPT_TEXT(key, value, aux) + DTO_JSON_KEY_LEN(key) + ((aux) ? 2 + json_len_escaped(value) : 4)
+#define DTO_JSON_LEN_OPT_FIXED2(key, value, aux) \
+    + DTO_JSON_KEY_LEN(key) + ((aux) ? json_len_fixed2((double)(value)) : 4)
+
+#define DTO_CBOR_PUT_BOOL(value, aux) && cbor_put_bool(cursor, remaining, (value))
+#define DTO_CBOR_PUT_U32(value, aux) && cbor_put_uint(cursor, remaining, (value))
+#define DTO_CBOR_PUT_U64(value, aux) && cbor_put_uint(cursor, remaining, (value))
+#define DTO_CBOR_PUT_I32(value, aux) && cbor_put_int(cursor, remaining, (value))
+#define DTO_CBOR_PUT_TEXT(value, aux) && cbor_put_text(cursor, remaining, (value))
+#define DTO_CBOR_PUT_ENUM(value, aux) && cbor_put_int(cursor, remaining, (int64_t)(value))
+#define DTO_CBOR_PUT_OPT_I32(value, aux) \
+    && ((aux) ? cbor_put_int(cursor, remaining, (value)) : cbor_put_null(cursor, remaining))
+#define DTO_CBOR_PUT_OPT_TEXT(value, aux) \
+    && ((aux) ? cbor_put_text(cursor, remaining, (value)) : cbor_put_null(cursor, remaining))
+#define DTO_CBOR_PUT_OPT_FIXED2(value, aux) \
+    && ((aux) ? cbor_put_float(cursor, remaining, (float)(value)) : cbor_put_null(cursor, remaining))
+
+#define DTO_CBOR_LEN_BOOL(value, aux) + 1
+#define DTO_CBOR_LEN_U32(value, aux) + cbor_len_uint(value)
+#define DTO_CBOR_LEN_U64(value, aux) + cbor_len_uint(value)
+#define DTO_CBOR_LEN_I32(value, aux) + cbor_len_int(value)
+#define DTO_CBOR_LEN_TEXT(value, aux) + cbor_len_text(value)
+#define DTO_CBOR_LEN_ENUM(value, aux) + cbor_len_int((int64_t)(value))
+#define DTO_CBOR_LEN_OPT_I32(value, aux) + ((aux) ? cbor_len_int(value) : 1)
+#define DTO_CBOR_LEN_OPT_TEXT(value, aux) + ((aux) ? cbor_len_text(value) : 1)
+#define DTO_CBOR_LEN_OPT_FIXED2(value, aux) + ((aux) ? 5 : 1)
+
+#define DTO_X_JSON_PUT(kind, key, value, aux) DTO_JSON_PUT_##kind(key, value, aux)
+#define DTO_X_JSON_LEN(kind, key, value, aux) DTO_JSON_LEN_##kind(key, value, aux)
+#define DTO_X_CBOR_PUT(kind, key, value, aux) DTO_CBOR_PUT_##kind(value, aux)
+#define DTO_X_CBOR_LEN(kind, key, value, aux) DTO_CBOR_LEN_##kind(value, aux)
+#define DTO_X_COUNT(kind, key, value, aux) + 1
+
+#define DTO_DEFINE(prefix, type, FIELDS)                                                        \
+    static inline void prefix##_put_json_members(json_writer_t *w, const type *v, bool first_member) \
+    {                                                                                           \
+        size_t first = first_member ? 1 : 0;                                                    \
+        (void)v;                                                                                \
+        FIELDS(DTO_X_JSON_PUT)                                                                  \
+        (void)first;                                                                            \
+    }                                                                                           \
+    static inline void prefix##_put_json(json_writer_t *w, const type *v)                      \
+    {                                                                                           \
+        json_put_lit(w, "{");                                                                   \
+        prefix##_put_json_members(w, v, true);                                                  \
+        json_put_lit(w, "}");                                                                   \
+    }                                                                                           \
+    static inline size_t prefix##_json_len(const type *v)                                       \
+    {                                                                                           \
+        (void)v;                                                                                \
+        return 1 FIELDS(DTO_X_JSON_LEN);                                                        \
+    }                                                                                           \
+    static inline bool prefix##_put_cbor(uint8_t **cursor, size_t *remaining, const type *v)   \
+    {                                                                                           \
+        (void)v;                                                                                \
+        return cbor_put_array(cursor, remaining, 0 FIELDS(DTO_X_COUNT)) FIELDS(DTO_X_CBOR_PUT); \
+    }                                                                                           \
+    static inline size_t prefix##_cbor_len(const type *v)                                       \
+    {                                                                                           \
+        (void)v;                                                                                \
+        return cbor_len_uint(0 FIELDS(DTO_X_COUNT)) FIELDS(DTO_X_CBOR_LEN);                     \
+    }
@@ -2,9 +2,13 @@
 
 #include "esp_err.h"
 #include "api_usecases.h"
+#include "json_writer.h"
 
 #include <stddef.h>
 
+/* Writes the health JSON to a buffered or streaming writer; snapshot errors return before any write. */
+esp_err_t write_health_json(api_usecases_handle_t usecases, json_writer_t *w);
+
 /**
  * @brief Побудувати компактний JSON зі станом health.
  * @param out буфер призначення
@@ -4,11 +4,38 @@
 
 #include "esp_err.h"
 #include "esp_http_server.h"
+#include "json_writer.h"
 
 typedef bool (*http_error_map_provider_t)(esp_err_t err, int *out_http_status, const char **out_error_code);
 
 bool http_error_map_provider_hook(esp_err_t err, int *out_http_status, const char **out_error_code);
 esp_err_t http_error_send(httpd_req_t *req, int http_status, const char *code, const char *message);
 esp_err_t http_error_send_esp(httpd_req_t *req, esp_err_t err, const char *message);
+const char *http_error_code_name(esp_err_t err);
 esp_err_t http_success_send(httpd_req_t *req, const char *message);
 esp_err_t http_success_send_data_json(httpd_req_t *req, const char *data_json);
+
+/* Conditional GET: the ETag goes out with Cache-Control: no-cache, so clients revalidate via If-None-Match. */
+bool http_req_etag_matches(httpd_req_t *req, const char *etag);
+void http_etag_headers_set(httpd_req_t *req, const char *etag);
+esp_err_t http_not_modified_send(httpd_req_t *req, const char *etag);
+
+#define HTTP_JSON_STREAM_CHUNK_SIZE 512
+
+/*
+ * Chunked {"status":"ok","data":...} response through a fixed json_writer window. Until
+ * http_json_stream_started() is true nothing was sent, so errors can still use http_error_send*.
+ */
+typedef struct {
+    httpd_req_t *req;
+    json_writer_sink_t tee;
+    void *tee_ctx;
+    json_writer_t writer;
+    char chunk[HTTP_JSON_STREAM_CHUNK_SIZE];
+} http_json_stream_t;
+
+void http_json_stream_begin(httpd_req_t *req, http_json_stream_t *stream);
+/* Extra sink for the response bytes, e.g. a cache fill; call after begin. */
+void http_json_stream_tee(http_json_stream_t *stream, json_writer_sink_t sink, void *ctx);
+bool http_json_stream_started(const http_json_stream_t *stream);
+esp_err_t http_json_stream_end(http_json_stream_t *stream);
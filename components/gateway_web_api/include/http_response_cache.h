@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define HTTP_RESPONSE_CACHE_BODY_MAX 4096
+#define HTTP_RESPONSE_ETAG_SIZE 48
+
+typedef enum {
+    HTTP_RESPONSE_CACHE_STATUS = 0,
+    HTTP_RESPONSE_CACHE_LQI,
+    HTTP_RESPONSE_CACHE_SLOT_COUNT,
+} http_response_cache_slot_t;
+
+/*
+ * Last GET response per endpoint, keyed by an ETag built from the state generation. Bodies over
+ * HTTP_RESPONSE_CACHE_BODY_MAX are streamed every time but still get 304. Only the httpd task uses it.
+ */
+typedef struct {
+    char etag[HTTP_RESPONSE_ETAG_SIZE];
+    char *body;
+    size_t len;
+    size_t capacity;
+    bool filling;
+} http_response_cache_entry_t;
+
+typedef struct {
+    http_response_cache_entry_t entries[HTTP_RESPONSE_CACHE_SLOT_COUNT];
+} http_response_cache_t;
+
+/* If-None-Match: "*" or a comma list; W/ is ignored (weak comparison, RFC 9110). */
+bool http_etag_matches(const char *if_none_match, const char *etag);
+
+/* The slot body if it is complete and stored under this ETag, else NULL. */
+const http_response_cache_entry_t *http_response_cache_lookup(const http_response_cache_t *cache,
+                                                              http_response_cache_slot_t slot, const char *etag);
+
+/* Refill: begin invalidates, fill_sink (a json_writer_sink_t) appends, commit publishes; else the slot stays empty. */
+http_response_cache_entry_t *http_response_cache_fill_begin(http_response_cache_t *cache, http_response_cache_slot_t slot);
+bool http_response_cache_fill_sink(void *ctx, const char *data, size_t len);
+void http_response_cache_fill_commit(http_response_cache_entry_t *entry, const char *etag);
+
+void http_response_cache_release(http_response_cache_t *cache);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Heap-free single-pass reader of a flat JSON object; wanted keys come back as slices of the input.
+ * Matches cJSON_Parse + cJSON_GetObjectItem (case-insensitive keys, first duplicate wins, trailing
+ * text ignored, strtod numbers) except that nesting is capped at JSON_READER_MAX_DEPTH.
+ */
+
+#define JSON_READER_MAX_DEPTH 8
+
+typedef enum {
+    JSON_READER_ABSENT = 0,
+    JSON_READER_NUMBER,
+    JSON_READER_STRING,
+    JSON_READER_OTHER, /* null, true/false, object or array */
+} json_reader_kind_t;
+
+typedef struct {
+    json_reader_kind_t kind;
+    const char *start; /* strings: first byte after the quote */
+    const char *end;   /* strings: the closing quote */
+} json_reader_value_t;
+
+/* Scans up to '\0', filling values in parallel with keys; false if the text is not a valid object. */
+bool json_reader_scan_object(const char *json, const char *const *keys, size_t key_count, json_reader_value_t *values);
+
+/* Integer like cJSON valueint: truncated and saturated to int. */
+bool json_reader_get_int(const json_reader_value_t *value, int *out);
+
+/* true/false like cJSON_IsBool; anything else fails. */
+bool json_reader_get_bool(const json_reader_value_t *value, bool *out);
+
+/* Unescaped string into out; false if not a string or too long. out_len stops at the first '\0', like strlen. */
+bool json_reader_get_string(const json_reader_value_t *value, char *out, size_t out_size, size_t *out_len);
+
+/* Root array iterator; each element is syntax-checked and returned as a slice. */
+typedef struct {
+    const char *cursor;
+} json_reader_array_t;
+
+/* false if the root, after BOM and whitespace, is not '['. */
+bool json_reader_array_begin(const char *json, json_reader_array_t *it);
+
+/* Next element, JSON_READER_ABSENT after the last; objects start at '{' for json_reader_scan_object. false on syntax errors. */
+bool json_reader_array_next(json_reader_array_t *it, json_reader_value_t *out);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Compact JSON writer for the status/lqi/health builders. Overflow is sticky and checked once in
+ * json_writer_finish(); in stream mode the buffer is a chunk window flushed to the sink.
+ */
+typedef bool (*json_writer_sink_t)(void *ctx, const char *data, size_t len);
+
+typedef struct {
+    char *start;
+    char *cursor;
+    char *end; /* last byte is kept for '\0' */
+    bool overflow;
+    json_writer_sink_t sink;
+    void *sink_ctx;
+    size_t flushed; /* bytes already passed to the sink */
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size);
+void json_writer_init_stream(json_writer_t *w, char *buf, size_t size, json_writer_sink_t sink, void *sink_ctx);
+/* Terminates or flushes the document; false on overflow or sink failure. out_len excludes '\0'. */
+bool json_writer_finish(json_writer_t *w, size_t *out_len);
+
+void json_put_raw(json_writer_t *w, const char *data, size_t len);
+/* String literals only: the length comes from sizeof. */
+#define json_put_lit(w, lit) json_put_raw((w), "" lit, sizeof(lit) - 1)
+/* Unescaped string, for labels from a fixed set. */
+void json_put_str(json_writer_t *w, const char *text);
+/* JSON string contents without quotes; '"', '\\' and control bytes are escaped. */
+void json_put_escaped(json_writer_t *w, const char *text);
+void json_put_u32(json_writer_t *w, uint32_t value);
+void json_put_u64(json_writer_t *w, uint64_t value);
+void json_put_i32(json_writer_t *w, int32_t value);
+void json_put_bool(json_writer_t *w, bool value);
+/* Two decimal places, like "%.2f". */
+void json_put_fixed2(json_writer_t *w, double value);
+
+/* Exact length the matching json_put_* writes, for sizing allocations. */
+size_t json_len_u32(uint32_t value);
+size_t json_len_u64(uint64_t value);
+size_t json_len_i32(int32_t value);
+size_t json_len_escaped(const char *text);
+size_t json_len_fixed2(double value);
+static inline size_t json_len_bool(bool value)
+{
+    return value ? 4 : 5;
+}
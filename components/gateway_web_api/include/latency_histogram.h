@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Latency histogram with bucket bounds of 1, 2, 5, 10, 25, 50, 100, 250, 500, 1000 ms and an overflow bucket. */
+#define API_LATENCY_BUCKET_COUNT 11
+
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t buckets[API_LATENCY_BUCKET_COUNT];
+} api_latency_histogram_t;
+
+void api_latency_histogram_record(api_latency_histogram_t *hist, uint32_t sample_us);
+/* Upper bound of a bucket in ms; UINT32_MAX for the overflow bucket. */
+uint32_t api_latency_histogram_bucket_bound_ms(size_t bucket);
+/* Upper bound of the bucket holding the percentile (1..100); max for the overflow bucket. */
+uint32_t api_latency_histogram_percentile_ms(const api_latency_histogram_t *hist, uint32_t percentile);
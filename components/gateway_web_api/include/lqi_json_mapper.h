@@ -1,7 +1,17 @@
 #pragma once
 
 #include "esp_err.h"
+#include "api_dto_fields.h"
 #include "api_usecases.h"
+#include "json_writer.h"
 #include <stddef.h>
 
+/* CBOR schema id of lqi_update frames: [updated_ms, source, [neighbor rows]]. */
+#define API_CBOR_SCHEMA_LQI 2
+
+/* Writes /lqi to a buffered or streaming writer; a snapshot error returns before anything is written. */
+esp_err_t write_lqi_json(api_usecases_handle_t usecases, json_writer_t *w);
+/* Command counters and RTT histogram of one device; ESP_ERR_NOT_FOUND when it is not in the list. */
+esp_err_t write_device_diagnostics_json(api_usecases_handle_t usecases, uint16_t short_addr, json_writer_t *w);
 esp_err_t build_lqi_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len);
+esp_err_t build_lqi_cbor_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len);
@@ -2,9 +2,18 @@
 
 #include "esp_err.h"
 #include "api_usecases.h"
+#include "json_writer.h"
 
 #include <stddef.h>
 
+/* CBOR schema id of devices_delta: one API_DTO_DEVICE_CBOR_FIELDS array per device. */
+#define API_CBOR_SCHEMA_DEVICES 1
+
 char *create_status_json(api_usecases_handle_t usecases);
+/* Writes /status to a buffered or streaming writer; snapshot errors return before any write. */
+esp_err_t write_status_json(api_usecases_handle_t usecases, json_writer_t *w);
 esp_err_t build_status_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len);
+/* Writes the devices_delta payload ({"devices":[...]}) to a buffered or streaming writer. */
+esp_err_t write_devices_json(api_usecases_handle_t usecases, json_writer_t *w);
 esp_err_t build_devices_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len);
+esp_err_t build_devices_cbor_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len);
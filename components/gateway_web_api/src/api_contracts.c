@@ -1,5 +1,6 @@
 #include "api_contracts.h"
 #include "cJSON.h"
+#include "json_reader.h"
 #include <string.h>
 
 static bool valid_short_addr(int value)
@@ -7,134 +8,350 @@ static bool valid_short_addr(int value)
     return value > 0 && value <= 0xFFFF;
 }
 
-static esp_err_t parse_control_root(cJSON *root, api_control_request_t *out)
+static bool valid_group_id(int value)
 {
-    cJSON *addr_item = cJSON_GetObjectItem(root, "addr");
-    cJSON *ep_item = cJSON_GetObjectItem(root, "ep");
-    cJSON *cmd_item = cJSON_GetObjectItem(root, "cmd");
-    if (!cJSON_IsNumber(addr_item) || !cJSON_IsNumber(ep_item) || !cJSON_IsNumber(cmd_item)) {
+    return value > 0 && value <= API_GROUP_ID_MAX;
+}
+
+typedef struct {
+    const char *name;
+    uint8_t len;
+    gateway_core_job_type_t type;
+} job_type_entry_t;
+
+/* Perfect hash: (len ^ name[1]) & 7 is collision-free for the job names; empty slots have len 0. */
+#define JOB_TYPE_HASH(name, len) ((((unsigned)(len)) ^ (unsigned char)(name)[1]) & 7u)
+
+static const job_type_entry_t s_job_types[8] = {
+    [1] = {"topology_crawl", 14, GATEWAY_CORE_JOB_TYPE_TOPOLOGY_CRAWL},
+    [2] = {"lqi_refresh", 11, GATEWAY_CORE_JOB_TYPE_LQI_REFRESH},
+    [3] = {"reboot", 6, GATEWAY_CORE_JOB_TYPE_REBOOT},
+    [4] = {"factory_reset", 13, GATEWAY_CORE_JOB_TYPE_FACTORY_RESET},
+    [6] = {"update", 6, GATEWAY_CORE_JOB_TYPE_UPDATE},
+    [7] = {"scan", 4, GATEWAY_CORE_JOB_TYPE_WIFI_SCAN},
+};
+
+static const job_type_entry_t *job_type_lookup(const char *name, size_t len)
+{
+    if (!name || len < 2) {
+        return NULL;
+    }
+    const job_type_entry_t *entry = &s_job_types[JOB_TYPE_HASH(name, len)];
+    return (entry->len == len && memcmp(entry->name, name, len) == 0) ? entry : NULL;
+}
+
+/*
+ * Validation shared by the streaming parser (HTTP bodies) and the cJSON one (WS RPC params):
+ * both only extract typed values and hand them over here.
+ */
+static esp_err_t control_from_values(int addr, int ep, int cmd, bool confirm, api_control_request_t *out)
+{
+    if (!valid_short_addr(addr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ep <= 0 || ep > 240) {
         return ESP_ERR_INVALID_ARG;
     }
+    if (!(cmd == 0 || cmd == 1)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    out->addr = (uint16_t)addr;
+    out->ep = (uint8_t)ep;
+    out->cmd = (uint8_t)cmd;
+    out->confirm = confirm;
+    return ESP_OK;
+}
 
-    if (!valid_short_addr(addr_item->valueint)) {
+static esp_err_t delete_from_values(int short_addr, api_delete_request_t *out)
+{
+    if (!valid_short_addr(short_addr)) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (ep_item->valueint <= 0 || ep_item->valueint > 240) {
+    out->short_addr = (uint16_t)short_addr;
+    return ESP_OK;
+}
+
+static esp_err_t rename_from_values(int short_addr, const char *name, size_t name_len, api_rename_request_t *out)
+{
+    if (!valid_short_addr(short_addr)) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (!(cmd_item->valueint == 0 || cmd_item->valueint == 1)) {
+    if (name_len == 0 || name_len > API_DEVICE_NAME_MAX_LEN) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    out->addr = (uint16_t)addr_item->valueint;
-    out->ep = (uint8_t)ep_item->valueint;
-    out->cmd = (uint8_t)cmd_item->valueint;
+    out->short_addr = (uint16_t)short_addr;
+    memcpy(out->name, name, name_len);
+    out->name[name_len] = '\0';
     return ESP_OK;
 }
 
-static esp_err_t parse_delete_root(cJSON *root, api_delete_request_t *out)
+static esp_err_t wifi_save_from_values(const char *ssid, size_t ssid_len, const char *password, size_t pass_len,
+                                       api_wifi_save_request_t *out)
 {
-    cJSON *addr_item = cJSON_GetObjectItem(root, "short_addr");
-    if (!cJSON_IsNumber(addr_item)) {
+    if (ssid_len == 0 || ssid_len > API_WIFI_SSID_MAX_LEN ||
+        pass_len < 8 || pass_len > API_WIFI_PASSWORD_MAX_LEN)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(out->ssid, ssid, ssid_len);
+    out->ssid[ssid_len] = '\0';
+    memcpy(out->password, password, pass_len);
+    out->password[pass_len] = '\0';
+    return ESP_OK;
+}
+
+static esp_err_t job_submit_from_values(const char *type, size_t type_len, bool has_delay, int delay_ms,
+                                        api_job_submit_request_t *out)
+{
+    if (!job_type_lookup(type, type_len)) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (!valid_short_addr(addr_item->valueint)) {
+    if (has_delay && (delay_ms < 0 || delay_ms > 60000)) {
         return ESP_ERR_INVALID_ARG;
     }
-    out->short_addr = (uint16_t)addr_item->valueint;
+
+    memcpy(out->type, type, type_len);
+    out->type[type_len] = '\0';
+    out->reboot_delay_ms = has_delay ? (uint32_t)delay_ms : 1000;
     return ESP_OK;
 }
 
-static esp_err_t parse_rename_root(cJSON *root, api_rename_request_t *out)
+static esp_err_t group_member_from_values(int group_id, int addr, int ep, api_group_member_request_t *out)
 {
-    cJSON *addr_item = cJSON_GetObjectItem(root, "short_addr");
-    cJSON *name_item = cJSON_GetObjectItem(root, "name");
-    if (!cJSON_IsNumber(addr_item) || !cJSON_IsString(name_item) || !name_item->valuestring) {
+    if (!valid_group_id(group_id) || !valid_short_addr(addr) || ep <= 0 || ep > 240) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    out->group_id = (uint16_t)group_id;
+    out->addr = (uint16_t)addr;
+    out->ep = (uint8_t)ep;
+    return ESP_OK;
+}
+
+static esp_err_t parse_control_root(const cJSON *root, api_control_request_t *out)
+{
+    const cJSON *addr_item = cJSON_GetObjectItem(root, "addr");
+    const cJSON *ep_item = cJSON_GetObjectItem(root, "ep");
+    const cJSON *cmd_item = cJSON_GetObjectItem(root, "cmd");
+    const cJSON *confirm_item = cJSON_GetObjectItem(root, "confirm");
+    if (!cJSON_IsNumber(addr_item) || !cJSON_IsNumber(ep_item) || !cJSON_IsNumber(cmd_item)) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (!valid_short_addr(addr_item->valueint)) {
+    if (confirm_item != NULL && !cJSON_IsBool(confirm_item)) {
         return ESP_ERR_INVALID_ARG;
     }
+    return control_from_values(addr_item->valueint, ep_item->valueint, cmd_item->valueint, cJSON_IsTrue(confirm_item),
+                               out);
+}
 
-    size_t name_len = strlen(name_item->valuestring);
-    if (name_len == 0 || name_len > API_DEVICE_NAME_MAX_LEN) {
+static esp_err_t parse_delete_root(const cJSON *root, api_delete_request_t *out)
+{
+    const cJSON *addr_item = cJSON_GetObjectItem(root, "short_addr");
+    if (!cJSON_IsNumber(addr_item)) {
         return ESP_ERR_INVALID_ARG;
     }
+    return delete_from_values(addr_item->valueint, out);
+}
 
-    out->short_addr = (uint16_t)addr_item->valueint;
-    strlcpy(out->name, name_item->valuestring, sizeof(out->name));
-    return ESP_OK;
+static esp_err_t parse_rename_root(const cJSON *root, api_rename_request_t *out)
+{
+    const cJSON *addr_item = cJSON_GetObjectItem(root, "short_addr");
+    const cJSON *name_item = cJSON_GetObjectItem(root, "name");
+    if (!cJSON_IsNumber(addr_item) || !cJSON_IsString(name_item) || !name_item->valuestring) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return rename_from_values(addr_item->valueint, name_item->valuestring, strlen(name_item->valuestring), out);
 }
 
-static esp_err_t parse_wifi_save_root(cJSON *root, api_wifi_save_request_t *out)
+static esp_err_t parse_job_submit_root(const cJSON *root, api_job_submit_request_t *out)
 {
-    cJSON *ssid_item = cJSON_GetObjectItem(root, "ssid");
-    cJSON *pass_item = cJSON_GetObjectItem(root, "password");
-    if (!cJSON_IsString(ssid_item) || !ssid_item->valuestring ||
-        !cJSON_IsString(pass_item) || !pass_item->valuestring)
+    const cJSON *type_item = cJSON_GetObjectItem(root, "type");
+    if (!cJSON_IsString(type_item) || !type_item->valuestring) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const cJSON *delay_item = cJSON_GetObjectItem(root, "reboot_delay_ms");
+    if (delay_item != NULL && !cJSON_IsNumber(delay_item)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return job_submit_from_values(type_item->valuestring, strlen(type_item->valuestring), delay_item != NULL,
+                                  delay_item ? delay_item->valueint : 0, out);
+}
+
+/* Request bodies go through json_reader: no cJSON tree, no heap, strings decoded straight into stack buffers. */
+static const char *const s_control_keys[] = {"addr", "ep", "cmd", "confirm"};
+static const char *const s_delete_keys[] = {"short_addr"};
+static const char *const s_rename_keys[] = {"short_addr", "name"};
+static const char *const s_wifi_save_keys[] = {"ssid", "password"};
+static const char *const s_job_submit_keys[] = {"type", "reboot_delay_ms"};
+static const char *const s_group_create_keys[] = {"name"};
+static const char *const s_group_delete_keys[] = {"group_id"};
+static const char *const s_group_member_keys[] = {"group_id", "addr", "ep"};
+static const char *const s_group_control_keys[] = {"group_id", "cmd"};
+
+#define SCAN_FIELDS(json, keys, values) \
+    json_reader_scan_object((json), (keys), sizeof(keys) / sizeof((keys)[0]), (values))
+
+static esp_err_t parse_control_text(const char *json, api_control_request_t *out)
+{
+    json_reader_value_t v[4];
+    int addr;
+    int ep;
+    int cmd;
+    bool confirm = false;
+    if (!SCAN_FIELDS(json, s_control_keys, v) || !json_reader_get_int(&v[0], &addr) ||
+        !json_reader_get_int(&v[1], &ep) || !json_reader_get_int(&v[2], &cmd))
     {
         return ESP_ERR_INVALID_ARG;
     }
+    if (v[3].kind != JSON_READER_ABSENT && !json_reader_get_bool(&v[3], &confirm)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return control_from_values(addr, ep, cmd, confirm, out);
+}
 
-    size_t ssid_len = strlen(ssid_item->valuestring);
-    size_t pass_len = strlen(pass_item->valuestring);
-    if (ssid_len == 0 || ssid_len > API_WIFI_SSID_MAX_LEN ||
-        pass_len < 8 || pass_len > API_WIFI_PASSWORD_MAX_LEN)
+static esp_err_t parse_control_batch_text(const char *json, api_control_batch_t *out)
+{
+    json_reader_array_t it;
+    if (!json_reader_array_begin(json, &it)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    out->count = 0;
+    for (;;) {
+        json_reader_value_t item;
+        if (!json_reader_array_next(&it, &item)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (item.kind == JSON_READER_ABSENT) {
+            break;
+        }
+        if (out->count == API_CONTROL_BATCH_MAX) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        /* A bad element only fails itself: the rest of the batch is still sent. */
+        size_t i = out->count++;
+        out->items[i] = (api_control_request_t){0};
+        out->results[i] = item.kind == JSON_READER_OTHER ? parse_control_text(item.start, &out->items[i])
+                                                         : ESP_ERR_INVALID_ARG;
+    }
+    return out->count > 0 ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+static esp_err_t parse_delete_text(const char *json, api_delete_request_t *out)
+{
+    json_reader_value_t v[1];
+    int short_addr;
+    if (!SCAN_FIELDS(json, s_delete_keys, v) || !json_reader_get_int(&v[0], &short_addr)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return delete_from_values(short_addr, out);
+}
+
+static esp_err_t parse_rename_text(const char *json, api_rename_request_t *out)
+{
+    json_reader_value_t v[2];
+    int short_addr;
+    char name[API_DEVICE_NAME_MAX_LEN + 1];
+    size_t name_len;
+    if (!SCAN_FIELDS(json, s_rename_keys, v) || !json_reader_get_int(&v[0], &short_addr) ||
+        !json_reader_get_string(&v[1], name, sizeof(name), &name_len))
     {
+        /* A name that does not fit is over API_DEVICE_NAME_MAX_LEN anyway. */
         return ESP_ERR_INVALID_ARG;
     }
+    return rename_from_values(short_addr, name, name_len, out);
+}
 
-    strlcpy(out->ssid, ssid_item->valuestring, sizeof(out->ssid));
-    strlcpy(out->password, pass_item->valuestring, sizeof(out->password));
-    return ESP_OK;
+static esp_err_t parse_wifi_save_text(const char *json, api_wifi_save_request_t *out)
+{
+    json_reader_value_t v[2];
+    char ssid[API_WIFI_SSID_MAX_LEN + 1];
+    char password[API_WIFI_PASSWORD_MAX_LEN + 1];
+    size_t ssid_len;
+    size_t pass_len;
+    if (!SCAN_FIELDS(json, s_wifi_save_keys, v) || !json_reader_get_string(&v[0], ssid, sizeof(ssid), &ssid_len) ||
+        !json_reader_get_string(&v[1], password, sizeof(password), &pass_len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return wifi_save_from_values(ssid, ssid_len, password, pass_len, out);
 }
 
-static bool valid_job_type(const char *type)
+static esp_err_t parse_job_submit_text(const char *json, api_job_submit_request_t *out)
 {
-    return type &&
-           (strcmp(type, "scan") == 0 ||
-            strcmp(type, "factory_reset") == 0 ||
-            strcmp(type, "reboot") == 0 ||
-            strcmp(type, "update") == 0 ||
-            strcmp(type, "lqi_refresh") == 0);
+    json_reader_value_t v[2];
+    char type[sizeof(out->type)];
+    size_t type_len;
+    int delay_ms = 0;
+    if (!SCAN_FIELDS(json, s_job_submit_keys, v) || !json_reader_get_string(&v[0], type, sizeof(type), &type_len)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool has_delay = v[1].kind != JSON_READER_ABSENT;
+    if (has_delay && !json_reader_get_int(&v[1], &delay_ms)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return job_submit_from_values(type, type_len, has_delay, delay_ms, out);
 }
 
-static esp_err_t parse_job_submit_root(cJSON *root, api_job_submit_request_t *out)
+static esp_err_t parse_group_create_text(const char *json, api_group_create_request_t *out)
 {
-    cJSON *type_item = cJSON_GetObjectItem(root, "type");
-    if (!cJSON_IsString(type_item) || !type_item->valuestring || !valid_job_type(type_item->valuestring)) {
+    json_reader_value_t v[1];
+    size_t name_len;
+    if (!SCAN_FIELDS(json, s_group_create_keys, v) ||
+        !json_reader_get_string(&v[0], out->name, sizeof(out->name), &name_len) || name_len == 0)
+    {
         return ESP_ERR_INVALID_ARG;
     }
-    strlcpy(out->type, type_item->valuestring, sizeof(out->type));
+    return ESP_OK;
+}
 
-    out->reboot_delay_ms = 1000;
-    cJSON *delay_item = cJSON_GetObjectItem(root, "reboot_delay_ms");
-    if (delay_item != NULL) {
-        if (!cJSON_IsNumber(delay_item) || delay_item->valueint < 0 || delay_item->valueint > 60000) {
-            return ESP_ERR_INVALID_ARG;
-        }
-        out->reboot_delay_ms = (uint32_t)delay_item->valueint;
+static esp_err_t parse_group_delete_text(const char *json, api_group_delete_request_t *out)
+{
+    json_reader_value_t v[1];
+    int group_id;
+    if (!SCAN_FIELDS(json, s_group_delete_keys, v) || !json_reader_get_int(&v[0], &group_id) ||
+        !valid_group_id(group_id))
+    {
+        return ESP_ERR_INVALID_ARG;
     }
+    out->group_id = (uint16_t)group_id;
     return ESP_OK;
 }
 
-static esp_err_t parse_json_string(const char *json, cJSON **out_root)
+static esp_err_t parse_group_member_text(const char *json, api_group_member_request_t *out)
 {
-    if (!json || !out_root) {
+    json_reader_value_t v[3];
+    int group_id;
+    int addr;
+    int ep;
+    if (!SCAN_FIELDS(json, s_group_member_keys, v) || !json_reader_get_int(&v[0], &group_id) ||
+        !json_reader_get_int(&v[1], &addr) || !json_reader_get_int(&v[2], &ep))
+    {
         return ESP_ERR_INVALID_ARG;
     }
+    return group_member_from_values(group_id, addr, ep, out);
+}
 
-    cJSON *root = cJSON_Parse(json);
-    if (!root) {
+static esp_err_t parse_group_control_text(const char *json, api_group_control_request_t *out)
+{
+    json_reader_value_t v[2];
+    int group_id;
+    int cmd;
+    if (!SCAN_FIELDS(json, s_group_control_keys, v) || !json_reader_get_int(&v[0], &group_id) ||
+        !json_reader_get_int(&v[1], &cmd) || !valid_group_id(group_id) || !(cmd == 0 || cmd == 1))
+    {
         return ESP_ERR_INVALID_ARG;
     }
-    *out_root = root;
+    out->group_id = (uint16_t)group_id;
+    out->cmd = (uint8_t)cmd;
     return ESP_OK;
 }
 
-static esp_err_t parse_json_body(httpd_req_t *req, cJSON **out_root, char *buf, size_t buf_size)
+static esp_err_t read_body(httpd_req_t *req, char *buf, size_t buf_size)
 {
-    if (!req || !out_root || !buf || buf_size < 2) {
+    if (!req || !buf || buf_size < 2) {
         return ESP_ERR_INVALID_ARG;
     }
 
@@ -153,13 +370,6 @@ static esp_err_t parse_json_body(httpd_req_t *req, cJSON **out_root, char *buf,
         remaining -= (size_t)len;
     }
     buf[total] = '\0';
-
-    cJSON *root = cJSON_Parse(buf);
-    if (!root) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    *out_root = root;
     return ESP_OK;
 }
 
@@ -170,15 +380,25 @@ esp_err_t api_parse_control_request(httpd_req_t *req, api_control_request_t *out
     }
 
     char buf[128];
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_body(req, &root, buf, sizeof(buf));
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
+    return parse_control_text(buf, out);
+}
 
-    err = parse_control_root(root, out);
-    cJSON_Delete(root);
-    return err;
+esp_err_t api_parse_control_batch_request(httpd_req_t *req, api_control_batch_t *out)
+{
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char buf[1024];
+    esp_err_t err = read_body(req, buf, sizeof(buf));
+    if (err != ESP_OK) {
+        return err;
+    }
+    return parse_control_batch_text(buf, out);
 }
 
 esp_err_t api_parse_delete_request(httpd_req_t *req, api_delete_request_t *out)
@@ -188,15 +408,11 @@ esp_err_t api_parse_delete_request(httpd_req_t *req, api_delete_request_t *out)
     }
 
     char buf[96];
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_body(req, &root, buf, sizeof(buf));
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-
-    err = parse_delete_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_delete_text(buf, out);
 }
 
 esp_err_t api_parse_rename_request(httpd_req_t *req, api_rename_request_t *out)
@@ -206,15 +422,11 @@ esp_err_t api_parse_rename_request(httpd_req_t *req, api_rename_request_t *out)
     }
 
     char buf[192];
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_body(req, &root, buf, sizeof(buf));
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-
-    err = parse_rename_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_rename_text(buf, out);
 }
 
 esp_err_t api_parse_wifi_save_request(httpd_req_t *req, api_wifi_save_request_t *out)
@@ -224,15 +436,11 @@ esp_err_t api_parse_wifi_save_request(httpd_req_t *req, api_wifi_save_request_t
     }
 
     char buf[256];
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_body(req, &root, buf, sizeof(buf));
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-
-    err = parse_wifi_save_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_wifi_save_text(buf, out);
 }
 
 esp_err_t api_parse_job_submit_request(httpd_req_t *req, api_job_submit_request_t *out)
@@ -242,88 +450,183 @@ esp_err_t api_parse_job_submit_request(httpd_req_t *req, api_job_submit_request_
     }
 
     char buf[160];
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_body(req, &root, buf, sizeof(buf));
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-
-    err = parse_job_submit_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_job_submit_text(buf, out);
 }
 
-esp_err_t api_parse_control_json(const char *json, api_control_request_t *out)
+esp_err_t api_parse_group_create_request(httpd_req_t *req, api_group_create_request_t *out)
 {
     if (!out) {
         return ESP_ERR_INVALID_ARG;
     }
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_string(json, &root);
+
+    char buf[160];
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-    err = parse_control_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_group_create_text(buf, out);
 }
 
-esp_err_t api_parse_delete_json(const char *json, api_delete_request_t *out)
+esp_err_t api_parse_group_delete_request(httpd_req_t *req, api_group_delete_request_t *out)
 {
     if (!out) {
         return ESP_ERR_INVALID_ARG;
     }
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_string(json, &root);
+
+    char buf[96];
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-    err = parse_delete_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_group_delete_text(buf, out);
 }
 
-esp_err_t api_parse_rename_json(const char *json, api_rename_request_t *out)
+esp_err_t api_parse_group_member_request(httpd_req_t *req, api_group_member_request_t *out)
 {
     if (!out) {
         return ESP_ERR_INVALID_ARG;
     }
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_string(json, &root);
+
+    char buf[128];
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-    err = parse_rename_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_group_member_text(buf, out);
 }
 
-esp_err_t api_parse_wifi_save_json(const char *json, api_wifi_save_request_t *out)
+esp_err_t api_parse_group_control_request(httpd_req_t *req, api_group_control_request_t *out)
 {
     if (!out) {
         return ESP_ERR_INVALID_ARG;
     }
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_string(json, &root);
+
+    char buf[96];
+    esp_err_t err = read_body(req, buf, sizeof(buf));
     if (err != ESP_OK) {
         return err;
     }
-    err = parse_wifi_save_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_group_control_text(buf, out);
+}
+
+esp_err_t api_parse_control_json(const char *json, api_control_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_control_text(json, out);
+}
+
+esp_err_t api_parse_control_batch_json(const char *json, api_control_batch_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_control_batch_text(json, out);
+}
+
+esp_err_t api_parse_delete_json(const char *json, api_delete_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_delete_text(json, out);
+}
+
+esp_err_t api_parse_rename_json(const char *json, api_rename_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_rename_text(json, out);
+}
+
+esp_err_t api_parse_wifi_save_json(const char *json, api_wifi_save_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_wifi_save_text(json, out);
 }
 
 esp_err_t api_parse_job_submit_json(const char *json, api_job_submit_request_t *out)
 {
-    if (!out) {
+    if (!json || !out) {
         return ESP_ERR_INVALID_ARG;
     }
-    cJSON *root = NULL;
-    esp_err_t err = parse_json_string(json, &root);
-    if (err != ESP_OK) {
-        return err;
+    return parse_job_submit_text(json, out);
+}
+
+esp_err_t api_parse_group_create_json(const char *json, api_group_create_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
     }
-    err = parse_job_submit_root(root, out);
-    cJSON_Delete(root);
-    return err;
+    return parse_group_create_text(json, out);
+}
+
+esp_err_t api_parse_group_delete_json(const char *json, api_group_delete_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_group_delete_text(json, out);
+}
+
+esp_err_t api_parse_group_member_json(const char *json, api_group_member_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_group_member_text(json, out);
+}
+
+esp_err_t api_parse_group_control_json(const char *json, api_group_control_request_t *out)
+{
+    if (!json || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_group_control_text(json, out);
+}
+
+esp_err_t api_parse_control_params(const cJSON *params, api_control_request_t *out)
+{
+    if (!cJSON_IsObject(params) || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_control_root(params, out);
+}
+
+esp_err_t api_parse_delete_params(const cJSON *params, api_delete_request_t *out)
+{
+    if (!cJSON_IsObject(params) || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_delete_root(params, out);
+}
+
+esp_err_t api_parse_rename_params(const cJSON *params, api_rename_request_t *out)
+{
+    if (!cJSON_IsObject(params) || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_rename_root(params, out);
+}
+
+esp_err_t api_parse_job_submit_params(const cJSON *params, api_job_submit_request_t *out)
+{
+    if (!cJSON_IsObject(params) || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return parse_job_submit_root(params, out);
+}
+
+gateway_core_job_type_t api_job_type_from_name(const char *type)
+{
+    const job_type_entry_t *entry = type ? job_type_lookup(type, strlen(type)) : NULL;
+    return entry ? entry->type : GATEWAY_CORE_JOB_TYPE_WIFI_SCAN;
 }
@@ -0,0 +1,130 @@
+#include "api_handlers.h"
+#include "api_contracts.h"
+#include "api_usecases.h"
+#include "http_error.h"
+
+#include "esp_log.h"
+
+#include <stdio.h>
+
+static const char *TAG = "API_GROUPS";
+
+static api_usecases_handle_t req_usecases(httpd_req_t *req)
+{
+    return req ? (api_usecases_handle_t)req->user_ctx : NULL;
+}
+
+static void write_groups_json(json_writer_t *w, const zigbee_group_t *groups, int count)
+{
+    json_put_lit(w, "{\"groups\":[");
+    for (int i = 0; i < count; i++) {
+        const zigbee_group_t *group = &groups[i];
+        if (i > 0) {
+            json_put_lit(w, ",");
+        }
+        json_put_lit(w, "{\"id\":");
+        json_put_u32(w, group->group_id);
+        json_put_lit(w, ",\"name\":\"");
+        json_put_escaped(w, group->name);
+        json_put_lit(w, "\",\"members\":[");
+        for (int m = 0; m < group->member_count; m++) {
+            if (m > 0) {
+                json_put_lit(w, ",");
+            }
+            json_put_lit(w, "{\"addr\":");
+            json_put_u32(w, group->members[m].short_addr);
+            json_put_lit(w, ",\"ep\":");
+            json_put_u32(w, group->members[m].endpoint);
+            json_put_lit(w, "}");
+        }
+        json_put_lit(w, "]}");
+    }
+    json_put_lit(w, "]}");
+}
+
+esp_err_t api_groups_list_handler(httpd_req_t *req)
+{
+    zigbee_group_t groups[GATEWAY_MAX_GROUPS];
+    int count = api_usecase_get_groups_snapshot(req_usecases(req), groups, GATEWAY_MAX_GROUPS);
+
+    http_json_stream_t stream;
+    http_json_stream_begin(req, &stream);
+    write_groups_json(&stream.writer, groups, count);
+    return http_json_stream_end(&stream);
+}
+
+esp_err_t api_group_create_handler(httpd_req_t *req)
+{
+    api_group_create_request_t in = {0};
+    if (api_parse_group_create_request(req, &in) != ESP_OK) {
+        return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Invalid group name");
+    }
+
+    uint16_t group_id = 0;
+    esp_err_t err = api_usecase_group_create(req_usecases(req), &in, &group_id);
+    if (err != ESP_OK) {
+        return http_error_send_esp(req, err, "Failed to create group");
+    }
+    ESP_LOGI(TAG, "Group 0x%04x created: %s", group_id, in.name);
+
+    char data_json[32];
+    snprintf(data_json, sizeof(data_json), "{\"group_id\":%u}", (unsigned)group_id);
+    return http_success_send_data_json(req, data_json);
+}
+
+esp_err_t api_group_delete_handler(httpd_req_t *req)
+{
+    api_group_delete_request_t in = {0};
+    if (api_parse_group_delete_request(req, &in) != ESP_OK) {
+        return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Invalid group_id");
+    }
+
+    esp_err_t err = api_usecase_group_delete(req_usecases(req), &in);
+    if (err != ESP_OK) {
+        return http_error_send_esp(req, err, "Failed to delete group");
+    }
+    return http_success_send(req, "Group deleted");
+}
+
+esp_err_t api_group_add_member_handler(httpd_req_t *req)
+{
+    api_group_member_request_t in = {0};
+    if (api_parse_group_member_request(req, &in) != ESP_OK) {
+        return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Missing parameters");
+    }
+
+    esp_err_t err = api_usecase_group_add_member(req_usecases(req), &in);
+    if (err != ESP_OK) {
+        return http_error_send_esp(req, err, "Failed to add group member");
+    }
+    return http_success_send(req, "Member added");
+}
+
+esp_err_t api_group_remove_member_handler(httpd_req_t *req)
+{
+    api_group_member_request_t in = {0};
+    if (api_parse_group_member_request(req, &in) != ESP_OK) {
+        return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Missing parameters");
+    }
+
+    esp_err_t err = api_usecase_group_remove_member(req_usecases(req), &in);
+    if (err != ESP_OK) {
+        return http_error_send_esp(req, err, "Failed to remove group member");
+    }
+    return http_success_send(req, "Member removed");
+}
+
+esp_err_t api_group_control_handler(httpd_req_t *req)
+{
+    api_group_control_request_t in = {0};
+    if (api_parse_group_control_request(req, &in) != ESP_OK) {
+        return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Missing parameters");
+    }
+
+    ESP_LOGI(TAG, "Web Group Control: group=0x%04x, cmd=%d", in.group_id, in.cmd);
+    esp_err_t err = api_usecase_group_control(req_usecases(req), &in);
+    if (err != ESP_OK) {
+        return http_error_send_esp(req, err, "Failed to send group command");
+    }
+    return http_success_send(req, "Group command sent");
+}
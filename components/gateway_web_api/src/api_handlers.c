@@ -88,12 +88,69 @@ esp_err_t api_control_handler(httpd_req_t *req)
         return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Missing parameters");
     }
 
-    ESP_LOGI(TAG, "Web Control: addr=0x%04x, ep=%d, cmd=%d", in.addr, in.ep, in.cmd);
+    ESP_LOGI(TAG, "Web Control: addr=0x%04x, ep=%d, cmd=%d, confirm=%d", in.addr, in.ep, in.cmd, in.confirm);
     esp_err_t err = api_usecase_control(usecases, &in);
     if (err != ESP_OK) {
         return http_error_send_esp(req, err, "Failed to send command");
     }
-    return http_success_send(req, "Command sent");
+    return http_success_send(req, in.confirm ? "Command confirmed" : "Command sent");
+}
+
+static void write_control_batch_json(json_writer_t *w, const api_control_batch_t *batch)
+{
+    uint32_t sent = 0;
+    for (size_t i = 0; i < batch->count; i++) {
+        sent += batch->results[i] == ESP_OK ? 1 : 0;
+    }
+
+    json_put_lit(w, "{\"sent\":");
+    json_put_u32(w, sent);
+    json_put_lit(w, ",\"failed\":");
+    json_put_u32(w, (uint32_t)batch->count - sent);
+    json_put_lit(w, ",\"results\":[");
+    for (size_t i = 0; i < batch->count; i++) {
+        const api_control_request_t *item = &batch->items[i];
+        if (i > 0) {
+            json_put_lit(w, ",");
+        }
+        json_put_lit(w, "{");
+        /* Elements that failed validation have no trustworthy address to echo. */
+        if (item->addr != 0) {
+            json_put_lit(w, "\"addr\":");
+            json_put_u32(w, item->addr);
+            json_put_lit(w, ",\"ep\":");
+            json_put_u32(w, item->ep);
+            json_put_lit(w, ",");
+        }
+        if (batch->results[i] == ESP_OK) {
+            json_put_lit(w, "\"ok\":true}");
+        } else {
+            json_put_lit(w, "\"ok\":false,\"code\":\"");
+            json_put_str(w, http_error_code_name(batch->results[i]));
+            json_put_lit(w, "\"}");
+        }
+    }
+    json_put_lit(w, "]}");
+}
+
+esp_err_t api_control_batch_handler(httpd_req_t *req)
+{
+    api_usecases_handle_t usecases = req_usecases(req);
+    api_control_batch_t batch;
+    if (api_parse_control_batch_request(req, &batch) != ESP_OK) {
+        return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Expected a JSON array of 1-32 commands");
+    }
+
+    esp_err_t err = api_usecase_control_batch(usecases, &batch);
+    if (err != ESP_OK) {
+        return http_error_send_esp(req, err, "Failed to send commands");
+    }
+    ESP_LOGI(TAG, "Web Control batch: %u commands", (unsigned)batch.count);
+
+    http_json_stream_t stream;
+    http_json_stream_begin(req, &stream);
+    write_control_batch_json(&stream.writer, &batch);
+    return http_json_stream_end(&stream);
 }
 
 esp_err_t api_delete_device_handler(httpd_req_t *req)
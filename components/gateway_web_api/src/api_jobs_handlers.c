@@ -1,6 +1,8 @@
 #include "api_handlers.h"
 #include "api_contracts.h"
+#include "api_dto_fields.h"
 #include "api_usecases.h"
+#include "dto_codec.h"
 #include "gateway_jobs_facade.h"
 #include "http_error.h"
 
@@ -16,6 +18,7 @@
 #define JOB_API_RESULT_JSON_LIMIT_REBOOT        512
 #define JOB_API_RESULT_JSON_LIMIT_UPDATE        768
 #define JOB_API_RESULT_JSON_LIMIT_LQI_REFRESH   1024
+#define JOB_API_RESULT_JSON_LIMIT_TOPOLOGY      256
 static size_t job_result_json_limit_for_type(gateway_core_job_type_t type)
 {
     switch (type) {
@@ -27,34 +30,15 @@ static size_t job_result_json_limit_for_type(gateway_core_job_type_t type)
         return JOB_API_RESULT_JSON_LIMIT_REBOOT;
     case GATEWAY_CORE_JOB_TYPE_LQI_REFRESH:
         return JOB_API_RESULT_JSON_LIMIT_LQI_REFRESH;
+    case GATEWAY_CORE_JOB_TYPE_TOPOLOGY_CRAWL:
+        return JOB_API_RESULT_JSON_LIMIT_TOPOLOGY;
     case GATEWAY_CORE_JOB_TYPE_UPDATE:
     default:
         return JOB_API_RESULT_JSON_LIMIT_UPDATE;
     }
 }
 
-static gateway_core_job_type_t parse_job_type(const char *type)
-{
-    if (!type) {
-        return GATEWAY_CORE_JOB_TYPE_WIFI_SCAN;
-    }
-    if (strcmp(type, "scan") == 0) {
-        return GATEWAY_CORE_JOB_TYPE_WIFI_SCAN;
-    }
-    if (strcmp(type, "factory_reset") == 0) {
-        return GATEWAY_CORE_JOB_TYPE_FACTORY_RESET;
-    }
-    if (strcmp(type, "reboot") == 0) {
-        return GATEWAY_CORE_JOB_TYPE_REBOOT;
-    }
-    if (strcmp(type, "update") == 0) {
-        return GATEWAY_CORE_JOB_TYPE_UPDATE;
-    }
-    if (strcmp(type, "lqi_refresh") == 0) {
-        return GATEWAY_CORE_JOB_TYPE_LQI_REFRESH;
-    }
-    return GATEWAY_CORE_JOB_TYPE_WIFI_SCAN;
-}
+DTO_DEFINE(dto_job_info, gateway_core_job_info_t, API_DTO_JOB_INFO_FIELDS)
 
 static esp_err_t parse_job_id_from_uri(const char *uri, uint32_t *out_id)
 {
@@ -88,7 +72,7 @@ esp_err_t api_jobs_submit_handler(httpd_req_t *req)
         return http_error_send_esp(req, err, "Invalid job payload");
     }
 
-    gateway_core_job_type_t type = parse_job_type(in.type);
+    gateway_core_job_type_t type = api_job_type_from_name(in.type);
     uint32_t job_id = 0;
     err = api_usecase_jobs_submit(usecases, type, in.reboot_delay_ms, &job_id);
     if (err != ESP_OK) {
@@ -152,19 +136,14 @@ esp_err_t api_jobs_get_handler(httpd_req_t *req)
         }
     }
 
+    /* Head ends with the open "result" key; the raw result JSON is streamed after it. */
     char head_json[256];
-    int written = snprintf(
-        head_json, sizeof(head_json),
-        "{\"job_id\":%" PRIu32 ",\"type\":\"%s\",\"state\":\"%s\",\"done\":%s,"
-        "\"created_ms\":%" PRIu64 ",\"updated_ms\":%" PRIu64 ",\"error\":\"%s\",\"result\":",
-        info->id,
-        gateway_jobs_type_to_string(info->type),
-        gateway_jobs_state_to_string(info->state),
-        (info->state == GATEWAY_CORE_JOB_STATE_SUCCEEDED || info->state == GATEWAY_CORE_JOB_STATE_FAILED) ? "true" : "false",
-        info->created_ms,
-        info->updated_ms,
-        esp_err_to_name(info->err));
-    if (written < 0 || (size_t)written >= sizeof(head_json)) {
+    json_writer_t w;
+    json_writer_init(&w, head_json, sizeof(head_json));
+    json_put_lit(&w, "{");
+    dto_job_info_put_json_members(&w, info, true);
+    json_put_lit(&w, ",\"result\":");
+    if (!json_writer_finish(&w, NULL)) {
         free(info);
         return http_error_send_esp(req, ESP_ERR_NO_MEM, "Job response too large");
     }
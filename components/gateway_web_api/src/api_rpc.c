@@ -0,0 +1,153 @@
+#include "api_rpc.h"
+
+#include "api_contracts.h"
+#include "cJSON.h"
+#include "esp_log.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "API_RPC";
+
+#define RPC_PERMIT_JOIN_DEFAULT_S 60
+#define RPC_PERMIT_JOIN_MAX_S 254
+
+typedef esp_err_t (*rpc_method_fn_t)(api_usecases_handle_t usecases, const cJSON *params, char *result,
+                                     size_t result_size, const char **out_message);
+
+typedef struct {
+    const char *name;
+    rpc_method_fn_t fn;
+} rpc_method_t;
+
+static esp_err_t rpc_control(api_usecases_handle_t usecases, const cJSON *params, char *result, size_t result_size,
+                             const char **out_message)
+{
+    (void)result;
+    (void)result_size;
+    api_control_request_t in = {0};
+    if (api_parse_control_params(params, &in) != ESP_OK) {
+        *out_message = "Missing parameters";
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_LOGD(TAG, "RPC control: addr=0x%04x, ep=%d, cmd=%d", in.addr, in.ep, in.cmd);
+    esp_err_t err = api_usecase_control(usecases, &in);
+    if (err != ESP_OK) {
+        *out_message = "Failed to send command";
+    }
+    return err;
+}
+
+static esp_err_t rpc_rename(api_usecases_handle_t usecases, const cJSON *params, char *result, size_t result_size,
+                            const char **out_message)
+{
+    (void)result;
+    (void)result_size;
+    api_rename_request_t in = {0};
+    if (api_parse_rename_params(params, &in) != ESP_OK) {
+        *out_message = "Invalid params";
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = api_usecase_rename_device(usecases, in.short_addr, in.name);
+    if (err != ESP_OK) {
+        *out_message = "Rename failed";
+    }
+    return err;
+}
+
+static esp_err_t rpc_delete(api_usecases_handle_t usecases, const cJSON *params, char *result, size_t result_size,
+                            const char **out_message)
+{
+    (void)result;
+    (void)result_size;
+    api_delete_request_t in = {0};
+    if (api_parse_delete_params(params, &in) != ESP_OK) {
+        *out_message = "Invalid params";
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = api_usecase_delete_device(usecases, in.short_addr);
+    if (err != ESP_OK) {
+        *out_message = "Delete failed";
+    }
+    return err;
+}
+
+static esp_err_t rpc_permit_join(api_usecases_handle_t usecases, const cJSON *params, char *result,
+                                 size_t result_size, const char **out_message)
+{
+    int duration = RPC_PERMIT_JOIN_DEFAULT_S;
+    const cJSON *duration_item = params ? cJSON_GetObjectItem(params, "duration") : NULL;
+    if (duration_item) {
+        if (!cJSON_IsNumber(duration_item) || duration_item->valueint <= 0 ||
+            duration_item->valueint > RPC_PERMIT_JOIN_MAX_S) {
+            *out_message = "Invalid duration";
+            return ESP_ERR_INVALID_ARG;
+        }
+        duration = duration_item->valueint;
+    }
+    esp_err_t err = api_usecase_permit_join(usecases, (uint8_t)duration);
+    if (err != ESP_OK) {
+        *out_message = "Failed to open network";
+        return err;
+    }
+    int written = snprintf(result, result_size, "{\"duration\":%d}", duration);
+    return (written < 0 || (size_t)written >= result_size) ? ESP_ERR_NO_MEM : ESP_OK;
+}
+
+static esp_err_t rpc_jobs_submit(api_usecases_handle_t usecases, const cJSON *params, char *result,
+                                 size_t result_size, const char **out_message)
+{
+    api_job_submit_request_t in = {0};
+    if (api_parse_job_submit_params(params, &in) != ESP_OK) {
+        *out_message = "Invalid job payload";
+        return ESP_ERR_INVALID_ARG;
+    }
+    gateway_core_job_type_t type = api_job_type_from_name(in.type);
+    uint32_t job_id = 0;
+    esp_err_t err = api_usecase_jobs_submit(usecases, type, in.reboot_delay_ms, &job_id);
+    if (err != ESP_OK) {
+        *out_message = "Failed to queue job";
+        return err;
+    }
+
+    gateway_core_job_info_t info = {0};
+    const char *state = "queued";
+    if (api_usecase_jobs_get(usecases, job_id, &info) == ESP_OK) {
+        state = gateway_jobs_state_to_string(info.state);
+    }
+    int written = snprintf(result, result_size, "{\"job_id\":%" PRIu32 ",\"type\":\"%s\",\"state\":\"%s\"}",
+                           job_id, gateway_jobs_type_to_string(type), state);
+    return (written < 0 || (size_t)written >= result_size) ? ESP_ERR_NO_MEM : ESP_OK;
+}
+
+static const rpc_method_t s_rpc_methods[] = {
+    {"control", rpc_control},
+    {"rename", rpc_rename},
+    {"delete", rpc_delete},
+    {"permit_join", rpc_permit_join},
+    {"jobs.submit", rpc_jobs_submit},
+};
+
+esp_err_t api_rpc_dispatch(api_usecases_handle_t usecases, const char *method, const struct cJSON *params,
+                           char *result, size_t result_size, const char **out_message)
+{
+    const char *message = "Invalid request";
+    esp_err_t err = ESP_ERR_INVALID_ARG;
+    if (usecases && method && result && result_size >= sizeof("null")) {
+        strcpy(result, "null");
+        err = ESP_ERR_NOT_SUPPORTED;
+        message = "Unknown method";
+        for (size_t i = 0; i < sizeof(s_rpc_methods) / sizeof(s_rpc_methods[0]); i++) {
+            if (strcmp(method, s_rpc_methods[i].name) == 0) {
+                message = NULL;
+                err = s_rpc_methods[i].fn(usecases, params, result, result_size, &message);
+                break;
+            }
+        }
+    }
+    if (out_message) {
+        *out_message = message;
+    }
+    return err;
+}
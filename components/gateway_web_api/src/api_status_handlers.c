@@ -1,101 +1,122 @@
 #include "api_handlers.h"
+#include "api_usecases_internal.h"
 #include "status_json_builder.h"
 #include "http_error.h"
+#include "http_response_cache.h"
 #include "lqi_json_mapper.h"
 
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-#define STATUS_JSON_STACK_CAP 1024
-#define STATUS_JSON_HEAP_RETRIES 3
-#define LQI_JSON_STACK_CAP 1024
-#define LQI_JSON_HEAP_RETRIES 3
+typedef esp_err_t (*api_json_writer_fn_t)(api_usecases_handle_t usecases, json_writer_t *w);
 
 static api_usecases_handle_t req_usecases(httpd_req_t *req)
 {
     return req ? (api_usecases_handle_t)req->user_ctx : NULL;
 }
 
-esp_err_t api_status_handler(httpd_req_t *req)
+/*
+ * The generation is read before the builder takes its snapshot: a concurrent change can only
+ * make the body newer than its ETag, which costs one extra rebuild but never a stale 304.
+ */
+static bool response_etag(api_usecases_handle_t usecases, http_response_cache_slot_t slot, char *out, size_t out_size)
 {
-    api_usecases_handle_t usecases = req_usecases(req);
-    char stack_json[STATUS_JSON_STACK_CAP];
-    size_t out_len = 0;
-    esp_err_t ret = build_status_json_compact(usecases, stack_json, sizeof(stack_json), &out_len);
-    if (ret == ESP_OK) {
-        esp_err_t send_ret = http_success_send_data_json(req, stack_json);
-        if (send_ret == ESP_ERR_NO_MEM) {
-            return http_error_send_esp(req, ESP_ERR_NO_MEM, "Failed to wrap status payload");
-        }
-        return send_ret;
-    }
-    if (ret != ESP_ERR_NO_MEM) {
-        return http_error_send_esp(req, ret, "Failed to build status payload");
+    zigbee_state_generation_t gen;
+    if (api_usecase_get_state_generation(usecases, &gen) != ESP_OK) {
+        return false;
     }
 
-    size_t needed = STATUS_JSON_STACK_CAP * 2;
-    for (int i = 0; i < STATUS_JSON_HEAP_RETRIES; i++) {
-        char *heap_json = (char *)malloc(needed);
-        if (!heap_json) {
-            return http_error_send_esp(req, ESP_ERR_NO_MEM, "Failed to build status payload");
+    int written;
+    if (slot == HTTP_RESPONSE_CACHE_STATUS) {
+        written = snprintf(out, out_size, "\"%08" PRIx32 "-s%" PRIx32 ".%" PRIx32 ".%" PRIx32 "\"", gen.epoch,
+                           gen.devices, gen.network, gen.attrs);
+    } else {
+        /* Until the LQI cache is populated /lqi reads the live neighbor table, which has no generation. */
+        if (gen.lqi == 0) {
+            return false;
         }
-        ret = build_status_json_compact(usecases, heap_json, needed, &out_len);
-        if (ret == ESP_OK) {
-            esp_err_t send_ret = http_success_send_data_json(req, heap_json);
-            free(heap_json);
-            if (send_ret == ESP_ERR_NO_MEM) {
-                return http_error_send_esp(req, ESP_ERR_NO_MEM, "Failed to wrap status payload");
-            }
-            return send_ret;
+        written = snprintf(out, out_size, "\"%08" PRIx32 "-l%" PRIx32 ".%" PRIx32 ".%" PRIx32 "\"", gen.epoch,
+                           gen.devices, gen.lqi, gen.cmd_stats);
+    }
+    return written > 0 && (size_t)written < out_size;
+}
+
+static esp_err_t send_cached_json(httpd_req_t *req, http_response_cache_slot_t slot, api_json_writer_fn_t write_fn,
+                                  const char *error_message)
+{
+    api_usecases_handle_t usecases = req_usecases(req);
+    http_response_cache_t *cache = api_usecases_response_cache(usecases);
+
+    char etag[HTTP_RESPONSE_ETAG_SIZE];
+    bool cacheable = cache && response_etag(usecases, slot, etag, sizeof(etag));
+    if (cacheable) {
+        if (http_req_etag_matches(req, etag)) {
+            return http_not_modified_send(req, etag);
         }
-        free(heap_json);
-        if (ret != ESP_ERR_NO_MEM) {
-            return http_error_send_esp(req, ret, "Failed to build status payload");
+        http_etag_headers_set(req, etag);
+        const http_response_cache_entry_t *hit = http_response_cache_lookup(cache, slot, etag);
+        if (hit) {
+            httpd_resp_set_type(req, "application/json");
+            return httpd_resp_send(req, hit->body, (ssize_t)hit->len);
         }
-        needed *= 2;
     }
 
-    return http_error_send_esp(req, ESP_ERR_NO_MEM, "Status payload too large");
+    http_json_stream_t stream;
+    http_json_stream_begin(req, &stream);
+    http_response_cache_entry_t *fill = cacheable ? http_response_cache_fill_begin(cache, slot) : NULL;
+    if (fill) {
+        http_json_stream_tee(&stream, http_response_cache_fill_sink, fill);
+    }
+    esp_err_t ret = write_fn(usecases, &stream.writer);
+    if (ret != ESP_OK) {
+        http_response_cache_fill_commit(fill, NULL);
+        return http_error_send_esp(req, ret, error_message);
+    }
+    ret = http_json_stream_end(&stream);
+    http_response_cache_fill_commit(fill, ret == ESP_OK ? etag : NULL);
+    return ret;
+}
+
+esp_err_t api_status_handler(httpd_req_t *req)
+{
+    return send_cached_json(req, HTTP_RESPONSE_CACHE_STATUS, write_status_json, "Failed to build status payload");
 }
 
 esp_err_t api_lqi_handler(httpd_req_t *req)
 {
-    api_usecases_handle_t usecases = req_usecases(req);
-    size_t out_len = 0;
+    return send_cached_json(req, HTTP_RESPONSE_CACHE_LQI, write_lqi_json, "Failed to build LQI payload");
+}
 
-    char stack_json[LQI_JSON_STACK_CAP];
-    esp_err_t ret = build_lqi_json_compact(usecases, stack_json, sizeof(stack_json), &out_len);
-    if (ret == ESP_OK) {
-        esp_err_t send_ret = http_success_send_data_json(req, stack_json);
-        if (send_ret == ESP_ERR_NO_MEM) {
-            return http_error_send_esp(req, ESP_ERR_NO_MEM, "LQI payload too large");
-        }
-        return send_ret;
+/* /diagnostics/{addr}: decimal or 0x-prefixed short address as the last path segment. */
+static esp_err_t parse_short_addr_from_uri(const char *uri, uint16_t *out_addr)
+{
+    const char *last_slash = uri ? strrchr(uri, '/') : NULL;
+    if (!last_slash || *(last_slash + 1) == '\0') {
+        return ESP_ERR_INVALID_ARG;
     }
-    if (ret != ESP_ERR_NO_MEM) {
-        return http_error_send_esp(req, ret, "Failed to build LQI payload");
+    char *endptr = NULL;
+    unsigned long value = strtoul(last_slash + 1, &endptr, 0);
+    if (endptr == NULL || *endptr != '\0' || value == 0 || value > 0xFFFF) {
+        return ESP_ERR_INVALID_ARG;
     }
+    *out_addr = (uint16_t)value;
+    return ESP_OK;
+}
 
-    size_t needed = LQI_JSON_STACK_CAP * 2;
-    for (int i = 0; i < LQI_JSON_HEAP_RETRIES; i++) {
-        char *json = (char *)malloc(needed);
-        if (!json) {
-            return http_error_send_esp(req, ESP_ERR_NO_MEM, "Out of memory");
-        }
-        ret = build_lqi_json_compact(usecases, json, needed, &out_len);
-        if (ret == ESP_OK) {
-            esp_err_t send_ret = http_success_send_data_json(req, json);
-            free(json);
-            if (send_ret == ESP_ERR_NO_MEM) {
-                return http_error_send_esp(req, ESP_ERR_NO_MEM, "LQI payload too large");
-            }
-            return send_ret;
-        }
-        free(json);
-        if (ret != ESP_ERR_NO_MEM) {
-            return http_error_send_esp(req, ret, "Failed to build LQI payload");
-        }
-        needed *= 2;
+esp_err_t api_device_diagnostics_handler(httpd_req_t *req)
+{
+    uint16_t short_addr = 0;
+    if (parse_short_addr_from_uri(req ? req->uri : NULL, &short_addr) != ESP_OK) {
+        return http_error_send_esp(req, ESP_ERR_INVALID_ARG, "Invalid device address");
     }
 
-    return http_error_send_esp(req, ESP_ERR_NO_MEM, "LQI payload too large");
+    http_json_stream_t stream;
+    http_json_stream_begin(req, &stream);
+    esp_err_t ret = write_device_diagnostics_json(req_usecases(req), short_addr, &stream.writer);
+    if (ret != ESP_OK) {
+        return http_error_send_esp(req, ret, "Device not found");
+    }
+    return http_json_stream_end(&stream);
 }
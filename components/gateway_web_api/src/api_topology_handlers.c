@@ -0,0 +1,212 @@
+#include "api_handlers.h"
+#include "api_usecases.h"
+#include "http_error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TOPOLOGY_QUERY_MAX_LEN 96
+#define TOPOLOGY_NODE_CHUNK 32
+#define TOPOLOGY_EDGE_CHUNK 64
+
+typedef struct {
+    uint32_t crawl_id;
+    uint32_t nodes_from;
+    uint32_t edges_from;
+} topology_cursor_t;
+
+static api_usecases_handle_t req_usecases(httpd_req_t *req)
+{
+    return req ? (api_usecases_handle_t)req->user_ctx : NULL;
+}
+
+static uint32_t query_u32(const char *query, const char *key)
+{
+    char value[12];
+    if (httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK) {
+        return 0;
+    }
+    char *end = NULL;
+    unsigned long parsed = strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || parsed > UINT32_MAX) {
+        return 0;
+    }
+    return (uint32_t)parsed;
+}
+
+static void parse_cursor(httpd_req_t *req, topology_cursor_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    char query[TOPOLOGY_QUERY_MAX_LEN];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK) {
+        return;
+    }
+    out->crawl_id = query_u32(query, "crawl_id");
+    out->nodes_from = query_u32(query, "nodes_from");
+    out->edges_from = query_u32(query, "edges_from");
+}
+
+static const char *device_type_label(uint8_t type)
+{
+    switch (type) {
+    case GATEWAY_TOPOLOGY_DEVICE_COORDINATOR:
+        return "coordinator";
+    case GATEWAY_TOPOLOGY_DEVICE_ROUTER:
+        return "router";
+    case GATEWAY_TOPOLOGY_DEVICE_END_DEVICE:
+        return "end_device";
+    default:
+        return "unknown";
+    }
+}
+
+static const char *node_state_label(uint8_t state)
+{
+    switch (state) {
+    case GATEWAY_TOPOLOGY_NODE_PENDING:
+        return "pending";
+    case GATEWAY_TOPOLOGY_NODE_QUERYING:
+        return "querying";
+    case GATEWAY_TOPOLOGY_NODE_DONE:
+        return "done";
+    case GATEWAY_TOPOLOGY_NODE_FAILED:
+        return "failed";
+    default:
+        return "leaf";
+    }
+}
+
+static const char *crawl_state_label(uint8_t state)
+{
+    switch (state) {
+    case GATEWAY_TOPOLOGY_CRAWL_RUNNING:
+        return "running";
+    case GATEWAY_TOPOLOGY_CRAWL_DONE:
+        return "done";
+    case GATEWAY_TOPOLOGY_CRAWL_FAILED:
+        return "failed";
+    default:
+        return "idle";
+    }
+}
+
+/* Returns false when the crawl was replaced mid-stream: the rest of the graph is not this crawl's. */
+static bool write_nodes(json_writer_t *w, api_usecases_handle_t usecases, uint32_t crawl_id, uint32_t *cursor)
+{
+    gateway_topology_node_t chunk[TOPOLOGY_NODE_CHUNK];
+    bool first = true;
+    for (;;) {
+        int count = api_usecase_get_topology_nodes(usecases, crawl_id, *cursor, chunk, TOPOLOGY_NODE_CHUNK);
+        if (count < 0) {
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            if (!first) {
+                json_put_lit(w, ",");
+            }
+            first = false;
+            json_put_lit(w, "{\"i\":");
+            json_put_u32(w, *cursor + (uint32_t)i);
+            json_put_lit(w, ",\"addr\":");
+            json_put_u32(w, chunk[i].short_addr);
+            json_put_lit(w, ",\"type\":\"");
+            json_put_str(w, device_type_label(chunk[i].device_type));
+            json_put_lit(w, "\",\"depth\":");
+            json_put_u32(w, chunk[i].depth);
+            json_put_lit(w, ",\"state\":\"");
+            json_put_str(w, node_state_label(chunk[i].state));
+            json_put_lit(w, "\"}");
+        }
+        *cursor += (uint32_t)count;
+        if (count < TOPOLOGY_NODE_CHUNK) {
+            return true;
+        }
+    }
+}
+
+static bool write_edges(json_writer_t *w, api_usecases_handle_t usecases, uint32_t crawl_id, uint32_t *cursor)
+{
+    gateway_topology_edge_t chunk[TOPOLOGY_EDGE_CHUNK];
+    bool first = true;
+    for (;;) {
+        int count = api_usecase_get_topology_edges(usecases, crawl_id, *cursor, chunk, TOPOLOGY_EDGE_CHUNK);
+        if (count < 0) {
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            if (!first) {
+                json_put_lit(w, ",");
+            }
+            first = false;
+            json_put_lit(w, "{\"from\":");
+            json_put_u32(w, chunk[i].from);
+            json_put_lit(w, ",\"to\":");
+            json_put_u32(w, chunk[i].to);
+            json_put_lit(w, ",\"lqi\":");
+            json_put_u32(w, chunk[i].lqi);
+            json_put_lit(w, ",\"depth\":");
+            json_put_u32(w, chunk[i].depth);
+            json_put_lit(w, ",\"rel\":");
+            json_put_u32(w, chunk[i].relationship);
+            json_put_lit(w, "}");
+        }
+        *cursor += (uint32_t)count;
+        if (count < TOPOLOGY_EDGE_CHUNK) {
+            return true;
+        }
+    }
+}
+
+esp_err_t api_topology_handler(httpd_req_t *req)
+{
+    api_usecases_handle_t usecases = req_usecases(req);
+    gateway_topology_summary_t summary = {0};
+    esp_err_t err = api_usecase_get_topology_summary(usecases, &summary);
+    if (err != ESP_OK) {
+        return http_error_send_esp(req, err, "Topology unavailable");
+    }
+
+    /* The cursor only carries over within one crawl; a new crawl is served from the start. */
+    topology_cursor_t cursor;
+    parse_cursor(req, &cursor);
+    if (cursor.crawl_id != summary.crawl_id) {
+        cursor.nodes_from = 0;
+        cursor.edges_from = 0;
+    }
+    uint32_t crawl_id = summary.crawl_id;
+
+    http_json_stream_t stream;
+    http_json_stream_begin(req, &stream);
+    json_writer_t *w = &stream.writer;
+    json_put_lit(w, "{\"crawl_id\":");
+    json_put_u32(w, crawl_id);
+    json_put_lit(w, ",\"nodes\":[");
+    bool current = crawl_id != 0 && write_nodes(w, usecases, crawl_id, &cursor.nodes_from);
+    json_put_lit(w, "],\"edges\":[");
+    current = current && write_edges(w, usecases, crawl_id, &cursor.edges_from);
+    json_put_lit(w, "]");
+
+    /* Read after the arrays, so "complete" never claims nodes or edges that were not sent. */
+    if (api_usecase_get_topology_summary(usecases, &summary) != ESP_OK || summary.crawl_id != crawl_id) {
+        current = false;
+    }
+    bool complete = current && summary.state != GATEWAY_TOPOLOGY_CRAWL_RUNNING &&
+                    cursor.nodes_from >= summary.node_count && cursor.edges_from >= summary.edge_count;
+
+    json_put_lit(w, ",\"state\":\"");
+    json_put_str(w, current ? crawl_state_label(summary.state) : (crawl_id ? "superseded" : "idle"));
+    json_put_lit(w, "\",\"truncated\":");
+    json_put_bool(w, current && summary.truncated);
+    json_put_lit(w, ",\"routers_done\":");
+    json_put_u32(w, current ? summary.routers_done : 0);
+    json_put_lit(w, ",\"routers_failed\":");
+    json_put_u32(w, current ? summary.routers_failed : 0);
+    json_put_lit(w, ",\"complete\":");
+    json_put_bool(w, complete);
+    json_put_lit(w, ",\"next\":{\"nodes\":");
+    json_put_u32(w, cursor.nodes_from);
+    json_put_lit(w, ",\"edges\":");
+    json_put_u32(w, cursor.edges_from);
+    json_put_lit(w, "}}");
+    return http_json_stream_end(&stream);
+}
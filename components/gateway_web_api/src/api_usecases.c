@@ -29,6 +29,10 @@ esp_err_t api_usecases_create(const api_usecases_init_params_t *params, api_usec
 
 void api_usecases_destroy(api_usecases_handle_t handle)
 {
+    if (!handle) {
+        return;
+    }
+    http_response_cache_release(&handle->response_cache);
     free(handle);
 }
 
@@ -62,6 +66,11 @@ void api_usecases_set_ws_providers(api_usecases_handle_t handle, api_ws_client_c
     handle->ws_provider_ctx = provider_ctx;
 }
 
+http_response_cache_t *api_usecases_response_cache(api_usecases_handle_t handle)
+{
+    return handle ? &handle->response_cache : NULL;
+}
+
 esp_err_t api_usecases_require_handle(api_usecases_handle_t handle)
 {
     return handle ? ESP_OK : ESP_ERR_INVALID_ARG;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "api_usecases.h"
+#include "http_response_cache.h"
 
 struct api_usecases {
     const api_service_ops_t *service_ops;
@@ -10,9 +11,11 @@ struct api_usecases {
     api_ws_client_count_provider_t ws_client_count_provider;
     api_ws_metrics_provider_t ws_metrics_provider;
     api_ws_provider_ctx_t *ws_provider_ctx;
+    http_response_cache_t response_cache;
 };
 
 esp_err_t api_usecases_require_handle(api_usecases_handle_t handle);
 esp_err_t api_usecases_require_wifi_system(api_usecases_handle_t handle);
 esp_err_t api_usecases_require_zigbee(api_usecases_handle_t handle);
 esp_err_t api_usecases_require_jobs(api_usecases_handle_t handle);
+http_response_cache_t *api_usecases_response_cache(api_usecases_handle_t handle);
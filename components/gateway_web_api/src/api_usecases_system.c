@@ -160,6 +160,8 @@ esp_err_t api_usecase_collect_health_snapshot(api_usecases_handle_t handle, api_
     out->zigbee_pan_id = gw_state.pan_id;
     out->zigbee_channel = gw_state.channel;
     out->zigbee_short_addr = gw_state.short_addr;
+    /* Counters only; a missing value must not fail the whole health snapshot. */
+    (void)gateway_wifi_system_get_zigbee_event_stats(handle->wifi_system, &out->zigbee_events);
 
     gateway_wifi_state_t wifi_state = {0};
     ret = gateway_wifi_system_get_wifi_state(handle->wifi_system, &wifi_state);
@@ -19,9 +19,63 @@ esp_err_t api_usecase_control(api_usecases_handle_t handle, const api_control_re
         return ret;
     }
 
+    if (in->confirm) {
+        return gateway_device_zigbee_send_on_off_confirmed(handle->zigbee_service, in->addr, in->ep, in->cmd,
+                                                           API_CONTROL_CONFIRM_TIMEOUT_MS);
+    }
     return gateway_device_zigbee_send_on_off(handle->zigbee_service, in->addr, in->ep, in->cmd);
 }
 
+esp_err_t api_usecase_control_batch(api_usecases_handle_t handle, api_control_batch_t *batch)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !batch || batch->count > API_CONTROL_BATCH_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (handle->service_ops) {
+        if (!handle->service_ops->send_on_off) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (size_t i = 0; i < batch->count; i++) {
+            if (batch->results[i] == ESP_OK) {
+                const api_control_request_t *in = &batch->items[i];
+                batch->results[i] = handle->service_ops->send_on_off(in->addr, in->ep, in->cmd);
+            }
+        }
+        return ESP_OK;
+    }
+
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    zigbee_on_off_cmd_t cmds[API_CONTROL_BATCH_MAX];
+    esp_err_t sent[API_CONTROL_BATCH_MAX];
+    size_t index[API_CONTROL_BATCH_MAX];
+    size_t count = 0;
+    for (size_t i = 0; i < batch->count; i++) {
+        if (batch->results[i] == ESP_OK) {
+            cmds[count] = (zigbee_on_off_cmd_t){
+                .short_addr = batch->items[i].addr,
+                .endpoint = batch->items[i].ep,
+                .on_off = batch->items[i].cmd,
+            };
+            index[count++] = i;
+        }
+    }
+    if (count == 0) {
+        return ESP_OK;
+    }
+
+    ret = gateway_device_zigbee_send_on_off_batch(handle->zigbee_service, cmds, count, sent);
+    for (size_t i = 0; i < count; i++) {
+        batch->results[index[i]] = ret == ESP_OK ? sent[i] : ret;
+    }
+    return ESP_OK;
+}
+
 esp_err_t api_usecase_get_network_status(api_usecases_handle_t handle, zigbee_network_status_t *out_status)
 {
     esp_err_t ret = api_usecases_require_handle(handle);
@@ -75,6 +129,87 @@ esp_err_t api_usecase_get_cached_lqi_snapshot(api_usecases_handle_t handle, zigb
                                                          out_source, out_updated_ms);
 }
 
+int api_usecase_get_cmd_stats_snapshot(api_usecases_handle_t handle, gateway_cmd_stats_t *out_stats, int max_stats)
+{
+    if (!handle) {
+        return 0;
+    }
+    if (api_usecases_require_zigbee(handle) != ESP_OK) {
+        return 0;
+    }
+    return gateway_device_zigbee_get_cmd_stats_snapshot(handle->zigbee_service, out_stats, max_stats);
+}
+
+int api_usecase_get_attr_snapshot(api_usecases_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                  gateway_attr_entry_t *out_attrs, int max_attrs)
+{
+    if (!handle) {
+        return 0;
+    }
+    if (api_usecases_require_zigbee(handle) != ESP_OK) {
+        return 0;
+    }
+    return gateway_device_zigbee_get_attr_snapshot(handle->zigbee_service, cluster_id, attr_id, out_attrs, max_attrs);
+}
+
+int api_usecase_get_device_profiles(api_usecases_handle_t handle, gateway_device_profile_t *out_profiles,
+                                    int max_profiles)
+{
+    if (!handle) {
+        return 0;
+    }
+    if (api_usecases_require_zigbee(handle) != ESP_OK) {
+        return 0;
+    }
+    return gateway_device_zigbee_get_device_profiles(handle->zigbee_service, out_profiles, max_profiles);
+}
+
+esp_err_t api_usecase_get_topology_summary(api_usecases_handle_t handle, gateway_topology_summary_t *out)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gateway_device_zigbee_get_topology_summary(handle->zigbee_service, out);
+}
+
+int api_usecase_get_topology_nodes(api_usecases_handle_t handle, uint32_t crawl_id, size_t from,
+                                   gateway_topology_node_t *out, size_t max_items)
+{
+    if (!handle || !out || api_usecases_require_zigbee(handle) != ESP_OK) {
+        return -1;
+    }
+    return gateway_device_zigbee_get_topology_nodes(handle->zigbee_service, crawl_id, from, out, max_items);
+}
+
+int api_usecase_get_topology_edges(api_usecases_handle_t handle, uint32_t crawl_id, size_t from,
+                                   gateway_topology_edge_t *out, size_t max_items)
+{
+    if (!handle || !out || api_usecases_require_zigbee(handle) != ESP_OK) {
+        return -1;
+    }
+    return gateway_device_zigbee_get_topology_edges(handle->zigbee_service, crawl_id, from, out, max_items);
+}
+
+esp_err_t api_usecase_get_state_generation(api_usecases_handle_t handle, zigbee_state_generation_t *out_generation)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !out_generation) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gateway_device_zigbee_get_state_generation(handle->zigbee_service, out_generation);
+}
+
 esp_err_t api_usecase_permit_join(api_usecases_handle_t handle, uint8_t duration_seconds)
 {
     esp_err_t ret = api_usecases_require_handle(handle);
@@ -116,3 +251,85 @@ esp_err_t api_usecase_rename_device(api_usecases_handle_t handle, uint16_t short
 
     return gateway_device_zigbee_rename_device(handle->zigbee_service, short_addr, name);
 }
+
+esp_err_t api_usecase_group_create(api_usecases_handle_t handle, const api_group_create_request_t *in,
+                                   uint16_t *out_group_id)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !in || !out_group_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gateway_device_zigbee_group_create(handle->zigbee_service, in->name, out_group_id);
+}
+
+esp_err_t api_usecase_group_delete(api_usecases_handle_t handle, const api_group_delete_request_t *in)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !in) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gateway_device_zigbee_group_delete(handle->zigbee_service, in->group_id);
+}
+
+esp_err_t api_usecase_group_add_member(api_usecases_handle_t handle, const api_group_member_request_t *in)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !in) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gateway_device_zigbee_group_add_member(handle->zigbee_service, in->group_id, in->addr, in->ep);
+}
+
+esp_err_t api_usecase_group_remove_member(api_usecases_handle_t handle, const api_group_member_request_t *in)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !in) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gateway_device_zigbee_group_remove_member(handle->zigbee_service, in->group_id, in->addr, in->ep);
+}
+
+esp_err_t api_usecase_group_control(api_usecases_handle_t handle, const api_group_control_request_t *in)
+{
+    esp_err_t ret = api_usecases_require_handle(handle);
+    if (ret != ESP_OK || !in) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ret = api_usecases_require_zigbee(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return gateway_device_zigbee_group_send_on_off(handle->zigbee_service, in->group_id, in->cmd);
+}
+
+int api_usecase_get_groups_snapshot(api_usecases_handle_t handle, zigbee_group_t *out_groups, int max_groups)
+{
+    if (!handle) {
+        return 0;
+    }
+    if (api_usecases_require_zigbee(handle) != ESP_OK) {
+        return 0;
+    }
+    return gateway_device_zigbee_get_groups_snapshot(handle->zigbee_service, out_groups, max_groups);
+}
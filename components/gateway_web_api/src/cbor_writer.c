@@ -0,0 +1,152 @@
+#include "cbor_writer.h"
+
+#include <string.h>
+
+#define CBOR_MAJOR_UINT 0u
+#define CBOR_MAJOR_NINT 1u
+#define CBOR_MAJOR_TEXT 3u
+#define CBOR_MAJOR_ARRAY 4u
+#define CBOR_SIMPLE_FALSE 0xf4u
+#define CBOR_SIMPLE_TRUE 0xf5u
+#define CBOR_SIMPLE_NULL 0xf6u
+#define CBOR_FLOAT32 0xfau
+
+/* Writes the initial byte plus the shortest big-endian argument for value. */
+static bool cbor_put_head(uint8_t **cursor, size_t *remaining, uint8_t major, uint64_t value)
+{
+    uint8_t head[9];
+    size_t len = 0;
+    if (value < 24u) {
+        head[len++] = (uint8_t)((major << 5) | value);
+    } else {
+        size_t arg_len;
+        uint8_t info;
+        if (value <= UINT8_MAX) {
+            arg_len = 1;
+            info = 24;
+        } else if (value <= UINT16_MAX) {
+            arg_len = 2;
+            info = 25;
+        } else if (value <= UINT32_MAX) {
+            arg_len = 4;
+            info = 26;
+        } else {
+            arg_len = 8;
+            info = 27;
+        }
+        head[len++] = (uint8_t)((major << 5) | info);
+        for (size_t i = arg_len; i > 0; i--) {
+            head[len++] = (uint8_t)(value >> (8 * (i - 1)));
+        }
+    }
+    if (*remaining < len) {
+        return false;
+    }
+    memcpy(*cursor, head, len);
+    *cursor += len;
+    *remaining -= len;
+    return true;
+}
+
+bool cbor_put_uint(uint8_t **cursor, size_t *remaining, uint64_t value)
+{
+    return cbor_put_head(cursor, remaining, CBOR_MAJOR_UINT, value);
+}
+
+bool cbor_put_int(uint8_t **cursor, size_t *remaining, int64_t value)
+{
+    if (value >= 0) {
+        return cbor_put_head(cursor, remaining, CBOR_MAJOR_UINT, (uint64_t)value);
+    }
+    /* Major type 1 encodes -1 - n. */
+    return cbor_put_head(cursor, remaining, CBOR_MAJOR_NINT, (uint64_t)(-(value + 1)));
+}
+
+bool cbor_put_text(uint8_t **cursor, size_t *remaining, const char *text)
+{
+    size_t len = text ? strlen(text) : 0;
+    uint8_t *start = *cursor;
+    size_t start_remaining = *remaining;
+    if (!cbor_put_head(cursor, remaining, CBOR_MAJOR_TEXT, len)) {
+        return false;
+    }
+    if (*remaining < len) {
+        *cursor = start;
+        *remaining = start_remaining;
+        return false;
+    }
+    if (len > 0) {
+        memcpy(*cursor, text, len);
+    }
+    *cursor += len;
+    *remaining -= len;
+    return true;
+}
+
+bool cbor_put_array(uint8_t **cursor, size_t *remaining, size_t count)
+{
+    return cbor_put_head(cursor, remaining, CBOR_MAJOR_ARRAY, count);
+}
+
+static bool cbor_put_simple(uint8_t **cursor, size_t *remaining, uint8_t value)
+{
+    if (*remaining < 1) {
+        return false;
+    }
+    *(*cursor)++ = value;
+    (*remaining)--;
+    return true;
+}
+
+bool cbor_put_bool(uint8_t **cursor, size_t *remaining, bool value)
+{
+    return cbor_put_simple(cursor, remaining, value ? CBOR_SIMPLE_TRUE : CBOR_SIMPLE_FALSE);
+}
+
+bool cbor_put_null(uint8_t **cursor, size_t *remaining)
+{
+    return cbor_put_simple(cursor, remaining, CBOR_SIMPLE_NULL);
+}
+
+bool cbor_put_float(uint8_t **cursor, size_t *remaining, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (*remaining < 5) {
+        return false;
+    }
+    uint8_t *out = *cursor;
+    out[0] = CBOR_FLOAT32;
+    out[1] = (uint8_t)(bits >> 24);
+    out[2] = (uint8_t)(bits >> 16);
+    out[3] = (uint8_t)(bits >> 8);
+    out[4] = (uint8_t)bits;
+    *cursor += 5;
+    *remaining -= 5;
+    return true;
+}
+
+size_t cbor_len_uint(uint64_t value)
+{
+    if (value < 24u) {
+        return 1;
+    }
+    if (value <= UINT8_MAX) {
+        return 2;
+    }
+    if (value <= UINT16_MAX) {
+        return 3;
+    }
+    return (value <= UINT32_MAX) ? 5 : 9;
+}
+
+size_t cbor_len_int(int64_t value)
+{
+    return cbor_len_uint(value >= 0 ? (uint64_t)value : (uint64_t)(-(value + 1)));
+}
+
+size_t cbor_len_text(const char *text)
+{
+    size_t len = text ? strlen(text) : 0;
+    return cbor_len_uint(len) + len;
+}
@@ -1,14 +1,14 @@
 #include "health_json_builder.h"
 
+#include "api_dto_fields.h"
 #include "api_usecases.h"
+#include "dto_codec.h"
 #include "error_ring.h"
+#include "json_writer.h"
 
-#include <inttypes.h>
 #include <stdbool.h>
-#include <stdio.h>
-#include <string.h>
 
-static const char *wifi_link_quality_label(api_system_wifi_link_quality_t quality)
+const char *api_wifi_link_quality_label(api_system_wifi_link_quality_t quality)
 {
     switch (quality) {
     case API_WIFI_LINK_GOOD:
@@ -23,127 +23,111 @@ static const char *wifi_link_quality_label(api_system_wifi_link_quality_t qualit
     }
 }
 
-static bool append_literal(char **cursor, size_t *remaining, const char *text)
+const char *api_ws_encoding_label(bool binary)
 {
-    int written = snprintf(*cursor, *remaining, "%s", text);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
-    }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
+    return binary ? "cbor" : "json";
 }
 
-static bool append_u32(char **cursor, size_t *remaining, uint32_t value)
+DTO_DEFINE(dto_error_entry, gateway_error_entry_t, API_DTO_ERROR_ENTRY_FIELDS)
+DTO_DEFINE(dto_ws_client, api_ws_client_metrics_t, API_DTO_WS_CLIENT_FIELDS)
+DTO_DEFINE(dto_health_wifi, api_health_snapshot_t, API_DTO_HEALTH_WIFI_FIELDS)
+DTO_DEFINE(dto_health_zigbee, api_health_snapshot_t, API_DTO_HEALTH_ZIGBEE_FIELDS)
+DTO_DEFINE(dto_health_web, api_health_snapshot_t, API_DTO_HEALTH_WEB_FIELDS)
+DTO_DEFINE(dto_health_nvs, api_health_snapshot_t, API_DTO_HEALTH_NVS_FIELDS)
+DTO_DEFINE(dto_health_system, api_health_snapshot_t, API_DTO_HEALTH_SYSTEM_FIELDS)
+DTO_DEFINE(dto_health_telemetry, api_health_snapshot_t, API_DTO_HEALTH_TELEMETRY_FIELDS)
+DTO_DEFINE(dto_health_jobs, api_health_snapshot_t, API_DTO_HEALTH_JOBS_FIELDS)
+DTO_DEFINE(dto_health_ws, api_health_snapshot_t, API_DTO_HEALTH_WS_FIELDS)
+
+static void put_error_ring_array(json_writer_t *w)
 {
-    int written = snprintf(*cursor, *remaining, "%" PRIu32, value);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
-    }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
-}
-
-static bool append_u64(char **cursor, size_t *remaining, uint64_t value)
-{
-    int written = snprintf(*cursor, *remaining, "%" PRIu64, value);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
+    const size_t max_emit = 5;
+    gateway_error_entry_t entries[5];
+    size_t count = gateway_error_ring_snapshot(entries, max_emit);
+    if (count > max_emit) {
+        count = max_emit;
     }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
-}
 
-static bool append_i32(char **cursor, size_t *remaining, int32_t value)
-{
-    int written = snprintf(*cursor, *remaining, "%" PRId32, value);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
+    json_put_lit(w, "[");
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            json_put_lit(w, ",");
+        }
+        dto_error_entry_put_json(w, &entries[i]);
     }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
+    json_put_lit(w, "]");
 }
 
-static bool append_json_escaped(char **cursor, size_t *remaining, const char *src)
+static void put_ws_clients_array(json_writer_t *w, const api_ws_runtime_metrics_t *metrics)
 {
-    if (!src) {
-        return append_literal(cursor, remaining, "");
+    uint32_t count = metrics->client_count;
+    if (count > API_WS_METRICS_MAX_CLIENTS) {
+        count = API_WS_METRICS_MAX_CLIENTS;
     }
 
-    while (*src) {
-        unsigned char ch = (unsigned char)*src++;
-        if (ch == '"' || ch == '\\') {
-            if (*remaining < 3) {
-                return false;
-            }
-            *(*cursor)++ = '\\';
-            *(*cursor)++ = (char)ch;
-            *remaining -= 2;
-            continue;
+    json_put_lit(w, "[");
+    for (uint32_t i = 0; i < count; i++) {
+        if (i > 0) {
+            json_put_lit(w, ",");
         }
-        if (ch < 0x20) {
-            if (*remaining < 7) {
-                return false;
-            }
-            int written = snprintf(*cursor, *remaining, "\\u%04x", (unsigned)ch);
-            if (written != 6) {
-                return false;
-            }
-            *cursor += written;
-            *remaining -= (size_t)written;
-            continue;
-        }
-        if (*remaining < 2) {
-            return false;
-        }
-        *(*cursor)++ = (char)ch;
-        (*remaining)--;
+        dto_ws_client_put_json(w, &metrics->clients[i]);
     }
-    **cursor = '\0';
-    return true;
+    json_put_lit(w, "]");
 }
 
-static esp_err_t append_error_ring_array(char **cursor, size_t *remaining)
+static void put_latency_histogram(json_writer_t *w, const api_latency_histogram_t *hist)
 {
-    const size_t max_emit = 5;
-    gateway_error_entry_t entries[5];
-    size_t count = gateway_error_ring_snapshot(entries, max_emit);
-    if (count > max_emit) {
-        count = max_emit;
+    json_put_lit(w, "{\"count\":");
+    json_put_u32(w, hist->count);
+    json_put_lit(w, ",\"p50_ms\":");
+    json_put_u32(w, api_latency_histogram_percentile_ms(hist, 50));
+    json_put_lit(w, ",\"p95_ms\":");
+    json_put_u32(w, api_latency_histogram_percentile_ms(hist, 95));
+    json_put_lit(w, ",\"max_us\":");
+    json_put_u32(w, hist->max_us);
+    json_put_lit(w, ",\"buckets\":[");
+    for (size_t i = 0; i < API_LATENCY_BUCKET_COUNT; i++) {
+        if (i > 0) {
+            json_put_lit(w, ",");
+        }
+        json_put_u32(w, hist->buckets[i]);
     }
+    json_put_lit(w, "]}");
+}
 
-    if (!append_literal(cursor, remaining, "[")) {
-        return ESP_ERR_NO_MEM;
-    }
-    for (size_t i = 0; i < count; i++) {
-        if (i > 0 && !append_literal(cursor, remaining, ",")) {
-            return ESP_ERR_NO_MEM;
-        }
-        if (!append_literal(cursor, remaining, "{\"ts_ms\":") ||
-            !append_u64(cursor, remaining, entries[i].ts_ms) ||
-            !append_literal(cursor, remaining, ",\"source\":\"") ||
-            !append_json_escaped(cursor, remaining, entries[i].source) ||
-            !append_literal(cursor, remaining, "\",\"code\":") ||
-            !append_i32(cursor, remaining, entries[i].code) ||
-            !append_literal(cursor, remaining, ",\"message\":\"") ||
-            !append_json_escaped(cursor, remaining, entries[i].message) ||
-            !append_literal(cursor, remaining, "\"}"))
-        {
-            return ESP_ERR_NO_MEM;
+static void put_ws_latency_object(json_writer_t *w, const api_ws_runtime_metrics_t *metrics)
+{
+    static const char *const kind_names[API_WS_LATENCY_KIND_COUNT] = {
+        [API_WS_LATENCY_DEVICES] = "devices_delta",
+        [API_WS_LATENCY_HEALTH] = "health_state",
+        [API_WS_LATENCY_LQI] = "lqi_update",
+    };
+
+    /* Bucket edges are emitted once; the last bucket is open-ended. */
+    json_put_lit(w, "{\"bucket_bounds_ms\":[");
+    for (size_t i = 0; i + 1 < API_LATENCY_BUCKET_COUNT; i++) {
+        if (i > 0) {
+            json_put_lit(w, ",");
         }
-    }
-    if (!append_literal(cursor, remaining, "]")) {
-        return ESP_ERR_NO_MEM;
-    }
-    return ESP_OK;
+        json_put_u32(w, api_latency_histogram_bucket_bound_ms(i));
+    }
+    json_put_lit(w, "]");
+    for (int kind = 0; kind < API_WS_LATENCY_KIND_COUNT; kind++) {
+        const api_ws_event_latency_t *latency = &metrics->latency[kind];
+        json_put_lit(w, ",\"");
+        json_put_str(w, kind_names[kind]);
+        json_put_lit(w, "\":{\"serialize\":");
+        put_latency_histogram(w, &latency->serialize);
+        json_put_lit(w, ",\"sent\":");
+        put_latency_histogram(w, &latency->sent);
+        json_put_lit(w, "}");
+    }
+    json_put_lit(w, "}");
 }
 
-esp_err_t build_health_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+esp_err_t write_health_json(api_usecases_handle_t usecases, json_writer_t *w)
 {
-    if (!usecases || !out || out_size < 2) {
+    if (!usecases || !w) {
         return ESP_ERR_INVALID_ARG;
     }
 
@@ -152,139 +136,44 @@ esp_err_t build_health_json_compact(api_usecases_handle_t usecases, char *out, s
     if (hs_ret != ESP_OK) {
         return hs_ret;
     }
-    const uint64_t telemetry_updated_ms = hs.telemetry.uptime_ms;
-
-    char *cursor = out;
-    size_t remaining = out_size;
-
-    if (!append_literal(&cursor, &remaining, "{\"wifi\":{")) {
-        return ESP_ERR_NO_MEM;
-    }
-    if (!append_literal(&cursor, &remaining, "\"sta_connected\":") ||
-        !append_literal(&cursor, &remaining, hs.wifi_sta_connected ? "true" : "false") ||
-        !append_literal(&cursor, &remaining, ",\"fallback_ap_active\":") ||
-        !append_literal(&cursor, &remaining, hs.wifi_fallback_ap_active ? "true" : "false") ||
-        !append_literal(&cursor, &remaining, ",\"loaded_from_nvs\":") ||
-        !append_literal(&cursor, &remaining, hs.wifi_loaded_from_nvs ? "true" : "false") ||
-        !append_literal(&cursor, &remaining, ",\"active_ssid\":\"") ||
-        !append_json_escaped(&cursor, &remaining, hs.wifi_active_ssid) ||
-        !append_literal(&cursor, &remaining, "\",\"rssi\":"))
-    {
-        return ESP_ERR_NO_MEM;
-    }
-    if (hs.telemetry.has_wifi_rssi) {
-        if (!append_i32(&cursor, &remaining, hs.telemetry.wifi_rssi)) {
-            return ESP_ERR_NO_MEM;
-        }
-    } else if (!append_literal(&cursor, &remaining, "null")) {
-        return ESP_ERR_NO_MEM;
-    }
-    if (!append_literal(&cursor, &remaining, ",\"link_quality\":\"") ||
-        !append_literal(&cursor, &remaining, wifi_link_quality_label(hs.telemetry.wifi_link_quality)) ||
-        !append_literal(&cursor, &remaining, "\",\"ip\":"))
-    {
-        return ESP_ERR_NO_MEM;
-    }
-    if (hs.telemetry.has_wifi_ip) {
-        if (!append_literal(&cursor, &remaining, "\"") ||
-            !append_json_escaped(&cursor, &remaining, hs.telemetry.wifi_ip) ||
-            !append_literal(&cursor, &remaining, "\""))
-        {
-            return ESP_ERR_NO_MEM;
-        }
-    } else if (!append_literal(&cursor, &remaining, "null")) {
-        return ESP_ERR_NO_MEM;
-    }
 
-    if (!append_literal(&cursor, &remaining, "},\"zigbee\":{") ||
-        !append_literal(&cursor, &remaining, "\"started\":") ||
-        !append_literal(&cursor, &remaining, hs.zigbee_started ? "true" : "false") ||
-        !append_literal(&cursor, &remaining, ",\"factory_new\":") ||
-        !append_literal(&cursor, &remaining, hs.zigbee_factory_new ? "true" : "false") ||
-        !append_literal(&cursor, &remaining, ",\"pan_id\":") ||
-        !append_u32(&cursor, &remaining, hs.zigbee_pan_id) ||
-        !append_literal(&cursor, &remaining, ",\"channel\":") ||
-        !append_u32(&cursor, &remaining, hs.zigbee_channel) ||
-        !append_literal(&cursor, &remaining, ",\"short_addr\":") ||
-        !append_u32(&cursor, &remaining, hs.zigbee_short_addr) ||
-        !append_literal(&cursor, &remaining, "},\"web\":{") ||
-        !append_literal(&cursor, &remaining, "\"ws_clients\":") ||
-        !append_u32(&cursor, &remaining, hs.ws_clients) ||
-        !append_literal(&cursor, &remaining, ",\"ready\":true},\"nvs\":{") ||
-        !append_literal(&cursor, &remaining, "\"ok\":") ||
-        !append_literal(&cursor, &remaining, hs.nvs_ok ? "true" : "false") ||
-        !append_literal(&cursor, &remaining, ",\"schema_version\":") ||
-        !append_i32(&cursor, &remaining, hs.nvs_schema_version) ||
-        !append_literal(&cursor, &remaining, "},\"system\":{") ||
-        !append_literal(&cursor, &remaining, "\"uptime_ms\":") ||
-        !append_u64(&cursor, &remaining, hs.telemetry.uptime_ms) ||
-        !append_literal(&cursor, &remaining, ",\"heap_free\":") ||
-        !append_u32(&cursor, &remaining, hs.telemetry.heap_free) ||
-        !append_literal(&cursor, &remaining, ",\"heap_min\":") ||
-        !append_u32(&cursor, &remaining, hs.telemetry.heap_min) ||
-        !append_literal(&cursor, &remaining, ",\"heap_largest_block\":") ||
-        !append_u32(&cursor, &remaining, hs.telemetry.heap_largest_block) ||
-        !append_literal(&cursor, &remaining, ",\"main_stack_hwm_bytes\":") ||
-        !append_i32(&cursor, &remaining, hs.telemetry.main_stack_hwm_bytes) ||
-        !append_literal(&cursor, &remaining, ",\"httpd_stack_hwm_bytes\":") ||
-        !append_i32(&cursor, &remaining, hs.telemetry.httpd_stack_hwm_bytes) ||
-        !append_literal(&cursor, &remaining, ",\"temperature_c\":"))
-    {
-        return ESP_ERR_NO_MEM;
-    }
-    if (hs.telemetry.has_temperature_c) {
-        int written = snprintf(cursor, remaining, "%.2f", (double)hs.telemetry.temperature_c);
-        if (written < 0 || (size_t)written >= remaining) {
-            return ESP_ERR_NO_MEM;
-        }
-        cursor += written;
-        remaining -= (size_t)written;
-    } else if (!append_literal(&cursor, &remaining, "null")) {
-        return ESP_ERR_NO_MEM;
-    }
+    json_put_lit(w, "{\"wifi\":");
+    dto_health_wifi_put_json(w, &hs);
+    json_put_lit(w, ",\"zigbee\":");
+    dto_health_zigbee_put_json(w, &hs);
+    json_put_lit(w, ",\"web\":");
+    dto_health_web_put_json(w, &hs);
+    json_put_lit(w, ",\"nvs\":");
+    dto_health_nvs_put_json(w, &hs);
+    json_put_lit(w, ",\"system\":");
+    dto_health_system_put_json(w, &hs);
+    json_put_lit(w, ",\"telemetry\":");
+    dto_health_telemetry_put_json(w, &hs);
+    json_put_lit(w, ",\"runtime\":{\"jobs\":");
+    dto_health_jobs_put_json(w, &hs);
+    json_put_lit(w, ",\"ws\":{");
+    dto_health_ws_put_json_members(w, &hs, true);
+    json_put_lit(w, ",\"latency\":");
+    put_ws_latency_object(w, &hs.ws_metrics);
+    json_put_lit(w, ",\"clients\":");
+    put_ws_clients_array(w, &hs.ws_metrics);
+    json_put_lit(w, "}},\"errors\":");
+    put_error_ring_array(w);
+    json_put_lit(w, "}");
+    return ESP_OK;
+}
 
-    if (!append_literal(&cursor, &remaining, "},\"telemetry\":{") ||
-        !append_literal(&cursor, &remaining, "\"updated_ms\":") ||
-        !append_u64(&cursor, &remaining, telemetry_updated_ms) ||
-        !append_literal(&cursor, &remaining, "},\"runtime\":{") ||
-        !append_literal(&cursor, &remaining, "\"jobs\":{") ||
-        !append_literal(&cursor, &remaining, "\"submitted_total\":") ||
-        !append_u32(&cursor, &remaining, hs.jobs_metrics.submitted_total) ||
-        !append_literal(&cursor, &remaining, ",\"dedup_reused_total\":") ||
-        !append_u32(&cursor, &remaining, hs.jobs_metrics.dedup_reused_total) ||
-        !append_literal(&cursor, &remaining, ",\"completed_total\":") ||
-        !append_u32(&cursor, &remaining, hs.jobs_metrics.completed_total) ||
-        !append_literal(&cursor, &remaining, ",\"failed_total\":") ||
-        !append_u32(&cursor, &remaining, hs.jobs_metrics.failed_total) ||
-        !append_literal(&cursor, &remaining, ",\"queue_depth\":") ||
-        !append_u32(&cursor, &remaining, hs.jobs_metrics.queue_depth_current) ||
-        !append_literal(&cursor, &remaining, ",\"queue_depth_peak\":") ||
-        !append_u32(&cursor, &remaining, hs.jobs_metrics.queue_depth_peak) ||
-        !append_literal(&cursor, &remaining, ",\"latency_p95_ms\":") ||
-        !append_u32(&cursor, &remaining, hs.jobs_metrics.latency_p95_ms) ||
-        !append_literal(&cursor, &remaining, "},\"ws\":{") ||
-        !append_literal(&cursor, &remaining, "\"dropped_frames_total\":") ||
-        !append_u32(&cursor, &remaining, hs.ws_metrics.dropped_frames_total) ||
-        !append_literal(&cursor, &remaining, ",\"reconnect_count\":") ||
-        !append_u32(&cursor, &remaining, hs.ws_metrics.reconnect_count) ||
-        !append_literal(&cursor, &remaining, ",\"connections_total\":") ||
-        !append_u32(&cursor, &remaining, hs.ws_metrics.connections_total) ||
-        !append_literal(&cursor, &remaining, ",\"broadcast_lock_skips_total\":") ||
-        !append_u32(&cursor, &remaining, hs.ws_metrics.broadcast_lock_skips_total) ||
-        !append_literal(&cursor, &remaining, "}},\"errors\":"))
-    {
-        return ESP_ERR_NO_MEM;
-    }
-    esp_err_t ring_ret = append_error_ring_array(&cursor, &remaining);
-    if (ring_ret != ESP_OK) {
-        return ring_ret;
-    }
-    if (!append_literal(&cursor, &remaining, "}")) {
-        return ESP_ERR_NO_MEM;
+esp_err_t build_health_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+{
+    if (!usecases || !out || out_size < 2) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    if (out_len) {
-        *out_len = (size_t)(cursor - out);
+    json_writer_t w;
+    json_writer_init(&w, out, out_size);
+    esp_err_t ret = write_health_json(usecases, &w);
+    if (ret != ESP_OK) {
+        return ret;
     }
-    return ESP_OK;
+    return json_writer_finish(&w, out_len) ? ESP_OK : ESP_ERR_NO_MEM;
 }
@@ -1,5 +1,6 @@
 #include "http_error.h"
 #include "error_ring.h"
+#include "http_response_cache.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -19,6 +20,7 @@ static const char *http_status_text(int code)
     case 409: return "409 Conflict";
     case 500: return "500 Internal Server Error";
     case 503: return "503 Service Unavailable";
+    case 504: return "504 Gateway Timeout";
     default: return "500 Internal Server Error";
     }
 }
@@ -46,6 +48,10 @@ static bool map_error_default(esp_err_t err, int *out_http_status, const char **
         *out_http_status = 503;
         *out_error_code = "no_memory";
         return true;
+    case ESP_ERR_TIMEOUT:
+        *out_http_status = 504;
+        *out_error_code = "timeout";
+        return true;
     default:
         *out_http_status = 500;
         *out_error_code = "internal_error";
@@ -96,6 +102,14 @@ esp_err_t http_error_send_esp(httpd_req_t *req, esp_err_t err, const char *messa
     return http_error_send(req, http_status, error_code, message);
 }
 
+const char *http_error_code_name(esp_err_t err)
+{
+    int http_status = 500;
+    const char *error_code = "internal_error";
+    (void)map_error(err, &http_status, &error_code);
+    return error_code;
+}
+
 esp_err_t http_success_send(httpd_req_t *req, const char *message)
 {
     if (!req) {
@@ -132,3 +146,93 @@ esp_err_t http_success_send_data_json(httpd_req_t *req, const char *data_json)
     }
     return httpd_resp_sendstr_chunk(req, NULL);
 }
+
+#define HTTP_IF_NONE_MATCH_MAX_LEN 160
+
+bool http_req_etag_matches(httpd_req_t *req, const char *etag)
+{
+    if (!req || !etag) {
+        return false;
+    }
+    size_t len = httpd_req_get_hdr_value_len(req, "If-None-Match");
+    if (len == 0 || len >= HTTP_IF_NONE_MATCH_MAX_LEN) {
+        return false;
+    }
+
+    char value[HTTP_IF_NONE_MATCH_MAX_LEN];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", value, sizeof(value)) != ESP_OK) {
+        return false;
+    }
+    return http_etag_matches(value, etag);
+}
+
+void http_etag_headers_set(httpd_req_t *req, const char *etag)
+{
+    if (!req || !etag) {
+        return;
+    }
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+}
+
+esp_err_t http_not_modified_send(httpd_req_t *req, const char *etag)
+{
+    if (!req) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    httpd_resp_set_status(req, "304 Not Modified");
+    http_etag_headers_set(req, etag);
+    return httpd_resp_send(req, NULL, 0);
+}
+
+static bool http_json_stream_sink(void *ctx, const char *data, size_t len)
+{
+    http_json_stream_t *stream = (http_json_stream_t *)ctx;
+    if (httpd_resp_send_chunk(stream->req, data, (ssize_t)len) != ESP_OK) {
+        return false;
+    }
+    return !stream->tee || stream->tee(stream->tee_ctx, data, len);
+}
+
+void http_json_stream_begin(httpd_req_t *req, http_json_stream_t *stream)
+{
+    if (!stream) {
+        return;
+    }
+    stream->req = req;
+    stream->tee = NULL;
+    stream->tee_ctx = NULL;
+    json_writer_init_stream(&stream->writer, stream->chunk, sizeof(stream->chunk), http_json_stream_sink, stream);
+    if (!req) {
+        stream->writer.overflow = true;
+        return;
+    }
+    httpd_resp_set_type(req, "application/json");
+    json_put_lit(&stream->writer, "{\"status\":\"ok\",\"data\":");
+}
+
+void http_json_stream_tee(http_json_stream_t *stream, json_writer_sink_t sink, void *ctx)
+{
+    if (!stream) {
+        return;
+    }
+    stream->tee = sink;
+    stream->tee_ctx = ctx;
+}
+
+bool http_json_stream_started(const http_json_stream_t *stream)
+{
+    return stream && stream->writer.flushed > 0;
+}
+
+esp_err_t http_json_stream_end(http_json_stream_t *stream)
+{
+    if (!stream || !stream->req) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    json_put_lit(&stream->writer, "}");
+    if (!json_writer_finish(&stream->writer, NULL)) {
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(stream->req, NULL, 0);
+}
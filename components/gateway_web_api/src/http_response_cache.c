@@ -0,0 +1,125 @@
+#include "http_response_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static bool etag_char_is_space(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+bool http_etag_matches(const char *if_none_match, const char *etag)
+{
+    if (!if_none_match || !etag || etag[0] == '\0') {
+        return false;
+    }
+
+    size_t etag_len = strlen(etag);
+    const char *p = if_none_match;
+    while (*p) {
+        while (etag_char_is_space(*p) || *p == ',') {
+            p++;
+        }
+        const char *start = p;
+        while (*p && *p != ',') {
+            p++;
+        }
+        const char *end = p;
+        while (end > start && etag_char_is_space(end[-1])) {
+            end--;
+        }
+        if (end - start == 1 && *start == '*') {
+            return true;
+        }
+        if (end - start > 2 && start[0] == 'W' && start[1] == '/') {
+            start += 2;
+        }
+        if ((size_t)(end - start) == etag_len && memcmp(start, etag, etag_len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const http_response_cache_entry_t *http_response_cache_lookup(const http_response_cache_t *cache,
+                                                              http_response_cache_slot_t slot, const char *etag)
+{
+    if (!cache || (int)slot < 0 || slot >= HTTP_RESPONSE_CACHE_SLOT_COUNT || !etag) {
+        return NULL;
+    }
+    const http_response_cache_entry_t *entry = &cache->entries[slot];
+    if (entry->etag[0] == '\0' || !entry->body || strcmp(entry->etag, etag) != 0) {
+        return NULL;
+    }
+    return entry;
+}
+
+http_response_cache_entry_t *http_response_cache_fill_begin(http_response_cache_t *cache, http_response_cache_slot_t slot)
+{
+    if (!cache || (int)slot < 0 || slot >= HTTP_RESPONSE_CACHE_SLOT_COUNT) {
+        return NULL;
+    }
+    http_response_cache_entry_t *entry = &cache->entries[slot];
+    entry->etag[0] = '\0';
+    entry->len = 0;
+    entry->filling = true;
+    return entry;
+}
+
+bool http_response_cache_fill_sink(void *ctx, const char *data, size_t len)
+{
+    http_response_cache_entry_t *entry = (http_response_cache_entry_t *)ctx;
+    if (!entry || !entry->filling) {
+        return true;
+    }
+    size_t need = entry->len + len;
+    if (need > HTTP_RESPONSE_CACHE_BODY_MAX) {
+        /* Too large to keep; the response itself still goes out. */
+        entry->filling = false;
+        return true;
+    }
+    if (need > entry->capacity) {
+        size_t capacity = entry->capacity ? entry->capacity : 512;
+        while (capacity < need) {
+            capacity *= 2;
+        }
+        if (capacity > HTTP_RESPONSE_CACHE_BODY_MAX) {
+            capacity = HTTP_RESPONSE_CACHE_BODY_MAX;
+        }
+        char *body = (char *)realloc(entry->body, capacity);
+        if (!body) {
+            entry->filling = false;
+            return true;
+        }
+        entry->body = body;
+        entry->capacity = capacity;
+    }
+    memcpy(entry->body + entry->len, data, len);
+    entry->len = need;
+    return true;
+}
+
+void http_response_cache_fill_commit(http_response_cache_entry_t *entry, const char *etag)
+{
+    if (!entry) {
+        return;
+    }
+    bool complete = entry->filling && entry->body && etag && strlen(etag) < sizeof(entry->etag);
+    entry->filling = false;
+    if (!complete) {
+        entry->etag[0] = '\0';
+        return;
+    }
+    memcpy(entry->etag, etag, strlen(etag) + 1);
+}
+
+void http_response_cache_release(http_response_cache_t *cache)
+{
+    if (!cache) {
+        return;
+    }
+    for (int i = 0; i < HTTP_RESPONSE_CACHE_SLOT_COUNT; i++) {
+        free(cache->entries[i].body);
+        memset(&cache->entries[i], 0, sizeof(cache->entries[i]));
+    }
+}
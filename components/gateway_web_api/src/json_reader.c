@@ -0,0 +1,509 @@
+#include "json_reader.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* cJSON copies at most 63 number characters before calling strtod. */
+#define JSON_READER_NUMBER_MAX_LEN 63
+#define JSON_READER_KEY_MAX_LEN 32
+
+static const char *skip_ws(const char *p)
+{
+    while (*p != '\0' && (unsigned char)*p <= 32) {
+        p++;
+    }
+    return p;
+}
+
+static bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static bool parse_hex4(const char *p, uint32_t *out)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hex_value(p[i]);
+        if (digit < 0) {
+            return false;
+        }
+        value = (value << 4) | (uint32_t)digit;
+    }
+    *out = value;
+    return true;
+}
+
+/*
+ * Decodes the escape at *pp (pointing at the backslash) into UTF-8 and advances past it.
+ * Surrogate rules follow cJSON: a lone low half or an unpaired high half is an error.
+ */
+static bool decode_escape(const char **pp, char utf8[4], size_t *out_len)
+{
+    const char *p = *pp + 1;
+    uint32_t codepoint;
+    switch (*p) {
+    case '"':
+    case '\\':
+    case '/':
+        utf8[0] = *p;
+        *out_len = 1;
+        *pp = p + 1;
+        return true;
+    case 'b':
+        utf8[0] = '\b';
+        break;
+    case 'f':
+        utf8[0] = '\f';
+        break;
+    case 'n':
+        utf8[0] = '\n';
+        break;
+    case 'r':
+        utf8[0] = '\r';
+        break;
+    case 't':
+        utf8[0] = '\t';
+        break;
+    case 'u':
+        if (!parse_hex4(p + 1, &codepoint) || (codepoint >= 0xDC00 && codepoint <= 0xDFFF)) {
+            return false;
+        }
+        p += 5;
+        if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+            uint32_t low;
+            if (p[0] != '\\' || p[1] != 'u' || !parse_hex4(p + 2, &low) || low < 0xDC00 || low > 0xDFFF) {
+                return false;
+            }
+            codepoint = 0x10000 + (((codepoint & 0x3FF) << 10) | (low & 0x3FF));
+            p += 6;
+        }
+        if (codepoint < 0x80) {
+            utf8[0] = (char)codepoint;
+            *out_len = 1;
+        } else if (codepoint < 0x800) {
+            utf8[0] = (char)(0xC0 | (codepoint >> 6));
+            utf8[1] = (char)(0x80 | (codepoint & 0x3F));
+            *out_len = 2;
+        } else if (codepoint < 0x10000) {
+            utf8[0] = (char)(0xE0 | (codepoint >> 12));
+            utf8[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            utf8[2] = (char)(0x80 | (codepoint & 0x3F));
+            *out_len = 3;
+        } else {
+            utf8[0] = (char)(0xF0 | (codepoint >> 18));
+            utf8[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+            utf8[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            utf8[3] = (char)(0x80 | (codepoint & 0x3F));
+            *out_len = 4;
+        }
+        *pp = p;
+        return true;
+    default:
+        return false;
+    }
+    *out_len = 1;
+    *pp = p + 1;
+    return true;
+}
+
+/* p points at the opening quote; returns the closing quote or NULL. */
+static const char *scan_string(const char *p)
+{
+    p++;
+    for (;;) {
+        if (*p == '\0') {
+            return NULL;
+        }
+        if (*p == '"') {
+            return p;
+        }
+        if (*p == '\\') {
+            char utf8[4];
+            size_t len;
+            if (!decode_escape(&p, utf8, &len)) {
+                return NULL;
+            }
+            continue;
+        }
+        p++;
+    }
+}
+
+static bool is_number_char(char c)
+{
+    return is_digit(c) || c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.';
+}
+
+/*
+ * Accepts exactly what cJSON's strtod call consumes in full: -?(digits[.digits]|.digits)([eE][+-]?digits)?
+ * with the "digits" on either side of the dot optional but not both. Returns the end or NULL.
+ */
+static const char *scan_number(const char *p)
+{
+    const char *start = p;
+    if (*p == '-') {
+        p++;
+    }
+    size_t mantissa_digits = 0;
+    while (is_digit(*p)) {
+        p++;
+        mantissa_digits++;
+    }
+    if (*p == '.') {
+        p++;
+        while (is_digit(*p)) {
+            p++;
+            mantissa_digits++;
+        }
+    }
+    if (mantissa_digits == 0) {
+        return NULL;
+    }
+    if (*p == 'e' || *p == 'E') {
+        const char *q = p + 1;
+        if (*q == '+' || *q == '-') {
+            q++;
+        }
+        if (!is_digit(*q)) {
+            return NULL;
+        }
+        while (is_digit(*q)) {
+            q++;
+        }
+        p = q;
+    }
+    if (is_number_char(*p) || (size_t)(p - start) > JSON_READER_NUMBER_MAX_LEN) {
+        return NULL;
+    }
+    return p;
+}
+
+static const char *skip_value(const char *p, int depth, json_reader_kind_t *out_kind);
+
+static const char *skip_container(const char *p, int depth, char close)
+{
+    if (depth > JSON_READER_MAX_DEPTH) {
+        return NULL;
+    }
+    p = skip_ws(p + 1);
+    if (*p == close) {
+        return p + 1;
+    }
+    for (;;) {
+        if (close == '}') {
+            if (*p != '"' || !(p = scan_string(p))) {
+                return NULL;
+            }
+            p = skip_ws(p + 1);
+            if (*p != ':') {
+                return NULL;
+            }
+            p = skip_ws(p + 1);
+        }
+        json_reader_kind_t kind;
+        if (!(p = skip_value(p, depth, &kind))) {
+            return NULL;
+        }
+        p = skip_ws(p);
+        if (*p == close) {
+            return p + 1;
+        }
+        if (*p != ',') {
+            return NULL;
+        }
+        p = skip_ws(p + 1);
+    }
+}
+
+/* Returns the first byte after the value or NULL. */
+static const char *skip_value(const char *p, int depth, json_reader_kind_t *out_kind)
+{
+    *out_kind = JSON_READER_OTHER;
+    switch (*p) {
+    case '"':
+        *out_kind = JSON_READER_STRING;
+        p = scan_string(p);
+        return p ? p + 1 : NULL;
+    case '{':
+        return skip_container(p, depth + 1, '}');
+    case '[':
+        return skip_container(p, depth + 1, ']');
+    case 'n':
+        return strncmp(p, "null", 4) == 0 ? p + 4 : NULL;
+    case 't':
+        return strncmp(p, "true", 4) == 0 ? p + 4 : NULL;
+    case 'f':
+        return strncmp(p, "false", 5) == 0 ? p + 5 : NULL;
+    default:
+        if (*p == '-' || is_digit(*p)) {
+            *out_kind = JSON_READER_NUMBER;
+            return scan_number(p);
+        }
+        return NULL;
+    }
+}
+
+static char ascii_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static bool key_equals(const char *key, size_t key_len, const char *expected)
+{
+    for (size_t i = 0; i < key_len; i++) {
+        if (expected[i] == '\0' || ascii_lower(key[i]) != ascii_lower(expected[i])) {
+            return false;
+        }
+    }
+    return expected[key_len] == '\0';
+}
+
+static int match_key(const char *start, const char *end, const char *const *keys, size_t key_count)
+{
+    char unescaped[JSON_READER_KEY_MAX_LEN];
+    size_t key_len = (size_t)(end - start);
+    if (memchr(start, '\\', key_len)) {
+        /* Escaped keys are rare; decode them once so "addr" still matches "addr". */
+        json_reader_value_t raw = {.kind = JSON_READER_STRING, .start = start, .end = end};
+        if (!json_reader_get_string(&raw, unescaped, sizeof(unescaped), &key_len)) {
+            return -1;
+        }
+        start = unescaped;
+    }
+    for (size_t i = 0; i < key_count; i++) {
+        if (key_equals(start, key_len, keys[i])) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static const char *skip_root_prefix(const char *json)
+{
+    if (strncmp(json, "\xEF\xBB\xBF", 3) == 0) {
+        json += 3;
+    }
+    return skip_ws(json);
+}
+
+bool json_reader_scan_object(const char *json, const char *const *keys, size_t key_count, json_reader_value_t *values)
+{
+    if (!json || (key_count > 0 && (!keys || !values))) {
+        return false;
+    }
+    for (size_t i = 0; i < key_count; i++) {
+        values[i] = (json_reader_value_t){0};
+    }
+
+    const char *p = skip_root_prefix(json);
+    if (*p != '{') {
+        return false;
+    }
+    p = skip_ws(p + 1);
+    if (*p == '}') {
+        return true;
+    }
+    for (;;) {
+        if (*p != '"') {
+            return false;
+        }
+        const char *key_start = p + 1;
+        const char *key_end = scan_string(p);
+        if (!key_end) {
+            return false;
+        }
+        p = skip_ws(key_end + 1);
+        if (*p != ':') {
+            return false;
+        }
+        p = skip_ws(p + 1);
+
+        const char *value_start = p;
+        json_reader_kind_t kind;
+        p = skip_value(p, 1, &kind);
+        if (!p) {
+            return false;
+        }
+        int idx = match_key(key_start, key_end, keys, key_count);
+        if (idx >= 0 && values[idx].kind == JSON_READER_ABSENT) {
+            bool is_string = kind == JSON_READER_STRING;
+            values[idx].kind = kind;
+            values[idx].start = value_start + (is_string ? 1 : 0);
+            values[idx].end = p - (is_string ? 1 : 0);
+        }
+
+        p = skip_ws(p);
+        if (*p == '}') {
+            return true;
+        }
+        if (*p != ',') {
+            return false;
+        }
+        p = skip_ws(p + 1);
+    }
+}
+
+bool json_reader_array_begin(const char *json, json_reader_array_t *it)
+{
+    if (!json || !it) {
+        return false;
+    }
+    const char *p = skip_root_prefix(json);
+    if (*p != '[') {
+        return false;
+    }
+    it->cursor = skip_ws(p + 1);
+    if (*it->cursor == ']') {
+        it->cursor = NULL;
+    }
+    return true;
+}
+
+bool json_reader_array_next(json_reader_array_t *it, json_reader_value_t *out)
+{
+    if (!it || !out) {
+        return false;
+    }
+    *out = (json_reader_value_t){0};
+    if (!it->cursor) {
+        return true;
+    }
+
+    const char *value_start = it->cursor;
+    json_reader_kind_t kind;
+    const char *p = skip_value(value_start, 1, &kind);
+    if (!p) {
+        it->cursor = NULL;
+        return false;
+    }
+    bool is_string = kind == JSON_READER_STRING;
+    out->kind = kind;
+    out->start = value_start + (is_string ? 1 : 0);
+    out->end = p - (is_string ? 1 : 0);
+
+    p = skip_ws(p);
+    if (*p == ']') {
+        it->cursor = NULL;
+        return true;
+    }
+    if (*p != ',') {
+        it->cursor = NULL;
+        *out = (json_reader_value_t){0};
+        return false;
+    }
+    it->cursor = skip_ws(p + 1);
+    return true;
+}
+
+bool json_reader_get_bool(const json_reader_value_t *value, bool *out)
+{
+    if (!value || value->kind != JSON_READER_OTHER || !out) {
+        return false;
+    }
+    /* skip_value already matched the literal, so its first byte tells them apart. */
+    if (*value->start == 't') {
+        *out = true;
+        return true;
+    }
+    if (*value->start == 'f') {
+        *out = false;
+        return true;
+    }
+    return false;
+}
+
+bool json_reader_get_int(const json_reader_value_t *value, int *out)
+{
+    if (!value || value->kind != JSON_READER_NUMBER || !out) {
+        return false;
+    }
+
+    const char *p = value->start;
+    bool negative = *p == '-';
+    if (negative) {
+        p++;
+    }
+    int64_t acc = 0;
+    while (p < value->end && is_digit(*p)) {
+        if (acc <= (int64_t)INT_MAX + 1) {
+            acc = acc * 10 + (*p - '0');
+        }
+        p++;
+    }
+    if (p == value->end) {
+        if (negative) {
+            *out = acc >= -(int64_t)INT_MIN ? INT_MIN : (int)-acc;
+        } else {
+            *out = acc >= INT_MAX ? INT_MAX : (int)acc;
+        }
+        return true;
+    }
+
+    /* Fractions and exponents go through strtod and the same clamping cJSON applies to valueint. */
+    char buf[JSON_READER_NUMBER_MAX_LEN + 1];
+    size_t len = (size_t)(value->end - value->start);
+    memcpy(buf, value->start, len);
+    buf[len] = '\0';
+    double number = strtod(buf, NULL);
+    if (number >= INT_MAX) {
+        *out = INT_MAX;
+    } else if (number <= (double)INT_MIN) {
+        *out = INT_MIN;
+    } else {
+        *out = (int)number;
+    }
+    return true;
+}
+
+bool json_reader_get_string(const json_reader_value_t *value, char *out, size_t out_size, size_t *out_len)
+{
+    if (!value || value->kind != JSON_READER_STRING || !out || out_size == 0) {
+        return false;
+    }
+
+    size_t len = 0;
+    const char *p = value->start;
+    while (p < value->end) {
+        const char *run = p;
+        while (p < value->end && *p != '\\') {
+            p++;
+        }
+        size_t run_len = (size_t)(p - run);
+        if (len + run_len >= out_size) {
+            return false;
+        }
+        memcpy(out + len, run, run_len);
+        len += run_len;
+        if (p < value->end) {
+            char utf8[4];
+            size_t n;
+            if (!decode_escape(&p, utf8, &n) || len + n >= out_size) {
+                return false;
+            }
+            memcpy(out + len, utf8, n);
+            len += n;
+        }
+    }
+    out[len] = '\0';
+    if (out_len) {
+        *out_len = strlen(out);
+    }
+    return true;
+}
@@ -0,0 +1,262 @@
+#include "json_writer.h"
+
+#include <string.h>
+
+static const char s_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char s_hex_digits[] = "0123456789abcdef";
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size)
+{
+    w->start = buf;
+    w->cursor = buf;
+    w->end = (buf && size > 0) ? buf + size - 1 : buf;
+    w->overflow = (!buf || size == 0);
+    w->sink = NULL;
+    w->sink_ctx = NULL;
+    w->flushed = 0;
+}
+
+void json_writer_init_stream(json_writer_t *w, char *buf, size_t size, json_writer_sink_t sink, void *sink_ctx)
+{
+    json_writer_init(w, buf, size);
+    w->sink = sink;
+    w->sink_ctx = sink_ctx;
+    if (!sink) {
+        w->overflow = true;
+    }
+}
+
+static void json_writer_emit(json_writer_t *w, const char *data, size_t len)
+{
+    if (len == 0 || w->overflow) {
+        return;
+    }
+    if (!w->sink(w->sink_ctx, data, len)) {
+        w->overflow = true;
+        return;
+    }
+    w->flushed += len;
+}
+
+static void json_writer_flush(json_writer_t *w)
+{
+    json_writer_emit(w, w->start, (size_t)(w->cursor - w->start));
+    w->cursor = w->start;
+}
+
+bool json_writer_finish(json_writer_t *w, size_t *out_len)
+{
+    if (w->sink) {
+        json_writer_flush(w);
+    }
+    if (w->overflow) {
+        return false;
+    }
+    *w->cursor = '\0';
+    if (out_len) {
+        *out_len = w->flushed + (size_t)(w->cursor - w->start);
+    }
+    return true;
+}
+
+void json_put_raw(json_writer_t *w, const char *data, size_t len)
+{
+    if (w->overflow) {
+        return;
+    }
+    if ((size_t)(w->end - w->cursor) < len) {
+        if (!w->sink) {
+            w->overflow = true;
+            return;
+        }
+        json_writer_flush(w);
+        if ((size_t)(w->end - w->cursor) < len) {
+            /* Larger than the whole chunk window: hand it to the sink as is. */
+            json_writer_emit(w, data, len);
+            return;
+        }
+    }
+    memcpy(w->cursor, data, len);
+    w->cursor += len;
+}
+
+void json_put_str(json_writer_t *w, const char *text)
+{
+    if (text) {
+        json_put_raw(w, text, strlen(text));
+    }
+}
+
+static bool json_byte_is_plain(unsigned char ch)
+{
+    return ch >= 0x20 && ch != '"' && ch != '\\';
+}
+
+void json_put_escaped(json_writer_t *w, const char *text)
+{
+    if (!text) {
+        return;
+    }
+    const unsigned char *p = (const unsigned char *)text;
+    while (*p) {
+        const unsigned char *run = p;
+        while (json_byte_is_plain(*p)) {
+            p++;
+        }
+        json_put_raw(w, (const char *)run, (size_t)(p - run));
+        if (*p == '\0') {
+            break;
+        }
+        unsigned char ch = *p++;
+        if (ch == '"' || ch == '\\') {
+            char escaped[2] = {'\\', (char)ch};
+            json_put_raw(w, escaped, sizeof(escaped));
+        } else {
+            char escaped[6] = {'\\', 'u', '0', '0', s_hex_digits[ch >> 4], s_hex_digits[ch & 0x0f]};
+            json_put_raw(w, escaped, sizeof(escaped));
+        }
+    }
+}
+
+/* Formats value right-aligned into buf (ending at buf_end) two digits per step; returns the first digit. */
+static char *json_format_u32(char *buf_end, uint32_t value)
+{
+    char *p = buf_end;
+    while (value >= 100) {
+        uint32_t pair = (value % 100) * 2;
+        value /= 100;
+        *--p = s_digit_pairs[pair + 1];
+        *--p = s_digit_pairs[pair];
+    }
+    if (value >= 10) {
+        *--p = s_digit_pairs[value * 2 + 1];
+        *--p = s_digit_pairs[value * 2];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    return p;
+}
+
+void json_put_u32(json_writer_t *w, uint32_t value)
+{
+    char buf[10];
+    char *first = json_format_u32(buf + sizeof(buf), value);
+    json_put_raw(w, first, (size_t)(buf + sizeof(buf) - first));
+}
+
+void json_put_u64(json_writer_t *w, uint64_t value)
+{
+    char buf[20];
+    char *p = buf + sizeof(buf);
+    /* 64-bit division is a libcall on 32-bit targets; drop to the 32-bit loop as soon as possible. */
+    while (value > UINT32_MAX) {
+        uint32_t pair = (uint32_t)(value % 100) * 2;
+        value /= 100;
+        *--p = s_digit_pairs[pair + 1];
+        *--p = s_digit_pairs[pair];
+    }
+    char *first = json_format_u32(p, (uint32_t)value);
+    json_put_raw(w, first, (size_t)(buf + sizeof(buf) - first));
+}
+
+void json_put_i32(json_writer_t *w, int32_t value)
+{
+    char buf[11];
+    uint32_t magnitude = (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+    char *first = json_format_u32(buf + sizeof(buf), magnitude);
+    if (value < 0) {
+        *--first = '-';
+    }
+    json_put_raw(w, first, (size_t)(buf + sizeof(buf) - first));
+}
+
+void json_put_bool(json_writer_t *w, bool value)
+{
+    if (value) {
+        json_put_lit(w, "true");
+    } else {
+        json_put_lit(w, "false");
+    }
+}
+
+static uint64_t json_fixed2_hundredths(double value)
+{
+    if (value < 0) {
+        value = -value;
+    }
+    return (uint64_t)(value * 100.0 + 0.5);
+}
+
+void json_put_fixed2(json_writer_t *w, double value)
+{
+    if (value < 0) {
+        json_put_lit(w, "-");
+    }
+    uint64_t hundredths = json_fixed2_hundredths(value);
+    json_put_u64(w, hundredths / 100);
+    uint32_t frac = (uint32_t)(hundredths % 100) * 2;
+    char digits[3] = {'.', s_digit_pairs[frac], s_digit_pairs[frac + 1]};
+    json_put_raw(w, digits, sizeof(digits));
+}
+
+size_t json_len_u32(uint32_t value)
+{
+    size_t len = 1;
+    while (value >= 100) {
+        value /= 100;
+        len += 2;
+    }
+    return len + (value >= 10 ? 1 : 0);
+}
+
+size_t json_len_u64(uint64_t value)
+{
+    size_t len = 0;
+    while (value > UINT32_MAX) {
+        value /= 100;
+        len += 2;
+    }
+    return len + json_len_u32((uint32_t)value);
+}
+
+size_t json_len_i32(int32_t value)
+{
+    if (value < 0) {
+        return 1 + json_len_u32((uint32_t)0 - (uint32_t)value);
+    }
+    return json_len_u32((uint32_t)value);
+}
+
+size_t json_len_escaped(const char *text)
+{
+    size_t len = 0;
+    if (!text) {
+        return 0;
+    }
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        if (json_byte_is_plain(*p)) {
+            len += 1;
+        } else if (*p == '"' || *p == '\\') {
+            len += 2;
+        } else {
+            len += 6;
+        }
+    }
+    return len;
+}
+
+size_t json_len_fixed2(double value)
+{
+    return (value < 0 ? 1 : 0) + json_len_u64(json_fixed2_hundredths(value) / 100) + 3;
+}
@@ -0,0 +1,49 @@
+#include "latency_histogram.h"
+
+static const uint32_t s_bucket_bounds_ms[API_LATENCY_BUCKET_COUNT - 1] = {1, 2, 5, 10, 25, 50, 100, 250, 500, 1000};
+
+void api_latency_histogram_record(api_latency_histogram_t *hist, uint32_t sample_us)
+{
+    if (!hist) {
+        return;
+    }
+    size_t bucket = 0;
+    while (bucket < API_LATENCY_BUCKET_COUNT - 1 && sample_us > s_bucket_bounds_ms[bucket] * 1000u) {
+        bucket++;
+    }
+    hist->buckets[bucket]++;
+    hist->count++;
+    if (sample_us > hist->max_us) {
+        hist->max_us = sample_us;
+    }
+}
+
+uint32_t api_latency_histogram_bucket_bound_ms(size_t bucket)
+{
+    return (bucket < API_LATENCY_BUCKET_COUNT - 1) ? s_bucket_bounds_ms[bucket] : UINT32_MAX;
+}
+
+uint32_t api_latency_histogram_percentile_ms(const api_latency_histogram_t *hist, uint32_t percentile)
+{
+    if (!hist || hist->count == 0) {
+        return 0;
+    }
+    if (percentile > 100) {
+        percentile = 100;
+    }
+    /* Rank of the sample at this percentile, rounded up so p100 is the last sample. */
+    uint64_t rank = ((uint64_t)hist->count * percentile + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    /* The observed maximum is a tighter bound than the bucket edge when every sample is small. */
+    uint32_t max_ms = (uint32_t)(((uint64_t)hist->max_us + 999u) / 1000u);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < API_LATENCY_BUCKET_COUNT - 1; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            return (s_bucket_bounds_ms[i] < max_ms) ? s_bucket_bounds_ms[i] : max_ms;
+        }
+    }
+    return max_ms;
+}
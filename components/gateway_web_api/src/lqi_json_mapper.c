@@ -1,94 +1,14 @@
 #include "lqi_json_mapper.h"
+#include "api_dto_fields.h"
 #include "api_usecases.h"
+#include "cbor_writer.h"
+#include "dto_codec.h"
+#include "json_writer.h"
 #include <stdbool.h>
-#include <inttypes.h>
-#include <stdio.h>
+#include <stdlib.h>
 
 #define LQI_UNKNOWN_VALUE (-1)
 
-static bool append_literal(char **cursor, size_t *remaining, const char *text)
-{
-    int written = snprintf(*cursor, *remaining, "%s", text);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
-    }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
-}
-
-static bool append_u32(char **cursor, size_t *remaining, uint32_t value)
-{
-    int written = snprintf(*cursor, *remaining, "%" PRIu32, value);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
-    }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
-}
-
-static bool append_u64(char **cursor, size_t *remaining, uint64_t value)
-{
-    int written = snprintf(*cursor, *remaining, "%" PRIu64, value);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
-    }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
-}
-
-static bool append_i32(char **cursor, size_t *remaining, int32_t value)
-{
-    int written = snprintf(*cursor, *remaining, "%" PRId32, value);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
-    }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
-}
-
-static bool append_json_escaped(char **cursor, size_t *remaining, const char *src)
-{
-    if (!src) {
-        return append_literal(cursor, remaining, "");
-    }
-
-    while (*src) {
-        unsigned char ch = (unsigned char)*src++;
-        if (ch == '"' || ch == '\\') {
-            if (*remaining < 3) {
-                return false;
-            }
-            *(*cursor)++ = '\\';
-            *(*cursor)++ = (char)ch;
-            *remaining -= 2;
-            continue;
-        }
-        if (ch < 0x20) {
-            if (*remaining < 7) {
-                return false;
-            }
-            int written = snprintf(*cursor, *remaining, "\\u%04x", (unsigned)ch);
-            if (written != 6) {
-                return false;
-            }
-            *cursor += written;
-            *remaining -= (size_t)written;
-            continue;
-        }
-        if (*remaining < 2) {
-            return false;
-        }
-        *(*cursor)++ = (char)ch;
-        (*remaining)--;
-    }
-    **cursor = '\0';
-    return true;
-}
-
 static bool lqi_value_invalid(int lqi)
 {
     return (lqi <= 0);
@@ -99,21 +19,35 @@ static bool rssi_value_invalid(int rssi)
     return (rssi == 127 || rssi <= -127);
 }
 
-static const char *lqi_quality_label(int lqi)
+static lqi_quality_t lqi_quality_code(int lqi)
 {
     if (lqi_value_invalid(lqi)) {
-        return "unknown";
+        return LQI_QUALITY_UNKNOWN;
     }
     if (lqi >= 180) {
-        return "good";
+        return LQI_QUALITY_GOOD;
     }
     if (lqi >= 120) {
-        return "warn";
+        return LQI_QUALITY_WARN;
     }
-    return "bad";
+    return LQI_QUALITY_BAD;
 }
 
-static const char *lqi_source_label(zigbee_lqi_source_t source)
+const char *api_lqi_quality_label(lqi_quality_t quality)
+{
+    static const char *const labels[] = {
+        [LQI_QUALITY_UNKNOWN] = "unknown",
+        [LQI_QUALITY_GOOD] = "good",
+        [LQI_QUALITY_WARN] = "warn",
+        [LQI_QUALITY_BAD] = "bad",
+    };
+    if ((unsigned)quality >= sizeof(labels) / sizeof(labels[0])) {
+        return labels[LQI_QUALITY_UNKNOWN];
+    }
+    return labels[quality];
+}
+
+const char *api_lqi_source_label(zigbee_lqi_source_t source)
 {
     switch (source) {
     case ZIGBEE_LQI_SOURCE_MGMT_LQI:
@@ -126,131 +60,272 @@ static const char *lqi_source_label(zigbee_lqi_source_t source)
     }
 }
 
-esp_err_t build_lqi_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+/* Several KB at the Kconfig device maximum, so it is allocated rather than put on the httpd stack. */
+typedef struct {
+    zb_device_t devices[MAX_DEVICES];
+    zigbee_neighbor_lqi_t neighbors[MAX_DEVICES];
+    gateway_cmd_stats_t cmd_stats[MAX_DEVICES];
+    int dev_count;
+    int nbr_count;
+    int cmd_stats_count;
+    zigbee_lqi_source_t source;
+    uint64_t updated_ms;
+} lqi_snapshot_t;
+
+DTO_DEFINE(dto_lqi_row, api_lqi_row_t, API_DTO_LQI_ROW_FIELDS)
+DTO_DEFINE(dto_device_diagnostics, gateway_cmd_stats_t, API_DTO_DEVICE_DIAGNOSTICS_FIELDS)
+
+static const uint32_t s_rtt_bucket_bounds_ms[GATEWAY_CMD_RTT_BUCKET_COUNT - 1] = GATEWAY_CMD_RTT_BUCKET_BOUNDS_MS;
+
+static const gateway_cmd_stats_t *find_cmd_stats(const gateway_cmd_stats_t *stats, int count, uint16_t short_addr)
 {
-    if (!usecases || !out || out_size < 2) {
-        return ESP_ERR_INVALID_ARG;
+    for (int i = 0; i < count; i++) {
+        if (stats[i].short_addr == short_addr) {
+            return &stats[i];
+        }
     }
+    return NULL;
+}
 
-    zb_device_t devices[MAX_DEVICES] = {0};
-    zigbee_neighbor_lqi_t neighbors[MAX_DEVICES] = {0};
-    const int nbr_capacity = (int)(sizeof(neighbors) / sizeof(neighbors[0]));
-    int dev_count = api_usecase_get_devices_snapshot(usecases, devices, MAX_DEVICES);
-    int nbr_count = 0;
-    zigbee_lqi_source_t source = ZIGBEE_LQI_SOURCE_UNKNOWN;
-    uint64_t updated_ms = 0;
+static bool cmd_stats_has_rtt(const gateway_cmd_stats_t *stats)
+{
+    return stats->acked + stats->failed > 0;
+}
+
+static esp_err_t lqi_snapshot_collect(api_usecases_handle_t usecases, lqi_snapshot_t *snap)
+{
+    const int nbr_capacity = (int)(sizeof(snap->neighbors) / sizeof(snap->neighbors[0]));
+    snap->dev_count = api_usecase_get_devices_snapshot(usecases, snap->devices, MAX_DEVICES);
+    if (snap->dev_count < 0) {
+        snap->dev_count = 0;
+    }
+    snap->nbr_count = 0;
+    snap->cmd_stats_count = api_usecase_get_cmd_stats_snapshot(usecases, snap->cmd_stats, MAX_DEVICES);
+    if (snap->cmd_stats_count < 0) {
+        snap->cmd_stats_count = 0;
+    }
+    snap->source = ZIGBEE_LQI_SOURCE_UNKNOWN;
+    snap->updated_ms = 0;
 
     esp_err_t cached_ret = api_usecase_get_cached_lqi_snapshot(
         usecases,
-        neighbors, MAX_DEVICES, &nbr_count, &source, &updated_ms);
+        snap->neighbors, MAX_DEVICES, &snap->nbr_count, &snap->source, &snap->updated_ms);
     if (cached_ret != ESP_OK) {
         return cached_ret;
     }
-    if (nbr_count < 0) {
-        nbr_count = 0;
+    if (snap->nbr_count < 0) {
+        snap->nbr_count = 0;
     }
-    if (nbr_count > nbr_capacity) {
-        nbr_count = nbr_capacity;
+    if (snap->nbr_count > nbr_capacity) {
+        snap->nbr_count = nbr_capacity;
     }
 
-    if (updated_ms == 0) {
-        nbr_count = api_usecase_get_neighbor_lqi_snapshot(usecases, neighbors, MAX_DEVICES);
-        if (nbr_count < 0) {
-            nbr_count = 0;
+    if (snap->updated_ms == 0) {
+        snap->nbr_count = api_usecase_get_neighbor_lqi_snapshot(usecases, snap->neighbors, MAX_DEVICES);
+        if (snap->nbr_count < 0) {
+            snap->nbr_count = 0;
         }
-        if (nbr_count > nbr_capacity) {
-            nbr_count = nbr_capacity;
+        if (snap->nbr_count > nbr_capacity) {
+            snap->nbr_count = nbr_capacity;
         }
-        source = ZIGBEE_LQI_SOURCE_NEIGHBOR_TABLE;
-        if (nbr_count > 0) {
-            updated_ms = neighbors[0].updated_ms;
-            for (int i = 1; i < nbr_count && i < nbr_capacity; i++) {
-                if (neighbors[i].updated_ms > updated_ms) {
-                    updated_ms = neighbors[i].updated_ms;
+        snap->source = ZIGBEE_LQI_SOURCE_NEIGHBOR_TABLE;
+        if (snap->nbr_count > 0) {
+            snap->updated_ms = snap->neighbors[0].updated_ms;
+            for (int i = 1; i < snap->nbr_count; i++) {
+                if (snap->neighbors[i].updated_ms > snap->updated_ms) {
+                    snap->updated_ms = snap->neighbors[i].updated_ms;
                 }
             }
         }
     }
+    return ESP_OK;
+}
 
-    char *cursor = out;
-    size_t remaining = out_size;
-    if (!append_literal(&cursor, &remaining, "{\"neighbors\":[")) {
+static esp_err_t lqi_snapshot_create(api_usecases_handle_t usecases, lqi_snapshot_t **out)
+{
+    lqi_snapshot_t *snap = (lqi_snapshot_t *)calloc(1, sizeof(*snap));
+    if (!snap) {
         return ESP_ERR_NO_MEM;
     }
+    esp_err_t ret = lqi_snapshot_collect(usecases, snap);
+    if (ret != ESP_OK) {
+        free(snap);
+        return ret;
+    }
+    *out = snap;
+    return ESP_OK;
+}
 
-    for (int i = 0; i < dev_count; i++) {
-        int lqi = LQI_UNKNOWN_VALUE;
-        int rssi = 127;
-        bool direct = false;
-        zigbee_lqi_source_t row_source = ZIGBEE_LQI_SOURCE_UNKNOWN;
-        uint64_t row_updated_ms = 0;
-        for (int j = 0; j < nbr_count; j++) {
-            if (neighbors[j].short_addr == devices[i].short_addr) {
-                lqi = neighbors[j].lqi;
-                rssi = neighbors[j].rssi;
-                direct = true;
-                row_source = neighbors[j].source;
-                row_updated_ms = neighbors[j].updated_ms;
-                break;
-            }
+static void lqi_snapshot_row(const lqi_snapshot_t *snap, int dev_index, api_lqi_row_t *row)
+{
+    const zb_device_t *dev = &snap->devices[dev_index];
+    row->short_addr = dev->short_addr;
+    row->name = dev->name;
+    row->lqi = LQI_UNKNOWN_VALUE;
+    row->rssi = 127;
+    row->direct = false;
+    row->source = ZIGBEE_LQI_SOURCE_UNKNOWN;
+    row->updated_ms = 0;
+    for (int j = 0; j < snap->nbr_count; j++) {
+        if (snap->neighbors[j].short_addr == dev->short_addr) {
+            row->lqi = snap->neighbors[j].lqi;
+            row->rssi = snap->neighbors[j].rssi;
+            row->direct = true;
+            row->source = snap->neighbors[j].source;
+            row->updated_ms = snap->neighbors[j].updated_ms;
+            break;
         }
+    }
+    const gateway_cmd_stats_t *cmd = find_cmd_stats(snap->cmd_stats, snap->cmd_stats_count, dev->short_addr);
+    row->cmd = cmd ? *cmd : (gateway_cmd_stats_t){.short_addr = dev->short_addr};
+    row->has_rtt = cmd_stats_has_rtt(&row->cmd);
+    row->has_lqi = !lqi_value_invalid(row->lqi);
+    row->has_rssi = !rssi_value_invalid(row->rssi);
+    row->quality = lqi_quality_code(row->lqi);
+}
 
-        if (i > 0 && !append_literal(&cursor, &remaining, ",")) {
-            return ESP_ERR_NO_MEM;
-        }
-        if (!append_literal(&cursor, &remaining, "{\"short_addr\":") ||
-            !append_u32(&cursor, &remaining, devices[i].short_addr) ||
-            !append_literal(&cursor, &remaining, ",\"name\":\"") ||
-            !append_json_escaped(&cursor, &remaining, devices[i].name) ||
-            !append_literal(&cursor, &remaining, "\",\"lqi\":"))
-        {
-            return ESP_ERR_NO_MEM;
-        }
+esp_err_t write_lqi_json(api_usecases_handle_t usecases, json_writer_t *w)
+{
+    if (!usecases || !w) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-        if (lqi_value_invalid(lqi)) {
-            if (!append_literal(&cursor, &remaining, "null")) {
-                return ESP_ERR_NO_MEM;
-            }
-        } else if (!append_i32(&cursor, &remaining, lqi)) {
-            return ESP_ERR_NO_MEM;
-        }
+    lqi_snapshot_t *snap = NULL;
+    esp_err_t snap_ret = lqi_snapshot_create(usecases, &snap);
+    if (snap_ret != ESP_OK) {
+        return snap_ret;
+    }
 
-        if (!append_literal(&cursor, &remaining, ",\"rssi\":")) {
-            return ESP_ERR_NO_MEM;
-        }
-        if (rssi_value_invalid(rssi)) {
-            if (!append_literal(&cursor, &remaining, "null")) {
-                return ESP_ERR_NO_MEM;
-            }
-        } else if (!append_i32(&cursor, &remaining, rssi)) {
-            return ESP_ERR_NO_MEM;
+    json_put_lit(w, "{\"neighbors\":[");
+    for (int i = 0; i < snap->dev_count; i++) {
+        api_lqi_row_t row;
+        lqi_snapshot_row(snap, i, &row);
+        if (i > 0) {
+            json_put_lit(w, ",");
         }
+        dto_lqi_row_put_json(w, &row);
+    }
+    json_put_lit(w, "],\"updated_ms\":");
+    json_put_u64(w, snap->updated_ms);
+    json_put_lit(w, ",\"source\":\"");
+    json_put_str(w, api_lqi_source_label(snap->source));
+    json_put_lit(w, "\"}");
+    free(snap);
+    return ESP_OK;
+}
 
-        if (!append_literal(&cursor, &remaining, ",\"quality\":\"") ||
-            !append_literal(&cursor, &remaining, lqi_quality_label(lqi)) ||
-            !append_literal(&cursor, &remaining, "\",\"direct\":") ||
-            !append_literal(&cursor, &remaining, direct ? "true" : "false") ||
-            !append_literal(&cursor, &remaining, ",\"source\":\"") ||
-            !append_literal(&cursor, &remaining, lqi_source_label(row_source)) ||
-            !append_literal(&cursor, &remaining, "\",\"updated_ms\":") ||
-            !append_u64(&cursor, &remaining, row_updated_ms) ||
-            !append_literal(&cursor, &remaining, "}"))
-        {
-            return ESP_ERR_NO_MEM;
-        }
+esp_err_t build_lqi_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+{
+    if (!usecases || !out || out_size < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    json_writer_t w;
+    json_writer_init(&w, out, out_size);
+    esp_err_t ret = write_lqi_json(usecases, &w);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return json_writer_finish(&w, out_len) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t build_lqi_cbor_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+{
+    if (!usecases || !out || out_size < 2) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    if (!append_literal(&cursor, &remaining, "],\"updated_ms\":") ||
-        !append_u64(&cursor, &remaining, updated_ms) ||
-        !append_literal(&cursor, &remaining, ",\"source\":\"") ||
-        !append_literal(&cursor, &remaining, lqi_source_label(source)) ||
-        !append_literal(&cursor, &remaining, "\"}"))
-    {
+    lqi_snapshot_t *snap = NULL;
+    esp_err_t snap_ret = lqi_snapshot_create(usecases, &snap);
+    if (snap_ret != ESP_OK) {
+        return snap_ret;
+    }
+
+    /* Schema API_CBOR_SCHEMA_LQI: [updated_ms, source, [[short_addr, name, lqi, rssi, quality, direct, source,
+     * updated_ms], ...]]; quality/source are lqi_quality_t/zigbee_lqi_source_t codes, unknown lqi/rssi are null. */
+    uint8_t *cursor = (uint8_t *)out;
+    size_t remaining = out_size;
+    bool ok = cbor_put_array(&cursor, &remaining, 3) && cbor_put_uint(&cursor, &remaining, snap->updated_ms) &&
+              cbor_put_uint(&cursor, &remaining, (uint64_t)snap->source) &&
+              cbor_put_array(&cursor, &remaining, (size_t)snap->dev_count);
+    for (int i = 0; ok && i < snap->dev_count; i++) {
+        api_lqi_row_t row;
+        lqi_snapshot_row(snap, i, &row);
+        ok = dto_lqi_row_put_cbor(&cursor, &remaining, &row);
+    }
+    free(snap);
+    if (!ok) {
         return ESP_ERR_NO_MEM;
     }
 
     if (out_len) {
-        *out_len = (size_t)(cursor - out);
+        *out_len = (size_t)(cursor - (uint8_t *)out);
+    }
+    return ESP_OK;
+}
+
+esp_err_t write_device_diagnostics_json(api_usecases_handle_t usecases, uint16_t short_addr, json_writer_t *w)
+{
+    if (!usecases || !w) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Only the devices and command stats of the LQI snapshot are filled here. */
+    lqi_snapshot_t *snap = (lqi_snapshot_t *)calloc(1, sizeof(*snap));
+    if (!snap) {
+        return ESP_ERR_NO_MEM;
+    }
+    int dev_count = api_usecase_get_devices_snapshot(usecases, snap->devices, MAX_DEVICES);
+    const zb_device_t *dev = NULL;
+    for (int i = 0; i < dev_count; i++) {
+        if (snap->devices[i].short_addr == short_addr) {
+            dev = &snap->devices[i];
+            break;
+        }
+    }
+    if (!dev) {
+        free(snap);
+        return ESP_ERR_NOT_FOUND;
+    }
+    int stats_count = api_usecase_get_cmd_stats_snapshot(usecases, snap->cmd_stats, MAX_DEVICES);
+    const gateway_cmd_stats_t *found = find_cmd_stats(snap->cmd_stats, stats_count, short_addr);
+    gateway_cmd_stats_t cmd = found ? *found : (gateway_cmd_stats_t){.short_addr = short_addr};
+
+    json_put_lit(w, "{");
+    dto_device_diagnostics_put_json_members(w, &cmd, true);
+    json_put_lit(w, ",\"name\":\"");
+    json_put_escaped(w, dev->name);
+    json_put_lit(w, "\",\"success_pct\":");
+    free(snap);
+    uint32_t finished = cmd.acked + cmd.failed + cmd.timeout;
+    if (finished > 0) {
+        json_put_u32(w, (uint32_t)(((uint64_t)cmd.acked * 100u) / finished));
+    } else {
+        json_put_lit(w, "null");
+    }
+    json_put_lit(w, ",\"rtt\":{\"p50_ms\":");
+    if (cmd_stats_has_rtt(&cmd)) {
+        json_put_u32(w, cmd.rtt_p50_ms);
+        json_put_lit(w, ",\"p95_ms\":");
+        json_put_u32(w, cmd.rtt_p95_ms);
+    } else {
+        json_put_lit(w, "null,\"p95_ms\":null");
+    }
+    json_put_lit(w, ",\"buckets\":[");
+    for (size_t i = 0; i < GATEWAY_CMD_RTT_BUCKET_COUNT; i++) {
+        if (i > 0) {
+            json_put_lit(w, ",");
+        }
+        json_put_lit(w, "{\"le_ms\":");
+        if (i < GATEWAY_CMD_RTT_BUCKET_COUNT - 1) {
+            json_put_u32(w, s_rtt_bucket_bounds_ms[i]);
+        } else {
+            json_put_lit(w, "null");
+        }
+        json_put_lit(w, ",\"count\":");
+        json_put_u32(w, cmd.rtt_buckets[i]);
+        json_put_lit(w, "}");
     }
+    json_put_lit(w, "]}}");
     return ESP_OK;
 }
@@ -1,140 +1,196 @@
 #include "status_json_builder.h"
 
+#include "api_dto_fields.h"
 #include "api_usecases.h"
+#include "cbor_writer.h"
+#include "dto_codec.h"
 #include "http_error.h"
+#include "json_writer.h"
 #include "lqi_json_mapper.h"
 
-#include <inttypes.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
 
-static bool append_literal(char **cursor, size_t *remaining, const char *text)
+DTO_DEFINE(dto_network_status, zigbee_network_status_t, API_DTO_NETWORK_STATUS_FIELDS)
+DTO_DEFINE(dto_device, api_device_row_t, API_DTO_DEVICE_FIELDS)
+DTO_DEFINE(dto_device_cbor, api_device_row_t, API_DTO_DEVICE_CBOR_FIELDS)
+
+/* On/Off values kept for the join; a device with several switched endpoints reports the lowest one. */
+#define STATUS_ON_OFF_MAX (MAX_DEVICES * 2)
+
+/* ~160 B per device (10 KB at 64 devices), so it lives on the heap, not on the httpd stack. */
+typedef struct {
+    zigbee_network_status_t status;
+    zb_device_t devices[MAX_DEVICES];
+    api_device_row_t rows[MAX_DEVICES];
+    gateway_device_profile_t profiles[MAX_DEVICES];
+    gateway_attr_entry_t on_off[STATUS_ON_OFF_MAX];
+    int count;
+} status_snapshot_t;
+
+static const gateway_device_profile_t *find_profile(const status_snapshot_t *snap, int profile_count, uint16_t short_addr)
 {
-    int written = snprintf(*cursor, *remaining, "%s", text);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
+    for (int i = 0; i < profile_count; i++) {
+        if (snap->profiles[i].short_addr == short_addr) {
+            return &snap->profiles[i];
+        }
     }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
+    return NULL;
 }
 
-static bool append_u32(char **cursor, size_t *remaining, uint32_t value)
+static void status_snapshot_fill_rows(api_usecases_handle_t usecases, status_snapshot_t *snap)
 {
-    int written = snprintf(*cursor, *remaining, "%" PRIu32, value);
-    if (written < 0 || (size_t)written >= *remaining) {
-        return false;
+    const gateway_attr_entry_t *on_off = snap->on_off;
+    int on_off_count = api_usecase_get_attr_snapshot(usecases, GATEWAY_ZCL_CLUSTER_ON_OFF, GATEWAY_ZCL_ATTR_ON_OFF,
+                                                     snap->on_off, STATUS_ON_OFF_MAX);
+    int profile_count = api_usecase_get_device_profiles(usecases, snap->profiles, MAX_DEVICES);
+    for (int i = 0; i < snap->count; i++) {
+        api_device_row_t *row = &snap->rows[i];
+        *row = (api_device_row_t){
+            .short_addr = snap->devices[i].short_addr,
+            .name = snap->devices[i].name,
+        };
+        const gateway_attr_entry_t *best = NULL;
+        for (int j = 0; j < on_off_count; j++) {
+            if (on_off[j].short_addr == row->short_addr && (!best || on_off[j].endpoint < best->endpoint)) {
+                best = &on_off[j];
+            }
+        }
+        if (best) {
+            row->has_on_off = true;
+            row->on_off = best->value ? 1 : 0;
+            row->on_off_ms = best->updated_ms;
+        }
+        /* The rows point into the snapshot's profiles, which outlive the serialization. */
+        const gateway_device_profile_t *profile = find_profile(snap, profile_count, row->short_addr);
+        if (profile) {
+            row->has_ep = profile->on_off_endpoint != 0;
+            row->ep = profile->on_off_endpoint;
+            row->has_manufacturer = profile->manufacturer[0] != '\0';
+            row->manufacturer = profile->manufacturer;
+            row->has_model = profile->model[0] != '\0';
+            row->model = profile->model;
+        }
     }
-    *cursor += written;
-    *remaining -= (size_t)written;
-    return true;
 }
 
-static bool append_json_escaped(char **cursor, size_t *remaining, const char *src)
+static esp_err_t status_snapshot_collect(api_usecases_handle_t usecases, status_snapshot_t *snap, bool with_status)
 {
-    if (!src) {
-        return append_literal(cursor, remaining, "");
+    if (with_status && api_usecase_get_network_status(usecases, &snap->status) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    snap->count = api_usecase_get_devices_snapshot(usecases, snap->devices, MAX_DEVICES);
+    if (snap->count < 0) {
+        snap->count = 0;
     }
+    status_snapshot_fill_rows(usecases, snap);
+    return ESP_OK;
+}
 
-    while (*src) {
-        unsigned char ch = (unsigned char)*src++;
-        if (ch == '"' || ch == '\\') {
-            if (*remaining < 3) {
-                return false;
-            }
-            *(*cursor)++ = '\\';
-            *(*cursor)++ = (char)ch;
-            *remaining -= 2;
-            continue;
-        }
-        if (ch < 0x20) {
-            if (*remaining < 7) {
-                return false;
-            }
-            int written = snprintf(*cursor, *remaining, "\\u%04x", (unsigned)ch);
-            if (written != 6) {
-                return false;
-            }
-            *cursor += written;
-            *remaining -= (size_t)written;
-            continue;
-        }
-        if (*remaining < 2) {
-            return false;
-        }
-        *(*cursor)++ = (char)ch;
-        (*remaining)--;
+static esp_err_t status_snapshot_create(api_usecases_handle_t usecases, bool with_status, status_snapshot_t **out)
+{
+    status_snapshot_t *snap = (status_snapshot_t *)calloc(1, sizeof(*snap));
+    if (!snap) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = status_snapshot_collect(usecases, snap, with_status);
+    if (ret != ESP_OK) {
+        free(snap);
+        return ret;
     }
-    **cursor = '\0';
-    return true;
+    *out = snap;
+    return ESP_OK;
 }
 
-static esp_err_t append_devices_array(api_usecases_handle_t usecases, char **cursor, size_t *remaining)
+static void put_devices_array(json_writer_t *w, const status_snapshot_t *snap)
 {
-    zb_device_t snapshot[MAX_DEVICES];
-    int count = api_usecase_get_devices_snapshot(usecases, snapshot, MAX_DEVICES);
-    for (int i = 0; i < count; i++) {
-        if (i > 0 && !append_literal(cursor, remaining, ",")) {
-            return ESP_ERR_NO_MEM;
-        }
-        if (!append_literal(cursor, remaining, "{\"name\":\"") ||
-            !append_json_escaped(cursor, remaining, snapshot[i].name) ||
-            !append_literal(cursor, remaining, "\",\"short_addr\":") ||
-            !append_u32(cursor, remaining, snapshot[i].short_addr) ||
-            !append_literal(cursor, remaining, "}"))
-        {
-            return ESP_ERR_NO_MEM;
+    json_put_lit(w, "[");
+    for (int i = 0; i < snap->count; i++) {
+        if (i > 0) {
+            json_put_lit(w, ",");
         }
+        dto_device_put_json(w, &snap->rows[i]);
     }
-    return ESP_OK;
+    json_put_lit(w, "]");
 }
 
-esp_err_t build_status_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+static size_t devices_array_json_len(const status_snapshot_t *snap)
 {
-    if (!usecases || !out || out_size < 2) {
-        return ESP_ERR_INVALID_ARG;
+    size_t len = 2 + (snap->count > 1 ? (size_t)(snap->count - 1) : 0);
+    for (int i = 0; i < snap->count; i++) {
+        len += dto_device_json_len(&snap->rows[i]);
     }
+    return len;
+}
 
-    char *cursor = out;
-    size_t remaining = out_size;
+/* Top-level network fields are kept for older clients next to the "zigbee" object. */
+static void put_status_document(json_writer_t *w, const status_snapshot_t *snap)
+{
+    json_put_lit(w, "{");
+    dto_network_status_put_json_members(w, &snap->status, true);
+    json_put_lit(w, ",\"zigbee\":");
+    dto_network_status_put_json(w, &snap->status);
+    json_put_lit(w, ",\"devices\":");
+    put_devices_array(w, snap);
+    json_put_lit(w, "}");
+}
 
-    zigbee_network_status_t status = {0};
-    if (api_usecase_get_network_status(usecases, &status) != ESP_OK) {
-        return ESP_FAIL;
+static size_t status_document_json_len(const status_snapshot_t *snap)
+{
+    /* The top-level members are the network object without its braces. */
+    size_t network_len = dto_network_status_json_len(&snap->status);
+    return network_len + (sizeof(",\"zigbee\":") - 1) + network_len + (sizeof(",\"devices\":") - 1) +
+           devices_array_json_len(snap);
+}
+
+esp_err_t write_status_json(api_usecases_handle_t usecases, json_writer_t *w)
+{
+    if (!usecases || !w) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    if (!append_literal(&cursor, &remaining, "{\"pan_id\":") ||
-        !append_u32(&cursor, &remaining, status.pan_id) ||
-        !append_literal(&cursor, &remaining, ",\"channel\":") ||
-        !append_u32(&cursor, &remaining, status.channel) ||
-        !append_literal(&cursor, &remaining, ",\"short_addr\":") ||
-        !append_u32(&cursor, &remaining, status.short_addr) ||
-        !append_literal(&cursor, &remaining, ",\"zigbee\":{") ||
-        !append_literal(&cursor, &remaining, "\"pan_id\":") ||
-        !append_u32(&cursor, &remaining, status.pan_id) ||
-        !append_literal(&cursor, &remaining, ",\"channel\":") ||
-        !append_u32(&cursor, &remaining, status.channel) ||
-        !append_literal(&cursor, &remaining, ",\"short_addr\":") ||
-        !append_u32(&cursor, &remaining, status.short_addr) ||
-        !append_literal(&cursor, &remaining, "}") ||
-        !append_literal(&cursor, &remaining, ",\"devices\":["))
-    {
-        return ESP_ERR_NO_MEM;
+    /* The snapshot is taken up front; a failure leaves the writer untouched. */
+    status_snapshot_t *snap = NULL;
+    esp_err_t ret = status_snapshot_create(usecases, true, &snap);
+    if (ret != ESP_OK) {
+        return ret;
     }
+    put_status_document(w, snap);
+    free(snap);
+    return ESP_OK;
+}
 
-    esp_err_t dev_ret = append_devices_array(usecases, &cursor, &remaining);
-    if (dev_ret != ESP_OK) {
-        return dev_ret;
+esp_err_t build_status_json_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+{
+    if (!usecases || !out || out_size < 2) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    if (!append_literal(&cursor, &remaining, "]}")) {
-        return ESP_ERR_NO_MEM;
+    json_writer_t w;
+    json_writer_init(&w, out, out_size);
+    esp_err_t ret = write_status_json(usecases, &w);
+    if (ret != ESP_OK) {
+        return ret;
     }
+    return json_writer_finish(&w, out_len) ? ESP_OK : ESP_ERR_NO_MEM;
+}
 
-    if (out_len) {
-        *out_len = (size_t)(cursor - out);
+esp_err_t write_devices_json(api_usecases_handle_t usecases, json_writer_t *w)
+{
+    if (!usecases || !w) {
+        return ESP_ERR_INVALID_ARG;
     }
+
+    status_snapshot_t *snap = NULL;
+    esp_err_t ret = status_snapshot_create(usecases, false, &snap);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    json_put_lit(w, "{\"devices\":");
+    put_devices_array(w, snap);
+    json_put_lit(w, "}");
+    free(snap);
     return ESP_OK;
 }
 
@@ -144,24 +200,41 @@ esp_err_t build_devices_json_compact(api_usecases_handle_t usecases, char *out,
         return ESP_ERR_INVALID_ARG;
     }
 
-    char *cursor = out;
-    size_t remaining = out_size;
+    json_writer_t w;
+    json_writer_init(&w, out, out_size);
+    esp_err_t ret = write_devices_json(usecases, &w);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return json_writer_finish(&w, out_len) ? ESP_OK : ESP_ERR_NO_MEM;
+}
 
-    if (!append_literal(&cursor, &remaining, "{\"devices\":[")) {
-        return ESP_ERR_NO_MEM;
+esp_err_t build_devices_cbor_compact(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+{
+    if (!usecases || !out || out_size < 2) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    esp_err_t dev_ret = append_devices_array(usecases, &cursor, &remaining);
-    if (dev_ret != ESP_OK) {
-        return dev_ret;
+    status_snapshot_t *snap = NULL;
+    esp_err_t ret = status_snapshot_create(usecases, false, &snap);
+    if (ret != ESP_OK) {
+        return ret;
     }
 
-    if (!append_literal(&cursor, &remaining, "]}")) {
+    /* Schema API_CBOR_SCHEMA_DEVICES: [[short_addr, name, on_off, on_off_ms, ep, manufacturer, model], ...] */
+    uint8_t *cursor = (uint8_t *)out;
+    size_t remaining = out_size;
+    bool ok = cbor_put_array(&cursor, &remaining, (size_t)snap->count);
+    for (int i = 0; ok && i < snap->count; i++) {
+        ok = dto_device_cbor_put_cbor(&cursor, &remaining, &snap->rows[i]);
+    }
+    free(snap);
+    if (!ok) {
         return ESP_ERR_NO_MEM;
     }
 
     if (out_len) {
-        *out_len = (size_t)(cursor - out);
+        *out_len = (size_t)(cursor - (uint8_t *)out);
     }
     return ESP_OK;
 }
@@ -171,23 +244,22 @@ char *create_status_json(api_usecases_handle_t usecases)
     if (!usecases) {
         return NULL;
     }
-    size_t cap = 1024;
-    for (int i = 0; i < 4; i++) {
-        char *buf = (char *)malloc(cap);
-        if (!buf) {
-            return NULL;
-        }
-        size_t out_len = 0;
-        esp_err_t ret = build_status_json_compact(usecases, buf, cap, &out_len);
-        if (ret == ESP_OK) {
-            (void)out_len;
-            return buf;
-        }
-        free(buf);
-        if (ret != ESP_ERR_NO_MEM) {
-            return NULL;
+    status_snapshot_t *snap = NULL;
+    if (status_snapshot_create(usecases, true, &snap) != ESP_OK) {
+        return NULL;
+    }
+    /* One snapshot sizes and fills the buffer, so the length is exact. */
+    size_t cap = status_document_json_len(snap) + 1;
+    char *buf = (char *)malloc(cap);
+    if (buf) {
+        json_writer_t w;
+        json_writer_init(&w, buf, cap);
+        put_status_document(&w, snap);
+        if (!json_writer_finish(&w, NULL)) {
+            free(buf);
+            buf = NULL;
         }
-        cap *= 2;
     }
-    return NULL;
+    free(snap);
+    return buf;
 }
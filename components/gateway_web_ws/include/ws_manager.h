@@ -15,6 +15,7 @@ typedef struct {
     esp_err_t (*resp_set_status)(httpd_req_t *req, const char *status);
     esp_err_t (*resp_send)(httpd_req_t *req, const char *buf, ssize_t buf_len);
     int (*close_socket)(int fd);
+    esp_err_t (*req_get_url_query)(httpd_req_t *req, char *buf, size_t buf_len);
 } ws_manager_transport_ops_t;
 
 void ws_manager_set_transport_ops_for_test_with_handle(ws_manager_handle_t handle, const ws_manager_transport_ops_t *ops);
@@ -28,5 +29,6 @@ httpd_handle_t ws_manager_get_server_with_handle(ws_manager_handle_t handle);
 void ws_manager_set_server_with_handle(ws_manager_handle_t handle, httpd_handle_t server);
 esp_err_t ws_handler_with_handle(ws_manager_handle_t handle, httpd_req_t *req);
 void ws_broadcast_status_with_handle(ws_manager_handle_t handle);
+void ws_manager_ping_clients_with_handle(ws_manager_handle_t handle);
 void ws_httpd_close_fn_with_handle(ws_manager_handle_t handle, httpd_handle_t hd, int sockfd);
 int ws_manager_get_client_count_with_handle(ws_manager_handle_t handle);
@@ -3,7 +3,13 @@
 #include "api_usecases.h"
 #include "error_ring.h"
 #include "gateway_events.h"
+#include "ws_manager_broadcaster.h"
 #include "ws_manager_internal.h"
+#include "ws_manager_keepalive.h"
+#include "ws_manager_latency.h"
+#include "ws_manager_queue.h"
+#include "ws_manager_replay.h"
+#include "ws_manager_rx.h"
 #include "ws_manager_state.h"
 #include "ws_manager_transport.h"
 
@@ -11,12 +17,16 @@
 #include "esp_log.h"
 #include "esp_timer.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "WS_MANAGER";
 
-void ws_broadcast_status_with_handle(ws_manager_handle_t handle);
+/* Close status 1000 (normal closure), echoed back to a client-initiated close. */
+static const uint8_t s_ws_close_normal[2] = {0x03, 0xe8};
+static const uint8_t s_ws_close_unsupported[2] = {0x03, 0xeb}; /* 1003 */
+static const uint8_t s_ws_close_too_big[2] = {0x03, 0xf1};     /* 1009 */
 
 #if CONFIG_GATEWAY_SELF_TEST_APP
 static void ws_manager_reset_transport_to_defaults(ws_manager_handle_t handle)
@@ -37,34 +47,87 @@ static uint32_t ws_manager_client_count_provider_adapter(api_ws_provider_ctx_t *
 
 static void ws_debounce_timer_cb(void *arg)
 {
-    ws_manager_handle_t handle = (ws_manager_handle_t)arg;
-    ws_broadcast_status_with_handle(handle);
+    ws_manager_request_broadcast((ws_manager_handle_t)arg, WS_NOTIFY_DEVICES);
 }
 
 static void ws_periodic_timer_cb(void *arg)
 {
-    ws_manager_handle_t handle = (ws_manager_handle_t)arg;
-    ws_broadcast_status_with_handle(handle);
+    ws_manager_request_broadcast((ws_manager_handle_t)arg, WS_NOTIFY_ALL);
+}
+
+static void ws_ping_timer_cb(void *arg)
+{
+    ws_manager_request_broadcast((ws_manager_handle_t)arg, WS_NOTIFY_PING);
+}
+
+/* Posters stamp *_CHANGED events with their origin; fall back to delivery time without one. */
+static int64_t ws_event_origin_us(const void *event_data)
+{
+    return event_data ? ((const gateway_event_origin_t *)event_data)->origin_us : esp_timer_get_time();
 }
 
 static void device_list_changed_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
 {
     ws_manager_handle_t handle = (ws_manager_handle_t)arg;
-    (void)event_data;
-    if (event_base == GATEWAY_EVENT && event_id == GATEWAY_EVENT_DEVICE_LIST_CHANGED) {
-        ws_broadcast_status_with_handle(handle);
+    if (event_base == GATEWAY_EVENT &&
+        (event_id == GATEWAY_EVENT_DEVICE_LIST_CHANGED || event_id == GATEWAY_EVENT_DEVICE_STATE_CHANGED)) {
+        ws_manager_latency_note_origin(handle, WS_EVENT_DEVICES_DELTA, ws_event_origin_us(event_data));
+        ws_manager_request_broadcast(handle, WS_NOTIFY_DEVICES);
+    }
+}
+
+static void device_announce_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    ws_manager_handle_t handle = (ws_manager_handle_t)arg;
+    if (event_base == GATEWAY_EVENT && event_id == GATEWAY_EVENT_DEVICE_ANNOUNCE && event_data) {
+        /* The list change (and broadcast request) follows once the device is stored. */
+        ws_manager_latency_note_origin(handle, WS_EVENT_DEVICES_DELTA,
+                                       ((const gateway_device_announce_event_t *)event_data)->origin_us);
     }
 }
 
 static void lqi_state_changed_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
 {
     ws_manager_handle_t handle = (ws_manager_handle_t)arg;
-    (void)event_data;
     if (event_base == GATEWAY_EVENT && event_id == GATEWAY_EVENT_LQI_STATE_CHANGED) {
-        ws_broadcast_status_with_handle(handle);
+        ws_manager_latency_note_origin(handle, WS_EVENT_LQI_UPDATE, ws_event_origin_us(event_data));
+        ws_manager_request_broadcast(handle, WS_NOTIFY_LQI);
     }
 }
 
+static void job_state_changed_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    ws_manager_handle_t handle = (ws_manager_handle_t)arg;
+    if (event_base == GATEWAY_EVENT && event_id == GATEWAY_EVENT_JOB_STATE_CHANGED) {
+        ws_manager_latency_note_origin(handle, WS_EVENT_HEALTH_STATE, ws_event_origin_us(event_data));
+        ws_manager_request_broadcast(handle, WS_NOTIFY_JOBS);
+    }
+}
+
+static bool ws_query_since(const char *query, uint32_t *out_since)
+{
+    char value[12];
+    if (httpd_query_key_value(query, "since", value, sizeof(value)) != ESP_OK) {
+        return false;
+    }
+    char *end = NULL;
+    unsigned long since = strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || since > UINT32_MAX) {
+        return false;
+    }
+    *out_since = (uint32_t)since;
+    return true;
+}
+
+static ws_encoding_t ws_query_encoding(const char *query)
+{
+    char value[8];
+    if (httpd_query_key_value(query, "enc", value, sizeof(value)) == ESP_OK && strcmp(value, "cbor") == 0) {
+        return WS_ENCODING_CBOR;
+    }
+    return WS_ENCODING_JSON;
+}
+
 esp_err_t ws_manager_create(ws_manager_handle_t *out_handle)
 {
     if (!out_handle) {
@@ -75,8 +138,9 @@ esp_err_t ws_manager_create(ws_manager_handle_t *out_handle)
         return ESP_ERR_NO_MEM;
     }
     for (int i = 0; i < MAX_WS_CLIENTS; i++) {
-        handle->ws_fds[i] = -1;
+        handle->ws_clients[i].fd = -1;
     }
+    ws_manager_frame_pool_init(handle);
 #if CONFIG_GATEWAY_SELF_TEST_APP
     ws_manager_reset_transport_to_defaults(handle);
 #endif
@@ -95,11 +159,26 @@ void ws_manager_destroy(ws_manager_handle_t handle)
             GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_LIST_CHANGED, handle->list_changed_handler);
         handle->list_changed_handler = NULL;
     }
+    if (handle->state_changed_handler) {
+        (void)esp_event_handler_instance_unregister(
+            GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_STATE_CHANGED, handle->state_changed_handler);
+        handle->state_changed_handler = NULL;
+    }
     if (handle->lqi_changed_handler) {
         (void)esp_event_handler_instance_unregister(
             GATEWAY_EVENT, GATEWAY_EVENT_LQI_STATE_CHANGED, handle->lqi_changed_handler);
         handle->lqi_changed_handler = NULL;
     }
+    if (handle->job_changed_handler) {
+        (void)esp_event_handler_instance_unregister(
+            GATEWAY_EVENT, GATEWAY_EVENT_JOB_STATE_CHANGED, handle->job_changed_handler);
+        handle->job_changed_handler = NULL;
+    }
+    if (handle->announce_handler) {
+        (void)esp_event_handler_instance_unregister(
+            GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_ANNOUNCE, handle->announce_handler);
+        handle->announce_handler = NULL;
+    }
 
     if (handle->ws_debounce_timer) {
         (void)esp_timer_stop(handle->ws_debounce_timer);
@@ -111,11 +190,18 @@ void ws_manager_destroy(ws_manager_handle_t handle)
         (void)esp_timer_delete(handle->ws_periodic_timer);
         handle->ws_periodic_timer = NULL;
     }
+    if (handle->ws_ping_timer) {
+        (void)esp_timer_stop(handle->ws_ping_timer);
+        (void)esp_timer_delete(handle->ws_ping_timer);
+        handle->ws_ping_timer = NULL;
+    }
+    ws_manager_broadcaster_stop(handle);
 
-    if (handle->ws_broadcast_mutex) {
-        vSemaphoreDelete(handle->ws_broadcast_mutex);
-        handle->ws_broadcast_mutex = NULL;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        ws_manager_client_reset_locked(&handle->ws_clients[i], -1);
     }
+    ws_manager_snapshot_clear(handle);
+
     if (handle->ws_mutex) {
         vSemaphoreDelete(handle->ws_mutex);
         handle->ws_mutex = NULL;
@@ -144,7 +230,7 @@ void ws_manager_init_with_handle(ws_manager_handle_t handle, httpd_handle_t serv
     }
 
     for (int i = 0; i < MAX_WS_CLIENTS; i++) {
-        handle->ws_fds[i] = -1;
+        ws_manager_client_reset_locked(&handle->ws_clients[i], -1);
     }
 
     if (!handle->ws_mutex) {
@@ -153,11 +239,9 @@ void ws_manager_init_with_handle(ws_manager_handle_t handle, httpd_handle_t serv
             ESP_LOGE(TAG, "Failed to create WS mutex");
         }
     }
-    if (!handle->ws_broadcast_mutex) {
-        handle->ws_broadcast_mutex = xSemaphoreCreateMutex();
-        if (!handle->ws_broadcast_mutex) {
-            ESP_LOGE(TAG, "Failed to create WS broadcast mutex");
-        }
+    esp_err_t task_ret = ws_manager_broadcaster_start(handle);
+    if (task_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start WS broadcaster: %s", esp_err_to_name(task_ret));
     }
 
     if (handle->list_changed_handler == NULL) {
@@ -167,6 +251,14 @@ void ws_manager_init_with_handle(ws_manager_handle_t handle, httpd_handle_t serv
             ESP_LOGE(TAG, "Failed to register DEVICE_LIST_CHANGED handler: %s", esp_err_to_name(ret));
         }
     }
+    if (handle->state_changed_handler == NULL) {
+        /* Attribute reports change the devices_delta payload the same way a list change does. */
+        esp_err_t ret = esp_event_handler_instance_register(
+            GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_STATE_CHANGED, device_list_changed_handler, handle, &handle->state_changed_handler);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register DEVICE_STATE_CHANGED handler: %s", esp_err_to_name(ret));
+        }
+    }
     if (handle->lqi_changed_handler == NULL) {
         esp_err_t ret = esp_event_handler_instance_register(
             GATEWAY_EVENT, GATEWAY_EVENT_LQI_STATE_CHANGED, lqi_state_changed_handler, handle, &handle->lqi_changed_handler);
@@ -174,6 +266,20 @@ void ws_manager_init_with_handle(ws_manager_handle_t handle, httpd_handle_t serv
             ESP_LOGE(TAG, "Failed to register LQI_STATE_CHANGED handler: %s", esp_err_to_name(ret));
         }
     }
+    if (handle->job_changed_handler == NULL) {
+        esp_err_t ret = esp_event_handler_instance_register(
+            GATEWAY_EVENT, GATEWAY_EVENT_JOB_STATE_CHANGED, job_state_changed_handler, handle, &handle->job_changed_handler);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register JOB_STATE_CHANGED handler: %s", esp_err_to_name(ret));
+        }
+    }
+    if (handle->announce_handler == NULL) {
+        esp_err_t ret = esp_event_handler_instance_register(
+            GATEWAY_EVENT, GATEWAY_EVENT_DEVICE_ANNOUNCE, device_announce_handler, handle, &handle->announce_handler);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to register DEVICE_ANNOUNCE handler: %s", esp_err_to_name(ret));
+        }
+    }
 
     if (handle->ws_debounce_timer == NULL) {
         const esp_timer_create_args_t timer_args = {
@@ -199,14 +305,44 @@ void ws_manager_init_with_handle(ws_manager_handle_t handle, httpd_handle_t serv
         }
     }
 
-    handle->last_ws_devices_json_len = 0;
-    handle->last_ws_devices_send_us = 0;
-    handle->last_ws_health_json_len = 0;
-    handle->last_ws_health_send_us = 0;
-    handle->last_ws_lqi_json_len = 0;
-    handle->last_ws_lqi_send_us = 0;
+    if (handle->ws_ping_timer == NULL && WS_PING_INTERVAL_MS > 0) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = ws_ping_timer_cb,
+            .arg = handle,
+            .name = "ws_ping"
+        };
+        esp_err_t ret = esp_timer_create(&timer_args, &handle->ws_ping_timer);
+        if (ret == ESP_OK) {
+            ret = esp_timer_start_periodic(handle->ws_ping_timer, (uint64_t)WS_PING_INTERVAL_MS * 1000u);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start WS ping timer: %s", esp_err_to_name(ret));
+        }
+    }
+
+    ws_manager_snapshot_clear(handle);
+    memset(handle->last_payload_hash, 0, sizeof(handle->last_payload_hash));
+    memset(handle->last_payload_len, 0, sizeof(handle->last_payload_len));
+    memset(handle->last_send_us, 0, sizeof(handle->last_send_us));
+    memset(handle->pending_origin_us, 0, sizeof(handle->pending_origin_us));
+    memset(handle->inflight_origin_us, 0, sizeof(handle->inflight_origin_us));
+    memset(handle->json_streamed_hint, 0, sizeof(handle->json_streamed_hint));
+    memset(handle->cbor_size_hint, 0, sizeof(handle->cbor_size_hint));
+    memset(handle->build_failed, 0, sizeof(handle->build_failed));
     handle->ws_seq = 0;
     memset(&handle->ws_metrics, 0, sizeof(handle->ws_metrics));
+    atomic_store(&handle->broadcast_requests, 0);
+    atomic_store(&handle->flush_retry, false);
+}
+
+void ws_broadcast_status_with_handle(ws_manager_handle_t handle)
+{
+    ws_manager_request_broadcast(handle, WS_NOTIFY_ALL);
+}
+
+void ws_manager_ping_clients_with_handle(ws_manager_handle_t handle)
+{
+    ws_manager_request_broadcast(handle, WS_NOTIFY_PING);
 }
 
 void ws_httpd_close_fn_with_handle(ws_manager_handle_t handle, httpd_handle_t hd, int sockfd)
@@ -219,6 +355,20 @@ void ws_httpd_close_fn_with_handle(ws_manager_handle_t handle, httpd_handle_t hd
     ws_manager_transport_close_socket(handle, sockfd);
 }
 
+/*
+ * A payload that is not read stays in the socket and would be parsed as the next frame header,
+ * so a frame we cannot take ends the session. The failed return makes httpd close the socket.
+ */
+static esp_err_t ws_reject_frame(ws_manager_handle_t handle, httpd_req_t *req, const uint8_t *close_code,
+                                 const char *reason)
+{
+    int fd = ws_manager_transport_req_to_sockfd(handle, req);
+    gateway_error_ring_add("ws", (int32_t)ESP_ERR_INVALID_SIZE, reason);
+    (void)ws_manager_send_control_frame(handle, fd, WS_EVENT_CLOSE, close_code, 2);
+    ws_manager_remove_fd_internal(handle, fd);
+    return ESP_FAIL;
+}
+
 esp_err_t ws_handler_with_handle(ws_manager_handle_t handle, httpd_req_t *req)
 {
     if (!handle || !req) {
@@ -238,11 +388,24 @@ esp_err_t ws_handler_with_handle(ws_manager_handle_t handle, httpd_req_t *req)
         }
 
         ws_manager_note_connection(handle);
-        if (handle->ws_periodic_timer) {
-            (void)esp_timer_stop(handle->ws_periodic_timer);
-            (void)esp_timer_start_periodic(handle->ws_periodic_timer, 1000 * 1000);
+        if (handle->ws_periodic_timer && !esp_timer_is_active(handle->ws_periodic_timer)) {
+            (void)esp_timer_start_periodic(handle->ws_periodic_timer, WS_PERIODIC_BROADCAST_US);
+        }
+        char query[WS_QUERY_MAX_LEN];
+        if (ws_manager_transport_req_get_query(handle, req, query, sizeof(query)) != ESP_OK) {
+            query[0] = '\0';
+        }
+        ws_encoding_t encoding = ws_query_encoding(query);
+        if (encoding != WS_ENCODING_JSON) {
+            (void)ws_manager_set_client_encoding(handle, fd, encoding);
+        }
+        uint32_t since = 0;
+        if (ws_query_since(query, &since) && ws_manager_resume_client(handle, fd, since)) {
+            return ESP_OK;
+        }
+        if (!ws_manager_send_initial_snapshot(handle, fd)) {
+            ws_manager_request_broadcast(handle, WS_NOTIFY_ALL);
         }
-        ws_broadcast_status_with_handle(handle);
         return ESP_OK;
     }
 
@@ -258,7 +421,51 @@ esp_err_t ws_handler_with_handle(ws_manager_handle_t handle, httpd_req_t *req)
 
     if (ws_pkt.type == HTTPD_WS_TYPE_CLOSE) {
         int fd = ws_manager_transport_req_to_sockfd(handle, req);
+        (void)ws_manager_send_control_frame(handle, fd, WS_EVENT_CLOSE, s_ws_close_normal, sizeof(s_ws_close_normal));
         ws_manager_remove_fd_internal(handle, fd);
+        return ESP_OK;
+    }
+
+    if (ws_pkt.type == HTTPD_WS_TYPE_PING || ws_pkt.type == HTTPD_WS_TYPE_PONG) {
+        if (ws_pkt.len > WS_CONTROL_MAX_LEN) {
+            return ws_reject_frame(handle, req, s_ws_close_too_big, "control frame too large");
+        }
+        uint8_t control_buf[WS_CONTROL_MAX_LEN];
+        ws_pkt.payload = control_buf;
+        if (ws_pkt.len > 0) {
+            ret = ws_manager_transport_recv_frame(handle, req, &ws_pkt, sizeof(control_buf));
+            if (ret != ESP_OK) {
+                gateway_error_ring_add("ws", (int32_t)ret, "recv_frame control failed");
+                return ret;
+            }
+        }
+        int fd = ws_manager_transport_req_to_sockfd(handle, req);
+        if (ws_pkt.type == HTTPD_WS_TYPE_PING) {
+            (void)ws_manager_send_control_frame(handle, fd, WS_EVENT_PONG, control_buf, ws_pkt.len);
+        } else {
+            ws_manager_keepalive_on_pong(handle, fd, control_buf, ws_pkt.len);
+        }
+        return ESP_OK;
+    }
+
+    if (ws_pkt.type != HTTPD_WS_TYPE_TEXT && ws_pkt.len > 0) {
+        return ws_reject_frame(handle, req, s_ws_close_unsupported, "unsupported frame");
+    }
+    if (ws_pkt.type == HTTPD_WS_TYPE_TEXT && ws_pkt.len > 0) {
+        if (ws_pkt.len > WS_RX_MAX_LEN) {
+            ESP_LOGW(TAG, "WS message too large (%u bytes), closing", (unsigned)ws_pkt.len);
+            return ws_reject_frame(handle, req, s_ws_close_too_big, "message too large");
+        }
+        uint8_t rx_buf[WS_RX_MAX_LEN + 1];
+        ws_pkt.payload = rx_buf;
+        ret = ws_manager_transport_recv_frame(handle, req, &ws_pkt, WS_RX_MAX_LEN);
+        if (ret != ESP_OK) {
+            gateway_error_ring_add("ws", (int32_t)ret, "recv_frame payload failed");
+            return ret;
+        }
+        rx_buf[ws_pkt.len] = '\0';
+        int fd = ws_manager_transport_req_to_sockfd(handle, req);
+        (void)ws_manager_handle_text_message(handle, fd, (const char *)rx_buf, ws_pkt.len);
     }
     return ESP_OK;
 }
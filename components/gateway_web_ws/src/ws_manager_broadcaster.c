@@ -0,0 +1,107 @@
+#include "ws_manager_broadcaster.h"
+
+#include "ws_manager_internal.h"
+#include "ws_manager_keepalive.h"
+#include "ws_manager_transport.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "WS_BROADCASTER";
+
+static void ws_broadcaster_note_tick(ws_manager_handle_t handle, int64_t elapsed_us)
+{
+    uint32_t tick_us = (elapsed_us < 0) ? 0u : (elapsed_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_us;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    handle->ws_metrics.broadcast_ticks_total++;
+    handle->ws_metrics.broadcast_tick_last_us = tick_us;
+    if (tick_us > handle->ws_metrics.broadcast_tick_max_us) {
+        handle->ws_metrics.broadcast_tick_max_us = tick_us;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+}
+
+static void ws_broadcaster_task(void *arg)
+{
+    ws_manager_handle_t handle = (ws_manager_handle_t)arg;
+    bool retry = false;
+    for (;;) {
+        uint32_t bits = 0;
+        /* Clients left with a full socket buffer are tried again after a short pause, not in a spin. */
+        retry = ws_manager_take_flush_retry(handle) || retry;
+        (void)xTaskNotifyWait(0, UINT32_MAX, &bits, retry ? pdMS_TO_TICKS(WS_FLUSH_RETRY_MS) : portMAX_DELAY);
+        if (bits & WS_NOTIFY_STOP) {
+            break;
+        }
+        if (bits & ~WS_NOTIFY_FLUSH) {
+            /* Every request raised since the last wake-up is served by this single tick. */
+            int64_t started_us = esp_timer_get_time();
+            if (bits & WS_NOTIFY_PING) {
+                ws_manager_keepalive_tick(handle);
+            }
+            ws_manager_broadcast_tick(handle, bits);
+            ws_broadcaster_note_tick(handle, esp_timer_get_time() - started_us);
+        }
+        if (retry) {
+            retry = false;
+            ws_manager_flush_clients(handle);
+        }
+    }
+    xSemaphoreGive(handle->broadcaster_done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t ws_manager_broadcaster_start(ws_manager_handle_t handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->broadcaster_task) {
+        return ESP_OK;
+    }
+    if (!handle->broadcaster_done) {
+        handle->broadcaster_done = xSemaphoreCreateBinary();
+        if (!handle->broadcaster_done) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (xTaskCreate(ws_broadcaster_task, "ws_broadcast", WS_BROADCASTER_STACK_SIZE, handle, WS_BROADCASTER_PRIORITY,
+                    &handle->broadcaster_task) != pdPASS) {
+        handle->broadcaster_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void ws_manager_broadcaster_stop(ws_manager_handle_t handle)
+{
+    if (!handle) {
+        return;
+    }
+    if (handle->broadcaster_task) {
+        (void)xTaskNotify(handle->broadcaster_task, WS_NOTIFY_STOP, eSetBits);
+        /* The task still uses the handle and the semaphore until it gives it, so a slow tick is waited out. */
+        if (xSemaphoreTake(handle->broadcaster_done, pdMS_TO_TICKS(WS_BROADCASTER_STOP_TIMEOUT_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "WS broadcaster did not stop in %d ms, still waiting", WS_BROADCASTER_STOP_TIMEOUT_MS);
+            (void)xSemaphoreTake(handle->broadcaster_done, portMAX_DELAY);
+        }
+        handle->broadcaster_task = NULL;
+    }
+    if (handle->broadcaster_done) {
+        vSemaphoreDelete(handle->broadcaster_done);
+        handle->broadcaster_done = NULL;
+    }
+}
+
+void ws_manager_request_broadcast(ws_manager_handle_t handle, uint32_t notify_bits)
+{
+    if (!handle || !handle->broadcaster_task || notify_bits == 0) {
+        return;
+    }
+    atomic_fetch_add_explicit(&handle->broadcast_requests, 1u, memory_order_relaxed);
+    (void)xTaskNotify(handle->broadcaster_task, notify_bits, eSetBits);
+}
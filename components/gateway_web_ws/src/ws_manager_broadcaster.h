@@ -0,0 +1,12 @@
+#pragma once
+
+#include "ws_manager.h"
+
+#include <stdint.h>
+
+esp_err_t ws_manager_broadcaster_start(ws_manager_handle_t handle);
+void ws_manager_broadcaster_stop(ws_manager_handle_t handle);
+void ws_manager_request_broadcast(ws_manager_handle_t handle, uint32_t notify_bits);
+
+/* Runs on the broadcaster task only. */
+void ws_manager_broadcast_tick(ws_manager_handle_t handle, uint32_t notify_bits);
@@ -7,43 +7,183 @@
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #define MAX_WS_CLIENTS 8
 #define WS_JSON_BUF_SIZE 2048
-#define WS_FRAME_BUF_SIZE 2200
+#define WS_ENVELOPE_HEADER_RESERVE 96
+#define WS_FRAME_BUF_SIZE (WS_ENVELOPE_HEADER_RESERVE + WS_JSON_BUF_SIZE + 2)
+#define WS_FRAME_POOL_SIZE 4
+/* Oversized CBOR payloads get a transient heap frame, grown by doubling up to this size. */
+#define WS_FRAME_MAX_SIZE (16 * 1024)
+/* Messages longer than this go out as TEXT + CONTINUATION fragments. */
+#define WS_FRAGMENT_LEN 1024
+/* Writer window of a streamed JSON frame; full windows are copied into its fragment segments. */
+#define WS_STREAM_WINDOW_LEN 256
 #define WS_PROTOCOL_VERSION 1
 #define WS_MIN_DUP_BROADCAST_INTERVAL_US (250 * 1000)
 #define WS_MIN_BROADCAST_INTERVAL_US (120 * 1000)
 #define WS_MIN_HEALTH_BROADCAST_INTERVAL_US (800 * 1000)
 #define WS_MIN_LQI_BROADCAST_INTERVAL_US (800 * 1000)
-#define WS_BROADCAST_RETRY_US (20 * 1000)
+#define WS_PERIODIC_BROADCAST_US (1000 * 1000)
+#define WS_BROADCASTER_STACK_SIZE 4096
+#define WS_BROADCASTER_PRIORITY 5
+#define WS_BROADCASTER_STOP_TIMEOUT_MS 1000
+#define WS_CLIENT_QUEUE_DEPTH 4
+/* A client whose socket buffer is full is tried again after this delay. */
+#define WS_FLUSH_RETRY_MS 50
+#define WS_RX_MAX_LEN 256
+#define WS_QUERY_MAX_LEN 48
+#define WS_CONTROL_MAX_LEN 125
+#define WS_CLIENT_SLOW_RTT_US (500 * 1000)
+
+#ifdef CONFIG_GATEWAY_WS_PING_INTERVAL_MS
+#define WS_PING_INTERVAL_MS CONFIG_GATEWAY_WS_PING_INTERVAL_MS
+#else
+#define WS_PING_INTERVAL_MS 15000
+#endif
+
+#ifdef CONFIG_GATEWAY_WS_MAX_MISSED_PONGS
+#define WS_MAX_MISSED_PONGS CONFIG_GATEWAY_WS_MAX_MISSED_PONGS
+#else
+#define WS_MAX_MISSED_PONGS 3
+#endif
+
+#define WS_TOPIC_DEVICES (1u << 0)
+#define WS_TOPIC_HEALTH (1u << 1)
+#define WS_TOPIC_LQI (1u << 2)
+#define WS_TOPIC_ALL (WS_TOPIC_DEVICES | WS_TOPIC_HEALTH | WS_TOPIC_LQI)
+
+/* Broadcaster task notification bits; repeated requests coalesce into one tick. */
+#define WS_NOTIFY_DEVICES (1u << 0)
+#define WS_NOTIFY_HEALTH (1u << 1)
+#define WS_NOTIFY_LQI (1u << 2)
+#define WS_NOTIFY_JOBS (1u << 3)
+#define WS_NOTIFY_PING (1u << 4)
+#define WS_NOTIFY_FLUSH (1u << 5)
+#define WS_NOTIFY_STOP (1u << 31)
+#define WS_NOTIFY_ALL (WS_NOTIFY_DEVICES | WS_NOTIFY_HEALTH | WS_NOTIFY_LQI)
+
+typedef enum {
+    WS_EVENT_DEVICES_DELTA = 0,
+    WS_EVENT_HEALTH_STATE,
+    WS_EVENT_LQI_UPDATE,
+    WS_EVENT_SUBSCRIPTION,
+    WS_EVENT_RESYNC,
+    WS_EVENT_RPC_RESULT,
+    WS_EVENT_PING,
+    WS_EVENT_PONG,
+    WS_EVENT_CLOSE,
+    WS_EVENT_KIND_COUNT,
+} ws_event_kind_t;
+
+/* Kinds below this value are fanned out to subscribers; the rest are control frames. */
+#define WS_EVENT_BROADCAST_KIND_COUNT WS_EVENT_SUBSCRIPTION
+
+/*
+ * Wire encoding negotiated per client with ?enc=cbor. Kinds with a CBOR schema are
+ * delivered as BINARY frames to CBOR clients; everything else stays JSON text.
+ */
+typedef enum {
+    WS_ENCODING_JSON = 0,
+    WS_ENCODING_CBOR,
+    WS_ENCODING_COUNT,
+} ws_encoding_t;
+
+/* One fragment of a streamed frame's payload. */
+typedef struct ws_frame_segment {
+    struct ws_frame_segment *next;
+    size_t len;
+    char data[WS_FRAGMENT_LEN];
+} ws_frame_segment_t;
+
+/*
+ * One serialized frame shared by every client queue; returned to the pool (or freed
+ * when it came from the heap fallback) by the last release. The payload is written
+ * at storage + WS_ENVELOPE_HEADER_RESERVE and the envelope header is placed right
+ * in front of it, so data/len describe the finished envelope without a copy.
+ *
+ * A streamed frame (JSON payload larger than a pooled frame) keeps only the envelope
+ * header in data/len; the payload and the closing brace follow in `segments`, each
+ * segment sent as one CONTINUATION fragment. Streamed frames are always heap frames.
+ */
+typedef struct {
+    atomic_uint refcount;
+    ws_event_kind_t kind;
+    ws_encoding_t encoding;
+    bool pooled;
+    size_t capacity;
+    char *storage;
+    char *data;
+    size_t len;
+    size_t payload_len;
+    uint32_t seq;
+    /* When the payload was serialized (0 for control and cached frames); paired with the origin at the wire. */
+    int64_t built_us;
+    ws_frame_segment_t *segments;
+    ws_frame_segment_t *segments_tail;
+} ws_frame_t;
+
+typedef struct {
+    int fd;
+    uint8_t topics;
+    ws_encoding_t encoding;
+    ws_frame_t *queue[WS_CLIENT_QUEUE_DEPTH];
+    uint8_t queue_head;
+    uint8_t queue_len;
+    bool draining;
+    /* Progress of the head frame: payload bytes in finished fragments, then bytes of the current fragment. */
+    size_t tx_offset;
+    uint16_t tx_fragment_sent;
+    uint32_t queue_depth_peak;
+    uint32_t dropped_frames;
+    uint32_t coalesced_frames;
+    uint32_t throttled_frames;
+    bool ping_pending;
+    uint8_t missed_pongs;
+    uint32_t ping_round;
+    int64_t ping_sent_us;
+    uint32_t srtt_us;
+} ws_client_t;
 
 typedef struct ws_manager_ctx {
-    int ws_fds[MAX_WS_CLIENTS];
+    ws_client_t ws_clients[MAX_WS_CLIENTS];
     httpd_handle_t server;
     api_usecases_handle_t api_usecases;
     SemaphoreHandle_t ws_mutex;
-    SemaphoreHandle_t ws_broadcast_mutex;
+    TaskHandle_t broadcaster_task;
+    SemaphoreHandle_t broadcaster_done;
+    atomic_uint broadcast_requests;
+    atomic_bool flush_retry;
     esp_event_handler_instance_t list_changed_handler;
+    esp_event_handler_instance_t state_changed_handler;
     esp_event_handler_instance_t lqi_changed_handler;
+    esp_event_handler_instance_t job_changed_handler;
+    esp_event_handler_instance_t announce_handler;
     esp_timer_handle_t ws_debounce_timer;
     esp_timer_handle_t ws_periodic_timer;
-    char ws_devices_json_buf[WS_JSON_BUF_SIZE];
-    char last_ws_devices_json[WS_JSON_BUF_SIZE];
-    size_t last_ws_devices_json_len;
-    int64_t last_ws_devices_send_us;
-    char ws_health_json_buf[WS_JSON_BUF_SIZE];
-    char last_ws_health_json[WS_JSON_BUF_SIZE];
-    size_t last_ws_health_json_len;
-    int64_t last_ws_health_send_us;
-    char ws_lqi_json_buf[WS_JSON_BUF_SIZE];
-    char last_ws_lqi_json[WS_JSON_BUF_SIZE];
-    size_t last_ws_lqi_json_len;
-    int64_t last_ws_lqi_send_us;
-    char ws_frame_buf[WS_FRAME_BUF_SIZE];
+    esp_timer_handle_t ws_ping_timer;
+    uint32_t ping_round;
+    ws_frame_t ws_frame_pool[WS_FRAME_POOL_SIZE];
+    char ws_frame_pool_storage[WS_FRAME_POOL_SIZE][WS_FRAME_BUF_SIZE];
+    ws_frame_t *snapshot_frames[WS_ENCODING_COUNT][WS_EVENT_BROADCAST_KIND_COUNT];
+    uint32_t last_payload_hash[WS_EVENT_KIND_COUNT];
+    size_t last_payload_len[WS_EVENT_KIND_COUNT];
+    int64_t last_send_us[WS_EVENT_KIND_COUNT];
+    int64_t pending_origin_us[WS_EVENT_BROADCAST_KIND_COUNT];
+    /* Origin of the change carried by frame seq inflight_seq[kind], recorded when its first copy is written. */
+    int64_t inflight_origin_us[WS_EVENT_BROADCAST_KIND_COUNT];
+    uint32_t inflight_seq[WS_EVENT_BROADCAST_KIND_COUNT];
+    /* JSON kinds whose last payload needed a streamed frame, and the CBOR heap frame size that last worked. */
+    bool json_streamed_hint[WS_EVENT_BROADCAST_KIND_COUNT];
+    size_t cbor_size_hint[WS_EVENT_BROADCAST_KIND_COUNT];
+    /* A build failure sends one resync to the affected subscribers until the kind builds again. */
+    bool build_failed[WS_ENCODING_COUNT][WS_EVENT_BROADCAST_KIND_COUNT];
     uint32_t ws_seq;
     api_ws_runtime_metrics_t ws_metrics;
 #if CONFIG_GATEWAY_SELF_TEST_APP
@@ -1,28 +1,80 @@
 #include "ws_manager_json.h"
 
+#include "cbor_writer.h"
 #include "ws_manager_internal.h"
+#include "ws_manager_queue.h"
 #include "ws_manager_state.h"
 
 #include "esp_timer.h"
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
-esp_err_t ws_manager_wrap_event_payload(ws_manager_handle_t handle, const char *type, const char *data_json, size_t data_len,
-                                        size_t *out_len)
+esp_err_t ws_manager_wrap_event_payload(ws_manager_handle_t handle, ws_frame_t *frame, size_t payload_len)
 {
-    if (!handle || !type || !data_json || !out_len) {
+    bool streamed = frame && frame->segments;
+    if (!handle || !frame || payload_len == 0 || (!streamed && payload_len > ws_manager_frame_payload_capacity(frame))) {
         return ESP_ERR_INVALID_ARG;
     }
+    /* A streamed payload is already in the segments; the closing brace goes after it. */
+    if (streamed && !ws_manager_frame_append(frame, "}", 1)) {
+        return ESP_ERR_NO_MEM;
+    }
 
     uint32_t seq = ws_manager_next_seq(handle);
     uint64_t ts_ms = (uint64_t)(esp_timer_get_time() / 1000);
-    int written = snprintf(handle->ws_frame_buf, sizeof(handle->ws_frame_buf),
-                           "{\"version\":%d,\"seq\":%" PRIu32 ",\"ts\":%" PRIu64 ",\"type\":\"%s\",\"data\":%.*s}",
-                           WS_PROTOCOL_VERSION, seq, ts_ms, type, (int)data_len, data_json);
-    if (written < 0 || (size_t)written >= sizeof(handle->ws_frame_buf)) {
+    char header[WS_ENVELOPE_HEADER_RESERVE + 1];
+    int written = snprintf(header, sizeof(header),
+                           "{\"version\":%d,\"seq\":%" PRIu32 ",\"ts\":%" PRIu64 ",\"type\":\"%s\",\"data\":",
+                           WS_PROTOCOL_VERSION, seq, ts_ms, ws_manager_event_type_name(frame->kind));
+    if (written < 0 || (size_t)written > WS_ENVELOPE_HEADER_RESERVE) {
         return ESP_ERR_NO_MEM;
     }
-    *out_len = (size_t)written;
+
+    /* Payload already sits at storage + reserve; place the header right in front of it. */
+    char *payload = ws_manager_frame_payload(frame);
+    frame->data = payload - written;
+    memcpy(frame->data, header, (size_t)written);
+    frame->payload_len = payload_len;
+    if (streamed) {
+        frame->len = (size_t)written;
+    } else {
+        payload[payload_len] = '}';
+        frame->len = (size_t)written + payload_len + 1;
+    }
+    frame->seq = seq;
+    return ESP_OK;
+}
+
+esp_err_t ws_manager_wrap_cbor_payload(ws_manager_handle_t handle, ws_frame_t *frame, size_t payload_len, uint32_t seq)
+{
+    uint8_t schema = frame ? ws_manager_event_cbor_schema(frame->kind) : 0;
+    if (!handle || !frame || schema == 0 || payload_len == 0 || payload_len > ws_manager_frame_payload_capacity(frame)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* [version, schema, seq, ts, data]: the schema id replaces the JSON type name and field keys. */
+    uint64_t ts_ms = (uint64_t)(esp_timer_get_time() / 1000);
+    uint8_t header[WS_ENVELOPE_HEADER_RESERVE];
+    uint8_t *cursor = header;
+    size_t remaining = sizeof(header);
+    if (!cbor_put_array(&cursor, &remaining, 5) ||
+        !cbor_put_uint(&cursor, &remaining, WS_PROTOCOL_VERSION) ||
+        !cbor_put_uint(&cursor, &remaining, schema) ||
+        !cbor_put_uint(&cursor, &remaining, seq) ||
+        !cbor_put_uint(&cursor, &remaining, ts_ms))
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    size_t header_len = (size_t)(cursor - header);
+
+    char *payload = ws_manager_frame_payload(frame);
+    frame->data = payload - header_len;
+    memcpy(frame->data, header, header_len);
+    frame->encoding = WS_ENCODING_CBOR;
+    frame->payload_len = payload_len;
+    frame->len = header_len + payload_len;
+    frame->seq = seq;
     return ESP_OK;
 }
@@ -2,8 +2,10 @@
 
 #include "esp_err.h"
 #include "ws_manager.h"
+#include "ws_manager_internal.h"
 
 #include <stddef.h>
 
-esp_err_t ws_manager_wrap_event_payload(ws_manager_handle_t handle, const char *type, const char *data_json, size_t data_len,
-                                        size_t *out_len);
+esp_err_t ws_manager_wrap_event_payload(ws_manager_handle_t handle, ws_frame_t *frame, size_t payload_len);
+/* Binary twin of an already wrapped JSON event; reuses its seq so resume bookkeeping stays shared. */
+esp_err_t ws_manager_wrap_cbor_payload(ws_manager_handle_t handle, ws_frame_t *frame, size_t payload_len, uint32_t seq);
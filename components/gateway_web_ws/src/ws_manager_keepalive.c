@@ -0,0 +1,131 @@
+#include "ws_manager_keepalive.h"
+
+#include "error_ring.h"
+#include "ws_manager_internal.h"
+#include "ws_manager_queue.h"
+#include "ws_manager_transport.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "WS_KEEPALIVE";
+
+void ws_manager_keepalive_tick(ws_manager_handle_t handle)
+{
+    if (!handle || !handle->server) {
+        return;
+    }
+
+    ws_frame_t *frame = ws_manager_frame_acquire(handle, WS_EVENT_PING);
+    if (!frame) {
+        return;
+    }
+
+    int reaped_fds[MAX_WS_CLIENTS];
+    int reaped_count = 0;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    uint32_t round = ++handle->ping_round;
+    int written = snprintf(frame->storage, WS_CONTROL_MAX_LEN + 1, "%" PRIu32, round);
+    frame->data = frame->storage;
+    frame->len = (written > 0) ? (size_t)written : 0;
+    int64_t now_us = esp_timer_get_time();
+    for (int i = 0; i < MAX_WS_CLIENTS && frame->len > 0; i++) {
+        ws_client_t *client = &handle->ws_clients[i];
+        if (client->fd < 0) {
+            continue;
+        }
+        if (client->ping_pending && ++client->missed_pongs >= WS_MAX_MISSED_PONGS) {
+            reaped_fds[reaped_count++] = client->fd;
+            handle->ws_metrics.idle_reaped_total++;
+            ws_manager_client_evict_locked(handle, client);
+            continue;
+        }
+        /* A queue full of must-deliver frames skips this round rather than arming a ping never sent. */
+        if (!ws_manager_client_enqueue_locked(handle, client, frame)) {
+            continue;
+        }
+        /* Stamped at enqueue: the RTT includes queueing, which is what the send policy cares about. */
+        client->ping_pending = true;
+        client->ping_round = round;
+        client->ping_sent_us = now_us;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    ws_manager_frame_release(frame);
+
+    for (int i = 0; i < reaped_count; i++) {
+        ESP_LOGW(TAG, "WS client %d missed %d pongs, reaping", reaped_fds[i], WS_MAX_MISSED_PONGS);
+        gateway_error_ring_add("ws", (int32_t)ESP_ERR_TIMEOUT, "idle client reaped");
+        ws_manager_transport_trigger_close(handle, reaped_fds[i]);
+    }
+    ws_manager_flush_clients(handle);
+}
+
+esp_err_t ws_manager_send_control_frame(ws_manager_handle_t handle, int fd, ws_event_kind_t kind, const uint8_t *payload,
+                                        size_t len)
+{
+    if (!handle || len > WS_CONTROL_MAX_LEN || (len > 0 && !payload)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ws_frame_t *frame = ws_manager_frame_acquire(handle, kind);
+    if (!frame) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (len > 0) {
+        memcpy(frame->storage, payload, len);
+    }
+    frame->data = frame->storage;
+    frame->len = len;
+    esp_err_t ret = ws_manager_send_frame_to_client(handle, fd, frame);
+    ws_manager_frame_release(frame);
+    return ret;
+}
+
+void ws_manager_keepalive_on_pong(ws_manager_handle_t handle, int fd, const uint8_t *payload, size_t len)
+{
+    if (!handle || !payload || len == 0 || len > WS_CONTROL_MAX_LEN) {
+        return;
+    }
+    char text[WS_CONTROL_MAX_LEN + 1];
+    for (size_t i = 0; i < len; i++) {
+        text[i] = (char)payload[i];
+    }
+    text[len] = '\0';
+    char *end = NULL;
+    unsigned long round = strtoul(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        ws_client_t *client = &handle->ws_clients[i];
+        if (client->fd != fd) {
+            continue;
+        }
+        /* Unsolicited or stale pongs carry no usable timing. */
+        if (client->ping_pending && client->ping_round == (uint32_t)round) {
+            int64_t rtt_us = now_us - client->ping_sent_us;
+            uint32_t sample = (rtt_us < 0) ? 0u : (rtt_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)rtt_us;
+            /* RFC 6298 smoothing, alpha = 1/8. */
+            client->srtt_us = (client->srtt_us == 0) ? sample : client->srtt_us - client->srtt_us / 8 + sample / 8;
+            client->ping_pending = false;
+            client->missed_pongs = 0;
+        }
+        break;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+}
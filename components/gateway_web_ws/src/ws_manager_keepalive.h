@@ -0,0 +1,14 @@
+#pragma once
+
+#include "esp_err.h"
+#include "ws_manager.h"
+#include "ws_manager_internal.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Runs on the broadcaster task: counts unanswered pings, reaps dead clients, queues the next ping. */
+void ws_manager_keepalive_tick(ws_manager_handle_t handle);
+esp_err_t ws_manager_send_control_frame(ws_manager_handle_t handle, int fd, ws_event_kind_t kind, const uint8_t *payload,
+                                        size_t len);
+void ws_manager_keepalive_on_pong(ws_manager_handle_t handle, int fd, const uint8_t *payload, size_t len);
@@ -0,0 +1,93 @@
+#include "ws_manager_latency.h"
+
+static api_ws_event_latency_t *ws_latency_slot(ws_manager_handle_t handle, ws_event_kind_t kind)
+{
+    switch (kind) {
+    case WS_EVENT_DEVICES_DELTA:
+        return &handle->ws_metrics.latency[API_WS_LATENCY_DEVICES];
+    case WS_EVENT_HEALTH_STATE:
+        return &handle->ws_metrics.latency[API_WS_LATENCY_HEALTH];
+    case WS_EVENT_LQI_UPDATE:
+        return &handle->ws_metrics.latency[API_WS_LATENCY_LQI];
+    default:
+        return NULL;
+    }
+}
+
+static uint32_t ws_latency_elapsed_us(int64_t from_us, int64_t to_us)
+{
+    int64_t elapsed_us = to_us - from_us;
+    return (elapsed_us < 0) ? 0u : (elapsed_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_us;
+}
+
+void ws_manager_latency_note_origin(ws_manager_handle_t handle, ws_event_kind_t kind, int64_t origin_us)
+{
+    if (!handle || kind >= WS_EVENT_BROADCAST_KIND_COUNT || origin_us <= 0) {
+        return;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    /* Changes coalesced into one frame are measured from the oldest one. */
+    int64_t *pending = &handle->pending_origin_us[kind];
+    if (*pending == 0 || origin_us < *pending) {
+        *pending = origin_us;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+}
+
+void ws_manager_latency_attach(ws_manager_handle_t handle, ws_event_kind_t kind, uint32_t seq)
+{
+    if (!handle || kind >= WS_EVENT_BROADCAST_KIND_COUNT) {
+        return;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    /* A frame coalesced away before reaching the wire hands its older origin to this one. */
+    int64_t origin_us = handle->pending_origin_us[kind];
+    int64_t inflight_us = handle->inflight_origin_us[kind];
+    if (inflight_us > 0 && (origin_us == 0 || inflight_us < origin_us)) {
+        origin_us = inflight_us;
+    }
+    handle->pending_origin_us[kind] = 0;
+    handle->inflight_origin_us[kind] = origin_us;
+    handle->inflight_seq[kind] = seq;
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+}
+
+void ws_manager_latency_wire_locked(ws_manager_handle_t handle, const ws_frame_t *frame, int64_t sent_us)
+{
+    if (!handle || !frame || frame->kind >= WS_EVENT_BROADCAST_KIND_COUNT || frame->built_us == 0) {
+        return;
+    }
+    int64_t origin_us = handle->inflight_origin_us[frame->kind];
+    if (origin_us <= 0 || handle->inflight_seq[frame->kind] != frame->seq) {
+        return;
+    }
+    handle->inflight_origin_us[frame->kind] = 0;
+    api_ws_event_latency_t *slot = ws_latency_slot(handle, frame->kind);
+    if (slot) {
+        api_latency_histogram_record(&slot->serialize, ws_latency_elapsed_us(origin_us, frame->built_us));
+        api_latency_histogram_record(&slot->sent, ws_latency_elapsed_us(origin_us, sent_us));
+    }
+}
+
+void ws_manager_latency_discard(ws_manager_handle_t handle, ws_event_kind_t kind)
+{
+    if (!handle || kind >= WS_EVENT_BROADCAST_KIND_COUNT) {
+        return;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    handle->pending_origin_us[kind] = 0;
+    handle->inflight_origin_us[kind] = 0;
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "ws_manager.h"
+#include "ws_manager_internal.h"
+
+#include <stdint.h>
+
+/*
+ * Origin-to-wire latency per broadcast kind. Event handlers note when the change
+ * happened at its source; the broadcaster attaches that origin to the seq of the frame
+ * carrying the change, and the transport records origin->serialize and origin->sent
+ * when the last fragment of that frame (JSON or its CBOR twin) is first written to a
+ * socket. Ticks that end up sending nothing new discard the pending origin instead.
+ */
+void ws_manager_latency_note_origin(ws_manager_handle_t handle, ws_event_kind_t kind, int64_t origin_us);
+void ws_manager_latency_attach(ws_manager_handle_t handle, ws_event_kind_t kind, uint32_t seq);
+/* Called with ws_mutex held once a frame's final fragment is written. */
+void ws_manager_latency_wire_locked(ws_manager_handle_t handle, const ws_frame_t *frame, int64_t sent_us);
+void ws_manager_latency_discard(ws_manager_handle_t handle, ws_event_kind_t kind);
@@ -6,8 +6,12 @@
 #include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "ws_manager_broadcaster.h"
 #include "ws_manager_internal.h"
 #include "ws_manager_json.h"
+#include "ws_manager_latency.h"
+#include "ws_manager_queue.h"
+#include "ws_manager_replay.h"
 #include "ws_manager_state.h"
 #include "ws_manager_transport.h"
 
@@ -15,39 +19,286 @@
 
 static const char *TAG = "WS_POLICY";
 
-void ws_broadcast_status_with_handle(ws_manager_handle_t handle)
+typedef esp_err_t (*ws_payload_writer_t)(api_usecases_handle_t usecases, json_writer_t *w);
+typedef esp_err_t (*ws_payload_builder_t)(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len);
+
+static uint32_t ws_hash_bytes(uint32_t hash, const char *data, size_t len)
 {
-    if (!handle || !handle->server || !handle->api_usecases) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t ws_payload_hash(ws_frame_t *frame, size_t len)
+{
+    /* FNV-1a: enough to detect an unchanged payload without keeping a copy of it. */
+    uint32_t hash = 2166136261u;
+    if (!frame->segments) {
+        return ws_hash_bytes(hash, ws_manager_frame_payload(frame), len);
+    }
+    for (const ws_frame_segment_t *segment = frame->segments; segment; segment = segment->next) {
+        hash = ws_hash_bytes(hash, segment->data, segment->len);
+    }
+    return hash;
+}
+
+/* Counts a failed build and, once per failure streak, tells the subscribers that missed it to refetch. */
+static void ws_note_build(ws_manager_handle_t handle, ws_event_kind_t kind, ws_encoding_t encoding, bool built)
+{
+    bool first_failure = !built && !handle->build_failed[encoding][kind];
+    handle->build_failed[encoding][kind] = !built;
+    if (built) {
         return;
     }
-    if (handle->ws_broadcast_mutex && xSemaphoreTake(handle->ws_broadcast_mutex, 0) != pdTRUE) {
-        ws_manager_inc_lock_skips(handle);
-        if (handle->ws_debounce_timer) {
-            (void)esp_timer_stop(handle->ws_debounce_timer);
-            (void)esp_timer_start_once(handle->ws_debounce_timer, WS_BROADCAST_RETRY_US);
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    handle->ws_metrics.build_failures_total++;
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    if (first_failure) {
+        ws_manager_resync_subscribers(handle, kind, encoding);
+    }
+}
+
+static bool ws_payload_is_duplicate(ws_manager_handle_t handle, ws_event_kind_t kind, uint32_t hash, size_t len)
+{
+    return len > 0 && len == handle->last_payload_len[kind] && hash == handle->last_payload_hash[kind];
+}
+
+static void ws_payload_note_sent(ws_manager_handle_t handle, ws_event_kind_t kind, uint32_t hash, size_t len, int64_t now_us)
+{
+    handle->last_payload_hash[kind] = hash;
+    handle->last_payload_len[kind] = len;
+    handle->last_send_us[kind] = now_us;
+}
+
+static void ws_snapshot_store(ws_manager_handle_t handle, ws_frame_t *frame)
+{
+    if (frame->kind >= WS_EVENT_BROADCAST_KIND_COUNT) {
+        return;
+    }
+    /* A pooled buffer stays with the client queues; the cache keeps a copy sized to the envelope.
+     * Only when that copy cannot be allocated does the snapshot pin the pooled buffer. */
+    ws_frame_t *cached = frame->pooled ? ws_manager_frame_clone(frame) : NULL;
+    if (!cached) {
+        cached = frame;
+        ws_manager_frame_retain(frame);
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    ws_frame_t *previous = handle->snapshot_frames[frame->encoding][frame->kind];
+    handle->snapshot_frames[frame->encoding][frame->kind] = cached;
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    ws_manager_frame_release(previous);
+}
+
+static ws_frame_t *ws_build_cbor_frame(ws_manager_handle_t handle, ws_event_kind_t kind, ws_payload_builder_t builder,
+                                       size_t *out_payload_len);
+
+/* Builds the CBOR twin of a JSON event only while some CBOR client subscribes to its topic. */
+static void ws_send_cbor_twin(ws_manager_handle_t handle, ws_event_kind_t kind, ws_payload_builder_t cbor_builder,
+                              uint32_t seq)
+{
+    if (!cbor_builder || (ws_manager_encoding_topics(handle, WS_ENCODING_CBOR) & ws_manager_event_topic(kind)) == 0) {
+        return;
+    }
+    size_t payload_len = 0;
+    ws_frame_t *frame = ws_build_cbor_frame(handle, kind, cbor_builder, &payload_len);
+    if (!frame) {
+        return;
+    }
+    esp_err_t wrap_ret = ws_manager_wrap_cbor_payload(handle, frame, payload_len, seq);
+    if (wrap_ret == ESP_OK) {
+        frame->built_us = esp_timer_get_time();
+        ws_snapshot_store(handle, frame);
+        (void)ws_manager_send_frame_to_clients(handle, frame);
+        if (handle->ws_mutex) {
+            xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+        }
+        handle->ws_metrics.binary_frames_total++;
+        if (handle->ws_mutex) {
+            xSemaphoreGive(handle->ws_mutex);
         }
+    } else {
+        ESP_LOGW(TAG, "Failed to wrap WS %s CBOR frame: %s", ws_manager_event_type_name(kind), esp_err_to_name(wrap_ret));
+        ws_note_build(handle, kind, WS_ENCODING_CBOR, false);
+    }
+    ws_manager_frame_release(frame);
+}
+
+/* A measured frame takes the pending origin before any client can write it. */
+static void ws_wrap_and_send(ws_manager_handle_t handle, ws_frame_t *frame, size_t payload_len,
+                             ws_payload_builder_t cbor_builder, int64_t built_us, bool measured)
+{
+    esp_err_t wrap_ret = ws_manager_wrap_event_payload(handle, frame, payload_len);
+    if (wrap_ret == ESP_OK) {
+        frame->built_us = built_us;
+        if (measured) {
+            ws_manager_latency_attach(handle, frame->kind, frame->seq);
+        }
+        ws_snapshot_store(handle, frame);
+        (void)ws_manager_send_frame_to_clients(handle, frame);
+        ws_send_cbor_twin(handle, frame->kind, cbor_builder, frame->seq);
+    } else {
+        ESP_LOGW(TAG, "Failed to wrap WS %s frame: %s", ws_manager_event_type_name(frame->kind), esp_err_to_name(wrap_ret));
+        ws_note_build(handle, frame->kind, WS_ENCODING_JSON, false);
+    }
+}
+
+static ws_frame_t *ws_build_json_frame_once(ws_manager_handle_t handle, ws_event_kind_t kind,
+                                            ws_payload_writer_t writer, size_t *out_payload_len)
+{
+    /* The pooled frame is tried first unless the last payload of this kind already needed streaming. */
+    if (!handle->json_streamed_hint[kind]) {
+        ws_frame_t *frame = ws_manager_frame_acquire(handle, kind);
+        if (!frame) {
+            ESP_LOGW(TAG, "No WS frame buffer available for %s", ws_manager_event_type_name(kind));
+            return NULL;
+        }
+        json_writer_t w;
+        json_writer_init(&w, ws_manager_frame_payload(frame), ws_manager_frame_payload_capacity(frame));
+        esp_err_t ret = writer(handle->api_usecases, &w);
+        if (ret == ESP_OK && json_writer_finish(&w, out_payload_len)) {
+            return frame;
+        }
+        ws_manager_frame_release(frame);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to build WS %s payload: %s", ws_manager_event_type_name(kind), esp_err_to_name(ret));
+            return NULL;
+        }
+    }
+
+    ws_frame_t *frame = ws_manager_frame_acquire_streamed(handle, kind);
+    if (!frame) {
+        ESP_LOGW(TAG, "No WS stream frame available for %s", ws_manager_event_type_name(kind));
+        return NULL;
+    }
+    json_writer_t w;
+    json_writer_init_stream(&w, ws_manager_frame_payload(frame), WS_STREAM_WINDOW_LEN, ws_manager_frame_append, frame);
+    esp_err_t ret = writer(handle->api_usecases, &w);
+    if (ret == ESP_OK && !json_writer_finish(&w, out_payload_len)) {
+        ret = ESP_ERR_NO_MEM;
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to stream WS %s payload: %s", ws_manager_event_type_name(kind), esp_err_to_name(ret));
+        ws_manager_frame_release(frame);
+        return NULL;
+    }
+    handle->json_streamed_hint[kind] = *out_payload_len >= WS_JSON_BUF_SIZE;
+    return frame;
+}
+
+/*
+ * JSON payloads that outgrow a pooled frame are written through the json_writer chunk sink
+ * into a streamed frame and sent one segment per fragment, so their size is bounded only by
+ * free heap. A failed build is counted and answered with a resync instead of a silent skip.
+ */
+static ws_frame_t *ws_build_json_frame(ws_manager_handle_t handle, ws_event_kind_t kind, ws_payload_writer_t writer,
+                                       size_t *out_payload_len)
+{
+    ws_frame_t *frame = ws_build_json_frame_once(handle, kind, writer, out_payload_len);
+    ws_note_build(handle, kind, WS_ENCODING_JSON, frame != NULL);
+    return frame;
+}
+
+/*
+ * CBOR payloads stay contiguous: a pooled frame first, then a heap frame of doubling size
+ * up to WS_FRAME_MAX_SIZE. The size that worked is remembered per kind so steady-state
+ * large payloads are built once.
+ */
+static ws_frame_t *ws_build_cbor_frame_once(ws_manager_handle_t handle, ws_event_kind_t kind,
+                                            ws_payload_builder_t builder, size_t *out_payload_len)
+{
+    size_t capacity = handle->cbor_size_hint[kind];
+    if (capacity < WS_FRAME_BUF_SIZE) {
+        capacity = WS_FRAME_BUF_SIZE;
+    }
+    for (;;) {
+        ws_frame_t *frame = ws_manager_frame_acquire_sized(handle, kind, capacity);
+        if (!frame) {
+            ESP_LOGW(TAG, "No WS frame buffer available for %s CBOR (%u bytes)", ws_manager_event_type_name(kind),
+                     (unsigned)capacity);
+            return NULL;
+        }
+        esp_err_t build_ret = builder(handle->api_usecases, ws_manager_frame_payload(frame),
+                                      ws_manager_frame_payload_capacity(frame), out_payload_len);
+        if (build_ret == ESP_OK) {
+            bool fits_pool = (*out_payload_len + WS_ENVELOPE_HEADER_RESERVE + 1) <= WS_FRAME_BUF_SIZE;
+            handle->cbor_size_hint[kind] = fits_pool ? 0 : capacity;
+            return frame;
+        }
+        ws_manager_frame_release(frame);
+        if (build_ret != ESP_ERR_NO_MEM || capacity >= WS_FRAME_MAX_SIZE) {
+            ESP_LOGW(TAG, "Failed to build WS %s CBOR payload: %s", ws_manager_event_type_name(kind),
+                     esp_err_to_name(build_ret));
+            return NULL;
+        }
+        capacity = (capacity * 2 > WS_FRAME_MAX_SIZE) ? WS_FRAME_MAX_SIZE : capacity * 2;
+    }
+}
+
+static ws_frame_t *ws_build_cbor_frame(ws_manager_handle_t handle, ws_event_kind_t kind, ws_payload_builder_t builder,
+                                       size_t *out_payload_len)
+{
+    ws_frame_t *frame = ws_build_cbor_frame_once(handle, kind, builder, out_payload_len);
+    ws_note_build(handle, kind, WS_ENCODING_CBOR, frame != NULL);
+    return frame;
+}
+
+static void ws_broadcast_state_event(ws_manager_handle_t handle, ws_event_kind_t kind, ws_payload_writer_t writer,
+                                     ws_payload_builder_t cbor_builder, int64_t min_interval_us, int64_t now_us)
+{
+    if ((now_us - handle->last_send_us[kind]) < min_interval_us) {
+        return;
+    }
+    size_t payload_len = 0;
+    ws_frame_t *frame = ws_build_json_frame(handle, kind, writer, &payload_len);
+    if (!frame) {
         return;
     }
+    int64_t built_us = esp_timer_get_time();
+    uint32_t hash = ws_payload_hash(frame, payload_len);
+    bool same = ws_payload_is_duplicate(handle, kind, hash, payload_len);
+    if (!same || (now_us - handle->last_send_us[kind]) >= WS_MIN_DUP_BROADCAST_INTERVAL_US) {
+        ws_wrap_and_send(handle, frame, payload_len, cbor_builder, built_us, !same);
+        ws_payload_note_sent(handle, kind, hash, payload_len, now_us);
+    }
+    if (same) {
+        /* Nothing new reached the wire; a pending origin would only measure the next periodic tick. */
+        ws_manager_latency_discard(handle, kind);
+    }
+    ws_manager_frame_release(frame);
+}
 
-    bool release_broadcast_lock = (handle->ws_broadcast_mutex != NULL);
+static void ws_broadcast_devices_event(ws_manager_handle_t handle, int64_t now_us)
+{
     size_t json_len = 0;
-    esp_err_t build_ret = build_devices_json_compact(
-        handle->api_usecases, handle->ws_devices_json_buf, sizeof(handle->ws_devices_json_buf), &json_len);
-    if (build_ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to build WS delta JSON payload: %s", esp_err_to_name(build_ret));
-        goto out;
+    ws_frame_t *frame = ws_build_json_frame(handle, WS_EVENT_DEVICES_DELTA, write_devices_json, &json_len);
+    if (!frame) {
+        return;
     }
+    int64_t built_us = esp_timer_get_time();
 
-    int64_t now_us = esp_timer_get_time();
-    bool same_payload = (json_len == handle->last_ws_devices_json_len) &&
-                        (json_len > 0) &&
-                        (memcmp(handle->ws_devices_json_buf, handle->last_ws_devices_json, json_len) == 0);
-    if (same_payload && (now_us - handle->last_ws_devices_send_us) < WS_MIN_DUP_BROADCAST_INTERVAL_US) {
-        goto out;
+    int64_t last_devices_send_us = handle->last_send_us[WS_EVENT_DEVICES_DELTA];
+    uint32_t devices_hash = ws_payload_hash(frame, json_len);
+    bool same_payload = ws_payload_is_duplicate(handle, WS_EVENT_DEVICES_DELTA, devices_hash, json_len);
+    if (same_payload) {
+        ws_manager_latency_discard(handle, WS_EVENT_DEVICES_DELTA);
+    }
+    if (same_payload && (now_us - last_devices_send_us) < WS_MIN_DUP_BROADCAST_INTERVAL_US) {
+        ws_manager_frame_release(frame);
+        return;
     }
 
-    int64_t elapsed_us = now_us - handle->last_ws_devices_send_us;
-    if (handle->last_ws_devices_send_us > 0 && elapsed_us < WS_MIN_BROADCAST_INTERVAL_US) {
+    int64_t elapsed_us = now_us - last_devices_send_us;
+    if (last_devices_send_us > 0 && elapsed_us < WS_MIN_BROADCAST_INTERVAL_US) {
         if (handle->ws_debounce_timer) {
             int64_t delay_us = WS_MIN_BROADCAST_INTERVAL_US - elapsed_us;
             if (delay_us < 1000) {
@@ -56,84 +307,93 @@ void ws_broadcast_status_with_handle(ws_manager_handle_t handle)
             (void)esp_timer_stop(handle->ws_debounce_timer);
             (void)esp_timer_start_once(handle->ws_debounce_timer, (uint64_t)delay_us);
         }
-        goto out;
+        ws_manager_frame_release(frame);
+        return;
     }
 
-    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
-    size_t frame_len = 0;
-    esp_err_t wrap_ret = ws_manager_wrap_event_payload(handle, "devices_delta", handle->ws_devices_json_buf, json_len, &frame_len);
-    if (wrap_ret == ESP_OK) {
-        (void)ws_manager_send_frame_to_clients(handle, handle->ws_frame_buf, frame_len);
-    } else {
-        ESP_LOGW(TAG, "Failed to wrap WS devices frame: %s", esp_err_to_name(wrap_ret));
-    }
+    /* Debounced changes keep their origin, so the deferral shows up in the histogram. */
+    ws_wrap_and_send(handle, frame, json_len, build_devices_cbor_compact, built_us, !same_payload);
+    ws_payload_note_sent(handle, WS_EVENT_DEVICES_DELTA, devices_hash, json_len, now_us);
+    ws_manager_frame_release(frame);
+}
 
-    if (json_len < sizeof(handle->last_ws_devices_json)) {
-        memcpy(handle->last_ws_devices_json, handle->ws_devices_json_buf, json_len);
-        handle->last_ws_devices_json[json_len] = '\0';
-        handle->last_ws_devices_json_len = json_len;
-    } else {
-        handle->last_ws_devices_json_len = 0;
-    }
-    handle->last_ws_devices_send_us = now_us;
-
-    if ((now_us - handle->last_ws_health_send_us) >= WS_MIN_HEALTH_BROADCAST_INTERVAL_US) {
-        size_t health_len = 0;
-        esp_err_t health_ret = build_health_json_compact(
-            handle->api_usecases, handle->ws_health_json_buf, sizeof(handle->ws_health_json_buf), &health_len);
-        if (health_ret == ESP_OK) {
-            bool same_health = (health_len == handle->last_ws_health_json_len) &&
-                               (health_len > 0) &&
-                               (memcmp(handle->ws_health_json_buf, handle->last_ws_health_json, health_len) == 0);
-            if (!same_health || (now_us - handle->last_ws_health_send_us) >= WS_MIN_DUP_BROADCAST_INTERVAL_US) {
-                wrap_ret = ws_manager_wrap_event_payload(handle, "health_state", handle->ws_health_json_buf, health_len, &frame_len);
-                if (wrap_ret == ESP_OK) {
-                    (void)ws_manager_send_frame_to_clients(handle, handle->ws_frame_buf, frame_len);
-                    if (health_len < sizeof(handle->last_ws_health_json)) {
-                        memcpy(handle->last_ws_health_json, handle->ws_health_json_buf, health_len);
-                        handle->last_ws_health_json[health_len] = '\0';
-                        handle->last_ws_health_json_len = health_len;
-                    } else {
-                        handle->last_ws_health_json_len = 0;
-                    }
-                    handle->last_ws_health_send_us = now_us;
-                }
-            }
-        }
+void ws_manager_broadcast_tick(ws_manager_handle_t handle, uint32_t notify_bits)
+{
+    if (!handle || !handle->server || !handle->api_usecases) {
+        return;
     }
 
-    if ((now_us - handle->last_ws_lqi_send_us) >= WS_MIN_LQI_BROADCAST_INTERVAL_US) {
-        size_t lqi_len = 0;
-        esp_err_t lqi_ret = build_lqi_json_compact(
-            handle->api_usecases, handle->ws_lqi_json_buf, sizeof(handle->ws_lqi_json_buf), &lqi_len);
-        if (lqi_ret == ESP_OK) {
-            bool same_lqi = (lqi_len == handle->last_ws_lqi_json_len) &&
-                            (lqi_len > 0) &&
-                            (memcmp(handle->ws_lqi_json_buf, handle->last_ws_lqi_json, lqi_len) == 0);
-            if (!same_lqi || (now_us - handle->last_ws_lqi_send_us) >= WS_MIN_DUP_BROADCAST_INTERVAL_US) {
-                wrap_ret = ws_manager_wrap_event_payload(handle, "lqi_update", handle->ws_lqi_json_buf, lqi_len, &frame_len);
-                if (wrap_ret == ESP_OK) {
-                    (void)ws_manager_send_frame_to_clients(handle, handle->ws_frame_buf, frame_len);
-                    if (lqi_len < sizeof(handle->last_ws_lqi_json)) {
-                        memcpy(handle->last_ws_lqi_json, handle->ws_lqi_json_buf, lqi_len);
-                        handle->last_ws_lqi_json[lqi_len] = '\0';
-                        handle->last_ws_lqi_json_len = lqi_len;
-                    } else {
-                        handle->last_ws_lqi_json_len = 0;
-                    }
-                    handle->last_ws_lqi_send_us = now_us;
-                }
-            }
+    /* Payloads nobody subscribed to are never built. */
+    uint8_t topics = ws_manager_subscribed_topics(handle);
+    for (int kind = 0; kind < WS_EVENT_BROADCAST_KIND_COUNT; kind++) {
+        if ((topics & ws_manager_event_topic((ws_event_kind_t)kind)) == 0) {
+            /* Nobody would receive it; don't let a later subscriber inherit a stale origin. */
+            ws_manager_latency_discard(handle, (ws_event_kind_t)kind);
         }
     }
-
+    if (topics == 0) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if ((notify_bits & WS_NOTIFY_DEVICES) && (topics & WS_TOPIC_DEVICES)) {
+        ws_broadcast_devices_event(handle, now_us);
+    }
+    if ((notify_bits & (WS_NOTIFY_HEALTH | WS_NOTIFY_JOBS)) && (topics & WS_TOPIC_HEALTH)) {
+        /* Job transitions skip the health interval; the duplicate check still applies. */
+        int64_t min_interval_us = (notify_bits & WS_NOTIFY_JOBS) ? 0 : WS_MIN_HEALTH_BROADCAST_INTERVAL_US;
+        ws_broadcast_state_event(handle, WS_EVENT_HEALTH_STATE, write_health_json, NULL, min_interval_us, now_us);
+    }
+    if ((notify_bits & WS_NOTIFY_LQI) && (topics & WS_TOPIC_LQI)) {
+        ws_broadcast_state_event(handle, WS_EVENT_LQI_UPDATE, write_lqi_json, build_lqi_cbor_compact,
+                                 WS_MIN_LQI_BROADCAST_INTERVAL_US, now_us);
+    }
     size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_8BIT);
-    (void)heap_before;
-    (void)heap_after;
     ESP_LOGD(TAG, "WS broadcast heap: before=%u after=%u delta=%d",
              (unsigned)heap_before, (unsigned)heap_after, (int)(heap_after - heap_before));
-out:
-    if (release_broadcast_lock) {
-        xSemaphoreGive(handle->ws_broadcast_mutex);
+}
+
+bool ws_manager_send_initial_snapshot(ws_manager_handle_t handle, int fd)
+{
+    if (!handle) {
+        return false;
+    }
+
+    ws_frame_t *frames[WS_EVENT_BROADCAST_KIND_COUNT] = {0};
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    ws_encoding_t encoding = ws_manager_client_encoding_locked(handle, fd);
+    for (int kind = 0; kind < WS_EVENT_BROADCAST_KIND_COUNT; kind++) {
+        /* Kinds without a binary schema are cached (and sent) as JSON only. */
+        ws_encoding_t cached = ws_manager_event_cbor_schema((ws_event_kind_t)kind) ? encoding : WS_ENCODING_JSON;
+        frames[kind] = handle->snapshot_frames[cached][kind];
+        ws_manager_frame_retain(frames[kind]);
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+
+    /* Without a cached devices frame the new client needs a fresh build. */
+    bool have_devices = (frames[WS_EVENT_DEVICES_DELTA] != NULL);
+    for (int kind = 0; kind < WS_EVENT_BROADCAST_KIND_COUNT; kind++) {
+        if (frames[kind] && have_devices) {
+            (void)ws_manager_send_frame_to_client(handle, fd, frames[kind]);
+        }
+        ws_manager_frame_release(frames[kind]);
+    }
+    return have_devices;
+}
+
+void ws_manager_snapshot_clear(ws_manager_handle_t handle)
+{
+    if (!handle) {
+        return;
+    }
+    for (int encoding = 0; encoding < WS_ENCODING_COUNT; encoding++) {
+        for (int kind = 0; kind < WS_EVENT_BROADCAST_KIND_COUNT; kind++) {
+            ws_manager_frame_release(handle->snapshot_frames[encoding][kind]);
+            handle->snapshot_frames[encoding][kind] = NULL;
+        }
     }
 }
@@ -0,0 +1,417 @@
+#include "ws_manager_queue.h"
+
+#include "lqi_json_mapper.h"
+#include "status_json_builder.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const s_event_type_names[WS_EVENT_KIND_COUNT] = {
+    [WS_EVENT_DEVICES_DELTA] = "devices_delta",
+    [WS_EVENT_HEALTH_STATE] = "health_state",
+    [WS_EVENT_LQI_UPDATE] = "lqi_update",
+    [WS_EVENT_SUBSCRIPTION] = "subscription",
+    [WS_EVENT_RESYNC] = "resync",
+    [WS_EVENT_RPC_RESULT] = "rpc_result",
+    [WS_EVENT_PING] = "ping",
+    [WS_EVENT_PONG] = "pong",
+    [WS_EVENT_CLOSE] = "close",
+};
+
+static bool ws_event_kind_is_state(ws_event_kind_t kind)
+{
+    return kind == WS_EVENT_HEALTH_STATE || kind == WS_EVENT_LQI_UPDATE;
+}
+
+static bool ws_event_kind_is_coalescible(ws_event_kind_t kind)
+{
+    /* A newer ping supersedes an unsent one just like a newer state snapshot. */
+    return ws_event_kind_is_state(kind) || kind == WS_EVENT_PING;
+}
+
+const char *ws_manager_event_type_name(ws_event_kind_t kind)
+{
+    if ((int)kind < 0 || kind >= WS_EVENT_KIND_COUNT) {
+        return "unknown";
+    }
+    return s_event_type_names[kind];
+}
+
+uint8_t ws_manager_event_topic(ws_event_kind_t kind)
+{
+    switch (kind) {
+    case WS_EVENT_DEVICES_DELTA:
+        return WS_TOPIC_DEVICES;
+    case WS_EVENT_HEALTH_STATE:
+        return WS_TOPIC_HEALTH;
+    case WS_EVENT_LQI_UPDATE:
+        return WS_TOPIC_LQI;
+    default:
+        /* Control replies are addressed to one client and bypass topic filtering. */
+        return 0;
+    }
+}
+
+uint8_t ws_manager_event_cbor_schema(ws_event_kind_t kind)
+{
+    switch (kind) {
+    case WS_EVENT_DEVICES_DELTA:
+        return API_CBOR_SCHEMA_DEVICES;
+    case WS_EVENT_LQI_UPDATE:
+        return API_CBOR_SCHEMA_LQI;
+    default:
+        /* Health and control frames stay JSON text for every client. */
+        return 0;
+    }
+}
+
+bool ws_manager_client_wants_frame(const ws_client_t *client, const ws_frame_t *frame)
+{
+    if (!client || !frame || client->fd < 0) {
+        return false;
+    }
+    uint8_t topic = ws_manager_event_topic(frame->kind);
+    if (topic != 0 && (client->topics & topic) == 0) {
+        return false;
+    }
+    return ws_manager_event_cbor_schema(frame->kind) == 0 || client->encoding == frame->encoding;
+}
+
+void ws_manager_frame_pool_init(ws_manager_handle_t handle)
+{
+    if (!handle) {
+        return;
+    }
+    for (int i = 0; i < WS_FRAME_POOL_SIZE; i++) {
+        ws_frame_t *frame = &handle->ws_frame_pool[i];
+        atomic_init(&frame->refcount, 0);
+        frame->pooled = true;
+        frame->capacity = WS_FRAME_BUF_SIZE;
+        frame->storage = handle->ws_frame_pool_storage[i];
+        frame->data = NULL;
+        frame->len = 0;
+        frame->payload_len = 0;
+        frame->built_us = 0;
+        frame->segments = NULL;
+        frame->segments_tail = NULL;
+    }
+}
+
+ws_frame_t *ws_manager_frame_acquire(ws_manager_handle_t handle, ws_event_kind_t kind)
+{
+    if (!handle) {
+        return NULL;
+    }
+
+    ws_frame_t *frame = NULL;
+    for (int i = 0; i < WS_FRAME_POOL_SIZE && !frame; i++) {
+        unsigned expected = 0;
+        if (atomic_compare_exchange_strong(&handle->ws_frame_pool[i].refcount, &expected, 1u)) {
+            frame = &handle->ws_frame_pool[i];
+        }
+    }
+    if (!frame) {
+        /* Every pooled buffer is still referenced by a slow client queue. */
+        frame = (ws_frame_t *)malloc(sizeof(*frame) + WS_FRAME_BUF_SIZE);
+        if (!frame) {
+            return NULL;
+        }
+        atomic_init(&frame->refcount, 1);
+        frame->pooled = false;
+        frame->capacity = WS_FRAME_BUF_SIZE;
+        frame->storage = (char *)(frame + 1);
+        if (handle->ws_mutex) {
+            xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+        }
+        handle->ws_metrics.frame_pool_misses_total++;
+        if (handle->ws_mutex) {
+            xSemaphoreGive(handle->ws_mutex);
+        }
+    }
+    frame->kind = kind;
+    frame->encoding = WS_ENCODING_JSON;
+    frame->data = NULL;
+    frame->len = 0;
+    frame->payload_len = 0;
+    frame->seq = 0;
+    frame->built_us = 0;
+    frame->segments = NULL;
+    frame->segments_tail = NULL;
+    return frame;
+}
+
+ws_frame_t *ws_manager_frame_acquire_sized(ws_manager_handle_t handle, ws_event_kind_t kind, size_t capacity)
+{
+    if (capacity <= WS_FRAME_BUF_SIZE) {
+        return ws_manager_frame_acquire(handle, kind);
+    }
+    if (!handle || capacity > WS_FRAME_MAX_SIZE) {
+        return NULL;
+    }
+    ws_frame_t *frame = (ws_frame_t *)malloc(sizeof(*frame) + capacity);
+    if (!frame) {
+        return NULL;
+    }
+    atomic_init(&frame->refcount, 1);
+    frame->pooled = false;
+    frame->capacity = capacity;
+    frame->storage = (char *)(frame + 1);
+    frame->kind = kind;
+    frame->encoding = WS_ENCODING_JSON;
+    frame->data = NULL;
+    frame->len = 0;
+    frame->payload_len = 0;
+    frame->seq = 0;
+    frame->built_us = 0;
+    frame->segments = NULL;
+    frame->segments_tail = NULL;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    handle->ws_metrics.large_frames_total++;
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    return frame;
+}
+
+ws_frame_t *ws_manager_frame_acquire_streamed(ws_manager_handle_t handle, ws_event_kind_t kind)
+{
+    if (!handle) {
+        return NULL;
+    }
+    /* Room for the envelope header and the writer window; the payload itself goes to segments. */
+    size_t capacity = WS_ENVELOPE_HEADER_RESERVE + WS_STREAM_WINDOW_LEN;
+    ws_frame_t *frame = (ws_frame_t *)malloc(sizeof(*frame) + capacity);
+    if (!frame) {
+        return NULL;
+    }
+    atomic_init(&frame->refcount, 1);
+    frame->pooled = false;
+    frame->capacity = capacity;
+    frame->storage = (char *)(frame + 1);
+    frame->kind = kind;
+    frame->encoding = WS_ENCODING_JSON;
+    frame->data = NULL;
+    frame->len = 0;
+    frame->payload_len = 0;
+    frame->seq = 0;
+    frame->built_us = 0;
+    frame->segments = NULL;
+    frame->segments_tail = NULL;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    handle->ws_metrics.large_frames_total++;
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    return frame;
+}
+
+ws_frame_t *ws_manager_frame_clone(const ws_frame_t *frame)
+{
+    if (!frame || frame->segments || !frame->data) {
+        return NULL;
+    }
+    ws_frame_t *copy = (ws_frame_t *)malloc(sizeof(*copy) + frame->len);
+    if (!copy) {
+        return NULL;
+    }
+    atomic_init(&copy->refcount, 1);
+    copy->kind = frame->kind;
+    copy->encoding = frame->encoding;
+    copy->pooled = false;
+    copy->capacity = frame->len;
+    copy->storage = (char *)(copy + 1);
+    copy->data = copy->storage;
+    copy->len = frame->len;
+    copy->payload_len = frame->payload_len;
+    copy->seq = frame->seq;
+    copy->built_us = 0;
+    copy->segments = NULL;
+    copy->segments_tail = NULL;
+    memcpy(copy->data, frame->data, frame->len);
+    return copy;
+}
+
+bool ws_manager_frame_append(void *ctx, const char *data, size_t len)
+{
+    ws_frame_t *frame = (ws_frame_t *)ctx;
+    if (!frame || (len > 0 && !data)) {
+        return false;
+    }
+    while (len > 0) {
+        ws_frame_segment_t *tail = frame->segments_tail;
+        if (!tail || tail->len == sizeof(tail->data)) {
+            tail = (ws_frame_segment_t *)malloc(sizeof(*tail));
+            if (!tail) {
+                return false;
+            }
+            tail->next = NULL;
+            tail->len = 0;
+            if (frame->segments_tail) {
+                frame->segments_tail->next = tail;
+            } else {
+                frame->segments = tail;
+            }
+            frame->segments_tail = tail;
+        }
+        size_t chunk = sizeof(tail->data) - tail->len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(tail->data + tail->len, data, chunk);
+        tail->len += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+char *ws_manager_frame_payload(ws_frame_t *frame)
+{
+    return frame ? frame->storage + WS_ENVELOPE_HEADER_RESERVE : NULL;
+}
+
+size_t ws_manager_frame_payload_capacity(const ws_frame_t *frame)
+{
+    /* Leave room for the closing envelope brace. */
+    return frame ? (frame->capacity - WS_ENVELOPE_HEADER_RESERVE - 1) : 0;
+}
+
+void ws_manager_frame_retain(ws_frame_t *frame)
+{
+    if (!frame) {
+        return;
+    }
+    atomic_fetch_add_explicit(&frame->refcount, 1u, memory_order_relaxed);
+}
+
+void ws_manager_frame_release(ws_frame_t *frame)
+{
+    if (!frame) {
+        return;
+    }
+    if (atomic_fetch_sub_explicit(&frame->refcount, 1u, memory_order_acq_rel) == 1u && !frame->pooled) {
+        ws_frame_segment_t *segment = frame->segments;
+        while (segment) {
+            ws_frame_segment_t *next = segment->next;
+            free(segment);
+            segment = next;
+        }
+        free(frame);
+    }
+}
+
+static ws_frame_t **ws_client_slot(ws_client_t *client, uint8_t pos)
+{
+    return &client->queue[(client->queue_head + pos) % WS_CLIENT_QUEUE_DEPTH];
+}
+
+static void ws_client_remove_at(ws_client_t *client, uint8_t pos)
+{
+    ws_manager_frame_release(*ws_client_slot(client, pos));
+    for (uint8_t i = pos; i + 1 < client->queue_len; i++) {
+        *ws_client_slot(client, i) = *ws_client_slot(client, (uint8_t)(i + 1));
+    }
+    client->queue_len--;
+    *ws_client_slot(client, client->queue_len) = NULL;
+}
+
+void ws_manager_client_reset_locked(ws_client_t *client, int fd)
+{
+    if (!client) {
+        return;
+    }
+    while (client->queue_len > 0) {
+        ws_manager_client_pop_locked(client);
+    }
+    memset(client, 0, sizeof(*client));
+    client->fd = fd;
+    client->topics = WS_TOPIC_ALL;
+}
+
+bool ws_manager_client_enqueue_locked(ws_manager_handle_t handle, ws_client_t *client, ws_frame_t *frame)
+{
+    if (!handle || !client || !frame || client->fd < 0) {
+        return true;
+    }
+
+    /* Head frame is owned by the drainer while a send is in flight or once part of it is on the wire. */
+    uint8_t first_mutable = (client->draining || client->tx_offset > 0 || client->tx_fragment_sent > 0) ? 1 : 0;
+
+    if (ws_event_kind_is_coalescible(frame->kind)) {
+        for (uint8_t i = first_mutable; i < client->queue_len; i++) {
+            ws_frame_t **slot = ws_client_slot(client, i);
+            if ((*slot)->kind == frame->kind) {
+                ws_manager_frame_release(*slot);
+                ws_manager_frame_retain(frame);
+                *slot = frame;
+                client->coalesced_frames++;
+                handle->ws_metrics.coalesced_frames_total++;
+                return true;
+            }
+        }
+    }
+
+    if (ws_event_kind_is_state(frame->kind) && client->srtt_us > WS_CLIENT_SLOW_RTT_US && client->queue_len > 0) {
+        /* High-RTT link: don't stack snapshots behind a backlog, the next tick refreshes them. */
+        client->throttled_frames++;
+        handle->ws_metrics.throttled_frames_total++;
+        return true;
+    }
+
+    if (client->queue_len == WS_CLIENT_QUEUE_DEPTH) {
+        if (ws_event_kind_is_coalescible(frame->kind)) {
+            /* State snapshots are superseded by the next tick; keep must-deliver frames queued. */
+            client->dropped_frames++;
+            handle->ws_metrics.dropped_frames_total++;
+            return true;
+        }
+        uint8_t victim = WS_CLIENT_QUEUE_DEPTH;
+        for (uint8_t i = first_mutable; i < client->queue_len; i++) {
+            if (ws_event_kind_is_coalescible((*ws_client_slot(client, i))->kind)) {
+                victim = i;
+                break;
+            }
+        }
+        if (victim == WS_CLIENT_QUEUE_DEPTH) {
+            return false;
+        }
+        ws_client_remove_at(client, victim);
+        client->dropped_frames++;
+        handle->ws_metrics.dropped_frames_total++;
+    }
+
+    ws_manager_frame_retain(frame);
+    *ws_client_slot(client, client->queue_len) = frame;
+    client->queue_len++;
+    if (client->queue_len > client->queue_depth_peak) {
+        client->queue_depth_peak = client->queue_len;
+    }
+    return true;
+}
+
+void ws_manager_client_pop_locked(ws_client_t *client)
+{
+    if (!client || client->queue_len == 0) {
+        return;
+    }
+    ws_frame_t **slot = ws_client_slot(client, 0);
+    ws_manager_frame_release(*slot);
+    *slot = NULL;
+    client->tx_offset = 0;
+    client->tx_fragment_sent = 0;
+    client->queue_head = (uint8_t)((client->queue_head + 1) % WS_CLIENT_QUEUE_DEPTH);
+    client->queue_len--;
+}
+
+void ws_manager_client_evict_locked(ws_manager_handle_t handle, ws_client_t *client)
+{
+    if (!handle || !client) {
+        return;
+    }
+    handle->ws_metrics.dropped_frames_total += (client->queue_len > 0) ? client->queue_len : 1u;
+    ws_manager_client_reset_locked(client, -1);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ws_manager.h"
+#include "ws_manager_internal.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+void ws_manager_frame_pool_init(ws_manager_handle_t handle);
+ws_frame_t *ws_manager_frame_acquire(ws_manager_handle_t handle, ws_event_kind_t kind);
+ws_frame_t *ws_manager_frame_acquire_sized(ws_manager_handle_t handle, ws_event_kind_t kind, size_t capacity);
+/* Heap frame for a JSON payload streamed through ws_manager_frame_append; its payload area is the writer window. */
+ws_frame_t *ws_manager_frame_acquire_streamed(ws_manager_handle_t handle, ws_event_kind_t kind);
+/* json_writer_sink_t for a streamed frame (ctx): appends to its segments, false when out of memory. */
+bool ws_manager_frame_append(void *ctx, const char *data, size_t len);
+/* Exact-size heap copy of a finished non-streamed frame, so cached snapshots do not pin pool buffers. */
+ws_frame_t *ws_manager_frame_clone(const ws_frame_t *frame);
+char *ws_manager_frame_payload(ws_frame_t *frame);
+size_t ws_manager_frame_payload_capacity(const ws_frame_t *frame);
+void ws_manager_frame_retain(ws_frame_t *frame);
+void ws_manager_frame_release(ws_frame_t *frame);
+const char *ws_manager_event_type_name(ws_event_kind_t kind);
+uint8_t ws_manager_event_topic(ws_event_kind_t kind);
+/* 0 when the kind has no binary schema and is always sent as JSON. */
+uint8_t ws_manager_event_cbor_schema(ws_event_kind_t kind);
+bool ws_manager_client_wants_frame(const ws_client_t *client, const ws_frame_t *frame);
+
+/* *_locked helpers must be called with ws_mutex held. */
+void ws_manager_client_reset_locked(ws_client_t *client, int fd);
+bool ws_manager_client_enqueue_locked(ws_manager_handle_t handle, ws_client_t *client, ws_frame_t *frame);
+void ws_manager_client_pop_locked(ws_client_t *client);
+void ws_manager_client_evict_locked(ws_manager_handle_t handle, ws_client_t *client);
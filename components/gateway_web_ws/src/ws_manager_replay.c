@@ -0,0 +1,147 @@
+#include "ws_manager_replay.h"
+
+#include "ws_manager_json.h"
+#include "ws_manager_queue.h"
+#include "ws_manager_state.h"
+#include "ws_manager_transport.h"
+
+#include "esp_log.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "WS_REPLAY";
+
+/* `missed` names the event a failed build skipped; NULL for a resume gap. */
+static ws_frame_t *ws_build_resync(ws_manager_handle_t handle, uint32_t since, const char *missed)
+{
+    ws_frame_t *frame = ws_manager_frame_acquire(handle, WS_EVENT_RESYNC);
+    if (!frame) {
+        return NULL;
+    }
+    char *payload = ws_manager_frame_payload(frame);
+    int written = missed ? snprintf(payload, ws_manager_frame_payload_capacity(frame),
+                                    "{\"since\":%" PRIu32 ",\"missed\":\"%s\"}", since, missed)
+                         : snprintf(payload, ws_manager_frame_payload_capacity(frame), "{\"since\":%" PRIu32 "}", since);
+    if (written <= 0 || (size_t)written >= ws_manager_frame_payload_capacity(frame) ||
+        ws_manager_wrap_event_payload(handle, frame, (size_t)written) != ESP_OK) {
+        ws_manager_frame_release(frame);
+        return NULL;
+    }
+    return frame;
+}
+
+static void ws_send_resync(ws_manager_handle_t handle, int fd, uint32_t since)
+{
+    ws_frame_t *frame = ws_build_resync(handle, since, NULL);
+    if (frame) {
+        (void)ws_manager_send_frame_to_client(handle, fd, frame);
+    }
+    ws_manager_frame_release(frame);
+}
+
+void ws_manager_resync_subscribers(ws_manager_handle_t handle, ws_event_kind_t kind, ws_encoding_t encoding)
+{
+    if (!handle) {
+        return;
+    }
+    uint8_t topic = ws_manager_event_topic(kind);
+    bool any_encoding = ws_manager_event_cbor_schema(kind) == 0;
+    int fds[MAX_WS_CLIENTS];
+    int count = 0;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    uint32_t since = handle->ws_seq;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        const ws_client_t *client = &handle->ws_clients[i];
+        if (client->fd >= 0 && (client->topics & topic) && (any_encoding || client->encoding == encoding)) {
+            fds[count++] = client->fd;
+        }
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    if (count == 0) {
+        return;
+    }
+
+    ESP_LOGW(TAG, "WS %s not built, resync for %d client(s)", ws_manager_event_type_name(kind), count);
+    ws_frame_t *frame = ws_build_resync(handle, since, ws_manager_event_type_name(kind));
+    for (int i = 0; frame && i < count; i++) {
+        (void)ws_manager_send_frame_to_client(handle, fds[i], frame);
+    }
+    ws_manager_frame_release(frame);
+}
+
+static void ws_resume_note(ws_manager_handle_t handle, bool resumed, uint32_t replayed)
+{
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    if (resumed) {
+        handle->ws_metrics.replay_resumes_total++;
+        handle->ws_metrics.replay_frames_total += replayed;
+    } else {
+        handle->ws_metrics.replay_resyncs_total++;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+}
+
+bool ws_manager_resume_client(ws_manager_handle_t handle, int fd, uint32_t since)
+{
+    if (!handle) {
+        return false;
+    }
+
+    /* Every broadcast kind is a full snapshot, so the newest frame of each kind changed after
+     * since is all a resuming client needs; older frames carry nothing it would keep. */
+    ws_frame_t *frames[WS_EVENT_BROADCAST_KIND_COUNT] = {0};
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    /* since > ws_seq means the client saw a previous boot's sequence. */
+    bool covered = since <= handle->ws_seq;
+    ws_encoding_t encoding = ws_manager_client_encoding_locked(handle, fd);
+    for (int kind = 0; covered && kind < WS_EVENT_BROADCAST_KIND_COUNT; kind++) {
+        const ws_frame_t *json = handle->snapshot_frames[WS_ENCODING_JSON][kind];
+        if (!json || json->seq <= since) {
+            continue;
+        }
+        /* A CBOR twin is built only while a CBOR client listens; without the matching one, resync. */
+        ws_encoding_t cached = ws_manager_event_cbor_schema((ws_event_kind_t)kind) ? encoding : WS_ENCODING_JSON;
+        ws_frame_t *frame = handle->snapshot_frames[cached][kind];
+        if (!frame || frame->seq != json->seq) {
+            covered = false;
+            break;
+        }
+        frames[kind] = frame;
+        ws_manager_frame_retain(frame);
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+
+    uint32_t replayed = 0;
+    for (int kind = 0; kind < WS_EVENT_BROADCAST_KIND_COUNT; kind++) {
+        if (frames[kind] && covered) {
+            (void)ws_manager_send_frame_to_client(handle, fd, frames[kind]);
+            replayed++;
+        }
+        ws_manager_frame_release(frames[kind]);
+    }
+
+    if (!covered) {
+        ESP_LOGI(TAG, "WS client %d since=%" PRIu32 " not covered (seq=%" PRIu32 "), resync", fd, since, handle->ws_seq);
+        ws_send_resync(handle, fd, since);
+        ws_resume_note(handle, false, 0);
+        return false;
+    }
+
+    ESP_LOGI(TAG, "WS client %d resumed from seq %" PRIu32 " (%" PRIu32 " frames)", fd, since, replayed);
+    ws_resume_note(handle, true, replayed);
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ws_manager.h"
+#include "ws_manager_internal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Sends fd the newest cached frame of every kind that changed after `since`. Returns
+ * false after sending a `resync` frame when `since` is from another boot or the client's
+ * encoding has no matching cached frame; the caller then falls back to the full snapshot.
+ */
+bool ws_manager_resume_client(ws_manager_handle_t handle, int fd, uint32_t since);
+
+/*
+ * Sends a `resync` naming the skipped event to every client subscribed to kind in the given
+ * encoding; called when a broadcast frame could not be built, so those clients refetch it over HTTP.
+ */
+void ws_manager_resync_subscribers(ws_manager_handle_t handle, ws_event_kind_t kind, ws_encoding_t encoding);
@@ -0,0 +1,104 @@
+#include "ws_manager_rpc.h"
+
+#include "api_rpc.h"
+#include "error_ring.h"
+#include "http_error.h"
+#include "ws_manager_internal.h"
+#include "ws_manager_json.h"
+#include "ws_manager_queue.h"
+#include "ws_manager_transport.h"
+
+#include "esp_log.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+static const char *TAG = "WS_RPC";
+
+#define WS_RPC_RESULT_MAX_LEN 192
+
+static bool ws_rpc_id(const cJSON *root, uint32_t *out_id)
+{
+    const cJSON *id_item = cJSON_GetObjectItem(root, "id");
+    if (!cJSON_IsNumber(id_item) || id_item->valuedouble < 0 || id_item->valuedouble > UINT32_MAX ||
+        (double)(uint32_t)id_item->valuedouble != id_item->valuedouble) {
+        return false;
+    }
+    *out_id = (uint32_t)id_item->valuedouble;
+    return true;
+}
+
+static esp_err_t ws_rpc_reply(ws_manager_handle_t handle, int fd, bool has_id, uint32_t id, esp_err_t err,
+                              const char *result, const char *message)
+{
+    ws_frame_t *frame = ws_manager_frame_acquire(handle, WS_EVENT_RPC_RESULT);
+    if (!frame) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    char id_text[12] = "null";
+    if (has_id) {
+        snprintf(id_text, sizeof(id_text), "%" PRIu32, id);
+    }
+    char *payload = ws_manager_frame_payload(frame);
+    size_t capacity = ws_manager_frame_payload_capacity(frame);
+    int written;
+    if (err == ESP_OK) {
+        written = snprintf(payload, capacity, "{\"id\":%s,\"ok\":true,\"result\":%s}", id_text, result);
+    } else {
+        /* Same error codes as the REST envelope, plus one for methods the dispatcher doesn't know. */
+        const char *code = (err == ESP_ERR_NOT_SUPPORTED) ? "unknown_method" : http_error_code_name(err);
+        written = snprintf(payload, capacity, "{\"id\":%s,\"ok\":false,\"error\":{\"code\":\"%s\",\"message\":\"%s\"}}",
+                           id_text, code, message ? message : "Request failed");
+    }
+
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (written > 0 && (size_t)written < capacity) {
+        ret = ws_manager_wrap_event_payload(handle, frame, (size_t)written);
+    }
+    if (ret == ESP_OK) {
+        ret = ws_manager_send_frame_to_client(handle, fd, frame);
+    }
+    ws_manager_frame_release(frame);
+    return ret;
+}
+
+esp_err_t ws_manager_handle_rpc(ws_manager_handle_t handle, int fd, const cJSON *root)
+{
+    if (!handle || !root) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t id = 0;
+    bool has_id = ws_rpc_id(root, &id);
+    const cJSON *method_item = cJSON_GetObjectItem(root, "method");
+    const cJSON *params = cJSON_GetObjectItem(root, "params");
+    char result[WS_RPC_RESULT_MAX_LEN];
+    const char *message = NULL;
+    esp_err_t err;
+    if (!has_id || !cJSON_IsString(method_item) || !method_item->valuestring) {
+        err = ESP_ERR_INVALID_ARG;
+        message = "Missing id or method";
+    } else {
+        err = api_rpc_dispatch(handle->api_usecases, method_item->valuestring, params, result, sizeof(result),
+                               &message);
+    }
+
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    handle->ws_metrics.rpc_requests_total++;
+    if (err != ESP_OK) {
+        handle->ws_metrics.rpc_errors_total++;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "WS client %d RPC %s failed: %s", fd,
+                 cJSON_IsString(method_item) ? method_item->valuestring : "?", esp_err_to_name(err));
+        gateway_error_ring_add("ws", (int32_t)err, message ? message : "rpc failed");
+    }
+    return ws_rpc_reply(handle, fd, has_id, id, err, result, message);
+}
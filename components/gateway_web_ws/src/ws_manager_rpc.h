@@ -0,0 +1,8 @@
+#pragma once
+
+#include "cJSON.h"
+#include "esp_err.h"
+#include "ws_manager.h"
+
+/* Executes {"id","method","params"} from fd and queues the correlated rpc_result to the same client. */
+esp_err_t ws_manager_handle_rpc(ws_manager_handle_t handle, int fd, const cJSON *root);
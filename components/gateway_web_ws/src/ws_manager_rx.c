@@ -0,0 +1,126 @@
+#include "ws_manager_rx.h"
+
+#include "cJSON.h"
+#include "ws_manager_internal.h"
+#include "ws_manager_json.h"
+#include "ws_manager_queue.h"
+#include "ws_manager_rpc.h"
+#include "ws_manager_state.h"
+#include "ws_manager_transport.h"
+
+#include "esp_log.h"
+
+#include <string.h>
+
+static const char *TAG = "WS_RX";
+
+typedef struct {
+    const char *name;
+    uint8_t bit;
+} ws_topic_name_t;
+
+static const ws_topic_name_t s_ws_topic_names[] = {
+    {"devices", WS_TOPIC_DEVICES},
+    {"health", WS_TOPIC_HEALTH},
+    {"lqi", WS_TOPIC_LQI},
+};
+
+static uint8_t ws_topics_from_json(const cJSON *topics_item)
+{
+    if (!topics_item) {
+        return WS_TOPIC_ALL;
+    }
+    if (!cJSON_IsArray(topics_item)) {
+        return 0;
+    }
+    uint8_t mask = 0;
+    const cJSON *entry = NULL;
+    cJSON_ArrayForEach(entry, topics_item) {
+        if (!cJSON_IsString(entry) || !entry->valuestring) {
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(s_ws_topic_names) / sizeof(s_ws_topic_names[0]); i++) {
+            if (strcmp(entry->valuestring, s_ws_topic_names[i].name) == 0) {
+                mask |= s_ws_topic_names[i].bit;
+            }
+        }
+    }
+    return mask;
+}
+
+static bool ws_append_bytes(char **cursor, size_t *remaining, const char *text, size_t len)
+{
+    if (len >= *remaining) {
+        return false;
+    }
+    memcpy(*cursor, text, len);
+    *cursor += len;
+    *remaining -= len;
+    return true;
+}
+
+static esp_err_t ws_send_subscription_state(ws_manager_handle_t handle, int fd, uint8_t topics)
+{
+    ws_frame_t *frame = ws_manager_frame_acquire(handle, WS_EVENT_SUBSCRIPTION);
+    if (!frame) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    char *payload = ws_manager_frame_payload(frame);
+    char *cursor = payload;
+    size_t remaining = ws_manager_frame_payload_capacity(frame);
+    bool ok = ws_append_bytes(&cursor, &remaining, "{\"topics\":[", 11);
+    bool first = true;
+    for (size_t i = 0; ok && i < sizeof(s_ws_topic_names) / sizeof(s_ws_topic_names[0]); i++) {
+        if ((topics & s_ws_topic_names[i].bit) == 0) {
+            continue;
+        }
+        ok = (first || ws_append_bytes(&cursor, &remaining, ",", 1)) &&
+             ws_append_bytes(&cursor, &remaining, "\"", 1) &&
+             ws_append_bytes(&cursor, &remaining, s_ws_topic_names[i].name, strlen(s_ws_topic_names[i].name)) &&
+             ws_append_bytes(&cursor, &remaining, "\"", 1);
+        first = false;
+    }
+    ok = ok && ws_append_bytes(&cursor, &remaining, "]}", 2);
+
+    esp_err_t ret = ok ? ws_manager_wrap_event_payload(handle, frame, (size_t)(cursor - payload)) : ESP_ERR_NO_MEM;
+    if (ret == ESP_OK) {
+        ret = ws_manager_send_frame_to_client(handle, fd, frame);
+    }
+    ws_manager_frame_release(frame);
+    return ret;
+}
+
+esp_err_t ws_manager_handle_text_message(ws_manager_handle_t handle, int fd, const char *msg, size_t len)
+{
+    if (!handle || !msg || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    cJSON *root = cJSON_ParseWithLength(msg, len);
+    if (!root) {
+        ESP_LOGD(TAG, "Ignoring non-JSON WS message from fd %d", fd);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+    cJSON *type_item = cJSON_GetObjectItem(root, "type");
+    if (cJSON_GetObjectItem(root, "method")) {
+        ret = ws_manager_handle_rpc(handle, fd, root);
+    } else if (cJSON_IsString(type_item) && type_item->valuestring) {
+        bool subscribe = (strcmp(type_item->valuestring, "subscribe") == 0);
+        bool unsubscribe = (strcmp(type_item->valuestring, "unsubscribe") == 0);
+        if (subscribe || unsubscribe) {
+            uint8_t requested = ws_topics_from_json(cJSON_GetObjectItem(root, "topics"));
+            uint8_t topics = 0;
+            if (ws_manager_update_client_topics(handle, fd, requested, subscribe, &topics)) {
+                ESP_LOGI(TAG, "WS client %d topics=0x%02x", fd, (unsigned)topics);
+                ret = ws_send_subscription_state(handle, fd, topics);
+            } else {
+                ret = ESP_ERR_NOT_FOUND;
+            }
+        }
+    }
+    cJSON_Delete(root);
+    return ret;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "esp_err.h"
+#include "ws_manager.h"
+
+#include <stddef.h>
+
+esp_err_t ws_manager_handle_text_message(ws_manager_handle_t handle, int fd, const char *msg, size_t len);
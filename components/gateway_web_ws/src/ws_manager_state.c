@@ -1,6 +1,7 @@
 #include "ws_manager_state.h"
 
 #include "ws_manager_internal.h"
+#include "ws_manager_queue.h"
 
 #include <string.h>
 
@@ -13,6 +14,24 @@ bool ws_manager_metrics_provider(ws_manager_handle_t handle, api_ws_runtime_metr
         xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
     }
     *out_metrics = handle->ws_metrics;
+    out_metrics->broadcast_requests_total = atomic_load_explicit(&handle->broadcast_requests, memory_order_relaxed);
+    out_metrics->client_count = 0;
+    for (int i = 0; i < MAX_WS_CLIENTS && out_metrics->client_count < API_WS_METRICS_MAX_CLIENTS; i++) {
+        const ws_client_t *client = &handle->ws_clients[i];
+        if (client->fd < 0) {
+            continue;
+        }
+        api_ws_client_metrics_t *out_client = &out_metrics->clients[out_metrics->client_count++];
+        out_client->fd = client->fd;
+        out_client->queue_depth = client->queue_len;
+        out_client->queue_depth_peak = client->queue_depth_peak;
+        out_client->dropped_frames = client->dropped_frames;
+        out_client->coalesced_frames = client->coalesced_frames;
+        out_client->throttled_frames = client->throttled_frames;
+        out_client->srtt_us = client->srtt_us;
+        out_client->missed_pongs = client->missed_pongs;
+        out_client->binary = (client->encoding == WS_ENCODING_CBOR);
+    }
     if (handle->ws_mutex) {
         xSemaphoreGive(handle->ws_mutex);
     }
@@ -45,7 +64,7 @@ int ws_manager_get_client_count_with_handle(ws_manager_handle_t handle)
         xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
     }
     for (int i = 0; i < MAX_WS_CLIENTS; i++) {
-        if (handle->ws_fds[i] != -1) {
+        if (handle->ws_clients[i].fd != -1) {
             count++;
         }
     }
@@ -88,14 +107,14 @@ bool ws_manager_add_fd(ws_manager_handle_t handle, int fd)
         xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
     }
     for (int i = 0; i < MAX_WS_CLIENTS; i++) {
-        if (handle->ws_fds[i] == fd) {
+        if (handle->ws_clients[i].fd == fd) {
             added = true;
             break;
         }
     }
     for (int i = 0; i < MAX_WS_CLIENTS && !added; i++) {
-        if (handle->ws_fds[i] == -1) {
-            handle->ws_fds[i] = fd;
+        if (handle->ws_clients[i].fd == -1) {
+            ws_manager_client_reset_locked(&handle->ws_clients[i], fd);
             added = true;
             break;
         }
@@ -116,8 +135,8 @@ void ws_manager_remove_fd_internal(ws_manager_handle_t handle, int fd)
         xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
     }
     for (int i = 0; i < MAX_WS_CLIENTS; i++) {
-        if (handle->ws_fds[i] == fd) {
-            handle->ws_fds[i] = -1;
+        if (handle->ws_clients[i].fd == fd) {
+            ws_manager_client_reset_locked(&handle->ws_clients[i], -1);
             break;
         }
     }
@@ -161,16 +180,106 @@ void ws_manager_inc_dropped_frames(ws_manager_handle_t handle)
     }
 }
 
-void ws_manager_inc_lock_skips(ws_manager_handle_t handle)
+uint8_t ws_manager_subscribed_topics(ws_manager_handle_t handle)
 {
     if (!handle) {
-        return;
+        return 0;
+    }
+    uint8_t topics = 0;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (handle->ws_clients[i].fd != -1) {
+            topics |= handle->ws_clients[i].topics;
+        }
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    return topics;
+}
+
+uint8_t ws_manager_encoding_topics(ws_manager_handle_t handle, ws_encoding_t encoding)
+{
+    if (!handle) {
+        return 0;
     }
+    uint8_t topics = 0;
     if (handle->ws_mutex) {
         xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
     }
-    handle->ws_metrics.broadcast_lock_skips_total++;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (handle->ws_clients[i].fd != -1 && handle->ws_clients[i].encoding == encoding) {
+            topics |= handle->ws_clients[i].topics;
+        }
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    return topics;
+}
+
+bool ws_manager_set_client_encoding(ws_manager_handle_t handle, int fd, ws_encoding_t encoding)
+{
+    if (!handle || encoding >= WS_ENCODING_COUNT) {
+        return false;
+    }
+    bool found = false;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (handle->ws_clients[i].fd == fd) {
+            handle->ws_clients[i].encoding = encoding;
+            found = true;
+            break;
+        }
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    return found;
+}
+
+ws_encoding_t ws_manager_client_encoding_locked(ws_manager_handle_t handle, int fd)
+{
+    for (int i = 0; handle && i < MAX_WS_CLIENTS; i++) {
+        if (handle->ws_clients[i].fd == fd) {
+            return handle->ws_clients[i].encoding;
+        }
+    }
+    return WS_ENCODING_JSON;
+}
+
+bool ws_manager_update_client_topics(ws_manager_handle_t handle, int fd, uint8_t topics, bool subscribe,
+                                     uint8_t *out_topics)
+{
+    if (!handle) {
+        return false;
+    }
+    bool found = false;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        ws_client_t *client = &handle->ws_clients[i];
+        if (client->fd != fd) {
+            continue;
+        }
+        if (subscribe) {
+            client->topics |= (uint8_t)(topics & WS_TOPIC_ALL);
+        } else {
+            client->topics &= (uint8_t)~topics;
+        }
+        if (out_topics) {
+            *out_topics = client->topics;
+        }
+        found = true;
+        break;
+    }
     if (handle->ws_mutex) {
         xSemaphoreGive(handle->ws_mutex);
     }
+    return found;
 }
@@ -2,6 +2,7 @@
 
 #include "api_usecases.h"
 #include "ws_manager.h"
+#include "ws_manager_internal.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -14,4 +15,12 @@ bool ws_manager_add_fd(ws_manager_handle_t handle, int fd);
 void ws_manager_remove_fd_internal(ws_manager_handle_t handle, int fd);
 void ws_manager_note_connection(ws_manager_handle_t handle);
 void ws_manager_inc_dropped_frames(ws_manager_handle_t handle);
-void ws_manager_inc_lock_skips(ws_manager_handle_t handle);
+bool ws_manager_send_initial_snapshot(ws_manager_handle_t handle, int fd);
+void ws_manager_snapshot_clear(ws_manager_handle_t handle);
+uint8_t ws_manager_subscribed_topics(ws_manager_handle_t handle);
+uint8_t ws_manager_encoding_topics(ws_manager_handle_t handle, ws_encoding_t encoding);
+bool ws_manager_set_client_encoding(ws_manager_handle_t handle, int fd, ws_encoding_t encoding);
+/* Must be called with ws_mutex held; unknown fds read as JSON. */
+ws_encoding_t ws_manager_client_encoding_locked(ws_manager_handle_t handle, int fd);
+bool ws_manager_update_client_topics(ws_manager_handle_t handle, int fd, uint8_t topics, bool subscribe,
+                                     uint8_t *out_topics);
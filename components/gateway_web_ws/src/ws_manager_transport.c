@@ -2,18 +2,18 @@
 
 #include "error_ring.h"
 #include "ws_manager_internal.h"
-#include "ws_manager_state.h"
+#include "ws_manager_latency.h"
+#include "ws_manager_queue.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include <string.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 static const char *TAG = "WS_TRANSPORT";
 
-static esp_err_t ws_manager_transport_send_frame_async(ws_manager_handle_t handle, httpd_handle_t hd, int fd,
-                                                       httpd_ws_frame_t *frame);
-
 #if CONFIG_GATEWAY_SELF_TEST_APP
 static esp_err_t ws_default_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame)
 {
@@ -44,53 +44,377 @@ static int ws_default_close_socket(int fd)
 {
     return close(fd);
 }
+
+static esp_err_t ws_default_req_get_url_query(httpd_req_t *req, char *buf, size_t buf_len)
+{
+    return httpd_req_get_url_query_str(req, buf, buf_len);
+}
 #endif
 
-esp_err_t ws_manager_send_frame_to_clients(ws_manager_handle_t handle, const char *json, size_t json_len)
+static httpd_ws_type_t ws_frame_opcode(const ws_frame_t *frame)
 {
-    if (!handle || !json || json_len == 0 || !handle->server) {
-        return ESP_ERR_INVALID_ARG;
+    switch (frame->kind) {
+    case WS_EVENT_PING:
+        return HTTPD_WS_TYPE_PING;
+    case WS_EVENT_PONG:
+        return HTTPD_WS_TYPE_PONG;
+    case WS_EVENT_CLOSE:
+        return HTTPD_WS_TYPE_CLOSE;
+    default:
+        return (frame->encoding == WS_ENCODING_CBOR) ? HTTPD_WS_TYPE_BINARY : HTTPD_WS_TYPE_TEXT;
+    }
+}
+
+void ws_manager_transport_trigger_close(ws_manager_handle_t handle, int fd)
+{
+#if CONFIG_GATEWAY_SELF_TEST_APP
+    (void)handle;
+    (void)fd;
+#else
+    if (handle && handle->server) {
+        (void)httpd_sess_trigger_close(handle->server, fd);
+    }
+#endif
+}
+
+typedef struct {
+    httpd_ws_type_t type;
+    const uint8_t *payload;
+    size_t len;
+    bool final;
+    bool fragmented;
+} ws_fragment_t;
+
+typedef enum {
+    WS_WRITE_DONE = 0,
+    WS_WRITE_BLOCKED, /* socket buffer full; the rest goes out on a later flush */
+    WS_WRITE_FAILED,
+} ws_write_result_t;
+
+typedef enum {
+    WS_DRAIN_IDLE = 0,
+    WS_DRAIN_PROGRESS,
+    WS_DRAIN_BLOCKED,
+} ws_drain_result_t;
+
+_Static_assert(WS_FRAGMENT_LEN <= UINT16_MAX - 4, "WS fragment and its header must fit tx_fragment_sent");
+
+/* A streamed frame goes out as its envelope header, then one CONTINUATION fragment per segment. */
+static void ws_next_streamed_fragment(const ws_frame_t *frame, size_t offset, ws_fragment_t *out)
+{
+    out->fragmented = true;
+    if (offset < frame->len) {
+        out->type = ws_frame_opcode(frame);
+        out->final = false;
+        out->payload = (const uint8_t *)frame->data + offset;
+        out->len = frame->len - offset;
+        return;
+    }
+    /* Segments are sent whole, so offset always lands on a segment boundary. */
+    size_t start = frame->len;
+    const ws_frame_segment_t *segment = frame->segments;
+    while (segment->next && start + segment->len <= offset) {
+        start += segment->len;
+        segment = segment->next;
+    }
+    out->type = HTTPD_WS_TYPE_CONTINUE;
+    out->final = (segment->next == NULL);
+    out->payload = (const uint8_t *)segment->data + (offset - start);
+    out->len = segment->len - (offset - start);
+}
+
+/* Control frames and short messages go out whole; longer ones as TEXT/BINARY + CONTINUATION fragments. */
+static void ws_next_fragment(const ws_frame_t *frame, size_t offset, ws_fragment_t *out)
+{
+    if (frame->segments) {
+        ws_next_streamed_fragment(frame, offset, out);
+        return;
     }
+    httpd_ws_type_t opcode = ws_frame_opcode(frame);
+    bool data_frame = (opcode == HTTPD_WS_TYPE_TEXT || opcode == HTTPD_WS_TYPE_BINARY);
+    size_t chunk = frame->len - offset;
+    out->fragmented = data_frame && frame->len > WS_FRAGMENT_LEN;
+    if (out->fragmented && chunk > WS_FRAGMENT_LEN) {
+        chunk = WS_FRAGMENT_LEN;
+    }
+    out->type = (offset == 0) ? opcode : HTTPD_WS_TYPE_CONTINUE;
+    out->final = (offset + chunk == frame->len);
+    out->payload = (const uint8_t *)frame->data + offset;
+    out->len = chunk;
+}
 
+#if CONFIG_GATEWAY_SELF_TEST_APP
+/* The test transport takes whole fragments; NO_MEM and TIMEOUT stand in for a full socket buffer. */
+static ws_write_result_t ws_write_fragment(ws_manager_handle_t handle, int fd, const ws_fragment_t *fragment,
+                                           uint16_t *io_sent, esp_err_t *out_err)
+{
     httpd_ws_frame_t ws_pkt;
     memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
-    ws_pkt.payload = (uint8_t *)json;
-    ws_pkt.len = json_len;
-    ws_pkt.type = HTTPD_WS_TYPE_TEXT;
+    ws_pkt.type = fragment->type;
+    ws_pkt.final = fragment->final;
+    ws_pkt.fragmented = fragment->fragmented;
+    ws_pkt.payload = (uint8_t *)fragment->payload;
+    ws_pkt.len = fragment->len;
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (handle->ws_transport_ops.send_frame_async) {
+        ret = handle->ws_transport_ops.send_frame_async(handle->server, fd, &ws_pkt);
+    }
+    *out_err = ret;
+    if (ret == ESP_OK) {
+        *io_sent = 0;
+        return WS_WRITE_DONE;
+    }
+    return (ret == ESP_ERR_NO_MEM || ret == ESP_ERR_TIMEOUT) ? WS_WRITE_BLOCKED : WS_WRITE_FAILED;
+}
+#else
+/*
+ * The frame header is written here rather than by httpd_ws_send_frame_async: that call blocks for the
+ * socket send timeout and reports every failure as ESP_FAIL without saying how much reached the socket,
+ * so a slow client could neither be skipped nor resumed. With MSG_DONTWAIT a full buffer comes back as
+ * HTTPD_SOCK_ERR_TIMEOUT and *io_sent records exactly where to continue.
+ */
+static ws_write_result_t ws_write_fragment(ws_manager_handle_t handle, int fd, const ws_fragment_t *fragment,
+                                           uint16_t *io_sent, esp_err_t *out_err)
+{
+    uint8_t header[4];
+    size_t header_len = 2;
+    header[0] = (uint8_t)((fragment->final ? 0x80 : 0x00) | ((uint8_t)fragment->type & 0x0F));
+    if (fragment->len < 126) {
+        header[1] = (uint8_t)fragment->len;
+    } else {
+        header[1] = 126;
+        header[2] = (uint8_t)(fragment->len >> 8);
+        header[3] = (uint8_t)fragment->len;
+        header_len = 4;
+    }
+    size_t total = header_len + fragment->len;
+    while (*io_sent < total) {
+        const uint8_t *src = (*io_sent < header_len) ? header + *io_sent : fragment->payload + (*io_sent - header_len);
+        size_t left = (*io_sent < header_len) ? header_len - *io_sent : total - *io_sent;
+        int written = httpd_socket_send(handle->server, fd, (const char *)src, left, MSG_DONTWAIT);
+        if (written == HTTPD_SOCK_ERR_TIMEOUT) {
+            *out_err = ESP_ERR_TIMEOUT;
+            return WS_WRITE_BLOCKED;
+        }
+        if (written <= 0) {
+            /* HTTPD_SOCK_ERR_INVALID: the session is gone; HTTPD_SOCK_ERR_FAIL: the socket is broken. */
+            *out_err = (written == HTTPD_SOCK_ERR_INVALID) ? ESP_ERR_INVALID_ARG : ESP_FAIL;
+            return WS_WRITE_FAILED;
+        }
+        *io_sent = (uint16_t)(*io_sent + (size_t)written);
+    }
+    *io_sent = 0;
+    return WS_WRITE_DONE;
+}
+#endif
 
+/* Lets the broadcaster task try blocked clients again after WS_FLUSH_RETRY_MS. */
+static void ws_manager_request_flush_retry(ws_manager_handle_t handle)
+{
+    TaskHandle_t task = handle->broadcaster_task;
+    if (atomic_exchange(&handle->flush_retry, true) || !task) {
+        return;
+    }
+    /* The broadcaster picks the flag up before its next wait; only other tasks need to wake it. */
+    if (xTaskGetCurrentTaskHandle() != task) {
+        (void)xTaskNotify(task, WS_NOTIFY_FLUSH, eSetBits);
+    }
+}
+
+/* Writes at most one fragment of the client's head frame and never waits for socket space. */
+static ws_drain_result_t ws_manager_drain_step(ws_manager_handle_t handle, int slot)
+{
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    ws_client_t *client = &handle->ws_clients[slot];
+    if (client->fd < 0 || client->draining || client->queue_len == 0) {
+        if (handle->ws_mutex) {
+            xSemaphoreGive(handle->ws_mutex);
+        }
+        return WS_DRAIN_IDLE;
+    }
+    int fd = client->fd;
+    ws_frame_t *frame = client->queue[client->queue_head];
+    size_t offset = client->tx_offset;
+    uint16_t sent = client->tx_fragment_sent;
+    ws_manager_frame_retain(frame);
+    client->draining = true;
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+
+    ws_fragment_t fragment;
+    ws_next_fragment(frame, offset, &fragment);
+    esp_err_t err = ESP_OK;
+    ws_write_result_t written = ws_write_fragment(handle, fd, &fragment, &sent, &err);
+
+    ws_drain_result_t result = WS_DRAIN_IDLE;
+    bool evicted = false;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    if (client->fd != fd) {
+        /* Slot was released (close_fn/CLOSE frame) while the send was in flight. */
+        if (handle->ws_mutex) {
+            xSemaphoreGive(handle->ws_mutex);
+        }
+        ws_manager_frame_release(frame);
+        return WS_DRAIN_IDLE;
+    }
+    client->draining = false;
+    switch (written) {
+    case WS_WRITE_DONE:
+        if (fragment.final) {
+            ws_manager_latency_wire_locked(handle, frame, esp_timer_get_time());
+            ws_manager_client_pop_locked(client);
+        } else {
+            client->tx_offset = offset + fragment.len;
+            client->tx_fragment_sent = 0;
+        }
+        result = WS_DRAIN_PROGRESS;
+        break;
+    case WS_WRITE_BLOCKED:
+        client->tx_fragment_sent = sent;
+        result = WS_DRAIN_BLOCKED;
+        break;
+    default:
+        ws_manager_client_evict_locked(handle, client);
+        evicted = true;
+        break;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+    ws_manager_frame_release(frame);
+
+    if (evicted) {
+        /* A half-written frame leaves the stream unusable, and an evicted client gets no more frames. */
+        ESP_LOGW(TAG, "WS send failed (%s), removing client %d", esp_err_to_name(err), fd);
+        gateway_error_ring_add("ws", (int32_t)err, "ws send failed");
+        ws_manager_transport_trigger_close(handle, fd);
+    }
+    return result;
+}
+
+static void ws_manager_flush_client(ws_manager_handle_t handle, int slot)
+{
+    ws_drain_result_t result;
+    do {
+        result = ws_manager_drain_step(handle, slot);
+    } while (result == WS_DRAIN_PROGRESS);
+    if (result == WS_DRAIN_BLOCKED) {
+        ws_manager_request_flush_retry(handle);
+    }
+}
+
+/*
+ * One fragment per client per pass: a client whose socket buffer is full is skipped and retried
+ * later instead of holding up delivery to everyone else.
+ */
+void ws_manager_flush_clients(ws_manager_handle_t handle)
+{
+    if (!handle || !handle->server) {
+        return;
+    }
+    bool progress;
+    bool blocked;
+    do {
+        progress = false;
+        blocked = false;
+        for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+            ws_drain_result_t result = ws_manager_drain_step(handle, i);
+            progress = progress || result == WS_DRAIN_PROGRESS;
+            blocked = blocked || result == WS_DRAIN_BLOCKED;
+        }
+    } while (progress);
+    if (blocked) {
+        ws_manager_request_flush_retry(handle);
+    }
+}
+
+bool ws_manager_take_flush_retry(ws_manager_handle_t handle)
+{
+    return handle && atomic_exchange(&handle->flush_retry, false);
+}
+
+esp_err_t ws_manager_send_frame_to_clients(ws_manager_handle_t handle, ws_frame_t *frame)
+{
+    if (!handle || !frame || frame->len == 0 || !handle->server) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int evicted_fds[MAX_WS_CLIENTS];
+    int evicted_count = 0;
     if (handle->ws_mutex) {
         xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
     }
     for (int i = 0; i < MAX_WS_CLIENTS; i++) {
-        if (handle->ws_fds[i] != -1) {
-            esp_err_t ret = ws_manager_transport_send_frame_async(handle, handle->server, handle->ws_fds[i], &ws_pkt);
-            if (ret != ESP_OK) {
-                ESP_LOGW(TAG, "WS send failed (%s), removing client %d", esp_err_to_name(ret), handle->ws_fds[i]);
-                gateway_error_ring_add("ws", (int32_t)ret, "send_frame_async failed");
-                // ws_mutex is already held in this loop; update metric inline to avoid recursive lock.
-                handle->ws_metrics.dropped_frames_total++;
-                handle->ws_fds[i] = -1;
-            }
+        ws_client_t *client = &handle->ws_clients[i];
+        if (!ws_manager_client_wants_frame(client, frame)) {
+            continue;
+        }
+        if (!ws_manager_client_enqueue_locked(handle, client, frame)) {
+            evicted_fds[evicted_count++] = client->fd;
+            handle->ws_metrics.slow_consumer_evictions_total++;
+            ws_manager_client_evict_locked(handle, client);
         }
     }
     if (handle->ws_mutex) {
         xSemaphoreGive(handle->ws_mutex);
     }
+
+    for (int i = 0; i < evicted_count; i++) {
+        ESP_LOGW(TAG, "WS client %d queue full of %s frames, evicting slow consumer",
+                 evicted_fds[i], ws_manager_event_type_name(frame->kind));
+        gateway_error_ring_add("ws", (int32_t)ESP_ERR_NO_MEM, "slow consumer evicted");
+        ws_manager_transport_trigger_close(handle, evicted_fds[i]);
+    }
+
+    ws_manager_flush_clients(handle);
     return ESP_OK;
 }
 
-static esp_err_t ws_manager_transport_send_frame_async(ws_manager_handle_t handle, httpd_handle_t hd, int fd,
-                                                       httpd_ws_frame_t *frame)
+esp_err_t ws_manager_send_frame_to_client(ws_manager_handle_t handle, int fd, ws_frame_t *frame)
 {
-#if CONFIG_GATEWAY_SELF_TEST_APP
-    if (handle && handle->ws_transport_ops.send_frame_async) {
-        return handle->ws_transport_ops.send_frame_async(hd, fd, frame);
+    if (!handle || !frame || !frame->data || !handle->server) {
+        return ESP_ERR_INVALID_ARG;
     }
-    return ESP_ERR_INVALID_STATE;
-#else
-    (void)handle;
-    return httpd_ws_send_frame_async(hd, fd, frame);
-#endif
+
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    bool evicted = false;
+    int slot = -1;
+    if (handle->ws_mutex) {
+        xSemaphoreTake(handle->ws_mutex, portMAX_DELAY);
+    }
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        ws_client_t *client = &handle->ws_clients[i];
+        if (client->fd != fd) {
+            continue;
+        }
+        ret = ESP_OK;
+        slot = i;
+        if (!ws_manager_client_enqueue_locked(handle, client, frame)) {
+            handle->ws_metrics.slow_consumer_evictions_total++;
+            ws_manager_client_evict_locked(handle, client);
+            evicted = true;
+        }
+        break;
+    }
+    if (handle->ws_mutex) {
+        xSemaphoreGive(handle->ws_mutex);
+    }
+
+    if (evicted) {
+        ESP_LOGW(TAG, "WS client %d queue full, evicting slow consumer", fd);
+        gateway_error_ring_add("ws", (int32_t)ESP_ERR_NO_MEM, "slow consumer evicted");
+        ws_manager_transport_trigger_close(handle, fd);
+        return ESP_ERR_NO_MEM;
+    }
+    if (ret == ESP_OK) {
+        ws_manager_flush_client(handle, slot);
+    }
+    return ret;
 }
 
 int ws_manager_transport_req_to_sockfd(ws_manager_handle_t handle, httpd_req_t *req)
@@ -145,6 +469,19 @@ esp_err_t ws_manager_transport_resp_send(ws_manager_handle_t handle, httpd_req_t
 #endif
 }
 
+esp_err_t ws_manager_transport_req_get_query(ws_manager_handle_t handle, httpd_req_t *req, char *buf, size_t buf_len)
+{
+#if CONFIG_GATEWAY_SELF_TEST_APP
+    if (handle && handle->ws_transport_ops.req_get_url_query) {
+        return handle->ws_transport_ops.req_get_url_query(req, buf, buf_len);
+    }
+    return ESP_ERR_NOT_FOUND;
+#else
+    (void)handle;
+    return httpd_req_get_url_query_str(req, buf, buf_len);
+#endif
+}
+
 void ws_manager_transport_close_socket(ws_manager_handle_t handle, int fd)
 {
 #if CONFIG_GATEWAY_SELF_TEST_APP
@@ -176,5 +513,6 @@ void ws_manager_reset_transport_ops_for_test_with_handle(ws_manager_handle_t han
     handle->ws_transport_ops.resp_set_status = ws_default_resp_set_status;
     handle->ws_transport_ops.resp_send = ws_default_resp_send;
     handle->ws_transport_ops.close_socket = ws_default_close_socket;
+    handle->ws_transport_ops.req_get_url_query = ws_default_req_get_url_query;
 }
 #endif
@@ -3,14 +3,22 @@
 #include "esp_err.h"
 #include "esp_http_server.h"
 #include "ws_manager.h"
+#include "ws_manager_internal.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <sys/types.h>
 
-esp_err_t ws_manager_send_frame_to_clients(ws_manager_handle_t handle, const char *json, size_t json_len);
+esp_err_t ws_manager_send_frame_to_clients(ws_manager_handle_t handle, ws_frame_t *frame);
+esp_err_t ws_manager_send_frame_to_client(ws_manager_handle_t handle, int fd, ws_frame_t *frame);
+void ws_manager_flush_clients(ws_manager_handle_t handle);
+/* Clears and returns the request to flush clients whose socket buffer was full. */
+bool ws_manager_take_flush_retry(ws_manager_handle_t handle);
 int ws_manager_transport_req_to_sockfd(ws_manager_handle_t handle, httpd_req_t *req);
 esp_err_t ws_manager_transport_recv_frame(ws_manager_handle_t handle, httpd_req_t *req, httpd_ws_frame_t *pkt,
                                           size_t max_len);
 esp_err_t ws_manager_transport_resp_set_status(ws_manager_handle_t handle, httpd_req_t *req, const char *status);
 esp_err_t ws_manager_transport_resp_send(ws_manager_handle_t handle, httpd_req_t *req, const char *buf, ssize_t buf_len);
+esp_err_t ws_manager_transport_req_get_query(ws_manager_handle_t handle, httpd_req_t *req, char *buf, size_t buf_len);
+void ws_manager_transport_trigger_close(ws_manager_handle_t handle, int fd);
 void ws_manager_transport_close_socket(ws_manager_handle_t handle, int fd);
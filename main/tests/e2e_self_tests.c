@@ -278,6 +278,82 @@ static void test_e2e_endpoint_control_service_error_propagates(void)
     api_usecases_set_service_ops_with_handle(s_api_usecases, NULL);
 }
 
+static void test_e2e_control_batch_contract_and_usecase(void)
+{
+    api_control_batch_t batch;
+    esp_err_t parse_ret = api_parse_control_batch_json(
+        "[{\"addr\":18842,\"ep\":1,\"cmd\":1},{\"addr\":0,\"ep\":1,\"cmd\":1},\"x\",{\"addr\":4660,\"ep\":2,\"cmd\":0}]",
+        &batch);
+    TEST_ASSERT_EQUAL(ESP_OK, parse_ret);
+    TEST_ASSERT_EQUAL(4, batch.count);
+    TEST_ASSERT_EQUAL(ESP_OK, batch.results[0]);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, batch.results[1]);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, batch.results[2]);
+    TEST_ASSERT_EQUAL(ESP_OK, batch.results[3]);
+
+    reset_api_mocks();
+    const api_service_ops_t mock_ops = make_mock_ops();
+    api_usecases_set_service_ops_with_handle(s_api_usecases, &mock_ops);
+
+    TEST_ASSERT_EQUAL(ESP_OK, api_usecase_control_batch(s_api_usecases, &batch));
+    TEST_ASSERT_EQUAL_INT(2, s_mock_send_on_off_called);
+    TEST_ASSERT_EQUAL_UINT16(4660, s_mock_send_on_off_addr);
+    TEST_ASSERT_EQUAL_UINT8(2, s_mock_send_on_off_ep);
+    TEST_ASSERT_EQUAL_UINT8(0, s_mock_send_on_off_cmd);
+    TEST_ASSERT_EQUAL(ESP_OK, batch.results[0]);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, batch.results[1]);
+
+    api_usecases_set_service_ops_with_handle(s_api_usecases, NULL);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_control_batch_json("[]", &batch));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_control_batch_json("{\"addr\":1,\"ep\":1,\"cmd\":1}", &batch));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_control_batch_json("[{\"addr\":1,\"ep\":1,\"cmd\":1},]", &batch));
+
+    char oversized[API_CONTROL_BATCH_MAX * 8 + 16];
+    size_t used = 0;
+    oversized[used++] = '[';
+    for (int i = 0; i <= API_CONTROL_BATCH_MAX; i++) {
+        if (i > 0) {
+            oversized[used++] = ',';
+        }
+        memcpy(oversized + used, "{}", 2);
+        used += 2;
+    }
+    oversized[used++] = ']';
+    oversized[used] = '\0';
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_control_batch_json(oversized, &batch));
+}
+
+static void test_e2e_group_contracts(void)
+{
+    api_group_create_request_t create = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_parse_group_create_json("{\"name\":\"Kitchen\"}", &create));
+    TEST_ASSERT_EQUAL_STRING("Kitchen", create.name);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_group_create_json("{\"name\":\"\"}", &create));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG,
+                      api_parse_group_create_json("{\"name\":\"0123456789abcdef0123456789abcdef\"}", &create));
+
+    api_group_member_request_t member = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_parse_group_member_json("{\"group_id\":3,\"addr\":4660,\"ep\":1}", &member));
+    TEST_ASSERT_EQUAL_UINT16(3, member.group_id);
+    TEST_ASSERT_EQUAL_UINT16(4660, member.addr);
+    TEST_ASSERT_EQUAL_UINT8(1, member.ep);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_group_member_json("{\"group_id\":3,\"addr\":4660}", &member));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_group_member_json("{\"group_id\":3,\"addr\":0,\"ep\":1}", &member));
+
+    api_group_control_request_t control = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_parse_group_control_json("{\"group_id\":65527,\"cmd\":0}", &control));
+    TEST_ASSERT_EQUAL_UINT16(API_GROUP_ID_MAX, control.group_id);
+    TEST_ASSERT_EQUAL_UINT8(0, control.cmd);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_group_control_json("{\"group_id\":65528,\"cmd\":1}", &control));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_group_control_json("{\"group_id\":1,\"cmd\":2}", &control));
+
+    api_group_delete_request_t del = {0};
+    TEST_ASSERT_EQUAL(ESP_OK, api_parse_group_delete_json("{\"group_id\":1}", &del));
+    TEST_ASSERT_EQUAL_UINT16(1, del.group_id);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, api_parse_group_delete_json("{\"group_id\":0}", &del));
+}
+
 static void test_e2e_wifi_settings_contract_and_usecase(void)
 {
     api_wifi_save_request_t req = {0};
@@ -504,6 +580,8 @@ void zgw_register_e2e_self_tests(void)
     RUN_TEST(test_e2e_control_contract_and_usecase);
     RUN_TEST(test_e2e_endpoint_control_invalid_json_rejected);
     RUN_TEST(test_e2e_endpoint_control_service_error_propagates);
+    RUN_TEST(test_e2e_control_batch_contract_and_usecase);
+    RUN_TEST(test_e2e_group_contracts);
     RUN_TEST(test_e2e_wifi_settings_contract_and_usecase);
     RUN_TEST(test_e2e_endpoint_wifi_settings_invalid_json_rejected);
     RUN_TEST(test_e2e_endpoint_wifi_settings_reboot_failure_propagates);
@@ -32,6 +32,10 @@ let wsReconnectTimer = null;
 let wsConnected = false;
 let lqiAutoRefreshInFlight = false;
 let lqiLastRefreshStartedAtMs = 0;
+const WS_RPC_TIMEOUT_MS = 5000;
+let wsSocket = null;
+let wsRpcNextId = 1;
+const wsRpcPending = new Map();
 
 function apiUrl(path) {
     return API_BASE + path;
@@ -184,6 +188,46 @@ async function submitJob(jobType, extraPayload = {}, options = {}) {
     throw new Error('Job timeout');
 }
 
+/**
+ * Command call over the open WS (RPC); rpc_result replies are matched by id.
+ * @param {string} method - control, rename, delete, permit_join, jobs.submit
+ * @param {object} params - the same fields as the matching REST request body
+ */
+function wsRpc(method, params) {
+    if (!wsConnected || !wsSocket || wsSocket.readyState !== WebSocket.OPEN) {
+        return Promise.reject(new Error('WS not connected'));
+    }
+    const id = wsRpcNextId++;
+    return new Promise((resolve, reject) => {
+        const timer = setTimeout(() => {
+            wsRpcPending.delete(id);
+            reject(new Error('WS RPC timeout'));
+        }, WS_RPC_TIMEOUT_MS);
+        wsRpcPending.set(id, { resolve, reject, timer });
+        wsSocket.send(JSON.stringify({ id, method, params }));
+    });
+}
+
+function settleWsRpc(reply) {
+    const pending = wsRpcPending.get(reply.id);
+    if (!pending) return;
+    wsRpcPending.delete(reply.id);
+    clearTimeout(pending.timer);
+    if (reply.ok) {
+        pending.resolve(reply.result);
+    } else {
+        pending.reject(new Error((reply.error && reply.error.message) || 'RPC error'));
+    }
+}
+
+function failPendingWsRpc() {
+    wsRpcPending.forEach((pending) => {
+        clearTimeout(pending.timer);
+        pending.reject(new Error('WS disconnected'));
+    });
+    wsRpcPending.clear();
+}
+
 /**
  * Ініціалізація WebSocket з'єднання
  */
@@ -200,12 +244,14 @@ function scheduleWsReconnect() {
 
 function initWebSocket() {
     const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
-    const wsUrl = `${protocol}//${window.location.host}/ws`;
+    // Resume from the last seen seq so the gateway replays only missed frames.
+    const resumeQuery = lastWsSeq > 0 ? `?since=${lastWsSeq}` : '';
+    const wsUrl = `${protocol}//${window.location.host}/ws${resumeQuery}`;
     const ws = new WebSocket(wsUrl);
+    wsSocket = ws;
 
     ws.onopen = () => {
         console.log('WS Connected');
-        lastWsSeq = 0;
         wsRetryAttempt = 0;
         if (wsReconnectTimer) {
             clearTimeout(wsReconnectTimer);
@@ -228,6 +274,25 @@ function initWebSocket() {
         if (data && data.status === 'ok' && data.data && typeof data.data === 'object') {
             data = data.data;
         }
+        if (data && data.type === 'rpc_result' && data.data) {
+            // Addressed to this client only; it does not advance the seq stream.
+            settleWsRpc(data.data);
+            return;
+        }
+        if (data && data.type === 'resync') {
+            // Gap too large to replay: the full snapshot that follows carries older seqs.
+            lastWsSeq = 0;
+            // The gateway could not build this event at all; fetch it over HTTP instead.
+            const missed = data.data && data.data.missed;
+            if (missed === 'devices_delta') {
+                fetchStatus();
+            } else if (missed === 'health_state') {
+                fetchHealth();
+            } else if (missed === 'lqi_update') {
+                fetchLqiMap();
+            }
+            return;
+        }
         if (data && Number.isFinite(data.seq)) {
             if (data.seq <= lastWsSeq) {
                 return;
@@ -279,6 +344,8 @@ function initWebSocket() {
         });
         updateConnectionStatus(false);
         wsConnected = false;
+        if (wsSocket === ws) wsSocket = null;
+        failPendingWsRpc();
         scheduleWsReconnect();
     };
 }
@@ -507,15 +574,20 @@ function renderDevices(devices) {
         const addrHex = '0x' + dev.short_addr.toString(16).toUpperCase().padStart(4, '0');
         const rawName = (dev.name || 'Пристрій').trim();
         const displayName = rawName.replace(/\s*0x[0-9a-fA-F]{1,4}\s*$/i, '').trim() || 'Пристрій';
+        // on_off comes from device reports; null means not known yet
+        const stateText = dev.on_off === 1 ? ' · ON' : (dev.on_off === 0 ? ' · OFF' : '');
+        // ep and model come from the interview; endpoint 1 is used until it finishes
+        const ep = dev.ep || 1;
+        const modelText = dev.model ? ' · ' + escapeHtml(dev.model) : '';
 
         li.innerHTML = `
             <div class="dev-info">
                 <strong>${displayName}</strong>
-                <small>Addr: ${addrHex}</small>
+                <small>Addr: ${addrHex}${stateText}${modelText}</small>
             </div>
             <div class="dev-actions">
-                <button class="btn-on" onclick="controlDevice(${dev.short_addr}, 1, 1)">${ICONS.on} ON</button>
-                <button class="btn-off" onclick="controlDevice(${dev.short_addr}, 1, 0)">${ICONS.off} OFF</button>
+                <button class="btn-on" onclick="controlDevice(${dev.short_addr}, ${ep}, 1)">${ICONS.on} ON</button>
+                <button class="btn-off" onclick="controlDevice(${dev.short_addr}, ${ep}, 0)">${ICONS.off} OFF</button>
                 <button class="btn-edit" onclick="openEditModal(${dev.short_addr}, '${displayName.replace(/'/g, "\\'")}')">${ICONS.edit}</button>
                 <button class="btn-del" onclick="deleteDevice(${dev.short_addr})">${ICONS.delete}</button>
             </div>
@@ -970,6 +1042,11 @@ function permitJoin() {
  * @param {number} ep - Endpoint (зазвичай 1)
  * @param {number} cmd - 1 (On) або 0 (Off)
  */
+// Device-supplied strings (the Basic model) must not reach innerHTML unescaped
+function escapeHtml(text) {
+    return String(text).replace(/[&<>"']/g, ch => ({ '&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;', "'": '&#39;' })[ch]);
+}
+
 function controlDevice(addr, ep, cmd) {
     const payload = {
         addr: addr,
@@ -977,11 +1054,13 @@ function controlDevice(addr, ep, cmd) {
         cmd: cmd
     };
 
-    requestJson(apiUrl('/control'), {
+    // Over an open WS the command skips a new HTTP request; REST stays as the fallback.
+    const viaWs = wsConnected ? wsRpc('control', payload) : Promise.reject(new Error('WS not connected'));
+    viaWs.catch(() => requestJson(apiUrl('/control'), {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify(payload)
-    })
+    }))
     .then(resp => {
         console.log('Control response:', resp);
     })
@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "api_contracts.h"
+#include "cJSON.h"
+
+#define BENCH_ITERATIONS 200000
+#define BENCH_ROUNDS 5
+
+typedef esp_err_t (*bench_parser_t)(const char *body);
+
+static size_t s_allocations;
+
+int httpd_req_recv(httpd_req_t *req, char *buf, size_t buf_len)
+{
+    (void)req;
+    (void)buf;
+    (void)buf_len;
+    return -1;
+}
+
+static void *bench_malloc(size_t size)
+{
+    s_allocations++;
+    return malloc(size);
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static esp_err_t reader_control(const char *body)
+{
+    api_control_request_t req;
+    return api_parse_control_json(body, &req);
+}
+
+/* The pre-json_reader HTTP path: build the tree, read three or four fields, free the tree. */
+static esp_err_t cjson_control(const char *body)
+{
+    api_control_request_t req;
+    cJSON *root = cJSON_Parse(body);
+    esp_err_t ret = root ? api_parse_control_params(root, &req) : ESP_ERR_INVALID_ARG;
+    cJSON_Delete(root);
+    return ret;
+}
+
+static esp_err_t reader_rename(const char *body)
+{
+    api_rename_request_t req;
+    return api_parse_rename_json(body, &req);
+}
+
+static esp_err_t cjson_rename(const char *body)
+{
+    api_rename_request_t req;
+    cJSON *root = cJSON_Parse(body);
+    esp_err_t ret = root ? api_parse_rename_params(root, &req) : ESP_ERR_INVALID_ARG;
+    cJSON_Delete(root);
+    return ret;
+}
+
+static esp_err_t reader_job(const char *body)
+{
+    api_job_submit_request_t req;
+    return api_parse_job_submit_json(body, &req);
+}
+
+static esp_err_t cjson_job(const char *body)
+{
+    api_job_submit_request_t req;
+    cJSON *root = cJSON_Parse(body);
+    esp_err_t ret = root ? api_parse_job_submit_params(root, &req) : ESP_ERR_INVALID_ARG;
+    cJSON_Delete(root);
+    return ret;
+}
+
+static void bench_parser(const char *name, bench_parser_t parser, const char *body)
+{
+    s_allocations = 0;
+    assert(parser(body) == ESP_OK);
+    size_t allocations = s_allocations;
+
+    /* Best of several rounds filters scheduler noise on a shared host. */
+    uint64_t best_ns = UINT64_MAX;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t start_ns = bench_now_ns();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            parser(body);
+        }
+        uint64_t elapsed_ns = bench_now_ns() - start_ns;
+        if (elapsed_ns < best_ns) {
+            best_ns = elapsed_ns;
+        }
+    }
+    printf("%-14s %4zu bytes %8.1f ns/body %3zu allocs/body\n", name, strlen(body),
+           (double)best_ns / BENCH_ITERATIONS, allocations);
+}
+
+int main(void)
+{
+    cJSON_Hooks hooks = {.malloc_fn = bench_malloc, .free_fn = free};
+    cJSON_InitHooks(&hooks);
+
+    const char *control = "{\"addr\":4660,\"ep\":1,\"cmd\":2,\"confirm\":true}";
+    const char *rename = "{\"short_addr\":4660,\"name\":\"Kitchen \\\"lamp\\\" \\u2116 2\"}";
+    const char *job = "{\"type\":\"reboot\",\"reboot_delay_ms\":2500}";
+
+    bench_parser("control", reader_control, control);
+    bench_parser("control cJSON", cjson_control, control);
+    bench_parser("rename", reader_rename, rename);
+    bench_parser("rename cJSON", cjson_rename, rename);
+    bench_parser("jobs", reader_job, job);
+    bench_parser("jobs cJSON", cjson_job, job);
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "api_contracts.h"
+#include "cJSON.h"
+#include "json_reader.h"
+
+/*
+ * Differential test: the HTTP body parsers (json_reader) against the cJSON path that WS RPC params still use.
+ * Built only when cJSON sources are available (see tools/run_host_tests.sh).
+ */
+
+#define DIFF_MUTATIONS_PER_SEED 2000
+#define DIFF_BODY_MAX 160
+
+static const char *const k_seeds[] = {
+    "{\"addr\":1,\"ep\":1,\"cmd\":0}",
+    " {\"ADDR\":513 , \"Ep\":11,\"cmd\":1} trailing",
+    "\xEF\xBB\xBF{\"addr\":1.9,\"ep\":1e1,\"cmd\":-0}",
+    "{\"addr\":1,\"addr\":2,\"ep\":3,\"cmd\":1}",
+    "{\"addr\":\"1\",\"ep\":1,\"cmd\":1}",
+    "{\"addr\":1,\"ep\":1}",
+    "{\"addr\":99999999999,\"ep\":1,\"cmd\":1}",
+    "{\"addr\":-99999999999,\"ep\":1,\"cmd\":1}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,}",
+    "{\"addr\":01,\"ep\":-.5,\"cmd\":1.}",
+    "{\"addr\":65535,\"ep\":240,\"cmd\":2,\"confirm\":true}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,\"Confirm\":false}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,\"confirm\":1}",
+    "{\"addr\":1,\"ep\":1,\"cmd\":1,\"confirm\":null}",
+    "{\"short_addr\":4660}",
+    "{\"short_addr\":4660,\"extra\":{\"a\":[1,{\"b\":null}],\"c\":true}}",
+    "{\"short_addr\":4660,\"deep\":[[[[[[1]]]]]]}",
+    "{\"short_addr\":null}",
+    "{\"short_addr\":4660,\"name\":\"Lamp\"}",
+    "{\"short_addr\":4660,\"name\":\"\\u041b\\u0430\\u043c\\u043f\\u0430 \\ud83d\\udca1\"}",
+    "{\"short_addr\":4660,\"name\":\"a\\\"b\\\\c\\/d\\n\\t\\b\\f\\r\"}",
+    "{\"short_addr\":4660,\"name\":\"x\\u0000y\"}",
+    "{\"short_addr\":4660,\"name\":\"\\udc00\"}",
+    "{\"short_addr\":4660,\"name\":\"AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\"}",
+    "{\"short_addr\":4660,\"name\":\"AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA\"}",
+    "{\"short_addr\":4660,\"name\":\"\"}",
+    "{\"type\":\"scan\"}",
+    "{\"type\":\"reboot\",\"reboot_delay_ms\":2500}",
+    "{\"type\":\"reboot\",\"reboot_delay_ms\":60001}",
+    "{\"type\":\"reboot\",\"reboot_delay_ms\":\"5\"}",
+    "{\"type\":\"lqi_refresh\"}",
+    "{\"type\":\"topology_crawl\"}",
+    "{\"type\":\"factory_reset\"}",
+    "{\"type\":\"update\"}",
+    "{\"type\":\"updatE\"}",
+    "{\"type\":\"lqi_refresx\"}",
+    "{\"type\":1}",
+    "[]",
+    "",
+    "{",
+    "{\"addr\":1 \"ep\":1}",
+};
+
+#define SEED_COUNT (sizeof(k_seeds) / sizeof(k_seeds[0]))
+
+/* Bytes that change JSON structure, numbers, literals and escapes; the rest of a mutation is plain text. */
+static const char k_alphabet[] = "{}[]\":,\\ \t0123456789.eE+-tfnrulsaxu_AZ\x7f\xc3\xa9";
+
+static size_t s_bodies_checked;
+static size_t s_bodies_accepted;
+
+/* The body parsers do not touch the request buffer (httpd is not exercised here). */
+int httpd_req_recv(httpd_req_t *req, char *buf, size_t buf_len)
+{
+    (void)req;
+    (void)buf;
+    (void)buf_len;
+    return -1;
+}
+
+static uint32_t next_random(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static int cjson_depth(const cJSON *item)
+{
+    int deepest = 0;
+    for (const cJSON *child = item ? item->child : NULL; child; child = child->next) {
+        int depth = cjson_depth(child);
+        if (depth > deepest) {
+            deepest = depth;
+        }
+    }
+    return (cJSON_IsObject(item) || cJSON_IsArray(item)) ? deepest + 1 : 0;
+}
+
+static void fail(const char *parser, const char *body, esp_err_t ref, esp_err_t got)
+{
+    fprintf(stderr, "%s differs from cJSON path (ref %d, got %d) on body:\n  ", parser, (int)ref, (int)got);
+    for (const unsigned char *p = (const unsigned char *)body; *p; p++) {
+        fprintf(stderr, (*p >= 0x20 && *p < 0x7f) ? "%c" : "\\x%02x", *p);
+    }
+    fprintf(stderr, "\n");
+    assert(0);
+}
+
+/* Output structs are only defined on success, so they are compared only then. */
+#define CHECK_PARSER(type, json_fn, params_fn)                                                                    \
+    do {                                                                                                          \
+        type a;                                                                                                   \
+        type b;                                                                                                   \
+        memset(&a, 0, sizeof(a));                                                                                 \
+        memset(&b, 0, sizeof(b));                                                                                 \
+        esp_err_t ref = (root && !too_deep) ? params_fn(root, &b) : ESP_ERR_INVALID_ARG;                          \
+        esp_err_t got = json_fn(body, &a);                                                                        \
+        if (ref != got || (ref == ESP_OK && memcmp(&a, &b, sizeof(a)) != 0)) {                                    \
+            fail(#json_fn, body, ref, got);                                                                       \
+        }                                                                                                         \
+        accepted = accepted || ref == ESP_OK;                                                                     \
+    } while (0)
+
+static void check_body(const char *body)
+{
+    cJSON *root = cJSON_Parse(body);
+    /* The only intended difference: json_reader caps nesting, cJSON goes much deeper. */
+    bool too_deep = root && cjson_depth(root) > JSON_READER_MAX_DEPTH;
+    bool accepted = false;
+
+    CHECK_PARSER(api_control_request_t, api_parse_control_json, api_parse_control_params);
+    CHECK_PARSER(api_delete_request_t, api_parse_delete_json, api_parse_delete_params);
+    CHECK_PARSER(api_rename_request_t, api_parse_rename_json, api_parse_rename_params);
+    CHECK_PARSER(api_job_submit_request_t, api_parse_job_submit_json, api_parse_job_submit_params);
+
+    cJSON_Delete(root);
+    s_bodies_checked++;
+    s_bodies_accepted += accepted ? 1 : 0;
+}
+
+static void mutate(const char *seed, uint32_t *rng, char *out)
+{
+    size_t len = strlen(seed);
+    memcpy(out, seed, len + 1);
+    unsigned edits = 1 + next_random(rng) % 3;
+    for (unsigned e = 0; e < edits; e++) {
+        size_t pos = len ? next_random(rng) % (len + 1) : 0;
+        char byte = k_alphabet[next_random(rng) % (sizeof(k_alphabet) - 1)];
+        switch (next_random(rng) % 4) {
+        case 0: /* replace */
+            if (pos < len) {
+                out[pos] = byte;
+            }
+            break;
+        case 1: /* insert */
+            if (len + 1 < DIFF_BODY_MAX) {
+                memmove(out + pos + 1, out + pos, len - pos + 1);
+                out[pos] = byte;
+                len++;
+            }
+            break;
+        case 2: /* delete */
+            if (pos < len) {
+                memmove(out + pos, out + pos + 1, len - pos);
+                len--;
+            }
+            break;
+        default: /* duplicate a run, which repeats keys and nests containers */
+            if (pos < len) {
+                size_t run = 1 + next_random(rng) % 8;
+                if (run > len - pos) {
+                    run = len - pos;
+                }
+                if (len + run < DIFF_BODY_MAX) {
+                    memmove(out + pos + run, out + pos, len - pos + 1);
+                    len += run;
+                }
+            }
+            break;
+        }
+    }
+}
+
+static void test_seed_corpus_matches(void)
+{
+    for (size_t i = 0; i < SEED_COUNT; i++) {
+        check_body(k_seeds[i]);
+    }
+}
+
+static void test_mutated_corpus_matches(void)
+{
+    uint32_t rng = 0x5eed041u;
+    char body[DIFF_BODY_MAX + 8];
+    for (size_t i = 0; i < SEED_COUNT; i++) {
+        for (int m = 0; m < DIFF_MUTATIONS_PER_SEED; m++) {
+            mutate(k_seeds[i], &rng, body);
+            check_body(body);
+        }
+    }
+    /* A corpus that the validators reject wholesale would prove nothing about the accepted values. */
+    assert(s_bodies_accepted * 20 > s_bodies_checked);
+}
+
+int main(void)
+{
+    printf("Running host tests: api_contracts_cjson_diff_host_test\n");
+
+    test_seed_corpus_matches();
+    test_mutated_corpus_matches();
+
+    printf("Host tests passed: api_contracts_cjson_diff_host_test (%zu bodies, %zu accepted)\n", s_bodies_checked,
+           s_bodies_accepted);
+    return 0;
+}
@@ -38,7 +38,7 @@ static bool metrics_provider(api_ws_provider_ctx_t *ctx, api_ws_runtime_metrics_
     out_metrics->connections_total = *(const uint32_t *)(const void *)ctx;
     out_metrics->reconnect_count = 1;
     out_metrics->dropped_frames_total = 2;
-    out_metrics->broadcast_lock_skips_total = 3;
+    out_metrics->broadcast_ticks_total = 3;
     return true;
 }
 
@@ -63,7 +63,7 @@ int main(void)
     assert(metrics.connections_total == 17u);
     assert(metrics.reconnect_count == 1u);
     assert(metrics.dropped_frames_total == 2u);
-    assert(metrics.broadcast_lock_skips_total == 3u);
+    assert(metrics.broadcast_ticks_total == 3u);
 
     printf("Host tests passed: api_usecases_ctx_host_test\n");
     return 0;
@@ -31,6 +31,16 @@ typedef struct {
     uint8_t facade_send_endpoint;
     uint8_t facade_send_on_off;
     esp_err_t facade_send_ret;
+    int facade_confirmed_calls;
+    uint32_t facade_confirmed_timeout_ms;
+    esp_err_t facade_confirmed_ret;
+    int facade_batch_calls;
+    size_t facade_batch_count;
+    zigbee_on_off_cmd_t facade_batch_cmds[API_CONTROL_BATCH_MAX];
+    int facade_group_calls;
+    uint16_t facade_group_id;
+    uint16_t facade_group_addr;
+    uint8_t facade_group_arg;
 
     gateway_core_factory_reset_report_t facade_factory_reset_report;
     esp_err_t facade_get_factory_report_ret;
@@ -64,6 +74,7 @@ static void reset_stub(void)
     g_stub.inj_schedule_reboot_ret = ESP_OK;
     g_stub.inj_factory_reset_ret = ESP_OK;
     g_stub.facade_send_ret = ESP_OK;
+    g_stub.facade_confirmed_ret = ESP_OK;
     g_stub.facade_get_factory_report_ret = ESP_OK;
     g_stub.facade_factory_reset_report.wifi_err = ESP_OK;
     g_stub.facade_factory_reset_report.devices_err = ESP_OK;
@@ -129,6 +140,18 @@ esp_err_t gateway_device_zigbee_send_on_off(zigbee_service_handle_t handle, uint
     return g_stub.facade_send_ret;
 }
 
+esp_err_t gateway_device_zigbee_send_on_off_confirmed(zigbee_service_handle_t handle, uint16_t short_addr,
+                                                      uint8_t endpoint, uint8_t on_off, uint32_t timeout_ms)
+{
+    (void)handle;
+    g_stub.facade_confirmed_calls++;
+    g_stub.facade_confirmed_timeout_ms = timeout_ms;
+    g_stub.facade_send_short_addr = short_addr;
+    g_stub.facade_send_endpoint = endpoint;
+    g_stub.facade_send_on_off = on_off;
+    return g_stub.facade_confirmed_ret;
+}
+
 esp_err_t gateway_wifi_system_create(const gateway_wifi_system_init_params_t *params, gateway_wifi_system_handle_t *out_handle)
 {
     (void)params;
@@ -212,6 +235,28 @@ esp_err_t gateway_device_zigbee_get_cached_lqi_snapshot(zigbee_service_handle_t
     return ESP_OK;
 }
 
+esp_err_t gateway_device_zigbee_send_on_off_batch(zigbee_service_handle_t handle, const zigbee_on_off_cmd_t *cmds,
+                                                  size_t count, esp_err_t *out_results)
+{
+    (void)handle;
+    g_stub.facade_batch_calls++;
+    g_stub.facade_batch_count = count;
+    for (size_t i = 0; i < count; i++) {
+        g_stub.facade_batch_cmds[i] = cmds[i];
+        out_results[i] = cmds[i].endpoint == 9 ? ESP_ERR_TIMEOUT : ESP_OK;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gateway_device_zigbee_get_state_generation(zigbee_service_handle_t handle, zigbee_state_generation_t *out_generation)
+{
+    (void)handle;
+    if (out_generation) {
+        *out_generation = (zigbee_state_generation_t){0};
+    }
+    return ESP_OK;
+}
+
 esp_err_t gateway_device_zigbee_permit_join(zigbee_service_handle_t handle, uint8_t duration_seconds)
 {
     (void)handle;
@@ -234,6 +279,120 @@ esp_err_t gateway_device_zigbee_rename_device(zigbee_service_handle_t handle, ui
     return ESP_OK;
 }
 
+esp_err_t gateway_device_zigbee_group_create(zigbee_service_handle_t handle, const char *name, uint16_t *out_group_id)
+{
+    (void)handle;
+    (void)name;
+    g_stub.facade_group_calls++;
+    *out_group_id = 1;
+    return ESP_OK;
+}
+
+esp_err_t gateway_device_zigbee_group_delete(zigbee_service_handle_t handle, uint16_t group_id)
+{
+    (void)handle;
+    g_stub.facade_group_calls++;
+    g_stub.facade_group_id = group_id;
+    return ESP_OK;
+}
+
+esp_err_t gateway_device_zigbee_group_add_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                                 uint8_t endpoint)
+{
+    (void)handle;
+    g_stub.facade_group_calls++;
+    g_stub.facade_group_id = group_id;
+    g_stub.facade_group_addr = short_addr;
+    g_stub.facade_group_arg = endpoint;
+    return ESP_OK;
+}
+
+esp_err_t gateway_device_zigbee_group_remove_member(zigbee_service_handle_t handle, uint16_t group_id, uint16_t short_addr,
+                                                    uint8_t endpoint)
+{
+    (void)handle;
+    g_stub.facade_group_calls++;
+    g_stub.facade_group_id = group_id;
+    g_stub.facade_group_addr = short_addr;
+    g_stub.facade_group_arg = endpoint;
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t gateway_device_zigbee_group_send_on_off(zigbee_service_handle_t handle, uint16_t group_id, uint8_t on_off)
+{
+    (void)handle;
+    g_stub.facade_group_calls++;
+    g_stub.facade_group_id = group_id;
+    g_stub.facade_group_arg = on_off;
+    return ESP_OK;
+}
+
+int gateway_device_zigbee_get_cmd_stats_snapshot(zigbee_service_handle_t handle, gateway_cmd_stats_t *out_stats,
+                                                  int max_stats)
+{
+    (void)handle;
+    (void)out_stats;
+    (void)max_stats;
+    return 0;
+}
+
+esp_err_t gateway_device_zigbee_get_topology_summary(zigbee_service_handle_t handle, gateway_topology_summary_t *out)
+{
+    (void)handle;
+    (void)out;
+    return ESP_ERR_INVALID_STATE;
+}
+
+int gateway_device_zigbee_get_topology_nodes(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                             gateway_topology_node_t *out, size_t max_items)
+{
+    (void)handle;
+    (void)crawl_id;
+    (void)from;
+    (void)out;
+    (void)max_items;
+    return -1;
+}
+
+int gateway_device_zigbee_get_topology_edges(zigbee_service_handle_t handle, uint32_t crawl_id, size_t from,
+                                             gateway_topology_edge_t *out, size_t max_items)
+{
+    (void)handle;
+    (void)crawl_id;
+    (void)from;
+    (void)out;
+    (void)max_items;
+    return -1;
+}
+
+int gateway_device_zigbee_get_attr_snapshot(zigbee_service_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                            gateway_attr_entry_t *out_attrs, int max_attrs)
+{
+    (void)handle;
+    (void)cluster_id;
+    (void)attr_id;
+    (void)out_attrs;
+    (void)max_attrs;
+    return 0;
+}
+
+int gateway_device_zigbee_get_device_profiles(zigbee_service_handle_t handle, gateway_device_profile_t *out_profiles,
+                                              int max_profiles)
+{
+    (void)handle;
+    (void)out_profiles;
+    (void)max_profiles;
+    return 0;
+}
+
+int gateway_device_zigbee_get_groups_snapshot(zigbee_service_handle_t handle, zigbee_group_t *out_groups, int max_groups)
+{
+    (void)handle;
+    (void)out_groups;
+    (void)max_groups;
+    return 0;
+}
+
 esp_err_t gateway_wifi_system_scan(gateway_wifi_system_handle_t handle, wifi_ap_info_t **out_list, size_t *out_count)
 {
     (void)handle;
@@ -347,6 +506,17 @@ esp_err_t gateway_wifi_system_get_wifi_state(gateway_wifi_system_handle_t handle
     return ESP_OK;
 }
 
+esp_err_t gateway_wifi_system_get_zigbee_event_stats(gateway_wifi_system_handle_t handle,
+                                                     gateway_zigbee_event_stats_t *out_stats)
+{
+    (void)handle;
+    if (!out_stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out_stats, 0, sizeof(*out_stats));
+    return ESP_OK;
+}
+
 esp_err_t gateway_wifi_system_get_schema_version(gateway_wifi_system_handle_t handle, int32_t *out_version)
 {
     (void)handle;
@@ -448,6 +618,74 @@ static void test_default_ops_fallback_uses_facade(void)
     assert(g_stub.facade_send_on_off == 0);
 }
 
+static void test_confirmed_control_waits_through_facade(void)
+{
+    reset_stub();
+    api_usecases_set_service_ops_with_handle(g_api_usecases, NULL);
+
+    g_stub.facade_confirmed_ret = ESP_ERR_TIMEOUT;
+    api_control_request_t req = {.addr = 0x3333, .ep = 1, .cmd = 1, .confirm = true};
+    assert(api_usecase_control(g_api_usecases, &req) == ESP_ERR_TIMEOUT);
+    assert(g_stub.facade_confirmed_calls == 1 && g_stub.facade_send_calls == 0);
+    assert(g_stub.facade_confirmed_timeout_ms == API_CONTROL_CONFIRM_TIMEOUT_MS);
+    assert(g_stub.facade_send_short_addr == 0x3333 && g_stub.facade_send_on_off == 1);
+}
+
+static void test_control_batch_dispatches_valid_items_once(void)
+{
+    reset_stub();
+    api_usecases_set_service_ops_with_handle(g_api_usecases, NULL);
+
+    api_control_batch_t batch = {
+        .count = 4,
+        .items = {{.addr = 0x1111, .ep = 1, .cmd = 1}, {0}, {.addr = 0x3333, .ep = 9, .cmd = 0}, {.addr = 0x4444, .ep = 2, .cmd = 1}},
+        .results = {ESP_OK, ESP_ERR_INVALID_ARG, ESP_OK, ESP_OK},
+    };
+    assert(api_usecase_control_batch(g_api_usecases, &batch) == ESP_OK);
+    assert(g_stub.facade_batch_calls == 1);
+    assert(g_stub.facade_send_calls == 0);
+    assert(g_stub.facade_batch_count == 3);
+    assert(g_stub.facade_batch_cmds[0].short_addr == 0x1111);
+    assert(g_stub.facade_batch_cmds[1].short_addr == 0x3333 && g_stub.facade_batch_cmds[1].on_off == 0);
+    assert(g_stub.facade_batch_cmds[2].short_addr == 0x4444 && g_stub.facade_batch_cmds[2].endpoint == 2);
+    assert(batch.results[0] == ESP_OK);
+    assert(batch.results[1] == ESP_ERR_INVALID_ARG);
+    assert(batch.results[2] == ESP_ERR_TIMEOUT);
+    assert(batch.results[3] == ESP_OK);
+
+    /* Nothing valid: the Zigbee stack is not touched at all. */
+    reset_stub();
+    api_control_batch_t invalid = {.count = 1, .results = {ESP_ERR_INVALID_ARG}};
+    assert(api_usecase_control_batch(g_api_usecases, &invalid) == ESP_OK);
+    assert(g_stub.facade_batch_calls == 0);
+    assert(api_usecase_control_batch(NULL, &invalid) == ESP_ERR_INVALID_ARG);
+}
+
+static void test_group_usecases_pass_through_to_facade(void)
+{
+    reset_stub();
+    api_usecases_set_service_ops_with_handle(g_api_usecases, NULL);
+
+    api_group_control_request_t control = {.group_id = 0x0007, .cmd = 1};
+    assert(api_usecase_group_control(g_api_usecases, &control) == ESP_OK);
+    assert(g_stub.facade_group_calls == 1);
+    assert(g_stub.facade_group_id == 0x0007 && g_stub.facade_group_arg == 1);
+    /* One group-cast, never a per-member fan-out. */
+    assert(g_stub.facade_send_calls == 0 && g_stub.facade_batch_calls == 0);
+
+    api_group_member_request_t member = {.group_id = 0x0007, .addr = 0x1234, .ep = 2};
+    assert(api_usecase_group_add_member(g_api_usecases, &member) == ESP_OK);
+    assert(g_stub.facade_group_addr == 0x1234 && g_stub.facade_group_arg == 2);
+    assert(api_usecase_group_remove_member(g_api_usecases, &member) == ESP_ERR_NOT_FOUND);
+
+    api_group_create_request_t create = {.name = "Kitchen"};
+    uint16_t group_id = 0;
+    assert(api_usecase_group_create(g_api_usecases, &create, &group_id) == ESP_OK && group_id == 1);
+    assert(api_usecase_group_create(g_api_usecases, &create, NULL) == ESP_ERR_INVALID_ARG);
+    assert(api_usecase_group_control(NULL, &control) == ESP_ERR_INVALID_ARG);
+    assert(g_stub.facade_group_calls == 4);
+}
+
 static void test_factory_report_mapping(void)
 {
     reset_stub();
@@ -472,6 +710,9 @@ int main(void)
     test_usecase_wifi_save_mapping();
     test_usecase_factory_reset_mapping();
     test_default_ops_fallback_uses_facade();
+    test_confirmed_control_waits_through_facade();
+    test_control_batch_dispatches_valid_items_once();
+    test_group_usecases_pass_through_to_facade();
     test_factory_report_mapping();
     api_usecases_destroy(g_api_usecases);
     g_api_usecases = NULL;
@@ -0,0 +1,89 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cbor_writer.h"
+
+static void assert_bytes(const uint8_t *buf, size_t len, const uint8_t *expected, size_t expected_len)
+{
+    assert(len == expected_len);
+    assert(memcmp(buf, expected, expected_len) == 0);
+}
+
+static void test_integers_use_shortest_argument(void)
+{
+    uint8_t buf[64];
+    uint8_t *cursor = buf;
+    size_t remaining = sizeof(buf);
+
+    assert(cbor_put_uint(&cursor, &remaining, 0));
+    assert(cbor_put_uint(&cursor, &remaining, 23));
+    assert(cbor_put_uint(&cursor, &remaining, 24));
+    assert(cbor_put_uint(&cursor, &remaining, 500));
+    assert(cbor_put_uint(&cursor, &remaining, 70000));
+    assert(cbor_put_uint(&cursor, &remaining, 0x100000000ull));
+    assert(cbor_put_int(&cursor, &remaining, -1));
+    assert(cbor_put_int(&cursor, &remaining, -60));
+    assert(cbor_put_int(&cursor, &remaining, -500));
+
+    const uint8_t expected[] = {
+        0x00,
+        0x17,
+        0x18, 0x18,
+        0x19, 0x01, 0xf4,
+        0x1a, 0x00, 0x01, 0x11, 0x70,
+        0x1b, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x20,
+        0x38, 0x3b,
+        0x39, 0x01, 0xf3,
+    };
+    assert_bytes(buf, (size_t)(cursor - buf), expected, sizeof(expected));
+    assert(remaining == sizeof(buf) - sizeof(expected));
+}
+
+static void test_text_array_and_simple_values(void)
+{
+    uint8_t buf[32];
+    uint8_t *cursor = buf;
+    size_t remaining = sizeof(buf);
+
+    assert(cbor_put_array(&cursor, &remaining, 4));
+    assert(cbor_put_text(&cursor, &remaining, "Lamp"));
+    assert(cbor_put_text(&cursor, &remaining, NULL));
+    assert(cbor_put_bool(&cursor, &remaining, true));
+    assert(cbor_put_null(&cursor, &remaining));
+
+    const uint8_t expected[] = {0x84, 0x64, 'L', 'a', 'm', 'p', 0x60, 0xf5, 0xf6};
+    assert_bytes(buf, (size_t)(cursor - buf), expected, sizeof(expected));
+}
+
+static void test_overflow_leaves_cursor_untouched(void)
+{
+    uint8_t buf[4];
+    uint8_t *cursor = buf;
+    size_t remaining = sizeof(buf);
+
+    assert(!cbor_put_uint(&cursor, &remaining, 70000));
+    assert(cursor == buf && remaining == sizeof(buf));
+    assert(!cbor_put_text(&cursor, &remaining, "Kitchen"));
+    assert(cursor == buf && remaining == sizeof(buf));
+
+    assert(cbor_put_text(&cursor, &remaining, "abc"));
+    assert(remaining == 0);
+    assert(!cbor_put_null(&cursor, &remaining));
+    assert(!cbor_put_bool(&cursor, &remaining, false));
+}
+
+int main(void)
+{
+    printf("Running host tests: cbor_writer_host_test\n");
+
+    test_integers_use_shortest_argument();
+    test_text_array_and_simple_values();
+    test_overflow_leaves_cursor_untouched();
+
+    printf("Host tests passed: cbor_writer_host_test\n");
+    return 0;
+}
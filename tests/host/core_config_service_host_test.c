@@ -137,6 +137,45 @@ esp_err_t device_repository_save(const gateway_device_record_t *devices, size_t
     return ESP_ERR_NOT_FOUND;
 }
 
+esp_err_t device_repository_load_groups(gateway_group_record_t *groups, size_t max_groups, int *group_count)
+{
+    (void)groups;
+    (void)max_groups;
+    if (!group_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *group_count = 0;
+    return ESP_OK;
+}
+
+esp_err_t device_repository_save_groups(const gateway_group_record_t *groups, size_t max_groups, int group_count)
+{
+    (void)groups;
+    (void)max_groups;
+    (void)group_count;
+    return ESP_OK;
+}
+
+esp_err_t device_repository_load_interviews(gateway_device_interview_t *records, size_t max_records, int *record_count)
+{
+    (void)records;
+    (void)max_records;
+    if (!record_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *record_count = 0;
+    return ESP_OK;
+}
+
+esp_err_t device_repository_save_interviews(const gateway_device_interview_t *records, size_t max_records,
+                                            int record_count)
+{
+    (void)records;
+    (void)max_records;
+    (void)record_count;
+    return ESP_OK;
+}
+
 esp_err_t config_repository_clear_wifi_credentials(void)
 {
     return g_stub.clear_wifi_ret;
@@ -283,6 +283,42 @@ static void test_delete_rolls_back_on_save_failure(void)
     device_service_destroy(handle);
 }
 
+static void test_generation_tracks_committed_changes_only(void)
+{
+    reset_stubs();
+
+    device_service_handle_t handle = make_service();
+    assert(device_service_get_generation(handle) == 0);
+    assert(device_service_init(handle) == GATEWAY_STATUS_OK);
+    uint32_t generation = device_service_get_generation(handle);
+    assert(generation == 1);
+
+    gateway_ieee_addr_t ieee = {0};
+    set_ieee(ieee, 0x50);
+    assert(device_service_add_with_ieee(handle, 0x3333, ieee) == GATEWAY_STATUS_OK);
+    assert(device_service_get_generation(handle) == ++generation);
+
+    /* Re-announcing the same device leaves the list untouched. */
+    assert(device_service_add_with_ieee(handle, 0x3333, ieee) == GATEWAY_STATUS_OK);
+    assert(device_service_get_generation(handle) == generation);
+
+    assert(device_service_update_name(handle, 0x3333, "Lamp") == GATEWAY_STATUS_OK);
+    assert(device_service_get_generation(handle) == ++generation);
+    assert(device_service_update_name(handle, 0x3333, "Lamp") == GATEWAY_STATUS_OK);
+    assert(device_service_get_generation(handle) == generation);
+
+    g_repo.save_status = GATEWAY_STATUS_FAIL;
+    assert(device_service_update_name(handle, 0x3333, "Other") == GATEWAY_STATUS_FAIL);
+    assert(device_service_delete(handle, 0x3333) == GATEWAY_STATUS_FAIL);
+    assert(device_service_get_generation(handle) == generation);
+
+    g_repo.save_status = GATEWAY_STATUS_OK;
+    assert(device_service_delete(handle, 0x3333) == GATEWAY_STATUS_OK);
+    assert(device_service_get_generation(handle) == ++generation);
+
+    device_service_destroy(handle);
+}
+
 int main(void)
 {
     printf("Running host tests: device_service_persistence_host_test\n");
@@ -292,6 +328,7 @@ int main(void)
     test_update_same_name_is_noop();
     test_update_rolls_back_on_save_failure();
     test_delete_rolls_back_on_save_failure();
+    test_generation_tracks_committed_changes_only();
     printf("Host tests passed: device_service_persistence_host_test\n");
     return 0;
 }
@@ -0,0 +1,151 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dto_codec.h"
+
+typedef struct {
+    bool flag;
+    uint32_t count;
+    uint64_t ts_ms;
+    int32_t delta;
+    const char *name;
+    int mode;
+    bool has_rssi;
+    int32_t rssi;
+    bool has_ip;
+    const char *ip;
+    bool has_temp;
+    float temp;
+} sample_dto_t;
+
+static const char *sample_mode_label(int mode)
+{
+    return mode == 1 ? "fast" : "slow";
+}
+
+#define SAMPLE_DTO_FIELDS(X)                          \
+    X(BOOL, "flag", v->flag, 0)                       \
+    X(U32, "count", v->count, 0)                      \
+    X(U64, "ts_ms", v->ts_ms, 0)                      \
+    X(I32, "delta", v->delta, 0)                      \
+    X(TEXT, "name", v->name, 0)                       \
+    X(ENUM, "mode", v->mode, sample_mode_label)       \
+    X(OPT_I32, "rssi", v->rssi, v->has_rssi)          \
+    X(OPT_TEXT, "ip", v->ip, v->has_ip)               \
+    X(OPT_FIXED2, "temp", v->temp, v->has_temp)
+
+DTO_DEFINE(sample_dto, sample_dto_t, SAMPLE_DTO_FIELDS)
+
+static void render_json(const sample_dto_t *dto, char *buf, size_t size, size_t *out_len)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    sample_dto_put_json(&w, dto);
+    assert(json_writer_finish(&w, out_len));
+}
+
+static void test_json_matches_table_order(void)
+{
+    sample_dto_t dto = {
+        .flag = true, .count = 42, .ts_ms = 1700000000123ull, .delta = -7, .name = "Lamp \"A\"",
+        .mode = 1, .has_rssi = true, .rssi = -61, .has_ip = true, .ip = "10.0.0.2", .has_temp = true, .temp = 41.25f,
+    };
+    char buf[256];
+    size_t len = 0;
+    render_json(&dto, buf, sizeof(buf), &len);
+    assert(strcmp(buf, "{\"flag\":true,\"count\":42,\"ts_ms\":1700000000123,\"delta\":-7,\"name\":\"Lamp \\\"A\\\"\","
+                       "\"mode\":\"fast\",\"rssi\":-61,\"ip\":\"10.0.0.2\",\"temp\":41.25}") == 0);
+    assert(len == sample_dto_json_len(&dto));
+
+    sample_dto_t empty = {.name = ""};
+    render_json(&empty, buf, sizeof(buf), &len);
+    assert(strcmp(buf, "{\"flag\":false,\"count\":0,\"ts_ms\":0,\"delta\":0,\"name\":\"\",\"mode\":\"slow\","
+                       "\"rssi\":null,\"ip\":null,\"temp\":null}") == 0);
+    assert(len == sample_dto_json_len(&empty));
+}
+
+static void test_lengths_are_exact(void)
+{
+    const uint32_t counts[] = {0, 9, 10, 99, 100, 12345, UINT32_MAX};
+    const int32_t deltas[] = {0, -1, 10, -100, INT32_MIN, INT32_MAX};
+    const char *names[] = {"", "plain", "tab\there", "\x01\x1f\\"};
+    const float temps[] = {0.0f, -3.5f, 99.994f, 99.996f, 1234.5f};
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        for (size_t j = 0; j < sizeof(deltas) / sizeof(deltas[0]); j++) {
+            for (size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++) {
+                sample_dto_t dto = {
+                    .flag = (i + j) % 2 == 0, .count = counts[i], .ts_ms = (uint64_t)counts[i] * 1000003ull,
+                    .delta = deltas[j], .name = names[k], .mode = (int)k, .has_rssi = (j % 2) == 0, .rssi = deltas[j],
+                    .has_ip = (k % 2) == 0, .ip = names[k], .has_temp = (i % 2) == 0,
+                    .temp = temps[(i + k) % (sizeof(temps) / sizeof(temps[0]))],
+                };
+                char json[512];
+                size_t json_len = 0;
+                render_json(&dto, json, sizeof(json), &json_len);
+                assert(json_len == sample_dto_json_len(&dto));
+
+                /* Exact length fits, one byte less (besides the terminator) overflows. */
+                char exact[512];
+                json_writer_t w;
+                json_writer_init(&w, exact, json_len + 1);
+                sample_dto_put_json(&w, &dto);
+                assert(json_writer_finish(&w, NULL));
+                json_writer_init(&w, exact, json_len);
+                sample_dto_put_json(&w, &dto);
+                assert(!json_writer_finish(&w, NULL));
+
+                uint8_t cbor[256];
+                uint8_t *cursor = cbor;
+                size_t remaining = sizeof(cbor);
+                assert(sample_dto_put_cbor(&cursor, &remaining, &dto));
+                assert((size_t)(cursor - cbor) == sample_dto_cbor_len(&dto));
+            }
+        }
+    }
+}
+
+static void test_cbor_is_positional_array(void)
+{
+    sample_dto_t dto = {
+        .flag = true, .count = 24, .ts_ms = 1, .delta = -1, .name = "ab", .mode = 1,
+        .has_rssi = false, .has_ip = false, .has_temp = true, .temp = 1.5f,
+    };
+    uint8_t buf[64];
+    uint8_t *cursor = buf;
+    size_t remaining = sizeof(buf);
+    assert(sample_dto_put_cbor(&cursor, &remaining, &dto));
+    const uint8_t expected[] = {
+        0x89,                         /* array(9) */
+        0xf5,                         /* true */
+        0x18, 0x18,                   /* 24 */
+        0x01,                         /* 1 */
+        0x20,                         /* -1 */
+        0x62, 'a', 'b',               /* "ab" */
+        0x01,                         /* enum code */
+        0xf6, 0xf6,                   /* absent rssi, ip */
+        0xfa, 0x3f, 0xc0, 0x00, 0x00, /* 1.5f */
+    };
+    assert((size_t)(cursor - buf) == sizeof(expected));
+    assert(memcmp(buf, expected, sizeof(expected)) == 0);
+
+    uint8_t small[8];
+    cursor = small;
+    remaining = sizeof(small);
+    assert(!sample_dto_put_cbor(&cursor, &remaining, &dto));
+}
+
+int main(void)
+{
+    printf("Running host tests: dto_codec_host_test\n");
+
+    test_json_matches_table_order();
+    test_lengths_are_exact();
+    test_cbor_is_positional_array();
+
+    printf("Host tests passed: dto_codec_host_test\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "http_response_cache.h"
+
+static void test_etag_list_matching(void)
+{
+    const char *etag = "\"1a2b3c4d-s3.7\"";
+
+    assert(http_etag_matches("\"1a2b3c4d-s3.7\"", etag));
+    assert(http_etag_matches("*", etag));
+    assert(http_etag_matches("W/\"1a2b3c4d-s3.7\"", etag));
+    assert(http_etag_matches("\"other\", \"1a2b3c4d-s3.7\"", etag));
+    assert(http_etag_matches("\"other\",\t\"1a2b3c4d-s3.7\" ", etag));
+
+    assert(!http_etag_matches("", etag));
+    assert(!http_etag_matches("\"1a2b3c4d-s3.8\"", etag));
+    assert(!http_etag_matches("\"1a2b3c4d-s3.7", etag));
+    assert(!http_etag_matches("\"1a2b3c4d-s3.7\"x", etag));
+    assert(!http_etag_matches("**", etag));
+    assert(!http_etag_matches(NULL, etag));
+    assert(!http_etag_matches("*", ""));
+}
+
+static void fill_slot(http_response_cache_t *cache, http_response_cache_slot_t slot, const char *body, const char *etag)
+{
+    http_response_cache_entry_t *entry = http_response_cache_fill_begin(cache, slot);
+    assert(entry);
+    size_t len = strlen(body);
+    size_t half = len / 2;
+    assert(http_response_cache_fill_sink(entry, body, half));
+    assert(http_response_cache_fill_sink(entry, body + half, len - half));
+    http_response_cache_fill_commit(entry, etag);
+}
+
+static void test_fill_and_lookup_by_etag(void)
+{
+    http_response_cache_t cache = {0};
+    const char *body = "{\"status\":\"ok\",\"data\":{\"devices\":[]}}";
+
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_STATUS, "\"a\""));
+    fill_slot(&cache, HTTP_RESPONSE_CACHE_STATUS, body, "\"a\"");
+
+    const http_response_cache_entry_t *hit = http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_STATUS, "\"a\"");
+    assert(hit);
+    assert(hit->len == strlen(body));
+    assert(memcmp(hit->body, body, hit->len) == 0);
+
+    /* A new generation or another slot never sees the old body. */
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_STATUS, "\"b\""));
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_LQI, "\"a\""));
+
+    http_response_cache_release(&cache);
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_STATUS, "\"a\""));
+}
+
+static void test_refill_invalidates_until_commit(void)
+{
+    http_response_cache_t cache = {0};
+    fill_slot(&cache, HTTP_RESPONSE_CACHE_LQI, "{\"v\":1}", "\"a\"");
+
+    http_response_cache_entry_t *entry = http_response_cache_fill_begin(&cache, HTTP_RESPONSE_CACHE_LQI);
+    assert(http_response_cache_fill_sink(entry, "{\"v\":2", 6));
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_LQI, "\"a\""));
+
+    /* The response failed half way: nothing is published. */
+    http_response_cache_fill_commit(entry, NULL);
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_LQI, "\"a\""));
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_LQI, "\"b\""));
+
+    fill_slot(&cache, HTTP_RESPONSE_CACHE_LQI, "{\"v\":3}", "\"c\"");
+    const http_response_cache_entry_t *hit = http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_LQI, "\"c\"");
+    assert(hit && hit->len == 7 && memcmp(hit->body, "{\"v\":3}", 7) == 0);
+
+    http_response_cache_release(&cache);
+}
+
+static void test_oversized_body_is_not_kept(void)
+{
+    http_response_cache_t cache = {0};
+    static char chunk[HTTP_RESPONSE_CACHE_BODY_MAX / 2 + 1];
+    memset(chunk, 'x', sizeof(chunk));
+
+    http_response_cache_entry_t *entry = http_response_cache_fill_begin(&cache, HTTP_RESPONSE_CACHE_STATUS);
+    assert(http_response_cache_fill_sink(entry, chunk, sizeof(chunk)));
+    /* The sink never fails the response it mirrors. */
+    assert(http_response_cache_fill_sink(entry, chunk, sizeof(chunk)));
+    http_response_cache_fill_commit(entry, "\"big\"");
+    assert(!http_response_cache_lookup(&cache, HTTP_RESPONSE_CACHE_STATUS, "\"big\""));
+
+    assert(entry->capacity <= HTTP_RESPONSE_CACHE_BODY_MAX);
+    http_response_cache_release(&cache);
+}
+
+int main(void)
+{
+    printf("Running host tests: http_response_cache_host_test\n");
+
+    test_etag_list_matching();
+    test_fill_and_lookup_by_etag();
+    test_refill_invalidates_until_commit();
+    test_oversized_body_is_not_kept();
+
+    printf("Host tests passed: http_response_cache_host_test\n");
+    return 0;
+}
@@ -9,8 +9,11 @@ typedef struct httpd_req {
     int method;
     const char *uri;
     void *user_ctx;
+    size_t content_len;
 } httpd_req_t;
 
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len);
+
 typedef struct {
     uint8_t type;
     uint8_t *payload;
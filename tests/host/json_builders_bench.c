@@ -0,0 +1,269 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "api_usecases.h"
+#include "error_ring.h"
+#include "health_json_builder.h"
+#include "lqi_json_mapper.h"
+#include "status_json_builder.h"
+
+#define BENCH_ITERATIONS 20000
+#define BENCH_ROUNDS 5
+#define BENCH_BUF_SIZE 16384
+#define BENCH_ERROR_ROWS 5
+
+/* The same driver also builds against older api_usecases.h revisions that lack the WS client table. */
+#ifdef API_WS_METRICS_MAX_CLIENTS
+#define BENCH_WS_CLIENTS API_WS_METRICS_MAX_CLIENTS
+#else
+#define BENCH_WS_CLIENTS 0
+#endif
+
+typedef esp_err_t (*bench_builder_t)(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len);
+
+int api_usecase_get_devices_snapshot(api_usecases_handle_t handle, zb_device_t *out_devices, int max_devices)
+{
+    (void)handle;
+    for (int i = 0; i < max_devices; i++) {
+        memset(&out_devices[i], 0, sizeof(out_devices[i]));
+        out_devices[i].short_addr = (uint16_t)(0x1000 + i * 37);
+        /* Every fourth name needs escaping so the slow path is measured too. */
+        snprintf(out_devices[i].name, sizeof(out_devices[i].name), (i % 4 == 0) ? "Lamp \"%d\"" : "Kitchen lamp %d", i);
+    }
+    return max_devices;
+}
+
+esp_err_t api_usecase_get_cached_lqi_snapshot(api_usecases_handle_t handle, zigbee_neighbor_lqi_t *out_neighbors,
+                                              int max_neighbors, int *out_count, zigbee_lqi_source_t *out_source,
+                                              uint64_t *out_updated_ms)
+{
+    (void)handle;
+    for (int i = 0; i < max_neighbors; i++) {
+        memset(&out_neighbors[i], 0, sizeof(out_neighbors[i]));
+        out_neighbors[i].short_addr = (uint16_t)(0x1000 + i * 37);
+        out_neighbors[i].lqi = 40 + (i * 13) % 215;
+        out_neighbors[i].rssi = -30 - (i * 7) % 60;
+        out_neighbors[i].relationship = (uint8_t)(i % 3);
+        out_neighbors[i].depth = (uint8_t)(1 + i % 4);
+        out_neighbors[i].updated_ms = 1700000000000ull + (uint64_t)i;
+        out_neighbors[i].source = ZIGBEE_LQI_SOURCE_MGMT_LQI;
+    }
+    *out_count = max_neighbors;
+    *out_source = ZIGBEE_LQI_SOURCE_MGMT_LQI;
+    *out_updated_ms = 1700000000000ull + (uint64_t)max_neighbors;
+    return ESP_OK;
+}
+
+int api_usecase_get_cmd_stats_snapshot(api_usecases_handle_t handle, gateway_cmd_stats_t *out_stats, int max_stats)
+{
+    (void)handle;
+    for (int i = 0; i < max_stats; i++) {
+        memset(&out_stats[i], 0, sizeof(out_stats[i]));
+        out_stats[i].short_addr = (uint16_t)(0x1000 + i * 37);
+        out_stats[i].sent = 100u + (uint32_t)i;
+        out_stats[i].acked = 95u + (uint32_t)(i % 5);
+        out_stats[i].rtt_p50_ms = 50;
+        out_stats[i].rtt_p95_ms = 400;
+    }
+    return max_stats;
+}
+
+int api_usecase_get_attr_snapshot(api_usecases_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                  gateway_attr_entry_t *out_attrs, int max_attrs)
+{
+    (void)handle;
+    (void)cluster_id;
+    (void)attr_id;
+    int count = max_attrs < MAX_DEVICES ? max_attrs : MAX_DEVICES;
+    for (int i = 0; i < count; i++) {
+        memset(&out_attrs[i], 0, sizeof(out_attrs[i]));
+        out_attrs[i].short_addr = (uint16_t)(0x1000 + i * 37);
+        out_attrs[i].endpoint = 1;
+        out_attrs[i].cluster_id = GATEWAY_ZCL_CLUSTER_ON_OFF;
+        out_attrs[i].attr_id = GATEWAY_ZCL_ATTR_ON_OFF;
+        out_attrs[i].zcl_type = 0x10;
+        out_attrs[i].value = (uint32_t)(i % 2);
+        out_attrs[i].updated_ms = 1700000000000ull + (uint64_t)i;
+    }
+    return count;
+}
+
+int api_usecase_get_device_profiles(api_usecases_handle_t handle, gateway_device_profile_t *out_profiles,
+                                    int max_profiles)
+{
+    (void)handle;
+    int count = max_profiles < MAX_DEVICES ? max_profiles : MAX_DEVICES;
+    for (int i = 0; i < count; i++) {
+        memset(&out_profiles[i], 0, sizeof(out_profiles[i]));
+        out_profiles[i].short_addr = (uint16_t)(0x1000 + i * 37);
+        out_profiles[i].state = GATEWAY_INTERVIEW_COMPLETE;
+        out_profiles[i].on_off_endpoint = 1;
+        snprintf(out_profiles[i].manufacturer, sizeof(out_profiles[i].manufacturer), "Vendor");
+        snprintf(out_profiles[i].model, sizeof(out_profiles[i].model), "Plug-%d", i);
+    }
+    return count;
+}
+
+int api_usecase_get_neighbor_lqi_snapshot(api_usecases_handle_t handle, zigbee_neighbor_lqi_t *out_neighbors, int max_neighbors)
+{
+    int count = 0;
+    zigbee_lqi_source_t source;
+    uint64_t updated_ms;
+    api_usecase_get_cached_lqi_snapshot(handle, out_neighbors, max_neighbors, &count, &source, &updated_ms);
+    return count;
+}
+
+esp_err_t api_usecase_get_network_status(api_usecases_handle_t handle, zigbee_network_status_t *out_status)
+{
+    (void)handle;
+    out_status->pan_id = 0x1a62;
+    out_status->channel = 15;
+    out_status->short_addr = 0;
+    return ESP_OK;
+}
+
+esp_err_t api_usecase_collect_health_snapshot(api_usecases_handle_t handle, api_health_snapshot_t *out)
+{
+    (void)handle;
+    memset(out, 0, sizeof(*out));
+    out->zigbee_started = true;
+    out->zigbee_pan_id = 0x1a62;
+    out->zigbee_channel = 15;
+    out->wifi_sta_connected = true;
+    snprintf(out->wifi_active_ssid, sizeof(out->wifi_active_ssid), "home-net");
+    out->nvs_ok = true;
+    out->nvs_schema_version = 3;
+    out->ws_clients = BENCH_WS_CLIENTS;
+    out->telemetry.uptime_ms = 987654321ull;
+    out->telemetry.heap_free = 123456;
+    out->telemetry.heap_min = 100000;
+    out->telemetry.heap_largest_block = 65536;
+    out->telemetry.main_stack_hwm_bytes = 2048;
+    out->telemetry.httpd_stack_hwm_bytes = 1536;
+    out->telemetry.has_temperature_c = true;
+    out->telemetry.temperature_c = 41.25f;
+    out->telemetry.has_wifi_rssi = true;
+    out->telemetry.wifi_rssi = -58;
+    out->telemetry.has_wifi_ip = true;
+    snprintf(out->telemetry.wifi_ip, sizeof(out->telemetry.wifi_ip), "192.168.1.40");
+    out->telemetry.wifi_link_quality = API_WIFI_LINK_GOOD;
+    out->jobs_metrics.submitted_total = 42;
+    out->jobs_metrics.completed_total = 40;
+    out->ws_metrics.connections_total = 17;
+#ifdef API_WS_LATENCY_KIND_COUNT
+    out->ws_metrics.broadcast_ticks_total = 90210;
+    for (int kind = 0; kind < API_WS_LATENCY_KIND_COUNT; kind++) {
+        for (uint32_t us = 500; us < 400000; us += 7919) {
+            api_latency_histogram_record(&out->ws_metrics.latency[kind].serialize, us / 4);
+            api_latency_histogram_record(&out->ws_metrics.latency[kind].sent, us);
+        }
+    }
+#endif
+#ifdef API_WS_METRICS_MAX_CLIENTS
+    out->ws_metrics.client_count = API_WS_METRICS_MAX_CLIENTS;
+    for (uint32_t i = 0; i < API_WS_METRICS_MAX_CLIENTS; i++) {
+        out->ws_metrics.clients[i].fd = (int32_t)(50 + i);
+        out->ws_metrics.clients[i].queue_depth = i % 3;
+        out->ws_metrics.clients[i].srtt_us = 1200 * (i + 1);
+        out->ws_metrics.clients[i].binary = (i % 2) == 0;
+    }
+#endif
+    return ESP_OK;
+}
+
+size_t gateway_error_ring_snapshot(gateway_error_entry_t *out, size_t max_items)
+{
+    size_t count = max_items < BENCH_ERROR_ROWS ? max_items : BENCH_ERROR_ROWS;
+    for (size_t i = 0; i < count; i++) {
+        memset(&out[i], 0, sizeof(out[i]));
+        out[i].ts_ms = 1700000000000ull + i;
+        out[i].code = -(int32_t)(0x100 + i);
+        snprintf(out[i].source, sizeof(out[i].source), "ws");
+        snprintf(out[i].message, sizeof(out[i].message), "send failed\tfd=%u", (unsigned)(50 + i));
+    }
+    return count;
+}
+
+/* Builders only pass the handle through to the stubs above. */
+static api_usecases_t *bench_usecases(void)
+{
+    static char storage;
+    return (api_usecases_t *)(void *)&storage;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_document(FILE *dump, const char *name, bench_builder_t builder, unsigned rows)
+{
+    static char buf[BENCH_BUF_SIZE];
+    size_t len = 0;
+    assert(builder(bench_usecases(), buf, sizeof(buf), &len) == ESP_OK);
+    assert(len == strlen(buf));
+    if (dump) {
+        fprintf(dump, "%s %s\n", name, buf);
+    }
+
+    /* Best of several rounds filters scheduler noise on a shared host. */
+    uint64_t best_ns = UINT64_MAX;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t start_ns = bench_now_ns();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            builder(bench_usecases(), buf, sizeof(buf), &len);
+        }
+        uint64_t elapsed_ns = bench_now_ns() - start_ns;
+        if (elapsed_ns < best_ns) {
+            best_ns = elapsed_ns;
+        }
+    }
+    double per_doc = (double)best_ns / BENCH_ITERATIONS;
+    printf("%-8s %6zu bytes %3u rows %10.0f ns/doc %8.1f ns/row\n", name, len, rows, per_doc, per_doc / rows);
+}
+
+/* Heap path of /status: sizing strategy plus allocation, copied out to fit the common signature. */
+static esp_err_t bench_create_status_json(api_usecases_handle_t usecases, char *out, size_t out_size, size_t *out_len)
+{
+    char *json = create_status_json(usecases);
+    if (!json) {
+        return ESP_ERR_NO_MEM;
+    }
+    size_t len = strlen(json);
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    if (len < out_size) {
+        memcpy(out, json, len + 1);
+        *out_len = len;
+        ret = ESP_OK;
+    }
+    free(json);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    FILE *dump = NULL;
+    if (argc > 1) {
+        dump = fopen(argv[1], "w");
+        assert(dump);
+    }
+
+    bench_document(dump, "status", build_status_json_compact, MAX_DEVICES);
+    bench_document(dump, "status*", bench_create_status_json, MAX_DEVICES);
+    bench_document(dump, "devices", build_devices_json_compact, MAX_DEVICES);
+    bench_document(dump, "lqi", build_lqi_json_compact, MAX_DEVICES);
+    bench_document(dump, "health", build_health_json_compact, BENCH_ERROR_ROWS + BENCH_WS_CLIENTS);
+
+    if (dump) {
+        fclose(dump);
+    }
+    return 0;
+}
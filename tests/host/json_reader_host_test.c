@@ -0,0 +1,220 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_reader.h"
+
+static const char *const k_keys[] = {"addr", "name", "extra"};
+#define KEY_COUNT (sizeof(k_keys) / sizeof(k_keys[0]))
+
+static bool scan(const char *json, json_reader_value_t values[KEY_COUNT])
+{
+    return json_reader_scan_object(json, k_keys, KEY_COUNT, values);
+}
+
+static void test_syntax_acceptance(void)
+{
+    json_reader_value_t v[KEY_COUNT];
+    const char *accepted[] = {
+        "{}",
+        " \t\r\n{ } ",
+        "\xEF\xBB\xBF{\"addr\":1}",
+        "{\"addr\":1,\"other\":{\"a\":[1,2,{\"b\":null}],\"c\":true},\"name\":\"x\"}",
+        "{\"addr\":-0.5e+2}",
+        "{\"addr\":01}",
+        "{\"addr\":1.}",
+        "{\"addr\":-.5}",
+        "{\"addr\":1} trailing text is ignored like cJSON_Parse",
+        "{\"name\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\ud83d\\ude00\"}",
+        "{\"other\":[]}",
+    };
+    for (size_t i = 0; i < sizeof(accepted) / sizeof(accepted[0]); i++) {
+        assert(scan(accepted[i], v));
+    }
+
+    const char *rejected[] = {
+        "",
+        "[1]",
+        "\"addr\"",
+        "{",
+        "{\"addr\"}",
+        "{\"addr\":}",
+        "{\"addr\":1,}",
+        "{\"addr\":1 \"name\":2}",
+        "{addr:1}",
+        "{\"addr\":+1}",
+        "{\"addr\":.5}",
+        "{\"addr\":-}",
+        "{\"addr\":1e}",
+        "{\"addr\":1.2.3}",
+        "{\"addr\":0x10}",
+        "{\"addr\":nul}",
+        "{\"addr\":True}",
+        "{\"name\":\"unterminated}",
+        "{\"name\":\"\\x\"}",
+        "{\"name\":\"\\u12G4\"}",
+        "{\"name\":\"\\udc00\"}",
+        "{\"name\":\"\\ud800x\"}",
+        "{\"other\":[1,]}",
+        "{\"other\":[[[[[[[[[1]]]]]]]]]}",
+        "{\"addr\":1234567890123456789012345678901234567890123456789012345678901234}",
+    };
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        assert(!scan(rejected[i], v));
+    }
+}
+
+static void test_keys_match_like_cjson_lookup(void)
+{
+    json_reader_value_t v[KEY_COUNT];
+    int value = 0;
+
+    assert(scan("{\"ADDR\":7}", v));
+    assert(json_reader_get_int(&v[0], &value) && value == 7);
+
+    /* First duplicate wins, later ones are only syntax-checked. */
+    assert(scan("{\"addr\":1,\"addr\":\"two\"}", v));
+    assert(v[0].kind == JSON_READER_NUMBER);
+    assert(json_reader_get_int(&v[0], &value) && value == 1);
+
+    assert(scan("{\"\\u0061ddr\":3,\"addrx\":4,\"add\":5}", v));
+    assert(json_reader_get_int(&v[0], &value) && value == 3);
+
+    assert(scan("{\"name\":null,\"extra\":[1]}", v));
+    assert(v[0].kind == JSON_READER_ABSENT);
+    assert(v[1].kind == JSON_READER_OTHER);
+    assert(v[2].kind == JSON_READER_OTHER);
+    assert(!json_reader_get_int(&v[1], &value));
+}
+
+static void test_bool_literals(void)
+{
+    json_reader_value_t v[KEY_COUNT];
+    bool flag = false;
+
+    assert(scan("{\"extra\":true}", v));
+    assert(json_reader_get_bool(&v[2], &flag) && flag);
+    assert(scan("{\"extra\":false}", v));
+    assert(json_reader_get_bool(&v[2], &flag) && !flag);
+
+    const char *not_bool[] = {"{\"extra\":null}", "{\"extra\":1}", "{\"extra\":\"true\"}", "{\"extra\":[true]}", "{}"};
+    for (size_t i = 0; i < sizeof(not_bool) / sizeof(not_bool[0]); i++) {
+        assert(scan(not_bool[i], v));
+        assert(!json_reader_get_bool(&v[2], &flag));
+    }
+}
+
+static int int_of(const char *json)
+{
+    json_reader_value_t v[KEY_COUNT];
+    int value = 0;
+    assert(scan(json, v));
+    assert(json_reader_get_int(&v[0], &value));
+    return value;
+}
+
+static void test_int_follows_cjson_valueint(void)
+{
+    assert(int_of("{\"addr\":0}") == 0);
+    assert(int_of("{\"addr\":-0}") == 0);
+    assert(int_of("{\"addr\":65535}") == 65535);
+    assert(int_of("{\"addr\":1.9}") == 1);
+    assert(int_of("{\"addr\":-1.9}") == -1);
+    assert(int_of("{\"addr\":1e3}") == 1000);
+    assert(int_of("{\"addr\":2147483647}") == INT_MAX);
+    assert(int_of("{\"addr\":2147483648}") == INT_MAX);
+    assert(int_of("{\"addr\":99999999999999999999}") == INT_MAX);
+    assert(int_of("{\"addr\":-2147483648}") == INT_MIN);
+    assert(int_of("{\"addr\":-99999999999999999999}") == INT_MIN);
+    assert(int_of("{\"addr\":1e300}") == INT_MAX);
+}
+
+static void test_string_decoding(void)
+{
+    json_reader_value_t v[KEY_COUNT];
+    char out[16];
+    size_t len = 0;
+
+    assert(scan("{\"name\":\"a\\\"b\\u00e9\\ud83d\\ude00\"}", v));
+    assert(json_reader_get_string(&v[1], out, sizeof(out), &len));
+    assert(len == 9);
+    assert(memcmp(out, "a\"b\xC3\xA9\xF0\x9F\x98\x80", 10) == 0);
+
+    assert(scan("{\"name\":\"0123456789abcde\"}", v));
+    assert(json_reader_get_string(&v[1], out, sizeof(out), &len) && len == 15);
+    assert(scan("{\"name\":\"0123456789abcdef\"}", v));
+    assert(!json_reader_get_string(&v[1], out, sizeof(out), &len));
+    assert(scan("{\"name\":\"0123456789abcd\\n\"}", v));
+    assert(!json_reader_get_string(&v[1], out, 15, &len));
+
+    assert(scan("{\"name\":\"\"}", v));
+    assert(json_reader_get_string(&v[1], out, sizeof(out), &len) && len == 0 && out[0] == '\0');
+
+    assert(scan("{\"name\":5}", v));
+    assert(!json_reader_get_string(&v[1], out, sizeof(out), &len));
+}
+
+static size_t count_array(const char *json, bool *out_ok)
+{
+    json_reader_array_t it;
+    json_reader_value_t item;
+    size_t count = 0;
+    *out_ok = json_reader_array_begin(json, &it);
+    while (*out_ok && (*out_ok = json_reader_array_next(&it, &item)) && item.kind != JSON_READER_ABSENT) {
+        count++;
+    }
+    return count;
+}
+
+static void test_array_iteration(void)
+{
+    bool ok = false;
+    assert(count_array(" [ ] ", &ok) == 0 && ok);
+    assert(count_array("[1,\"a\",{\"b\":[2]},null]", &ok) == 4 && ok);
+    count_array("[1,]", &ok);
+    assert(!ok);
+    count_array("[1 2]", &ok);
+    assert(!ok);
+    count_array("[{\"addr\":1}", &ok);
+    assert(!ok);
+    count_array("{\"addr\":1}", &ok);
+    assert(!ok);
+
+    json_reader_array_t it;
+    json_reader_value_t item;
+    json_reader_value_t v[KEY_COUNT];
+    int value = 0;
+    assert(json_reader_array_begin("[{\"addr\":5,\"name\":\"x\"},\"s\",{\"ADDR\":6}]", &it));
+
+    assert(json_reader_array_next(&it, &item) && item.kind == JSON_READER_OTHER);
+    assert(scan(item.start, v));
+    assert(json_reader_get_int(&v[0], &value) && value == 5);
+
+    assert(json_reader_array_next(&it, &item) && item.kind == JSON_READER_STRING);
+    assert(item.end - item.start == 1 && *item.start == 's');
+    assert(!scan(item.start, v));
+
+    assert(json_reader_array_next(&it, &item) && item.kind == JSON_READER_OTHER);
+    assert(scan(item.start, v));
+    assert(json_reader_get_int(&v[0], &value) && value == 6);
+
+    assert(json_reader_array_next(&it, &item) && item.kind == JSON_READER_ABSENT);
+    assert(json_reader_array_next(&it, &item) && item.kind == JSON_READER_ABSENT);
+}
+
+int main(void)
+{
+    printf("Running host tests: json_reader_host_test\n");
+
+    test_syntax_acceptance();
+    test_keys_match_like_cjson_lookup();
+    test_bool_literals();
+    test_int_follows_cjson_valueint();
+    test_string_decoding();
+    test_array_iteration();
+
+    printf("Host tests passed: json_reader_host_test\n");
+    return 0;
+}
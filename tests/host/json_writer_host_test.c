@@ -0,0 +1,184 @@
+#include <assert.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json_writer.h"
+
+static void assert_u64_matches_printf(uint64_t value)
+{
+    char buf[32];
+    char expected[32];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_put_u64(&w, value);
+    assert(json_writer_finish(&w, NULL));
+    snprintf(expected, sizeof(expected), "%" PRIu64, value);
+    assert(strcmp(buf, expected) == 0);
+}
+
+static void assert_i32_matches_printf(int32_t value)
+{
+    char buf[32];
+    char expected[32];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_put_i32(&w, value);
+    assert(json_writer_finish(&w, NULL));
+    snprintf(expected, sizeof(expected), "%" PRId32, value);
+    assert(strcmp(buf, expected) == 0);
+}
+
+static void test_integers_match_printf(void)
+{
+    const uint64_t u64_values[] = {0, 7, 9, 10, 99, 100, 101, 65535, 4294967295ull, 4294967296ull,
+                                   1234567890123ull, UINT64_MAX};
+    for (size_t i = 0; i < sizeof(u64_values) / sizeof(u64_values[0]); i++) {
+        assert_u64_matches_printf(u64_values[i]);
+    }
+    const int32_t i32_values[] = {0, -1, -9, -10, -127, 127, 255, INT32_MAX, INT32_MIN};
+    for (size_t i = 0; i < sizeof(i32_values) / sizeof(i32_values[0]); i++) {
+        assert_i32_matches_printf(i32_values[i]);
+    }
+    for (uint32_t v = 0; v < 100000; v += 7) {
+        assert_u64_matches_printf(v);
+    }
+}
+
+static void test_escaping_matches_legacy_format(void)
+{
+    char buf[64];
+    size_t len = 0;
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf));
+    json_put_escaped(&w, "Kitchen \"Lamp\"\\\n\x01 end");
+    assert(json_writer_finish(&w, &len));
+    assert(strcmp(buf, "Kitchen \\\"Lamp\\\"\\\\\\u000a\\u0001 end") == 0);
+    assert(len == strlen(buf));
+}
+
+static void test_fixed2_matches_printf(void)
+{
+    const float values[] = {0.0f, 41.25f, 41.256f, -3.5f, 85.0f, 100.999f};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        char buf[32];
+        char expected[32];
+        json_writer_t w;
+        json_writer_init(&w, buf, sizeof(buf));
+        json_put_fixed2(&w, (double)values[i]);
+        assert(json_writer_finish(&w, NULL));
+        snprintf(expected, sizeof(expected), "%.2f", (double)values[i]);
+        assert(strcmp(buf, expected) == 0);
+    }
+}
+
+static void test_overflow_is_sticky_and_reserves_terminator(void)
+{
+    char buf[8];
+    size_t len = 0;
+    json_writer_t w;
+
+    json_writer_init(&w, buf, sizeof(buf));
+    json_put_lit(&w, "{\"a\":1}");
+    assert(json_writer_finish(&w, &len));
+    assert(len == 7 && strcmp(buf, "{\"a\":1}") == 0);
+
+    json_writer_init(&w, buf, sizeof(buf));
+    json_put_lit(&w, "{\"ab\":1}");
+    json_put_lit(&w, "}");
+    assert(!json_writer_finish(&w, &len));
+
+    /* A short write after an overflow must not resurrect the document. */
+    json_writer_init(&w, buf, sizeof(buf));
+    json_put_u64(&w, UINT64_MAX);
+    json_put_lit(&w, "1");
+    assert(!json_writer_finish(&w, &len));
+
+    json_writer_init(&w, buf, 0);
+    assert(!json_writer_finish(&w, &len));
+}
+
+typedef struct {
+    char data[512];
+    size_t len;
+    size_t calls;
+    size_t fail_after;
+} capture_sink_t;
+
+static bool capture_sink(void *ctx, const char *data, size_t len)
+{
+    capture_sink_t *sink = (capture_sink_t *)ctx;
+    if (sink->calls++ >= sink->fail_after || sink->len + len > sizeof(sink->data)) {
+        return false;
+    }
+    memcpy(sink->data + sink->len, data, len);
+    sink->len += len;
+    return true;
+}
+
+static void write_sample_document(json_writer_t *w)
+{
+    json_put_lit(w, "{\"devices\":[");
+    for (uint32_t i = 0; i < 6; i++) {
+        if (i > 0) {
+            json_put_lit(w, ",");
+        }
+        json_put_lit(w, "{\"short_addr\":");
+        json_put_u32(w, 4096 + i);
+        json_put_lit(w, ",\"name\":\"");
+        json_put_escaped(w, "Lamp \"x\"");
+        json_put_lit(w, "\"}");
+    }
+    json_put_lit(w, "],\"note\":\"a literal longer than the whole chunk window\"}");
+}
+
+static void test_stream_matches_buffered_output(void)
+{
+    char buffered[512];
+    size_t buffered_len = 0;
+    json_writer_t w;
+    json_writer_init(&w, buffered, sizeof(buffered));
+    write_sample_document(&w);
+    assert(json_writer_finish(&w, &buffered_len));
+
+    /* A 16-byte window forces many flushes and the direct path for the long literal. */
+    char window[16];
+    capture_sink_t sink = {.fail_after = SIZE_MAX};
+    size_t streamed_len = 0;
+    json_writer_init_stream(&w, window, sizeof(window), capture_sink, &sink);
+    write_sample_document(&w);
+    assert(json_writer_finish(&w, &streamed_len));
+    assert(streamed_len == buffered_len);
+    assert(sink.len == buffered_len);
+    assert(memcmp(sink.data, buffered, buffered_len) == 0);
+    assert(sink.calls > 1);
+}
+
+static void test_stream_sink_failure_is_sticky(void)
+{
+    char window[16];
+    capture_sink_t sink = {.fail_after = 2};
+    json_writer_t w;
+    json_writer_init_stream(&w, window, sizeof(window), capture_sink, &sink);
+    write_sample_document(&w);
+    assert(!json_writer_finish(&w, NULL));
+    assert(sink.calls == 3);
+    assert(w.flushed == sink.len);
+}
+
+int main(void)
+{
+    printf("Running host tests: json_writer_host_test\n");
+
+    test_integers_match_printf();
+    test_escaping_matches_legacy_format();
+    test_fixed2_matches_printf();
+    test_overflow_is_sticky_and_reserves_terminator();
+    test_stream_matches_buffered_output();
+    test_stream_sink_failure_is_sticky();
+
+    printf("Host tests passed: json_writer_host_test\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "latency_histogram.h"
+
+static void test_samples_land_in_upper_bound_bucket(void)
+{
+    api_latency_histogram_t hist;
+    memset(&hist, 0, sizeof(hist));
+
+    api_latency_histogram_record(&hist, 0);
+    api_latency_histogram_record(&hist, 1000);
+    api_latency_histogram_record(&hist, 1001);
+    api_latency_histogram_record(&hist, 120000);
+    api_latency_histogram_record(&hist, 5000000);
+
+    assert(hist.count == 5);
+    assert(hist.max_us == 5000000);
+    assert(hist.buckets[0] == 2);
+    assert(hist.buckets[1] == 1);
+    assert(hist.buckets[7] == 1);
+    assert(hist.buckets[API_LATENCY_BUCKET_COUNT - 1] == 1);
+    assert(api_latency_histogram_bucket_bound_ms(7) == 250);
+    assert(api_latency_histogram_bucket_bound_ms(API_LATENCY_BUCKET_COUNT - 1) == UINT32_MAX);
+}
+
+static void test_percentiles_report_bucket_bounds(void)
+{
+    api_latency_histogram_t hist;
+    memset(&hist, 0, sizeof(hist));
+    assert(api_latency_histogram_percentile_ms(&hist, 95) == 0);
+
+    for (int i = 0; i < 19; i++) {
+        api_latency_histogram_record(&hist, 4000);
+    }
+    api_latency_histogram_record(&hist, 180000);
+
+    assert(api_latency_histogram_percentile_ms(&hist, 50) == 5);
+    assert(api_latency_histogram_percentile_ms(&hist, 95) == 5);
+    assert(api_latency_histogram_percentile_ms(&hist, 100) == 180);
+
+    api_latency_histogram_record(&hist, 2500000);
+    assert(api_latency_histogram_percentile_ms(&hist, 100) == 2500);
+}
+
+static void test_small_samples_are_capped_by_max(void)
+{
+    api_latency_histogram_t hist;
+    memset(&hist, 0, sizeof(hist));
+    api_latency_histogram_record(&hist, 30000);
+    api_latency_histogram_record(&hist, 31000);
+
+    /* Both fall in the 50 ms bucket, but nothing was slower than 31 ms. */
+    assert(api_latency_histogram_percentile_ms(&hist, 95) == 31);
+}
+
+int main(void)
+{
+    printf("Running host tests: latency_histogram_host_test\n");
+
+    test_samples_land_in_upper_bound_bucket();
+    test_percentiles_report_bucket_bounds();
+    test_small_samples_are_capped_by_max();
+
+    printf("Host tests passed: latency_histogram_host_test\n");
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "api_usecases.h"
+#include "status_json_builder.h"
+
+#define TEST_BUF_SIZE 2048
+
+static int s_device_count;
+static bool s_with_state;
+
+int api_usecase_get_devices_snapshot(api_usecases_handle_t handle, zb_device_t *out_devices, int max_devices)
+{
+    (void)handle;
+    static const struct {
+        uint16_t short_addr;
+        const char *name;
+    } k_devices[] = {
+        {0x1234, "Lamp \"A\"\\1"},
+        {0x0042, "Plug"},
+    };
+    int count = s_device_count < max_devices ? s_device_count : max_devices;
+    for (int i = 0; i < count; i++) {
+        memset(&out_devices[i], 0, sizeof(out_devices[i]));
+        out_devices[i].short_addr = k_devices[i].short_addr;
+        snprintf(out_devices[i].name, sizeof(out_devices[i].name), "%s", k_devices[i].name);
+    }
+    return count;
+}
+
+int api_usecase_get_attr_snapshot(api_usecases_handle_t handle, uint16_t cluster_id, uint16_t attr_id,
+                                  gateway_attr_entry_t *out_attrs, int max_attrs)
+{
+    (void)handle;
+    if (!s_with_state || max_attrs < 2) {
+        return 0;
+    }
+    /* Two switched endpoints: the lower one is reported. */
+    for (int i = 0; i < 2; i++) {
+        memset(&out_attrs[i], 0, sizeof(out_attrs[i]));
+        out_attrs[i].short_addr = 0x0042;
+        out_attrs[i].endpoint = (uint8_t)(2 - i);
+        out_attrs[i].cluster_id = cluster_id;
+        out_attrs[i].attr_id = attr_id;
+        out_attrs[i].value = (uint32_t)i;
+        out_attrs[i].updated_ms = 1700000000000ull + (uint64_t)i;
+    }
+    return 2;
+}
+
+int api_usecase_get_device_profiles(api_usecases_handle_t handle, gateway_device_profile_t *out_profiles,
+                                    int max_profiles)
+{
+    (void)handle;
+    if (!s_with_state || max_profiles < 1) {
+        return 0;
+    }
+    memset(&out_profiles[0], 0, sizeof(out_profiles[0]));
+    out_profiles[0].short_addr = 0x0042;
+    out_profiles[0].state = GATEWAY_INTERVIEW_COMPLETE;
+    out_profiles[0].on_off_endpoint = 1;
+    snprintf(out_profiles[0].manufacturer, sizeof(out_profiles[0].manufacturer), "Vendor");
+    snprintf(out_profiles[0].model, sizeof(out_profiles[0].model), "Plug-1");
+    return 1;
+}
+
+esp_err_t api_usecase_get_network_status(api_usecases_handle_t handle, zigbee_network_status_t *out_status)
+{
+    (void)handle;
+    out_status->pan_id = 0x1a62;
+    out_status->channel = 15;
+    out_status->short_addr = 0;
+    return ESP_OK;
+}
+
+/* Builders only pass the handle through to the stubs above. */
+static api_usecases_t *test_usecases(void)
+{
+    static char storage;
+    return (api_usecases_t *)(void *)&storage;
+}
+
+/*
+ * Output of the hand-written build_status_json_compact at the series baseline (24f9a3f) for the same
+ * devices: network fields, then devices as {"name","short_addr"}. Later fields may only be appended.
+ */
+static const char k_baseline_status[] =
+    "{\"pan_id\":6754,\"channel\":15,\"short_addr\":0,\"zigbee\":{\"pan_id\":6754,\"channel\":15,\"short_addr\":0},"
+    "\"devices\":[{\"name\":\"Lamp \\\"A\\\"\\\\1\",\"short_addr\":4660},{\"name\":\"Plug\",\"short_addr\":66}]}";
+
+#define DEVICE_EXTRAS_UNKNOWN ",\"on_off\":null,\"on_off_ms\":0,\"ep\":null,\"manufacturer\":null,\"model\":null"
+
+static void test_status_keeps_baseline_field_order(void)
+{
+    s_device_count = 2;
+    s_with_state = false;
+    char buf[TEST_BUF_SIZE];
+    size_t len = 0;
+    assert(build_status_json_compact(test_usecases(), buf, sizeof(buf), &len) == ESP_OK);
+    assert(len == strlen(buf));
+    assert(strcmp(buf, "{\"pan_id\":6754,\"channel\":15,\"short_addr\":0,\"zigbee\":{\"pan_id\":6754,\"channel\":15,"
+                       "\"short_addr\":0},\"devices\":[{\"name\":\"Lamp \\\"A\\\"\\\\1\",\"short_addr\":4660"
+                       DEVICE_EXTRAS_UNKNOWN "},{\"name\":\"Plug\",\"short_addr\":66" DEVICE_EXTRAS_UNKNOWN "}]}") == 0);
+
+    /* Dropping the appended fields gives back the baseline document byte for byte. */
+    char stripped[TEST_BUF_SIZE];
+    size_t out = 0;
+    size_t extras_len = sizeof(DEVICE_EXTRAS_UNKNOWN) - 1;
+    for (size_t i = 0; buf[i];) {
+        if (strncmp(&buf[i], DEVICE_EXTRAS_UNKNOWN, extras_len) == 0) {
+            i += extras_len;
+        } else {
+            stripped[out++] = buf[i++];
+        }
+    }
+    stripped[out] = '\0';
+    assert(strcmp(stripped, k_baseline_status) == 0);
+
+    char *created = create_status_json(test_usecases());
+    assert(created && strcmp(created, buf) == 0);
+    free(created);
+}
+
+static void test_devices_payload_joins_state_after_baseline_fields(void)
+{
+    s_device_count = 2;
+    s_with_state = true;
+    char buf[TEST_BUF_SIZE];
+    size_t len = 0;
+    assert(build_devices_json_compact(test_usecases(), buf, sizeof(buf), &len) == ESP_OK);
+    assert(strcmp(buf, "{\"devices\":[{\"name\":\"Lamp \\\"A\\\"\\\\1\",\"short_addr\":4660" DEVICE_EXTRAS_UNKNOWN
+                       "},{\"name\":\"Plug\",\"short_addr\":66,\"on_off\":1,\"on_off_ms\":1700000000001,\"ep\":1,"
+                       "\"manufacturer\":\"Vendor\",\"model\":\"Plug-1\"}]}") == 0);
+}
+
+static void test_devices_cbor_keeps_schema_positions(void)
+{
+    s_device_count = 1;
+    s_with_state = false;
+    uint8_t buf[64];
+    size_t len = 0;
+    assert(build_devices_cbor_compact(test_usecases(), (char *)buf, sizeof(buf), &len) == ESP_OK);
+    /* [[4660, "Lamp \"A\"\1", null, 0, null, null, null]]: short_addr stays at position 0. */
+    static const uint8_t expected[] = {0x81, 0x87, 0x19, 0x12, 0x34, 0x6a, 'L', 'a', 'm', 'p', ' ', '"', 'A', '"',
+                                       '\\', '1', 0xf6, 0x00, 0xf6, 0xf6, 0xf6};
+    assert(len == sizeof(expected));
+    assert(memcmp(buf, expected, sizeof(expected)) == 0);
+}
+
+int main(void)
+{
+    printf("Running host tests: status_json_builder_host_test\n");
+
+    test_status_keeps_baseline_field_order();
+    test_devices_payload_joins_state_after_baseline_fields();
+    test_devices_cbor_keeps_schema_positions();
+
+    printf("Host tests passed: status_json_builder_host_test\n");
+    return 0;
+}
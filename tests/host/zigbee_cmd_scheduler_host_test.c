@@ -0,0 +1,194 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "zigbee_cmd_scheduler.h"
+
+typedef struct {
+    int calls;
+    zigbee_cmd_completion_t last;
+} completions_t;
+
+static void record_completion(void *ctx, const zigbee_cmd_completion_t *completion)
+{
+    completions_t *c = (completions_t *)ctx;
+    c->calls++;
+    c->last = *completion;
+}
+
+static zigbee_on_off_cmd_t cmd(uint16_t addr, uint8_t ep, uint8_t on_off)
+{
+    return (zigbee_on_off_cmd_t){.short_addr = addr, .endpoint = ep, .on_off = on_off};
+}
+
+static uint32_t submit(zigbee_cmd_scheduler_t *s, zigbee_on_off_cmd_t c, uint64_t now)
+{
+    uint32_t ticket = 0;
+    assert(zigbee_cmd_scheduler_submit(s, &c, now, NULL, &ticket) == GATEWAY_STATUS_OK);
+    assert(ticket != 0);
+    return ticket;
+}
+
+static void test_response_completes_by_addr_and_tsn(void)
+{
+    zigbee_cmd_scheduler_t s;
+    completions_t done = {0};
+    zigbee_cmd_scheduler_init(&s, record_completion, &done);
+    assert(zigbee_cmd_scheduler_next_due_ms(&s) == ZIGBEE_CMD_SCHED_IDLE);
+
+    uint32_t t1 = submit(&s, cmd(0x1111, 1, 1), 0);
+    assert(zigbee_cmd_scheduler_next_due_ms(&s) == 0);
+
+    uint32_t ticket = 0;
+    zigbee_on_off_cmd_t out;
+    assert(zigbee_cmd_scheduler_next(&s, 0, &ticket, &out));
+    assert(ticket == t1 && out.short_addr == 0x1111 && out.on_off == 1);
+    zigbee_cmd_scheduler_on_sent(&s, ticket, true, 42, 100);
+    assert(zigbee_cmd_scheduler_next_due_ms(&s) == ZIGBEE_CMD_SCHED_ACK_TIMEOUT_MS);
+
+    gateway_status_t status;
+    assert(!zigbee_cmd_scheduler_result(&s, t1, &status));
+    /* Same TSN from another device, or another TSN from this one, is not ours. */
+    assert(!zigbee_cmd_scheduler_on_response(&s, 0x2222, 42, GATEWAY_STATUS_OK, 0));
+    assert(!zigbee_cmd_scheduler_on_response(&s, 0x1111, 41, GATEWAY_STATUS_OK, 0));
+    assert(zigbee_cmd_scheduler_on_response(&s, 0x1111, 42, GATEWAY_STATUS_OK, 340));
+
+    assert(done.calls == 1 && done.last.ticket == t1 && done.last.status == GATEWAY_STATUS_OK);
+    assert(done.last.short_addr == 0x1111 && done.last.rtt_ms == 240);
+    assert(zigbee_cmd_scheduler_result(&s, t1, &status) && status == GATEWAY_STATUS_OK);
+    assert(zigbee_cmd_scheduler_next_due_ms(&s) == ZIGBEE_CMD_SCHED_IDLE);
+}
+
+static void test_one_in_flight_per_device_in_fifo_order(void)
+{
+    zigbee_cmd_scheduler_t s;
+    zigbee_cmd_scheduler_init(&s, NULL, NULL);
+
+    uint32_t a1 = submit(&s, cmd(0x1111, 1, 1), 0);
+    uint32_t a2 = submit(&s, cmd(0x1111, 2, 1), 0);
+    uint32_t b1 = submit(&s, cmd(0x2222, 1, 0), 0);
+
+    uint32_t ticket = 0;
+    zigbee_on_off_cmd_t out;
+    assert(zigbee_cmd_scheduler_next(&s, 0, &ticket, &out) && ticket == a1);
+    zigbee_cmd_scheduler_on_sent(&s, ticket, true, 1, 0);
+    /* 0x1111 is busy, so the other device goes next. */
+    assert(zigbee_cmd_scheduler_next(&s, 0, &ticket, &out) && ticket == b1);
+    zigbee_cmd_scheduler_on_sent(&s, ticket, true, 2, 0);
+    assert(!zigbee_cmd_scheduler_next(&s, 0, &ticket, &out));
+    /* The queued command behind an in-flight one does not wake the pump. */
+    assert(zigbee_cmd_scheduler_next_due_ms(&s) == ZIGBEE_CMD_SCHED_ACK_TIMEOUT_MS);
+
+    assert(zigbee_cmd_scheduler_on_response(&s, 0x1111, 1, GATEWAY_STATUS_OK, 0));
+    assert(zigbee_cmd_scheduler_next(&s, 10, &ticket, &out) && ticket == a2 && out.endpoint == 2);
+}
+
+static void test_queued_command_is_coalesced_per_endpoint(void)
+{
+    zigbee_cmd_scheduler_t s;
+    completions_t done = {0};
+    zigbee_cmd_scheduler_init(&s, record_completion, &done);
+
+    uint32_t inflight = submit(&s, cmd(0x1111, 1, 1), 0);
+    uint32_t ticket = 0;
+    zigbee_on_off_cmd_t out;
+    assert(zigbee_cmd_scheduler_next(&s, 0, &ticket, &out) && ticket == inflight);
+    zigbee_cmd_scheduler_on_sent(&s, ticket, true, 7, 0);
+
+    uint32_t other_ep = submit(&s, cmd(0x1111, 2, 1), 0);
+    uint32_t first = submit(&s, cmd(0x1111, 1, 0), 0);
+    uint32_t second = submit(&s, cmd(0x1111, 1, 1), 0);
+    assert(second != first);
+    assert(done.calls == 1 && done.last.ticket == first && done.last.status == GATEWAY_STATUS_INVALID_STATE);
+
+    /* The rewritten command keeps its place behind ep 2 and carries the last state. */
+    assert(zigbee_cmd_scheduler_on_response(&s, 0x1111, 7, GATEWAY_STATUS_OK, 0));
+    assert(zigbee_cmd_scheduler_next(&s, 0, &ticket, &out) && ticket == other_ep);
+    zigbee_cmd_scheduler_on_sent(&s, ticket, true, 8, 0);
+    assert(zigbee_cmd_scheduler_on_response(&s, 0x1111, 8, GATEWAY_STATUS_OK, 0));
+    assert(zigbee_cmd_scheduler_next(&s, 0, &ticket, &out) && ticket == second && out.on_off == 1);
+    assert(!zigbee_cmd_scheduler_next(&s, 0, &ticket, &out));
+}
+
+static void test_retry_with_backoff_then_timeout(void)
+{
+    zigbee_cmd_scheduler_t s;
+    completions_t done = {0};
+    zigbee_cmd_scheduler_init(&s, record_completion, &done);
+
+    uint32_t t = submit(&s, cmd(0x3333, 1, 1), 0);
+    uint32_t ticket = 0;
+    zigbee_on_off_cmd_t out;
+    uint64_t now = 0;
+    uint64_t expected_pause = ZIGBEE_CMD_SCHED_RETRY_BASE_MS;
+
+    for (int attempt = 1; attempt <= ZIGBEE_CMD_SCHED_MAX_ATTEMPTS; attempt++) {
+        assert(zigbee_cmd_scheduler_next(&s, now, &ticket, &out) && ticket == t);
+        zigbee_cmd_scheduler_on_sent(&s, ticket, true, (uint8_t)attempt, now);
+        now += ZIGBEE_CMD_SCHED_ACK_TIMEOUT_MS;
+        zigbee_cmd_scheduler_tick(&s, now);
+        if (attempt < ZIGBEE_CMD_SCHED_MAX_ATTEMPTS) {
+            assert(done.calls == 0);
+            assert(zigbee_cmd_scheduler_next_due_ms(&s) == now + expected_pause);
+            assert(!zigbee_cmd_scheduler_next(&s, now + expected_pause - 1, &ticket, &out));
+            now += expected_pause;
+            expected_pause *= 2;
+        }
+    }
+    assert(done.calls == 1 && done.last.status == GATEWAY_STATUS_TIMEOUT && done.last.rtt_ms == 0);
+    /* A reply to an earlier attempt after giving up is ignored. */
+    assert(!zigbee_cmd_scheduler_on_response(&s, 0x3333, 1, GATEWAY_STATUS_OK, 0));
+
+    /* A send the stack refused counts as an attempt too. */
+    t = submit(&s, cmd(0x3333, 1, 0), now);
+    assert(zigbee_cmd_scheduler_next(&s, now, &ticket, &out));
+    zigbee_cmd_scheduler_on_sent(&s, ticket, false, 0, now);
+    assert(zigbee_cmd_scheduler_next_due_ms(&s) == now + ZIGBEE_CMD_SCHED_RETRY_BASE_MS);
+}
+
+static void test_backpressure_limits(void)
+{
+    zigbee_cmd_scheduler_t s;
+    zigbee_cmd_scheduler_init(&s, NULL, NULL);
+    uint32_t ticket = 0;
+
+    for (uint8_t ep = 1; ep <= ZIGBEE_CMD_SCHED_DEVICE_DEPTH; ep++) {
+        submit(&s, cmd(0x1111, ep, 1), 0);
+    }
+    zigbee_on_off_cmd_t extra = cmd(0x1111, 100, 1);
+    assert(zigbee_cmd_scheduler_submit(&s, &extra, 0, NULL, &ticket) == GATEWAY_STATUS_NO_MEM);
+    /* Coalescing still works on a full device queue. */
+    zigbee_on_off_cmd_t again = cmd(0x1111, 1, 0);
+    assert(zigbee_cmd_scheduler_submit(&s, &again, 0, NULL, &ticket) == GATEWAY_STATUS_OK);
+
+    zigbee_cmd_scheduler_init(&s, NULL, NULL);
+    for (uint16_t addr = 1; addr <= ZIGBEE_CMD_SCHED_SLOTS; addr++) {
+        submit(&s, cmd(addr, 1, 1), 0);
+    }
+    extra = cmd(0x7777, 1, 1);
+    assert(zigbee_cmd_scheduler_submit(&s, &extra, 0, NULL, &ticket) == GATEWAY_STATUS_NO_MEM);
+
+    zigbee_on_off_cmd_t out;
+    for (int i = 0; i < ZIGBEE_CMD_SCHED_MAX_IN_FLIGHT; i++) {
+        assert(zigbee_cmd_scheduler_next(&s, 0, &ticket, &out));
+        zigbee_cmd_scheduler_on_sent(&s, ticket, true, 0, 0);
+    }
+    assert(!zigbee_cmd_scheduler_next(&s, 0, &ticket, &out));
+
+    zigbee_on_off_cmd_t bad = cmd(0, 1, 1);
+    assert(zigbee_cmd_scheduler_submit(&s, &bad, 0, NULL, &ticket) == GATEWAY_STATUS_INVALID_ARG);
+}
+
+int main(void)
+{
+    printf("Running host tests: zigbee_cmd_scheduler_host_test\n");
+
+    test_response_completes_by_addr_and_tsn();
+    test_one_in_flight_per_device_in_fifo_order();
+    test_queued_command_is_coalesced_per_endpoint();
+    test_retry_with_backoff_then_timeout();
+    test_backpressure_limits();
+
+    printf("Host tests passed: zigbee_cmd_scheduler_host_test\n");
+    return 0;
+}
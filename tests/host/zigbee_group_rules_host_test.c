@@ -0,0 +1,90 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "zigbee_group_rules.h"
+
+static void test_create_assigns_lowest_free_id(void)
+{
+    gateway_group_record_t groups[3] = {0};
+    int count = 0;
+    uint16_t id = 0;
+
+    assert(zigbee_group_rules_create(groups, &count, 3, "Kitchen", &id) == GATEWAY_STATUS_OK);
+    assert(id == 1 && count == 1);
+    assert(strcmp(groups[0].name, "Kitchen") == 0);
+    assert(zigbee_group_rules_create(groups, &count, 3, "Hall", &id) == GATEWAY_STATUS_OK);
+    assert(id == 2);
+
+    assert(zigbee_group_rules_delete(groups, &count, 1, NULL) == GATEWAY_STATUS_OK);
+    assert(count == 1 && groups[0].group_id == 2);
+    assert(zigbee_group_rules_create(groups, &count, 3, "Kitchen again", &id) == GATEWAY_STATUS_OK);
+    assert(id == 1);
+
+    assert(zigbee_group_rules_create(groups, &count, 3, "Bedroom", &id) == GATEWAY_STATUS_OK);
+    assert(zigbee_group_rules_create(groups, &count, 3, "Overflow", &id) == GATEWAY_STATUS_NO_MEM);
+    assert(count == 3);
+}
+
+static void test_create_validates_name(void)
+{
+    gateway_group_record_t groups[2] = {0};
+    int count = 0;
+    uint16_t id = 0;
+
+    assert(zigbee_group_rules_create(groups, &count, 2, "", &id) == GATEWAY_STATUS_INVALID_ARG);
+    assert(zigbee_group_rules_create(groups, &count, 2, "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA", &id) ==
+           GATEWAY_STATUS_INVALID_ARG);
+    assert(zigbee_group_rules_create(groups, &count, 2, "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA", &id) == GATEWAY_STATUS_OK);
+    assert(count == 1);
+}
+
+static void test_members_add_remove(void)
+{
+    gateway_group_record_t group = {.group_id = 7};
+
+    assert(zigbee_group_rules_add_member(&group, 0x1234, 1) == GATEWAY_STATUS_OK);
+    assert(zigbee_group_rules_add_member(&group, 0x1234, 1) == GATEWAY_STATUS_OK);
+    assert(group.member_count == 1);
+    assert(zigbee_group_rules_add_member(&group, 0x1234, 2) == GATEWAY_STATUS_OK);
+    assert(group.member_count == 2);
+    assert(zigbee_group_rules_add_member(&group, 0, 1) == GATEWAY_STATUS_INVALID_ARG);
+    assert(zigbee_group_rules_add_member(&group, 0x1, 0) == GATEWAY_STATUS_INVALID_ARG);
+
+    assert(zigbee_group_rules_remove_member(&group, 0x1234, 3) == GATEWAY_STATUS_NOT_FOUND);
+    assert(zigbee_group_rules_remove_member(&group, 0x1234, 1) == GATEWAY_STATUS_OK);
+    assert(group.member_count == 1);
+    assert(group.members[0].endpoint == 2);
+
+    for (uint16_t addr = 1; group.member_count < GATEWAY_GROUP_MAX_MEMBERS; addr++) {
+        assert(zigbee_group_rules_add_member(&group, addr, 1) == GATEWAY_STATUS_OK);
+    }
+    assert(zigbee_group_rules_add_member(&group, 0x7777, 1) == GATEWAY_STATUS_NO_MEM);
+}
+
+static void test_remove_device_drops_all_memberships(void)
+{
+    gateway_group_record_t groups[2] = {{.group_id = 1}, {.group_id = 2}};
+    assert(zigbee_group_rules_add_member(&groups[0], 0x1111, 1) == GATEWAY_STATUS_OK);
+    assert(zigbee_group_rules_add_member(&groups[0], 0x2222, 1) == GATEWAY_STATUS_OK);
+    assert(zigbee_group_rules_add_member(&groups[0], 0x1111, 2) == GATEWAY_STATUS_OK);
+    assert(zigbee_group_rules_add_member(&groups[1], 0x1111, 1) == GATEWAY_STATUS_OK);
+
+    assert(zigbee_group_rules_remove_device(groups, 2, 0x1111) == 3);
+    assert(groups[0].member_count == 1 && groups[0].members[0].short_addr == 0x2222);
+    assert(groups[1].member_count == 0);
+    assert(zigbee_group_rules_remove_device(groups, 2, 0x1111) == 0);
+}
+
+int main(void)
+{
+    printf("Running host tests: zigbee_group_rules_host_test\n");
+
+    test_create_assigns_lowest_free_id();
+    test_create_validates_name();
+    test_members_add_remove();
+    test_remove_device_drops_all_memberships();
+
+    printf("Host tests passed: zigbee_group_rules_host_test\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "zigbee_interview.h"
+
+static const gateway_ieee_addr_t IEEE_A = {1, 2, 3, 4, 5, 6, 7, 8};
+static const gateway_ieee_addr_t IEEE_B = {8, 7, 6, 5, 4, 3, 2, 1};
+
+static gateway_endpoint_desc_t desc(uint16_t profile_id, uint16_t device_id, const uint16_t *in, uint8_t in_count)
+{
+    gateway_endpoint_desc_t d = {.profile_id = profile_id, .device_id = device_id, .in_count = in_count};
+    memcpy(d.in_clusters, in, in_count * sizeof(in[0]));
+    return d;
+}
+
+static void test_full_interview(void)
+{
+    zigbee_interview_t iv;
+    zigbee_interview_request_t req;
+    gateway_device_interview_t rec;
+
+    zigbee_interview_init(&iv);
+    assert(zigbee_interview_next_due_ms(&iv) == ZIGBEE_INTERVIEW_IDLE);
+    assert(zigbee_interview_enqueue(&iv, 0x1234, IEEE_A));
+    assert(zigbee_interview_next_due_ms(&iv) == 0);
+
+    assert(zigbee_interview_next(&iv, 0, &req));
+    assert(req.kind == ZIGBEE_INTERVIEW_REQ_ACTIVE_EP && req.short_addr == 0x1234);
+    /* One request at a time. */
+    zigbee_interview_request_t extra;
+    assert(!zigbee_interview_next(&iv, 0, &extra));
+    assert(zigbee_interview_next_due_ms(&iv) == ZIGBEE_INTERVIEW_TIMEOUT_MS);
+
+    /* The Green Power endpoint is skipped. */
+    const uint8_t eps[] = {1, 242, 2};
+    assert(!zigbee_interview_on_active_ep(&iv, req.token + 1, eps, 3));
+    assert(zigbee_interview_on_active_ep(&iv, req.token, eps, 3));
+    assert(iv.record.endpoint_count == 2);
+
+    const uint16_t ep1_in[] = {0x0003, 0x0004};
+    const uint16_t ep2_in[] = {0x0000, 0x0006, 0x0008};
+    assert(zigbee_interview_next(&iv, 10, &req) && req.kind == ZIGBEE_INTERVIEW_REQ_SIMPLE_DESC && req.endpoint == 1);
+    gateway_endpoint_desc_t d = desc(0x0104, 0x0100, ep1_in, 2);
+    assert(zigbee_interview_on_simple_desc(&iv, req.token, &d));
+    /* A duplicate of the same answer is late. */
+    assert(!zigbee_interview_on_simple_desc(&iv, req.token, &d));
+    assert(zigbee_interview_next(&iv, 20, &req) && req.endpoint == 2);
+    d = desc(0x0104, 0x0100, ep2_in, 3);
+    d.endpoint = 9; /* the slot keeps the endpoint it asked for */
+    assert(zigbee_interview_on_simple_desc(&iv, req.token, &d));
+
+    /* Basic goes to the endpoint that serves it. */
+    assert(zigbee_interview_next(&iv, 30, &req) && req.kind == ZIGBEE_INTERVIEW_REQ_BASIC && req.endpoint == 2);
+    assert(!zigbee_interview_on_basic(&iv, 0x9999, "x", "y"));
+    assert(zigbee_interview_on_basic(&iv, 0x1234, "ACME", "a-very-long-model-identifier-that-does-not-fit"));
+
+    assert(zigbee_interview_next_due_ms(&iv) == ZIGBEE_INTERVIEW_IDLE);
+    assert(zigbee_interview_take_result(&iv, &rec));
+    assert(rec.state == GATEWAY_INTERVIEW_COMPLETE && rec.short_addr == 0x1234);
+    assert(memcmp(rec.ieee_addr, IEEE_A, sizeof(IEEE_A)) == 0);
+    assert(rec.endpoint_count == 2 && rec.endpoints[1].endpoint == 2 && rec.endpoints[1].in_count == 3);
+    assert(strcmp(rec.manufacturer, "ACME") == 0 && strlen(rec.model) == GATEWAY_INTERVIEW_STRING_MAX_LEN);
+    assert(zigbee_interview_find_endpoint(&rec, 0x0006) == 2);
+    assert(zigbee_interview_find_endpoint(&rec, 0x0300) == 0);
+    assert(!zigbee_interview_take_result(&iv, &rec));
+}
+
+static void test_queue_waits_for_result_and_dedups(void)
+{
+    zigbee_interview_t iv;
+    zigbee_interview_request_t req;
+    gateway_device_interview_t rec;
+
+    zigbee_interview_init(&iv);
+    assert(zigbee_interview_enqueue(&iv, 0x1111, IEEE_A));
+    assert(zigbee_interview_enqueue(&iv, 0x2222, IEEE_B));
+    /* The same IEEE announcing again only moves the address. */
+    assert(zigbee_interview_enqueue(&iv, 0x2223, IEEE_B));
+    assert(iv.queue_count == 2 && iv.queue[1].short_addr == 0x2223);
+
+    assert(zigbee_interview_next(&iv, 0, &req) && req.short_addr == 0x1111);
+    assert(zigbee_interview_on_active_ep(&iv, req.token, NULL, 0));
+    /* No endpoints: done at once, and B waits until A's result is taken. */
+    assert(!zigbee_interview_next(&iv, 0, &req));
+    assert(zigbee_interview_next_due_ms(&iv) == ZIGBEE_INTERVIEW_IDLE);
+    assert(zigbee_interview_take_result(&iv, &rec) && rec.endpoint_count == 0);
+    assert(zigbee_interview_next_due_ms(&iv) == 0);
+    assert(zigbee_interview_next(&iv, 0, &req) && req.short_addr == 0x2223);
+
+    /* Deleting the device drops its interview. */
+    assert(zigbee_interview_cancel(&iv, 0x2223));
+    assert(!zigbee_interview_next(&iv, 0, &req));
+    assert(!zigbee_interview_on_active_ep(&iv, req.token, NULL, 0));
+
+    for (int i = 0; i < ZIGBEE_INTERVIEW_QUEUE_DEPTH; i++) {
+        gateway_ieee_addr_t ieee = {0xAA, (uint8_t)i};
+        assert(zigbee_interview_enqueue(&iv, (uint16_t)(0x3000 + i), ieee));
+    }
+    gateway_ieee_addr_t overflow = {0xBB};
+    assert(!zigbee_interview_enqueue(&iv, 0x4000, overflow));
+}
+
+static void test_retries_and_partial(void)
+{
+    zigbee_interview_t iv;
+    zigbee_interview_request_t req;
+    gateway_device_interview_t rec;
+    uint64_t now = 0;
+
+    /* A device that never answers Active_EP leaves nothing behind. */
+    zigbee_interview_init(&iv);
+    assert(zigbee_interview_enqueue(&iv, 0x1234, IEEE_A));
+    for (int attempt = 1; attempt <= ZIGBEE_INTERVIEW_MAX_ATTEMPTS; attempt++) {
+        assert(zigbee_interview_next(&iv, now, &req) && req.kind == ZIGBEE_INTERVIEW_REQ_ACTIVE_EP);
+        zigbee_interview_tick(&iv, now + ZIGBEE_INTERVIEW_TIMEOUT_MS - 1);
+        assert(iv.in_flight);
+        now += ZIGBEE_INTERVIEW_TIMEOUT_MS;
+        zigbee_interview_tick(&iv, now);
+    }
+    assert(iv.step == ZIGBEE_INTERVIEW_STEP_IDLE && !zigbee_interview_take_result(&iv, &rec));
+    assert(zigbee_interview_next_due_ms(&iv) == ZIGBEE_INTERVIEW_IDLE);
+
+    /* Lost Simple_Desc and Basic answers still give a record, marked partial. */
+    assert(zigbee_interview_enqueue(&iv, 0x1234, IEEE_A));
+    const uint8_t eps[] = {1};
+    assert(zigbee_interview_next(&iv, now, &req));
+    assert(zigbee_interview_on_active_ep(&iv, req.token, eps, 1));
+    for (int attempt = 1; attempt <= ZIGBEE_INTERVIEW_MAX_ATTEMPTS; attempt++) {
+        assert(zigbee_interview_next(&iv, now, &req) && req.kind == ZIGBEE_INTERVIEW_REQ_SIMPLE_DESC);
+        assert(zigbee_interview_on_error(&iv, req.token));
+    }
+    assert(zigbee_interview_next(&iv, now, &req) && req.kind == ZIGBEE_INTERVIEW_REQ_BASIC && req.endpoint == 1);
+    for (int attempt = 1; attempt <= ZIGBEE_INTERVIEW_MAX_ATTEMPTS; attempt++) {
+        if (attempt > 1) {
+            assert(zigbee_interview_next(&iv, now, &req) && req.kind == ZIGBEE_INTERVIEW_REQ_BASIC);
+        }
+        now += ZIGBEE_INTERVIEW_TIMEOUT_MS;
+        zigbee_interview_tick(&iv, now);
+    }
+    assert(zigbee_interview_take_result(&iv, &rec));
+    assert(rec.state == GATEWAY_INTERVIEW_PARTIAL && rec.endpoint_count == 1 && rec.endpoints[0].endpoint == 1);
+    assert(rec.model[0] == '\0');
+}
+
+int main(void)
+{
+    printf("Running host tests: zigbee_interview_host_test\n");
+
+    test_full_interview();
+    test_queue_waits_for_result_and_dedups();
+    test_retries_and_partial();
+
+    printf("Host tests passed: zigbee_interview_host_test\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "zigbee_lqi_refresh.h"
+
+static void make_page(zigbee_neighbor_lqi_t *items, uint8_t start_index, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        memset(&items[i], 0, sizeof(items[i]));
+        items[i].short_addr = (uint16_t)(0x1000 + start_index + i);
+        items[i].lqi = 100 + start_index + i;
+    }
+}
+
+static void answer(zigbee_lqi_refresh_t *r, uint8_t start_index, uint8_t table_entries, uint8_t count, uint64_t now)
+{
+    zigbee_neighbor_lqi_t items[8];
+    make_page(items, start_index, count);
+    assert(zigbee_lqi_refresh_on_page(r, start_index, table_entries, items, count, now));
+}
+
+static void test_pages_are_pipelined_after_first_response(void)
+{
+    zigbee_lqi_refresh_t r;
+    uint8_t start = 0xFF;
+    gateway_status_t status;
+    size_t count = 0;
+
+    zigbee_lqi_refresh_begin(&r, 0);
+    assert(zigbee_lqi_refresh_deadline_ms(&r) == ZIGBEE_LQI_REFRESH_PAGE_TIMEOUT_MS);
+    assert(zigbee_lqi_refresh_next(&r, &start) && start == 0);
+    /* Table size is unknown until page 0 answers. */
+    assert(!zigbee_lqi_refresh_next(&r, &start));
+    assert(!zigbee_lqi_refresh_result(&r, &status, &count));
+
+    answer(&r, 0, 8, 2, 100);
+    assert(zigbee_lqi_refresh_deadline_ms(&r) == 100 + ZIGBEE_LQI_REFRESH_PAGE_TIMEOUT_MS);
+
+    /* The rest of the table goes out at once, one request per page. */
+    uint8_t sent[ZIGBEE_LQI_REFRESH_MAX_IN_FLIGHT];
+    size_t sent_count = 0;
+    while (zigbee_lqi_refresh_next(&r, &start)) {
+        sent[sent_count++] = start;
+    }
+    assert(sent_count == 3 && sent[0] == 2 && sent[1] == 4 && sent[2] == 6);
+
+    /* Out of order answers land at their own index; a duplicate is not expected any more. */
+    answer(&r, 6, 8, 2, 150);
+    answer(&r, 2, 8, 2, 160);
+    zigbee_neighbor_lqi_t dup[2];
+    make_page(dup, 2, 2);
+    assert(!zigbee_lqi_refresh_on_page(&r, 2, 8, dup, 2, 170));
+    assert(!zigbee_lqi_refresh_result(&r, &status, &count));
+    answer(&r, 4, 8, 2, 180);
+
+    assert(zigbee_lqi_refresh_result(&r, &status, &count));
+    assert(status == GATEWAY_STATUS_OK && count == 8);
+    for (size_t i = 0; i < count; i++) {
+        assert(r.entries[i].short_addr == 0x1000 + i);
+    }
+    assert(zigbee_lqi_refresh_deadline_ms(&r) == ZIGBEE_LQI_REFRESH_IDLE);
+    assert(!zigbee_lqi_refresh_next(&r, &start));
+}
+
+static void test_short_page_and_shrinking_table(void)
+{
+    zigbee_lqi_refresh_t r;
+    uint8_t start = 0;
+    gateway_status_t status;
+    size_t count = 0;
+
+    zigbee_lqi_refresh_begin(&r, 0);
+    assert(zigbee_lqi_refresh_next(&r, &start) && start == 0);
+    answer(&r, 0, 6, 3, 0);
+    assert(zigbee_lqi_refresh_next(&r, &start) && start == 3);
+    assert(!zigbee_lqi_refresh_next(&r, &start));
+
+    /* A shorter page leaves a hole that is asked for again. */
+    answer(&r, 3, 6, 1, 0);
+    assert(zigbee_lqi_refresh_next(&r, &start) && start == 4);
+    /* The table lost entries meanwhile: the empty page ends the walk. */
+    answer(&r, 4, 4, 0, 0);
+    assert(zigbee_lqi_refresh_result(&r, &status, &count));
+    assert(status == GATEWAY_STATUS_OK && count == 4);
+
+    zigbee_lqi_refresh_begin(&r, 0);
+    assert(zigbee_lqi_refresh_next(&r, &start));
+    answer(&r, 0, 0, 0, 0);
+    assert(zigbee_lqi_refresh_result(&r, &status, &count));
+    assert(status == GATEWAY_STATUS_OK && count == 0);
+}
+
+static void test_table_larger_than_capacity_is_truncated(void)
+{
+    zigbee_lqi_refresh_t r;
+    uint8_t start = 0;
+    gateway_status_t status;
+    size_t count = 0;
+
+    zigbee_lqi_refresh_begin(&r, 0);
+    assert(zigbee_lqi_refresh_next(&r, &start));
+    answer(&r, 0, 200, 3, 0);
+    while (!zigbee_lqi_refresh_result(&r, &status, &count)) {
+        assert(zigbee_lqi_refresh_next(&r, &start));
+        assert(start < MAX_DEVICES);
+        answer(&r, start, 200, 3, 0);
+    }
+    assert(status == GATEWAY_STATUS_OK && count == MAX_DEVICES);
+}
+
+static void test_error_timeout_and_request_cap(void)
+{
+    zigbee_lqi_refresh_t r;
+    uint8_t start = 0;
+    gateway_status_t status;
+    size_t count = 0;
+
+    zigbee_lqi_refresh_begin(&r, 0);
+    assert(zigbee_lqi_refresh_next(&r, &start));
+    assert(!zigbee_lqi_refresh_on_error(&r, 5));
+    assert(zigbee_lqi_refresh_on_error(&r, 0));
+    assert(zigbee_lqi_refresh_result(&r, &status, &count) && status == GATEWAY_STATUS_FAIL && count == 0);
+
+    zigbee_lqi_refresh_begin(&r, 1000);
+    assert(zigbee_lqi_refresh_next(&r, &start));
+    zigbee_lqi_refresh_tick(&r, 1000 + ZIGBEE_LQI_REFRESH_PAGE_TIMEOUT_MS - 1);
+    assert(!zigbee_lqi_refresh_result(&r, &status, &count));
+    zigbee_lqi_refresh_tick(&r, 1000 + ZIGBEE_LQI_REFRESH_PAGE_TIMEOUT_MS);
+    assert(zigbee_lqi_refresh_result(&r, &status, &count) && status == GATEWAY_STATUS_TIMEOUT);
+    /* A late answer after the timeout is dropped. */
+    zigbee_neighbor_lqi_t late[1];
+    make_page(late, 0, 1);
+    assert(!zigbee_lqi_refresh_on_page(&r, 0, 1, late, 1, 5000));
+
+    /* One entry per page: the walk still ends, at the latest when the request budget runs out. */
+    zigbee_lqi_refresh_begin(&r, 0);
+    size_t requests = 0;
+    while (zigbee_lqi_refresh_next(&r, &start)) {
+        requests++;
+        answer(&r, start, 200, 1, 0);
+    }
+    assert(requests <= ZIGBEE_LQI_REFRESH_MAX_REQUESTS);
+    assert(zigbee_lqi_refresh_result(&r, &status, &count));
+    assert(status == (MAX_DEVICES > ZIGBEE_LQI_REFRESH_MAX_REQUESTS ? GATEWAY_STATUS_FAIL : GATEWAY_STATUS_OK));
+}
+
+int main(void)
+{
+    printf("Running host tests: zigbee_lqi_refresh_host_test\n");
+
+    test_pages_are_pipelined_after_first_response();
+    test_short_page_and_shrinking_table();
+    test_table_larger_than_capacity_is_truncated();
+    test_error_timeout_and_request_cap();
+
+    printf("Host tests passed: zigbee_lqi_refresh_host_test\n");
+    return 0;
+}
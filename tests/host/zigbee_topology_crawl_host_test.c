@@ -0,0 +1,173 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zigbee_topology_crawl.h"
+
+typedef struct {
+    uint32_t token;
+    uint16_t addr;
+    uint8_t start_index;
+} sent_t;
+
+static zigbee_topology_neighbor_t nb(uint16_t addr, uint8_t type, uint8_t rel, uint8_t depth, uint8_t lqi)
+{
+    return (zigbee_topology_neighbor_t){
+        .short_addr = addr, .device_type = type, .relationship = rel, .depth = depth, .lqi = lqi};
+}
+
+static size_t drain(zigbee_topology_crawl_t *c, uint64_t now, sent_t *out, size_t max)
+{
+    size_t n = 0;
+    while (n < max && zigbee_topology_crawl_next(c, now, &out[n].token, &out[n].addr, &out[n].start_index)) {
+        n++;
+    }
+    return n;
+}
+
+static int node_index(const zigbee_topology_crawl_t *c, uint16_t addr)
+{
+    for (uint16_t i = 0; i < c->summary.node_count; i++) {
+        if (c->nodes[i].short_addr == addr) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void test_breadth_first_with_paging(void)
+{
+    zigbee_topology_crawl_t *c = calloc(1, sizeof(*c));
+    assert(c);
+    sent_t sent[ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT + 1];
+
+    zigbee_topology_crawl_begin(c, 0x0000, 0);
+    assert(c->summary.crawl_id == 1 && c->summary.state == GATEWAY_TOPOLOGY_CRAWL_RUNNING);
+    assert(drain(c, 0, sent, 5) == 1 && sent[0].addr == 0x0000 && sent[0].start_index == 0);
+
+    /* Coordinator page 1 of 2: two routers and a sleepy end device. */
+    zigbee_topology_neighbor_t page0[] = {
+        nb(0x1111, GATEWAY_TOPOLOGY_DEVICE_ROUTER, 1, 1, 200),
+        nb(0x2222, GATEWAY_TOPOLOGY_DEVICE_ROUTER, 1, 1, 150),
+        nb(0x3333, GATEWAY_TOPOLOGY_DEVICE_END_DEVICE, 1, 1, 90),
+    };
+    assert(zigbee_topology_crawl_on_page(c, sent[0].token, 4, page0, 3, 10));
+    /* A second answer with the same token is a late duplicate. */
+    assert(!zigbee_topology_crawl_on_page(c, sent[0].token, 4, page0, 3, 11));
+    assert(c->summary.node_count == 4 && c->summary.edge_count == 3);
+    assert(c->nodes[node_index(c, 0x3333)].state == GATEWAY_TOPOLOGY_NODE_LEAF);
+
+    /* The coordinator's next page goes first, then the routers in discovery order, in parallel. */
+    size_t n = drain(c, 10, sent, ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT + 1);
+    assert(n == 3);
+    assert(sent[0].addr == 0x0000 && sent[0].start_index == 3);
+    assert(sent[1].addr == 0x1111 && sent[1].start_index == 0);
+    assert(sent[2].addr == 0x2222);
+    assert(zigbee_topology_crawl_next_due_ms(c) == 10 + ZIGBEE_TOPOLOGY_PAGE_TIMEOUT_MS);
+
+    zigbee_topology_neighbor_t r1[] = {
+        nb(0x0000, GATEWAY_TOPOLOGY_DEVICE_COORDINATOR, 0, 0, 210),
+        nb(0x4444, GATEWAY_TOPOLOGY_DEVICE_ROUTER, 1, 2, 120),
+    };
+    assert(zigbee_topology_crawl_on_page(c, sent[1].token, 2, r1, 2, 20));
+    zigbee_topology_neighbor_t coord_rest[] = {nb(0x2222, GATEWAY_TOPOLOGY_DEVICE_ROUTER, 1, 1, 140)};
+    assert(zigbee_topology_crawl_on_page(c, sent[0].token, 4, coord_rest, 1, 21));
+    assert(zigbee_topology_crawl_on_page(c, sent[2].token, 0, NULL, 0, 22));
+
+    /* Known nodes are not duplicated; the coordinator edge from 0x1111 points back at index 0. */
+    assert(c->summary.node_count == 5);
+    assert(c->edges[3].from == node_index(c, 0x1111) && c->edges[3].to == 0 && c->edges[3].lqi == 210);
+
+    n = drain(c, 30, sent, ZIGBEE_TOPOLOGY_MAX_IN_FLIGHT + 1);
+    assert(n == 1 && sent[0].addr == 0x4444 && sent[0].start_index == 0);
+    assert(c->summary.state == GATEWAY_TOPOLOGY_CRAWL_RUNNING);
+    zigbee_topology_neighbor_t r4[] = {nb(0x1111, GATEWAY_TOPOLOGY_DEVICE_ROUTER, 0, 1, 100)};
+    assert(zigbee_topology_crawl_on_page(c, sent[0].token, 1, r4, 1, 40));
+
+    assert(c->summary.state == GATEWAY_TOPOLOGY_CRAWL_DONE && c->summary.finished_ms == 40);
+    assert(c->summary.routers_done == 4 && c->summary.routers_failed == 0);
+    assert(c->summary.edge_count == 7 && !c->summary.truncated);
+    assert(zigbee_topology_crawl_next_due_ms(c) == ZIGBEE_TOPOLOGY_IDLE);
+
+    /* A new crawl starts from scratch under a new id. */
+    zigbee_topology_crawl_begin(c, 0x0000, 100);
+    assert(c->summary.crawl_id == 2 && c->summary.node_count == 1 && c->summary.edge_count == 0);
+    free(c);
+}
+
+static void test_silent_router_is_retried_then_failed(void)
+{
+    zigbee_topology_crawl_t *c = calloc(1, sizeof(*c));
+    assert(c);
+    sent_t sent[2];
+
+    zigbee_topology_crawl_begin(c, 0x0000, 0);
+    assert(drain(c, 0, sent, 2) == 1);
+    zigbee_topology_neighbor_t page[] = {nb(0x1111, GATEWAY_TOPOLOGY_DEVICE_ROUTER, 1, 1, 200)};
+    assert(zigbee_topology_crawl_on_page(c, sent[0].token, 1, page, 1, 0));
+
+    uint64_t now = 0;
+    for (int attempt = 1; attempt <= ZIGBEE_TOPOLOGY_MAX_ATTEMPTS; attempt++) {
+        assert(drain(c, now, sent, 2) == 1 && sent[0].addr == 0x1111);
+        zigbee_topology_crawl_tick(c, now + ZIGBEE_TOPOLOGY_PAGE_TIMEOUT_MS - 1);
+        assert(c->summary.state == GATEWAY_TOPOLOGY_CRAWL_RUNNING);
+        now += ZIGBEE_TOPOLOGY_PAGE_TIMEOUT_MS;
+        zigbee_topology_crawl_tick(c, now);
+        if (attempt < ZIGBEE_TOPOLOGY_MAX_ATTEMPTS) {
+            /* Waiting for a resend, not for a timer. */
+            assert(zigbee_topology_crawl_next_due_ms(c) == 0);
+        }
+    }
+    assert(c->summary.state == GATEWAY_TOPOLOGY_CRAWL_DONE);
+    assert(c->summary.routers_failed == 1 && c->nodes[1].state == GATEWAY_TOPOLOGY_NODE_FAILED);
+    assert(!zigbee_topology_crawl_on_page(c, sent[0].token, 1, page, 1, now));
+
+    /* A coordinator that answers with an error fails the whole crawl. */
+    zigbee_topology_crawl_begin(c, 0x0000, 0);
+    for (int attempt = 1; attempt <= ZIGBEE_TOPOLOGY_MAX_ATTEMPTS; attempt++) {
+        assert(drain(c, 0, sent, 2) == 1);
+        assert(zigbee_topology_crawl_on_error(c, sent[0].token, 5));
+    }
+    assert(c->summary.state == GATEWAY_TOPOLOGY_CRAWL_FAILED);
+    free(c);
+}
+
+static void test_arena_overflow_is_flagged(void)
+{
+    zigbee_topology_crawl_t *c = calloc(1, sizeof(*c));
+    assert(c);
+    sent_t sent[1];
+
+    zigbee_topology_crawl_begin(c, 0x0000, 0);
+    uint16_t addr = 0x1000;
+    while (!c->summary.truncated) {
+        if (!drain(c, 0, sent, 1)) {
+            break;
+        }
+        zigbee_topology_neighbor_t page[4];
+        for (int i = 0; i < 4; i++) {
+            page[i] = nb(addr++, GATEWAY_TOPOLOGY_DEVICE_ROUTER, 2, 1, 100);
+        }
+        assert(zigbee_topology_crawl_on_page(c, sent[0].token, 4, page, 4, 0));
+    }
+    assert(c->summary.truncated);
+    assert(c->summary.node_count == GATEWAY_TOPOLOGY_MAX_NODES);
+    assert(c->summary.edge_count <= GATEWAY_TOPOLOGY_MAX_EDGES);
+    for (uint16_t i = 0; i < c->summary.edge_count; i++) {
+        assert(c->edges[i].from < c->summary.node_count && c->edges[i].to < c->summary.node_count);
+    }
+    free(c);
+}
+
+int main(void)
+{
+    printf("Running host tests: zigbee_topology_crawl_host_test\n");
+
+    test_breadth_first_with_paging();
+    test_silent_router_is_retried_then_failed();
+    test_arena_overflow_is_flagged();
+
+    printf("Host tests passed: zigbee_topology_crawl_host_test\n");
+    return 0;
+}
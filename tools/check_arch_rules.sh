@@ -56,7 +56,9 @@ check_device_repository_symbol_ownership() {
         local path="${rel%%:*}"
         local symbol="${rel##*:}"
         case "${symbol}" in
-            device_repository_load|device_repository_save|device_repository_clear)
+            device_repository_load|device_repository_save|device_repository_clear|\
+            device_repository_load_groups|device_repository_save_groups|\
+            device_repository_load_interviews|device_repository_save_interviews)
                 case "${path}" in
                     components/gateway_core_persistence_adapter/src/gateway_persistence_adapter.c|\
                     components/gateway_core_storage/src/device_repository_nvs.c)
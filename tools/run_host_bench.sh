@@ -0,0 +1,78 @@
+#!/usr/bin/env bash
+# Microbenchmark of the JSON builders: the working tree against a baseline revision, then a byte-for-byte
+# comparison of the documents. The baseline is the first argument, else $BASE_REF, else 24f9a3f, the
+# revision before json_writer and the DTO field tables.
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+API_DIR="components/gateway_web_api"
+BASE_REF="${1:-${BASE_REF:-24f9a3f}}"
+
+BUILD_DIR="$(mktemp -d)"
+trap 'rm -rf "${BUILD_DIR}"' EXIT
+mkdir -p "${BUILD_DIR}/base"
+# Headers and writers must match the baseline builders, so the whole component is taken from BASE_REF.
+git -C "${ROOT_DIR}" archive "${BASE_REF}" "${API_DIR}" | tar -x -C "${BUILD_DIR}/base"
+
+build_bench() {
+    local out="$1"
+    local api_dir="$2"
+    local writer_srcs=()
+    for src in json_writer.c cbor_writer.c latency_histogram.c; do
+        if [[ -f "${api_dir}/src/${src}" ]]; then
+            writer_srcs+=("${api_dir}/src/${src}")
+        fi
+    done
+    cc -std=c11 -O2 -Wall -Wextra -Werror \
+        -DCONFIG_GATEWAY_MAX_DEVICES=64 \
+        -I"${ROOT_DIR}/tests/host/include" \
+        -I"${api_dir}/include" \
+        -I"${ROOT_DIR}/components/gateway_core/include" \
+        -I"${ROOT_DIR}/components/gateway_core_facade/include" \
+        -I"${ROOT_DIR}/components/gateway_core_state/include" \
+        -I"${ROOT_DIR}/components/gateway_core_wifi/include" \
+        -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+        -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+        "${ROOT_DIR}/tests/host/json_builders_bench.c" \
+        "${api_dir}/src/status_json_builder.c" \
+        "${api_dir}/src/lqi_json_mapper.c" \
+        "${api_dir}/src/health_json_builder.c" \
+        "${writer_srcs[@]}" \
+        -o "${out}"
+}
+
+build_bench "${BUILD_DIR}/json_builders_bench_base" "${BUILD_DIR}/base/${API_DIR}"
+build_bench "${BUILD_DIR}/json_builders_bench" "${ROOT_DIR}/${API_DIR}"
+
+echo "Baseline (${BASE_REF}):"
+"${BUILD_DIR}/json_builders_bench_base" "${BUILD_DIR}/base.txt"
+echo "Current:"
+"${BUILD_DIR}/json_builders_bench" "${BUILD_DIR}/current.txt"
+
+if cmp -s "${BUILD_DIR}/base.txt" "${BUILD_DIR}/current.txt"; then
+    echo "Documents are byte-identical"
+else
+    echo "Documents differ from ${BASE_REF}:"
+    paste -d'\n' "${BUILD_DIR}/base.txt" "${BUILD_DIR}/current.txt" |
+        awk 'NR % 2 { prev = $0; next } $0 != prev { print "  " $1 }'
+fi
+
+# Request body parsers: json_reader against the cJSON tree it replaced, with cJSON taken from ESP-IDF.
+CJSON_DIR="${CJSON_DIR:-${IDF_PATH:+${IDF_PATH}/components/json/cJSON}}"
+if [[ -n "${CJSON_DIR}" && -f "${CJSON_DIR}/cJSON.c" ]]; then
+    cc -std=c11 -O2 -Wall -Wextra -Werror \
+        -I"${ROOT_DIR}/tests/host/include" \
+        -I"${ROOT_DIR}/${API_DIR}/include" \
+        -I"${ROOT_DIR}/components/gateway_core_facade/include" \
+        -I"${CJSON_DIR}" \
+        "${ROOT_DIR}/tests/host/api_contracts_bench.c" \
+        "${ROOT_DIR}/${API_DIR}/src/api_contracts.c" \
+        "${ROOT_DIR}/${API_DIR}/src/json_reader.c" \
+        "${CJSON_DIR}/cJSON.c" \
+        -lm \
+        -o "${BUILD_DIR}/api_contracts_bench"
+    echo "Request parsers:"
+    "${BUILD_DIR}/api_contracts_bench"
+else
+    echo "Skipping request parser bench: cJSON not found (set IDF_PATH or CJSON_DIR)"
+fi
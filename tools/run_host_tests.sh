@@ -30,6 +30,66 @@ cc -std=c11 -Wall -Wextra -Werror \
 
 "${BUILD_DIR}/device_service_rules_host_test"
 
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+    -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+    "${ROOT_DIR}/tests/host/zigbee_group_rules_host_test.c" \
+    "${ROOT_DIR}/components/gateway_core_zigbee/src/zigbee_group_rules.c" \
+    -o "${BUILD_DIR}/zigbee_group_rules_host_test"
+
+"${BUILD_DIR}/zigbee_group_rules_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+    -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+    "${ROOT_DIR}/tests/host/zigbee_cmd_scheduler_host_test.c" \
+    "${ROOT_DIR}/components/gateway_core_zigbee/src/zigbee_cmd_scheduler.c" \
+    -o "${BUILD_DIR}/zigbee_cmd_scheduler_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+    -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+    "${ROOT_DIR}/tests/host/zigbee_lqi_refresh_host_test.c" \
+    "${ROOT_DIR}/components/gateway_core_zigbee/src/zigbee_lqi_refresh.c" \
+    -o "${BUILD_DIR}/zigbee_lqi_refresh_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+    -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+    "${ROOT_DIR}/tests/host/zigbee_topology_crawl_host_test.c" \
+    "${ROOT_DIR}/components/gateway_core_zigbee/src/zigbee_topology_crawl.c" \
+    -o "${BUILD_DIR}/zigbee_topology_crawl_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror -pthread \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+    -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+    "${ROOT_DIR}/tests/host/zigbee_event_ring_host_test.c" \
+    "${ROOT_DIR}/components/gateway_core_zigbee/src/zigbee_event_ring.c" \
+    -o "${BUILD_DIR}/zigbee_event_ring_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+    -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+    "${ROOT_DIR}/tests/host/zigbee_interview_host_test.c" \
+    "${ROOT_DIR}/components/gateway_core_zigbee/src/zigbee_interview.c" \
+    -o "${BUILD_DIR}/zigbee_interview_host_test"
+
+"${BUILD_DIR}/zigbee_event_ring_host_test"
+
+"${BUILD_DIR}/zigbee_interview_host_test"
+
+"${BUILD_DIR}/zigbee_topology_crawl_host_test"
+
+"${BUILD_DIR}/zigbee_lqi_refresh_host_test"
+
+"${BUILD_DIR}/zigbee_cmd_scheduler_host_test"
+
 cc -std=c11 -Wall -Wextra -Werror \
     -I"${ROOT_DIR}/tests/host/include" \
     -I"${ROOT_DIR}/components/gateway_core/include" \
@@ -80,10 +140,101 @@ cc -std=c11 -Wall -Wextra -Werror \
     "${ROOT_DIR}/components/gateway_web_api/src/api_usecases.c" \
     "${ROOT_DIR}/components/gateway_web_api/src/api_usecases_zigbee.c" \
     "${ROOT_DIR}/components/gateway_web_api/src/api_usecases_system.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/http_response_cache.c" \
     -o "${BUILD_DIR}/api_usecases_host_test"
 
 "${BUILD_DIR}/api_usecases_host_test"
 
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_web_api/include" \
+    "${ROOT_DIR}/tests/host/cbor_writer_host_test.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/cbor_writer.c" \
+    -o "${BUILD_DIR}/cbor_writer_host_test"
+
+"${BUILD_DIR}/cbor_writer_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_web_api/include" \
+    "${ROOT_DIR}/tests/host/latency_histogram_host_test.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/latency_histogram.c" \
+    -o "${BUILD_DIR}/latency_histogram_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_web_api/include" \
+    "${ROOT_DIR}/tests/host/json_writer_host_test.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/json_writer.c" \
+    -o "${BUILD_DIR}/json_writer_host_test"
+
+"${BUILD_DIR}/json_writer_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/components/gateway_web_api/include" \
+    "${ROOT_DIR}/tests/host/json_reader_host_test.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/json_reader.c" \
+    -o "${BUILD_DIR}/json_reader_host_test"
+
+"${BUILD_DIR}/json_reader_host_test"
+
+# cJSON is not vendored; the differential test takes it from ESP-IDF (or CJSON_DIR) when one is around.
+CJSON_DIR="${CJSON_DIR:-${IDF_PATH:+${IDF_PATH}/components/json/cJSON}}"
+if [[ -n "${CJSON_DIR}" && -f "${CJSON_DIR}/cJSON.c" ]]; then
+    cc -std=c11 -Wall -Wextra -Werror \
+        -I"${ROOT_DIR}/tests/host/include" \
+        -I"${ROOT_DIR}/components/gateway_web_api/include" \
+        -I"${ROOT_DIR}/components/gateway_core_facade/include" \
+        -I"${CJSON_DIR}" \
+        "${ROOT_DIR}/tests/host/api_contracts_cjson_diff_host_test.c" \
+        "${ROOT_DIR}/components/gateway_web_api/src/api_contracts.c" \
+        "${ROOT_DIR}/components/gateway_web_api/src/json_reader.c" \
+        "${CJSON_DIR}/cJSON.c" \
+        -lm \
+        -o "${BUILD_DIR}/api_contracts_cjson_diff_host_test"
+
+    "${BUILD_DIR}/api_contracts_cjson_diff_host_test"
+else
+    echo "Skipping api_contracts_cjson_diff_host_test: cJSON not found (set IDF_PATH or CJSON_DIR)"
+fi
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_web_api/include" \
+    "${ROOT_DIR}/tests/host/dto_codec_host_test.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/json_writer.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/cbor_writer.c" \
+    -o "${BUILD_DIR}/dto_codec_host_test"
+
+"${BUILD_DIR}/dto_codec_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/tests/host/include" \
+    -I"${ROOT_DIR}/components/gateway_web_api/include" \
+    -I"${ROOT_DIR}/components/gateway_core/include" \
+    -I"${ROOT_DIR}/components/gateway_core_facade/include" \
+    -I"${ROOT_DIR}/components/gateway_core_state/include" \
+    -I"${ROOT_DIR}/components/gateway_core_wifi/include" \
+    -I"${ROOT_DIR}/components/gateway_core_zigbee/include" \
+    -I"${ROOT_DIR}/components/gateway_shared_config/include" \
+    "${ROOT_DIR}/tests/host/status_json_builder_host_test.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/status_json_builder.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/json_writer.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/cbor_writer.c" \
+    -o "${BUILD_DIR}/status_json_builder_host_test"
+
+"${BUILD_DIR}/status_json_builder_host_test"
+
+cc -std=c11 -Wall -Wextra -Werror \
+    -I"${ROOT_DIR}/components/gateway_web_api/include" \
+    "${ROOT_DIR}/tests/host/http_response_cache_host_test.c" \
+    "${ROOT_DIR}/components/gateway_web_api/src/http_response_cache.c" \
+    -o "${BUILD_DIR}/http_response_cache_host_test"
+
+"${BUILD_DIR}/http_response_cache_host_test"
+
+"${BUILD_DIR}/latency_histogram_host_test"
+
 cc -std=c11 -Wall -Wextra -Werror \
     -I"${ROOT_DIR}/tests/host/include" \
     -I"${ROOT_DIR}/components/gateway_web_api/include" \